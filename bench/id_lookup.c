@@ -0,0 +1,97 @@
+// Enterprise by Ash Amin. (Copyright 2023)
+
+/*
+File description: id_lookup.c measures how long it takes to find a node by ID
+in an ID index, for stores holding between one thousand and one million nodes.
+The cost per lookup should stay flat as the store grows.
+
+The benchmark uses a small node holding only an ID so that a million nodes fit
+comfortably in memory. It exercises the same record store and ID index that
+every enterprise list uses.
+*/
+
+// Import C standard libraries.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+// Import the enterprise data structures being measured.
+#include "../src/constants.h"
+#include "../src/id_index.c"
+#include "../src/record_store.c"
+
+#define ID_LOOKUP_QUERIES 4096
+#define ID_LOOKUP_ROUNDS 1000
+
+// A node with nothing but an ID.
+struct id_lookup_node {
+    enterprise_id id;
+};
+
+// Returns the current time in nanoseconds.
+uint64_t id_lookup_now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+}
+
+// Fill a store with node_count nodes, then time random lookups.
+// Returns the average number of nanoseconds per lookup, or -1 on failure.
+double id_lookup_run(uint32_t node_count) {
+    struct record_store store;
+    struct id_index index;
+    record_store_init(&store, sizeof(struct id_lookup_node));
+    id_index_init(&index);
+
+    for (uint32_t node = 1; node <= node_count; node++) {
+        struct id_lookup_node* record = record_store_append(&store);
+        if (record == NULL) return -1;
+        record->id = node;
+        if (id_index_insert(&index, record->id, record_store_handle(record))\
+        == false) return -1;
+    }
+
+    // Pick the IDs to look up ahead of time so only the lookup is timed.
+    enterprise_id* queries = malloc(sizeof(enterprise_id) * ID_LOOKUP_QUERIES);
+    if (queries == NULL) return -1;
+    for (int query = 0; query < ID_LOOKUP_QUERIES; query++) {
+        queries[query] = 1 + (uint32_t)rand() % node_count;
+    }
+
+    uint64_t found = 0;
+    uint64_t start = id_lookup_now();
+    for (int round = 0; round < ID_LOOKUP_ROUNDS; round++) {
+        for (int query = 0; query < ID_LOOKUP_QUERIES; query++) {
+            uint32_t handle = id_index_find(&index, queries[query]);
+            if (record_store_get(&store, handle) != NULL) found++;
+        }
+    }
+    uint64_t elapsed = id_lookup_now() - start;
+
+    free(queries);
+    id_index_free(&index);
+    record_store_free(&store);
+
+    if (found != (uint64_t)ID_LOOKUP_QUERIES * ID_LOOKUP_ROUNDS) return -1;
+    return (double)elapsed / ((double)ID_LOOKUP_QUERIES * ID_LOOKUP_ROUNDS);
+}
+
+int main(void) {
+    const uint32_t node_counts[] = {1000, 10000, 100000, 1000000};
+    srand(1);
+
+    printf("%-12s %12s\n", "nodes", "ns/lookup");
+    for (size_t size = 0; size < LEN(node_counts); size++) {
+        double result = id_lookup_run(node_counts[size]);
+        if (result < 0) {
+            printf("Failed to run lookup benchmark for %u nodes.\n",
+            node_counts[size]);
+            return -1;
+        }
+        printf("%-12u %12.1f\n", node_counts[size], result);
+    }
+    return 0;
+}
@@ -0,0 +1,374 @@
+// Enterprise by Ash Amin. (Copyright 2023)
+
+/*
+File description: lists.c measures every operation of every enterprise list,
+for lists holding between one thousand and one million nodes. For each list
+and size it reports the nanoseconds and heap allocations per operation, and
+the peak resident memory of the run.
+
+Operations measured:
+append: Add a node to the end of the list.
+append_reserved: Add a node to a list that reserved room for every node.
+get_node: Find a node by a random ID.
+select_next, select_previous: Move the selection by one node.
+get_num: Count the nodes of the list.
+label_rows: Format the labels of a screen of rows, scrolling by one row.
+label_rows_cached: Ask for the same labels again, as an idle frame does.
+label_rows_jump: Format the labels of a screen of rows at a random row.
+label_rows_jump_far: Jump back and forth between the rows a quarter and three
+quarters of the way down, as far as a row can be from both ends of the list.
+delete_node: Delete every node in a random order.
+
+Every list and size runs in a child process of its own, so that the peak
+resident memory reported belongs to that run alone. Allocations are counted by
+routing malloc, calloc and realloc through counting wrappers before the
+enterprise sources are included.
+*/
+
+// Import C standard libraries.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+// Count every allocation made by the enterprise sources.
+uint64_t lists_allocations = 0;
+
+void* lists_malloc(size_t size) {
+    lists_allocations++;
+    return malloc(size);
+}
+
+void* lists_calloc(size_t count, size_t size) {
+    lists_allocations++;
+    return calloc(count, size);
+}
+
+void* lists_realloc(void* pointer, size_t size) {
+    lists_allocations++;
+    return realloc(pointer, size);
+}
+
+#define malloc(size) lists_malloc(size)
+#define calloc(count, size) lists_calloc(count, size)
+#define realloc(pointer, size) lists_realloc(pointer, size)
+
+// Import the enterprise lists being measured, without the GUI. The program
+// compiles each source file on its own, but they are compiled in here so that
+// their allocations are counted as well.
+#ifndef ENTERPRISE_HEADLESS
+#define ENTERPRISE_HEADLESS
+#endif
+#include "../src/enterprise_id.c"
+#include "../src/enterprise_amount.c"
+#include "../src/record_store.c"
+#include "../src/id_index.c"
+#include "../src/sort_index.c"
+#include "../src/text_index.c"
+#include "../src/string_pool.c"
+#include "../src/row_labels.c"
+#include "../src/facility_references.c"
+#include "../src/stock_valuation.c"
+#include "../src/worker_pool.c"
+#include "../src/journal.c"
+#include "../src/facilities.c"
+#include "../src/employee_facilities.c"
+#include "../src/employees.c"
+#include "../src/inventory_facility.c"
+#include "../src/inventory.c"
+#include "../src/customers.c"
+#include "../src/suppliers.c"
+#include "../src/expenses.c"
+#include "../src/orders.c"
+#include "../src/snapshot.c"
+#include "../src/snapshot_map.c"
+#include "../src/journal_records.c"
+#include "../src/csv.c"
+#include "../src/export.c"
+#include "../src/enterprise.c"
+
+#undef malloc
+#undef calloc
+#undef realloc
+
+#define LISTS_QUERIES 65536
+#define LISTS_JUMPS 64
+#define LISTS_VISIBLE_ROWS 24
+
+// The operations of one kind of list, with its nodes left opaque.
+struct lists_entity {
+    const char* name;
+    void* (*list_new)(struct string_pool* string_pool);
+    void (*list_free)(void* list);
+    void (*append)(void* list);
+    bool (*reserve)(void* list, uint32_t count);
+    void* (*get_node)(void* list, enterprise_id id);
+    void (*delete_node)(void* list, enterprise_id id);
+    int (*get_num)(void* list);
+    void (*select_next)(void* list);
+    void (*select_previous)(void* list);
+    void (*select)(void* list, enterprise_id id);
+    void (*label_rows)(void* list, uint32_t first_row, uint32_t row_count);
+};
+
+// Define the wrappers that let a list of the given kind be measured through
+// a lists_entity. The constructor is passed in because expense and order
+// lists do not take a string pool.
+#define LISTS_ENTITY(entity, constructor) \
+void* lists_##entity##_new(struct string_pool* string_pool) { \
+    (void)string_pool; \
+    return constructor; \
+} \
+void lists_##entity##_free(void* list) { \
+    entity##_list_free(list); \
+} \
+void lists_##entity##_append(void* list) { \
+    entity##_list_append(list); \
+} \
+bool lists_##entity##_reserve(void* list, uint32_t count) { \
+    return entity##_list_reserve(list, count); \
+} \
+void* lists_##entity##_get_node(void* list, enterprise_id id) { \
+    return entity##_list_get_node(list, id); \
+} \
+void lists_##entity##_delete_node(void* list, enterprise_id id) { \
+    entity##_list_delete_node(list, id); \
+} \
+int lists_##entity##_get_num(void* list) { \
+    return entity##_list_get_num_##entity##_nodes(list); \
+} \
+void lists_##entity##_select_next(void* list) { \
+    entity##_list_select_next_node(list); \
+} \
+void lists_##entity##_select_previous(void* list) { \
+    entity##_list_select_previous_node(list); \
+} \
+void lists_##entity##_select(void* list, enterprise_id id) { \
+    ((struct entity##_list*)list)->id_currently_selected = id; \
+} \
+void lists_##entity##_label_rows(void* list, \
+uint32_t first_row, uint32_t row_count) { \
+    entity##_list_label_rows(list, first_row, row_count); \
+}
+
+LISTS_ENTITY(facility, facility_list_new(string_pool))
+LISTS_ENTITY(employee, employee_list_new(string_pool))
+LISTS_ENTITY(item, item_list_new(string_pool))
+LISTS_ENTITY(customer, customer_list_new(string_pool))
+LISTS_ENTITY(supplier, supplier_list_new(string_pool))
+LISTS_ENTITY(expense, expense_list_new())
+LISTS_ENTITY(order, order_list_new())
+
+#define LISTS_ENTITY_ENTRY(entity) { \
+    #entity, lists_##entity##_new, lists_##entity##_free, \
+    lists_##entity##_append, lists_##entity##_reserve, \
+    lists_##entity##_get_node, \
+    lists_##entity##_delete_node, lists_##entity##_get_num, \
+    lists_##entity##_select_next, lists_##entity##_select_previous, \
+    lists_##entity##_select, lists_##entity##_label_rows \
+}
+
+const struct lists_entity lists_entities[] = {
+    LISTS_ENTITY_ENTRY(facility),
+    LISTS_ENTITY_ENTRY(employee),
+    LISTS_ENTITY_ENTRY(item),
+    LISTS_ENTITY_ENTRY(customer),
+    LISTS_ENTITY_ENTRY(supplier),
+    LISTS_ENTITY_ENTRY(expense),
+    LISTS_ENTITY_ENTRY(order),
+};
+
+// Returns the current time in nanoseconds.
+uint64_t lists_now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+}
+
+// Returns the peak resident memory of this process in kilobytes.
+long lists_peak_rss() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+    return usage.ru_maxrss;
+}
+
+// Returns a random number between 0 and limit - 1.
+uint32_t lists_random(uint32_t limit) {
+    uint32_t value = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    return value % limit;
+}
+
+// The timing of one operation, started by lists_start.
+struct lists_timing {
+    uint64_t started;
+    uint64_t allocations;
+};
+
+struct lists_timing lists_start() {
+    struct lists_timing timing;
+    timing.allocations = lists_allocations;
+    timing.started = lists_now();
+    return timing;
+}
+
+// Print the cost of operation_count operations timed since lists_start.
+void lists_report(const char* entity, uint32_t node_count, \
+const char* operation, struct lists_timing timing, uint64_t operation_count) {
+    uint64_t elapsed = lists_now() - timing.started;
+    uint64_t allocations = lists_allocations - timing.allocations;
+    printf("%-10s %10u %-19s %12.1f %10.3f %10ld\n", entity, node_count, \
+    operation, (double)elapsed / (double)operation_count, \
+    (double)allocations / (double)operation_count, lists_peak_rss());
+}
+
+// Measure every operation of one list holding node_count nodes.
+// Returns 0 on success, or -1 on failure.
+int lists_run(const struct lists_entity* entity, uint32_t node_count) {
+    struct string_pool* string_pool = string_pool_new();
+    if (string_pool == NULL) return -1;
+    void* list = entity->list_new(string_pool);
+    if (list == NULL) return -1;
+
+    struct lists_timing timing = lists_start();
+    for (uint32_t node = 0; node < node_count; node++) entity->append(list);
+    lists_report(entity->name, node_count, "append", timing, node_count);
+    if (entity->get_num(list) != (int)node_count) return -1;
+
+    // Append to a second list that reserves room for every node first, as
+    // loading and importing do.
+    void* reserved_list = entity->list_new(string_pool);
+    if (reserved_list == NULL) return -1;
+    timing = lists_start();
+    if (entity->reserve(reserved_list, node_count) == false) return -1;
+    for (uint32_t node = 0; node < node_count; node++) {
+        entity->append(reserved_list);
+    }
+    lists_report(entity->name, node_count, "append_reserved", timing, \
+    node_count);
+    if (entity->get_num(reserved_list) != (int)node_count) return -1;
+    entity->list_free(reserved_list);
+
+    // Pick the IDs to look up ahead of time so only the lookup is timed.
+    enterprise_id* queries = malloc(sizeof(enterprise_id) * LISTS_QUERIES);
+    if (queries == NULL) return -1;
+    for (int query = 0; query < LISTS_QUERIES; query++) {
+        queries[query] = 1 + lists_random(node_count);
+    }
+    uint64_t found = 0;
+    timing = lists_start();
+    for (int query = 0; query < LISTS_QUERIES; query++) {
+        if (entity->get_node(list, queries[query]) != NULL) found++;
+    }
+    lists_report(entity->name, node_count, "get_node", timing, LISTS_QUERIES);
+    free(queries);
+    if (found != LISTS_QUERIES) return -1;
+
+    entity->select(list, node_count / 2);
+    timing = lists_start();
+    for (int step = 0; step < LISTS_QUERIES; step++) entity->select_next(list);
+    lists_report(entity->name, node_count, "select_next", timing, \
+    LISTS_QUERIES);
+    timing = lists_start();
+    for (int step = 0; step < LISTS_QUERIES; step++) {
+        entity->select_previous(list);
+    }
+    lists_report(entity->name, node_count, "select_previous", timing, \
+    LISTS_QUERIES);
+
+    uint32_t counts = LISTS_QUERIES;
+    int counted = 0;
+    timing = lists_start();
+    for (uint32_t count = 0; count < counts; count++) {
+        counted += entity->get_num(list);
+    }
+    lists_report(entity->name, node_count, "get_num", timing, counts);
+    if (counted != (int)(node_count * counts)) return -1;
+
+    // Scroll through the list one row at a time, as a dragged scrollbar does.
+    uint32_t last_row = node_count - LISTS_VISIBLE_ROWS;
+    timing = lists_start();
+    for (int step = 0; step < LISTS_QUERIES; step++) {
+        entity->label_rows(list, (uint32_t)step % last_row, \
+        LISTS_VISIBLE_ROWS);
+    }
+    lists_report(entity->name, node_count, "label_rows", timing, \
+    LISTS_QUERIES);
+    timing = lists_start();
+    for (int step = 0; step < LISTS_QUERIES; step++) {
+        entity->label_rows(list, 0, LISTS_VISIBLE_ROWS);
+    }
+    lists_report(entity->name, node_count, "label_rows_cached", timing, \
+    LISTS_QUERIES);
+    timing = lists_start();
+    for (int jump = 0; jump < LISTS_JUMPS; jump++) {
+        entity->label_rows(list, lists_random(last_row), LISTS_VISIBLE_ROWS);
+    }
+    lists_report(entity->name, node_count, "label_rows_jump", timing, \
+    LISTS_JUMPS);
+    timing = lists_start();
+    for (int jump = 0; jump < LISTS_JUMPS; jump++) {
+        uint32_t row = jump % 2 == 0 ? node_count / 4 : node_count / 4 * 3;
+        entity->label_rows(list, row, LISTS_VISIBLE_ROWS);
+    }
+    lists_report(entity->name, node_count, "label_rows_jump_far", timing, \
+    LISTS_JUMPS);
+
+    // Delete every node in a random order.
+    enterprise_id* ids = malloc(sizeof(enterprise_id) * node_count);
+    if (ids == NULL) return -1;
+    for (uint32_t node = 0; node < node_count; node++) ids[node] = node + 1;
+    for (uint32_t node = node_count - 1; node > 0; node--) {
+        uint32_t other = lists_random(node + 1);
+        enterprise_id id = ids[node];
+        ids[node] = ids[other];
+        ids[other] = id;
+    }
+    timing = lists_start();
+    for (uint32_t node = 0; node < node_count; node++) {
+        entity->delete_node(list, ids[node]);
+    }
+    lists_report(entity->name, node_count, "delete_node", timing, node_count);
+    free(ids);
+    if (entity->get_num(list) != 0) return -1;
+
+    entity->list_free(list);
+    string_pool_free(string_pool);
+    return 0;
+}
+
+int main(void) {
+    const uint32_t node_counts[] = {1000, 10000, 100000, 1000000};
+
+    printf("%-10s %10s %-19s %12s %10s %10s\n", "list", "nodes", \
+    "operation", "ns/op", "allocs/op", "peak KiB");
+    for (size_t entity = 0; entity < LEN(lists_entities); entity++) {
+        for (size_t size = 0; size < LEN(node_counts); size++) {
+            // Run each list and size in a child of its own so that its peak
+            // memory is not mixed up with the runs before it.
+            fflush(stdout);
+            pid_t child = fork();
+            if (child < 0) return -1;
+            if (child == 0) {
+                srand(1);
+                int result = lists_run(&lists_entities[entity], \
+                node_counts[size]);
+                fflush(stdout);
+                _exit(result == 0 ? 0 : 1);
+            }
+
+            int status = 0;
+            if (waitpid(child, &status, 0) < 0 || WIFEXITED(status) == false \
+            || WEXITSTATUS(status) != 0) {
+                printf("Failed to run list benchmark for %u %s nodes.\n", \
+                node_counts[size], lists_entities[entity].name);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
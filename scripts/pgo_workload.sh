@@ -0,0 +1,23 @@
+#!/bin/bash
+# Train a profile guided build of the batch runner on a made up enterprise.
+# The database is made and removed again inside the profile directory.
+# Usage: pgo_workload.sh enterprise_cli profile_directory records
+set -e
+cli=$1
+directory=$2
+records=$3
+database=$directory/workload.db
+exported=$directory/workload_export.db
+
+rm -f "$database" "$database.journal" "$exported"
+"$cli" -f "$database" generate "$records"
+"$cli" -f "$database" report > /dev/null
+for list in facilities employees items customers suppliers expenses orders; do
+    "$cli" -f "$database" query "$list" > /dev/null
+    "$cli" -f "$database" query "$list" 1 > /dev/null
+done
+"$cli" -f "$database" export "$exported"
+"$cli" -f "$database" import "$exported"
+"$cli" -f "$database" compact
+"$cli" -f "$database" memory > /dev/null
+rm -f "$database" "$database.journal" "$exported"
@@ -0,0 +1,889 @@
+// Enterprise by Ash Amin. (Copyright 2023)
+
+/*
+File description: cli.c runs batch jobs on an enterprise database without a
+display, for example nightly jobs on a server. It is built with
+ENTERPRISE_HEADLESS defined, which leaves the GUI out of the enterprise, so it
+needs neither SDL, OpenGL nor Nuklear.
+
+Usage: enterprise_cli [-f database] command [arguments]
+
+Commands:
+- report: Print the enterprise's name, balance and how many of each record
+there are.
+- query list [id]: Print every record of a list, or only the record with the
+given ID, as tab separated values with a header line. The lists are facilities,
+employees, items, customers, suppliers, expenses and orders.
+- export file: Write the database, including its journal, to a snapshot file.
+- import file: Replace the database with a snapshot file.
+- import-csv list file: Add every record of a CSV file to the facilities,
+customers, suppliers or items, and save the database. Records that can not be
+added are reported with their line number and skipped.
+- export-csv list file, export-json list file: Write every record of a list
+to a CSV or JSON file, or to standard output if file is -. Besides the lists
+named for query, the facilities of employees and items can be exported as
+employee_facilities and item_facilities.
+- compact: Save the database and empty its journal.
+- generate count: Add count made up records to every list and save the
+database, for trying out the program on a large enterprise and for training
+profile guided builds.
+- memory: Print how many records of each type there are, the slots and memory
+held for them, and how many have been appended and removed since loading.
+- valuation: Print how much stock each facility holds and what it is worth at
+retail price and at internal cost, followed by the totals.
+- references id: Print the employees who work at the facility with the given
+ID, the items stocked there and the expenses made there.
+- delete-facility id [cascade]: Delete the facility with the given ID and save
+the database. A facility that anything refers to is only deleted with cascade,
+which takes it off its employees and items and leaves its expenses without a
+facility.
+
+The database is enterprise.db unless another is named with -f. Commands that
+only read the database never write to it or its journal.
+*/
+
+// Import C standard libraries.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Import enterprise, without the GUI.
+#ifndef ENTERPRISE_HEADLESS
+#define ENTERPRISE_HEADLESS
+#endif
+#include "constants.h"
+
+#ifndef ENTERPRISE_DATABASE
+#define ENTERPRISE_DATABASE
+#include "enterprise.h"
+#endif
+
+#define CLI_EXIT_SUCCESS 0
+#define CLI_EXIT_FAILURE 1
+#define CLI_EXIT_USAGE 2
+
+// Print how to use the program.
+void cli_usage() {
+    fprintf(stderr, "Usage: enterprise_cli [-f database] command [arguments]\n"
+    "Commands:\n"
+    "  report             Print how many of each record there are.\n"
+    "  query list [id]    Print the records of a list, or one record.\n"
+    "  export file        Write the database to a snapshot file.\n"
+    "  import file        Replace the database with a snapshot file.\n"
+    "  import-csv list file\n"
+    "                     Add the records of a CSV file to a list.\n"
+    "  export-csv list file\n"
+    "  export-json list file\n"
+    "                     Write the records of a list to a file, or to\n"
+    "                     standard output if file is -.\n"
+    "  compact            Save the database and empty its journal.\n"
+    "  generate count     Add count made up records to every list.\n"
+    "  memory             Print the memory used by each type of record.\n"
+    "  valuation          Print the value of the stock at each facility.\n"
+    "  references id      Print what refers to a facility.\n"
+    "  delete-facility id [cascade]\n"
+    "                     Delete a facility, and with cascade, every\n"
+    "                     reference to it.\n"
+    "Lists: facilities, employees, items, customers, suppliers, expenses, "
+    "orders.\n");
+}
+
+// Print text as a tab separated field. Tabs and line breaks in the text are
+// printed as spaces so that they can not split the record.
+void cli_print_text(const char* text) {
+    if (text == NULL) return;
+    for (const char* character = text; *character != '\0'; character++) {
+        if (*character == '\t' || *character == '\n' || *character == '\r')
+            putchar(' ');
+        else putchar(*character);
+    }
+}
+
+// Returns the first record to print from a store: the record found by ID if
+// an ID was asked for, or else the first record of the store.
+void* cli_first(struct record_store* store, void* found, enterprise_id id) {
+    if (id != ENTERPRISE_ID_NONE) return found;
+    return record_store_first(store);
+}
+
+// Returns the next record to print from a store, or NULL if only one record
+// was asked for.
+void* cli_next(struct record_store* store, void* record, enterprise_id id) {
+    if (id != ENTERPRISE_ID_NONE) return NULL;
+    return record_store_next(store, record);
+}
+
+// Print facilities as tab separated values.
+void cli_query_facilities(struct enterprise* enterprise, enterprise_id id) {
+    struct facility_list* list = enterprise->facility_list;
+    printf("id\ttype\tname\temail\tphone\taddress\n");
+    struct facility_node* facility = \
+    cli_first(&list->store, facility_list_get_node(list, id), id);
+    while (facility != NULL) {
+        printf("%lld\t%s\t", facility->id, \
+        facility_list_get_node_type(list, facility->id));
+        cli_print_text(facility->name);
+        putchar('\t');
+        cli_print_text(facility->email);
+        putchar('\t');
+        cli_print_text(facility->phone);
+        putchar('\t');
+        cli_print_text(facility->address);
+        putchar('\n');
+        facility = cli_next(&list->store, facility, id);
+    }
+}
+
+// Print employees as tab separated values. The facilities an employee works
+// at are printed as a space separated list of facility IDs.
+void cli_query_employees(struct enterprise* enterprise, enterprise_id id) {
+    struct employee_list* list = enterprise->employee_list;
+    printf("id\tname\temail\tphone\taddress\tfacility_ids\n");
+    struct employee_node* employee = \
+    cli_first(&list->store, employee_list_get_node(list, id), id);
+    while (employee != NULL) {
+        printf("%lld\t", employee->id);
+        cli_print_text(employee->name);
+        putchar('\t');
+        cli_print_text(employee->email);
+        putchar('\t');
+        cli_print_text(employee->phone);
+        putchar('\t');
+        cli_print_text(employee->address);
+        putchar('\t');
+
+        struct employee_facility_list* facilities = \
+        employee->employee_facility_list;
+        struct employee_facility_node* employee_facility = \
+        facilities == NULL ? NULL : record_store_first(&facilities->store);
+        while (employee_facility != NULL) {
+            printf("%lld", employee_facility->facility_id);
+            employee_facility = \
+            record_store_next(&facilities->store, employee_facility);
+            if (employee_facility != NULL) putchar(' ');
+        }
+        putchar('\n');
+        employee = cli_next(&list->store, employee, id);
+    }
+}
+
+// Print items as tab separated values. Where an item is stocked is printed
+// as a space separated list of facility_id:quantity pairs.
+void cli_query_items(struct enterprise* enterprise, enterprise_id id) {
+    struct item_list* list = enterprise->item_list;
+    printf("id\tname\tretail_price\tinternal_cost\tstock\n");
+    struct item_node* item = \
+    cli_first(&list->store, item_list_get_node(list, id), id);
+    while (item != NULL) {
+        char retail_price[ENTERPRISE_CENTS_TEXT_LENGTH];
+        char internal_cost[ENTERPRISE_CENTS_TEXT_LENGTH];
+        enterprise_cents_format(item->retail_price, retail_price);
+        enterprise_cents_format(item->internal_cost, internal_cost);
+        printf("%lld\t", item->id);
+        cli_print_text(item->name);
+        printf("\t%s\t%s\t", retail_price, internal_cost);
+
+        struct item_facility_list* facilities = item->item_facility_list;
+        struct item_facility_node* item_facility = \
+        facilities == NULL ? NULL : record_store_first(&facilities->store);
+        while (item_facility != NULL) {
+            printf("%lld:%lld", item_facility->facility_id, \
+            item_facility->quantity);
+            item_facility = \
+            record_store_next(&facilities->store, item_facility);
+            if (item_facility != NULL) putchar(' ');
+        }
+        putchar('\n');
+        item = cli_next(&list->store, item, id);
+    }
+}
+
+// Print customers as tab separated values.
+void cli_query_customers(struct enterprise* enterprise, enterprise_id id) {
+    struct customer_list* list = enterprise->customer_list;
+    printf("id\tname\temail\tphone\taddress\n");
+    struct customer_node* customer = \
+    cli_first(&list->store, customer_list_get_node(list, id), id);
+    while (customer != NULL) {
+        printf("%lld\t", customer->id);
+        cli_print_text(customer->name);
+        putchar('\t');
+        cli_print_text(customer->email);
+        putchar('\t');
+        cli_print_text(customer->phone);
+        putchar('\t');
+        cli_print_text(customer->address);
+        putchar('\n');
+        customer = cli_next(&list->store, customer, id);
+    }
+}
+
+// Print suppliers as tab separated values.
+void cli_query_suppliers(struct enterprise* enterprise, enterprise_id id) {
+    struct supplier_list* list = enterprise->supplier_list;
+    printf("id\tname\temail\tphone\taddress\n");
+    struct supplier_node* supplier = \
+    cli_first(&list->store, supplier_list_get_node(list, id), id);
+    while (supplier != NULL) {
+        printf("%lld\t", supplier->id);
+        cli_print_text(supplier->name);
+        putchar('\t');
+        cli_print_text(supplier->email);
+        putchar('\t');
+        cli_print_text(supplier->phone);
+        putchar('\t');
+        cli_print_text(supplier->address);
+        putchar('\n');
+        supplier = cli_next(&list->store, supplier, id);
+    }
+}
+
+// Print expenses as tab separated values.
+void cli_query_expenses(struct enterprise* enterprise, enterprise_id id) {
+    struct expense_list* list = enterprise->expense_list;
+    printf("id\ttype\tfacility_id\tsupplier_id\n");
+    struct expense_node* expense = \
+    cli_first(&list->store, expense_list_get_node(list, id), id);
+    while (expense != NULL) {
+        printf("%lld\t%s\t%lld\t%lld\n", expense->id, \
+        expense_list_get_node_type(list, expense->id), expense->facility_id, \
+        expense->supplier_id);
+        expense = cli_next(&list->store, expense, id);
+    }
+}
+
+// Print orders as tab separated values.
+void cli_query_orders(struct enterprise* enterprise, enterprise_id id) {
+    struct order_list* list = enterprise->order_list;
+    printf("id\tsupplier_type\tsupplier_id\trecipient_type\trecipient_id"
+    "\ttime_order_placed\tdelivered\n");
+    struct order_node* order = \
+    cli_first(&list->store, order_list_get_node(list, id), id);
+    while (order != NULL) {
+        printf("%lld\t%s\t%lld\t%s\t%lld\t%lld\t%s\n", order->id, \
+        order->supplier_type == order_supplier_facility \
+        ? "Facility" : "Supplier", order->supplier_id, \
+        order->recipient_type == order_recipient_customer \
+        ? "Customer" : "Facility", order->recipient_id, \
+        (long long)order->time_order_placed, order->delivered ? "yes" : "no");
+        order = cli_next(&list->store, order, id);
+    }
+}
+
+// A list that can be queried, and how to print it.
+struct cli_list {
+    const char* name;
+    void (*query)(struct enterprise* enterprise, enterprise_id id);
+};
+
+const struct cli_list cli_lists[] = {
+    {"facilities", cli_query_facilities},
+    {"employees", cli_query_employees},
+    {"items", cli_query_items},
+    {"customers", cli_query_customers},
+    {"suppliers", cli_query_suppliers},
+    {"expenses", cli_query_expenses},
+    {"orders", cli_query_orders},
+};
+
+// Read the enterprise kept at path, replaying its journal, without writing to
+// either of them. A database that does not exist yet reads as empty.
+// Returns pointer to the enterprise on success, or NULL on failure.
+struct enterprise* cli_read(const char* path) {
+    struct enterprise* enterprise = enterprise_load(path, NULL);
+    if (enterprise == NULL) {
+        FILE* file = fopen(path, "rb");
+        if (file != NULL) {
+            fclose(file);
+            fprintf(stderr, "Failed to load enterprise from '%s'.\n", path);
+            return NULL;
+        }
+        enterprise = enterprise_new();
+        if (enterprise == NULL) return NULL;
+    }
+
+    char journal_path[ENTERPRISE_JOURNAL_PATH_LENGTH];
+    enterprise_journal_path(path, journal_path);
+    if (enterprise_replay(enterprise, journal_path) == false) {
+        fprintf(stderr, "Journal '%s' is damaged, reading the changes before "
+        "the damage.\n", journal_path);
+    }
+    return enterprise;
+}
+
+// Print the enterprise's name, balance and how many of each record there are.
+int cli_report(const char* path) {
+    struct enterprise* enterprise = cli_read(path);
+    if (enterprise == NULL) return CLI_EXIT_FAILURE;
+
+    // Count the links between employees or items and facilities.
+    uint64_t employee_facilities = 0;
+    struct employee_node* employee = \
+    record_store_first(&enterprise->employee_list->store);
+    while (employee != NULL) {
+        if (employee->employee_facility_list != NULL) {
+            employee_facilities += \
+            employee->employee_facility_list->store.count;
+        }
+        employee = record_store_next(&enterprise->employee_list->store, \
+        employee);
+    }
+    uint64_t item_facilities = 0;
+    struct item_node* item = record_store_first(&enterprise->item_list->store);
+    while (item != NULL) {
+        if (item->item_facility_list != NULL) {
+            item_facilities += item->item_facility_list->store.count;
+        }
+        item = record_store_next(&enterprise->item_list->store, item);
+    }
+
+    printf("name\t");
+    cli_print_text(enterprise->name);
+    char balance[ENTERPRISE_CENTS_TEXT_LENGTH];
+    enterprise_cents_format(enterprise->balance, balance);
+    printf("\nbalance\t%s", balance);
+    printf("\nfacilities\t%u\n", enterprise->facility_list->store.count);
+    printf("employees\t%u\n", enterprise->employee_list->store.count);
+    printf("employee_facilities\t%llu\n", \
+    (unsigned long long)employee_facilities);
+    printf("items\t%u\n", enterprise->item_list->store.count);
+    printf("item_facilities\t%llu\n", (unsigned long long)item_facilities);
+    printf("customers\t%u\n", enterprise->customer_list->store.count);
+    printf("suppliers\t%u\n", enterprise->supplier_list->store.count);
+    printf("expenses\t%u\n", enterprise->expense_list->store.count);
+    printf("orders\t%u\n", enterprise->order_list->store.count);
+    enterprise_quit(enterprise);
+    return CLI_EXIT_SUCCESS;
+}
+
+// Print one line of the memory report.
+void cli_print_memory(const char* name, struct record_store_stats* stats) {
+    printf("%s\t%llu\t%llu\t%llu\t%llu\t%llu\t%llu\n", name, \
+    (unsigned long long)stats->records, (unsigned long long)stats->capacity, \
+    (unsigned long long)stats->chunks, (unsigned long long)stats->bytes, \
+    (unsigned long long)stats->appends, (unsigned long long)stats->removes);
+}
+
+// Print the records, slots, chunks and bytes held by each type of node, and
+// how many records have been appended and removed since loading.
+int cli_memory(const char* path) {
+    struct enterprise* enterprise = cli_read(path);
+    if (enterprise == NULL) return CLI_EXIT_FAILURE;
+
+    struct enterprise_memory memory;
+    enterprise_get_memory(enterprise, &memory);
+    printf("type\trecords\tslots\tchunks\tbytes\tappends\tremoves\n");
+    cli_print_memory("facilities", &memory.facilities);
+    cli_print_memory("employees", &memory.employees);
+    cli_print_memory("employee_facilities", &memory.employee_facilities);
+    cli_print_memory("items", &memory.items);
+    cli_print_memory("item_facilities", &memory.item_facilities);
+    cli_print_memory("customers", &memory.customers);
+    cli_print_memory("suppliers", &memory.suppliers);
+    cli_print_memory("expenses", &memory.expenses);
+    cli_print_memory("orders", &memory.orders);
+    printf("strings\t%llu\t\t\t%llu\t\t\n", \
+    (unsigned long long)memory.strings, \
+    (unsigned long long)memory.string_bytes);
+    enterprise_quit(enterprise);
+    return CLI_EXIT_SUCCESS;
+}
+
+// Print the stock held at each facility and its value, then the totals.
+int cli_valuation(const char* path) {
+    struct enterprise* enterprise = cli_read(path);
+    if (enterprise == NULL) return CLI_EXIT_FAILURE;
+    struct stock_valuation* valuation = &enterprise->item_list->valuation;
+    if (item_list_value(enterprise->item_list) == false) {
+        fprintf(stderr, "Failed to value the stock.\n");
+        enterprise_quit(enterprise);
+        return CLI_EXIT_FAILURE;
+    }
+
+    char retail_value[ENTERPRISE_CENTS_TEXT_LENGTH];
+    char internal_value[ENTERPRISE_CENTS_TEXT_LENGTH];
+    printf("facility_id\tstock\tretail_value\tinternal_value\n");
+    for (uint32_t row = 0; row < valuation->facility_count; row++) {
+        enterprise_cents_format(valuation->retail_values[row], retail_value);
+        enterprise_cents_format\
+        (valuation->internal_values[row], internal_value);
+        printf("%lld\t%lld\t%s\t%s\n", valuation->facility_ids[row], \
+        valuation->quantities[row], retail_value, internal_value);
+    }
+    enterprise_cents_format(valuation->retail_value, retail_value);
+    enterprise_cents_format(valuation->internal_value, internal_value);
+    printf("total\t%lld\t%s\t%s\n", valuation->quantity, retail_value, \
+    internal_value);
+    enterprise_quit(enterprise);
+    return CLI_EXIT_SUCCESS;
+}
+
+// Print the employees, items and expenses that refer to the facility with the
+// ID given as text, as tab separated values with a header line.
+int cli_references(const char* path, const char* id_text) {
+    enterprise_id facility_id = enterprise_id_parse(id_text);
+    if (facility_id == ENTERPRISE_ID_NONE) {
+        fprintf(stderr, "Invalid ID '%s'.\n", id_text);
+        return CLI_EXIT_USAGE;
+    }
+    struct enterprise* enterprise = cli_read(path);
+    if (enterprise == NULL) return CLI_EXIT_FAILURE;
+    struct facility_references* references = \
+    &enterprise->facility_list->references;
+    if (facility_references_build(references) == false) {
+        fprintf(stderr, "Failed to find the references to facilities.\n");
+        enterprise_quit(enterprise);
+        return CLI_EXIT_FAILURE;
+    }
+
+    const struct facility_reference_set* set = \
+    facility_references_find(references, facility_id);
+    printf("type\tid\tname\n");
+    for (uint32_t index = 0; set != NULL && index < set->count; index++) {
+        struct facility_reference reference = set->references[index];
+        if (reference.type == facility_reference_employee) {
+            struct employee_node* employee = employee_list_get_node\
+            (enterprise->employee_list, reference.owner_id);
+            printf("employee\t%lld\t", reference.owner_id);
+            if (employee != NULL) cli_print_text(employee->name);
+        }
+        else if (reference.type == facility_reference_item) {
+            struct item_node* item = \
+            item_list_get_node(enterprise->item_list, reference.owner_id);
+            printf("item\t%lld\t", reference.owner_id);
+            if (item != NULL) cli_print_text(item->name);
+        }
+        else printf("expense\t%lld\t", reference.owner_id);
+        putchar('\n');
+    }
+    enterprise_quit(enterprise);
+    return CLI_EXIT_SUCCESS;
+}
+
+// Delete the facility with the ID given as text from the database at path,
+// then save it. Unless cascade is set, a facility that anything refers to is
+// left as it is.
+int cli_delete_facility(const char* path, const char* id_text, bool cascade) {
+    enterprise_id facility_id = enterprise_id_parse(id_text);
+    if (facility_id == ENTERPRISE_ID_NONE) {
+        fprintf(stderr, "Invalid ID '%s'.\n", id_text);
+        return CLI_EXIT_USAGE;
+    }
+    struct enterprise* enterprise = enterprise_open(path, false, NULL);
+    if (enterprise == NULL) {
+        fprintf(stderr, "Failed to open '%s'.\n", path);
+        return CLI_EXIT_FAILURE;
+    }
+    if (facility_list_get_node(enterprise->facility_list, facility_id) \
+    == NULL) {
+        fprintf(stderr, "There is no facility with ID %lld.\n", facility_id);
+        enterprise_quit(enterprise);
+        return CLI_EXIT_FAILURE;
+    }
+
+    const struct facility_reference_set* set = facility_references_find\
+    (&enterprise->facility_list->references, facility_id);
+    if (set != NULL && cascade == false) {
+        fprintf(stderr, "Facility %lld is referred to by %u employees, %u "
+        "items and %u expenses. Delete it with cascade to remove them.\n", \
+        facility_id, set->type_counts[facility_reference_employee], \
+        set->type_counts[facility_reference_item], \
+        set->type_counts[facility_reference_expense]);
+        enterprise_quit(enterprise);
+        return CLI_EXIT_FAILURE;
+    }
+
+    bool saved = enterprise_delete_facility(enterprise, facility_id) && \
+    enterprise_save(enterprise, path, NULL);
+    enterprise_quit(enterprise);
+    if (saved == false) {
+        fprintf(stderr, "Failed to delete facility %lld from '%s'.\n", \
+        facility_id, path);
+        return CLI_EXIT_FAILURE;
+    }
+    return CLI_EXIT_SUCCESS;
+}
+
+// Print the records of the named list, or only the record with the ID given
+// as text if id_text is not NULL.
+int cli_query(const char* path, const char* list_name, const char* id_text) {
+    const struct cli_list* list = NULL;
+    for (size_t index = 0; index < LEN(cli_lists); index++) {
+        if (strcmp(cli_lists[index].name, list_name) == 0) {
+            list = &cli_lists[index];
+        }
+    }
+    if (list == NULL) {
+        fprintf(stderr, "Unknown list '%s'.\n", list_name);
+        return CLI_EXIT_USAGE;
+    }
+
+    enterprise_id id = ENTERPRISE_ID_NONE;
+    if (id_text != NULL) {
+        id = enterprise_id_parse(id_text);
+        if (id == ENTERPRISE_ID_NONE) {
+            fprintf(stderr, "'%s' is not an ID.\n", id_text);
+            return CLI_EXIT_USAGE;
+        }
+    }
+
+    struct enterprise* enterprise = cli_read(path);
+    if (enterprise == NULL) return CLI_EXIT_FAILURE;
+    list->query(enterprise, id);
+    enterprise_quit(enterprise);
+    return CLI_EXIT_SUCCESS;
+}
+
+// Write the database at path, including its journal, to a snapshot file.
+int cli_export(const char* path, const char* export_path) {
+    struct enterprise* enterprise = cli_read(path);
+    if (enterprise == NULL) return CLI_EXIT_FAILURE;
+    bool saved = enterprise_save(enterprise, export_path, NULL);
+    enterprise_quit(enterprise);
+    if (saved == false) {
+        fprintf(stderr, "Failed to write '%s'.\n", export_path);
+        return CLI_EXIT_FAILURE;
+    }
+    return CLI_EXIT_SUCCESS;
+}
+
+// Replace the database at path with the snapshot at import_path. The
+// database's journal is emptied once the snapshot is in place, as its changes
+// belong to the database being replaced.
+int cli_import(const char* path, const char* import_path) {
+    struct enterprise* enterprise = enterprise_load(import_path, NULL);
+    if (enterprise == NULL) {
+        fprintf(stderr, "Failed to load '%s'.\n", import_path);
+        return CLI_EXIT_FAILURE;
+    }
+    bool saved = enterprise_save(enterprise, path, NULL) && \
+    enterprise_start_journal(enterprise, path, true);
+    enterprise_quit(enterprise);
+    if (saved == false) {
+        fprintf(stderr, "Failed to replace '%s'.\n", path);
+        return CLI_EXIT_FAILURE;
+    }
+    return CLI_EXIT_SUCCESS;
+}
+
+// Add every record of the CSV file at csv_path to the named list of the
+// database at path, then save it.
+int cli_import_csv(const char* path, const char* list_name, \
+const char* csv_path) {
+    FILE* file = fopen(csv_path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Failed to open '%s'.\n", csv_path);
+        return CLI_EXIT_FAILURE;
+    }
+    struct enterprise* enterprise = enterprise_open(path, true, NULL);
+    if (enterprise == NULL) {
+        fprintf(stderr, "Failed to open '%s'.\n", path);
+        fclose(file);
+        return CLI_EXIT_FAILURE;
+    }
+
+    struct csv_reader reader;
+    struct csv_import import = {0, 0};
+    bool imported = csv_reader_init(&reader, file);
+    if (imported == false) fprintf(stderr, "Not enough memory to import.\n");
+    else if (strcmp(list_name, "facilities") == 0) {
+        imported = csv_import_list(&reader, csv_facility_columns, \
+        LEN(csv_facility_columns), csv_add_facility, \
+        enterprise->facility_list, stderr, &import);
+    }
+    else if (strcmp(list_name, "customers") == 0) {
+        imported = csv_import_list(&reader, csv_customer_columns, \
+        LEN(csv_customer_columns), csv_add_customer, \
+        enterprise->customer_list, stderr, &import);
+    }
+    else if (strcmp(list_name, "suppliers") == 0) {
+        imported = csv_import_list(&reader, csv_supplier_columns, \
+        LEN(csv_supplier_columns), csv_add_supplier, \
+        enterprise->supplier_list, stderr, &import);
+    }
+    else if (strcmp(list_name, "items") == 0) {
+        imported = csv_import_list(&reader, csv_item_columns, \
+        LEN(csv_item_columns), csv_add_item, enterprise->item_list, stderr, \
+        &import);
+    }
+    else {
+        fprintf(stderr, "Can not import CSV into '%s'. The lists are "
+        "facilities, customers, suppliers and items.\n", list_name);
+        csv_reader_free(&reader);
+        fclose(file);
+        enterprise_quit(enterprise);
+        return CLI_EXIT_USAGE;
+    }
+    csv_reader_free(&reader);
+    fclose(file);
+
+    // Nothing is saved unless the whole file was read.
+    bool saved = imported && enterprise_save(enterprise, path, NULL);
+    enterprise_quit(enterprise);
+    if (saved == false) {
+        fprintf(stderr, "Failed to import '%s' into '%s'.\n", csv_path, path);
+        return CLI_EXIT_FAILURE;
+    }
+    printf("imported\t%llu\nskipped\t%llu\n", \
+    (unsigned long long)import.imported, (unsigned long long)import.skipped);
+    return CLI_EXIT_SUCCESS;
+}
+
+// Save the database at path and empty its journal.
+int cli_compact(const char* path) {
+    struct enterprise* enterprise = enterprise_open(path, false, NULL);
+    if (enterprise == NULL) {
+        fprintf(stderr, "Failed to open '%s'.\n", path);
+        return CLI_EXIT_FAILURE;
+    }
+    bool saved = enterprise_save(enterprise, path, NULL);
+    enterprise_quit(enterprise);
+    if (saved == false) {
+        fprintf(stderr, "Failed to save '%s'.\n", path);
+        return CLI_EXIT_FAILURE;
+    }
+    return CLI_EXIT_SUCCESS;
+}
+
+// Fill the text fields of a made up facility, employee, customer or supplier,
+// noting the change in the journal.
+void cli_generate_contact(struct enterprise* enterprise, \
+enum journal_list list, enterprise_id id, const char** name, \
+const char** email, const char** phone, const char** address, \
+const char* kind, uint64_t number) {
+    char text[ENTERPRISE_STRING_LENGTH];
+    snprintf(text, sizeof(text), "%s %llu", kind, (unsigned long long)number);
+    string_pool_assign(enterprise->string_pool, name, text);
+    snprintf(text, sizeof(text), "%s%llu@example.com", kind, \
+    (unsigned long long)number);
+    string_pool_assign(enterprise->string_pool, email, text);
+    snprintf(text, sizeof(text), "555-%04llu", \
+    (unsigned long long)(number % 10000));
+    string_pool_assign(enterprise->string_pool, phone, text);
+    snprintf(text, sizeof(text), "%llu Main Street", \
+    (unsigned long long)(number % 1000));
+    string_pool_assign(enterprise->string_pool, address, text);
+    journal_put(enterprise->journal, list, ENTERPRISE_ID_NONE, id);
+}
+
+// Add count made up records to every list of the database at path, then save
+// it. Employees and items are linked to a facility, and expenses and orders
+// refer to the facilities, suppliers and customers made alongside them.
+int cli_generate(const char* path, const char* count_text) {
+    char* end = NULL;
+    unsigned long long count = strtoull(count_text, &end, 10);
+    if (end == count_text || *end != '\0' || count == 0 || \
+    count > UINT32_MAX) {
+        fprintf(stderr, "'%s' is not a number of records.\n", count_text);
+        return CLI_EXIT_USAGE;
+    }
+    struct enterprise* enterprise = enterprise_open(path, true, NULL);
+    if (enterprise == NULL) {
+        fprintf(stderr, "Failed to open '%s'.\n", path);
+        return CLI_EXIT_FAILURE;
+    }
+
+    if (facility_list_reserve(enterprise->facility_list, count) == false || \
+    employee_list_reserve(enterprise->employee_list, count) == false || \
+    item_list_reserve(enterprise->item_list, count) == false || \
+    customer_list_reserve(enterprise->customer_list, count) == false || \
+    supplier_list_reserve(enterprise->supplier_list, count) == false || \
+    expense_list_reserve(enterprise->expense_list, count) == false || \
+    order_list_reserve(enterprise->order_list, count) == false) {
+        fprintf(stderr, "Not enough memory for %llu records.\n", count);
+        enterprise_quit(enterprise);
+        return CLI_EXIT_FAILURE;
+    }
+
+    for (uint64_t number = 1; number <= count; number++) {
+        facility_list_append(enterprise->facility_list);
+        struct facility_node* facility = \
+        facility_list_get_selected_node(enterprise->facility_list);
+        if (facility == NULL) break;
+        facility->type = (enum facility_type)(number % 3);
+        cli_generate_contact(enterprise, journal_list_facilities, \
+        facility->id, &facility->name, &facility->email, &facility->phone, \
+        &facility->address, "Facility", number);
+
+        employee_list_append(enterprise->employee_list);
+        struct employee_node* employee = \
+        employee_list_get_selected_node(enterprise->employee_list);
+        if (employee == NULL) break;
+        cli_generate_contact(enterprise, journal_list_employees, \
+        employee->id, &employee->name, &employee->email, &employee->phone, \
+        &employee->address, "Employee", number);
+        employee->employee_facility_list = employee_facility_list_new\
+        (enterprise->journal, enterprise->employee_list->facility_references, \
+        employee->id);
+        employee_facility_list_append(employee->employee_facility_list);
+        employee_facility_list_set_facility(employee->employee_facility_list, \
+        employee_facility_list_get_selected_node\
+        (employee->employee_facility_list), facility->id);
+
+        item_list_append(enterprise->item_list);
+        struct item_node* item = \
+        item_list_get_selected_node(enterprise->item_list);
+        if (item == NULL) break;
+        char text[ENTERPRISE_STRING_LENGTH];
+        snprintf(text, sizeof(text), "Item %llu", (unsigned long long)number);
+        string_pool_assign(enterprise->string_pool, &item->name, text);
+        item->retail_price = (enterprise_cents)(number % 100) * 100 + 99;
+        item->internal_cost = (enterprise_cents)(number % 50) * 100 + 25;
+        item_list_sort_node(enterprise->item_list, item);
+        journal_put(enterprise->journal, journal_list_items, \
+        ENTERPRISE_ID_NONE, item->id);
+        item->item_facility_list = \
+        item_facility_list_new(enterprise->journal, \
+        &enterprise->item_list->valuation, \
+        enterprise->item_list->facility_references, item->id);
+        item_facility_list_append(item->item_facility_list);
+        struct item_facility_node* item_facility = \
+        item_facility_list_get_selected_node(item->item_facility_list);
+        if (item_facility != NULL) {
+            item_facility_list_set_facility(item->item_facility_list, \
+            item_facility, facility->id);
+            item_facility->quantity = (enterprise_quantity)(number % 500);
+            stock_valuation_change(&enterprise->item_list->valuation, \
+            item_facility->facility_id, item_facility->quantity, \
+            item->retail_price, item->internal_cost);
+        }
+
+        customer_list_append(enterprise->customer_list);
+        struct customer_node* customer = \
+        customer_list_get_selected_node(enterprise->customer_list);
+        if (customer == NULL) break;
+        cli_generate_contact(enterprise, journal_list_customers, \
+        customer->id, &customer->name, &customer->email, &customer->phone, \
+        &customer->address, "Customer", number);
+
+        supplier_list_append(enterprise->supplier_list);
+        struct supplier_node* supplier = \
+        supplier_list_get_selected_node(enterprise->supplier_list);
+        if (supplier == NULL) break;
+        cli_generate_contact(enterprise, journal_list_suppliers, \
+        supplier->id, &supplier->name, &supplier->email, &supplier->phone, \
+        &supplier->address, "Supplier", number);
+
+        expense_list_append(enterprise->expense_list);
+        struct expense_node* expense = \
+        expense_list_get_selected_node(enterprise->expense_list);
+        if (expense == NULL) break;
+        expense_list_set_facility(enterprise->expense_list, expense, \
+        facility->id);
+        expense->supplier_id = supplier->id;
+        expense->type = (enum expense_type)(number % 5);
+        journal_put(enterprise->journal, journal_list_expenses, \
+        ENTERPRISE_ID_NONE, expense->id);
+
+        order_list_append(enterprise->order_list);
+        struct order_node* order = \
+        order_list_get_selected_node(enterprise->order_list);
+        if (order == NULL) break;
+        order->supplier_id = supplier->id;
+        order->recipient_id = customer->id;
+        order->supplier_type = order_supplier_supplier;
+        order->recipient_type = order_recipient_customer;
+        order->delivered = number % 2 == 0;
+        journal_put(enterprise->journal, journal_list_orders, \
+        ENTERPRISE_ID_NONE, order->id);
+    }
+
+    bool saved = enterprise_save(enterprise, path, NULL);
+    enterprise_quit(enterprise);
+    if (saved == false) {
+        fprintf(stderr, "Failed to save '%s'.\n", path);
+        return CLI_EXIT_FAILURE;
+    }
+    return CLI_EXIT_SUCCESS;
+}
+
+// Write every record of the named table of the database at path to the file
+// at export_path in format, or to standard output if export_path is "-".
+int cli_export_table(const char* path, const char* table_name, \
+const char* export_path, enum export_format format) {
+    enum export_table table = 0;
+    while (table < export_table_count && \
+    strcmp(table_name, export_table_names[table]) != 0) {
+        table++;
+    }
+    if (table == export_table_count) {
+        fprintf(stderr, "Unknown list '%s'.\n", table_name);
+        return CLI_EXIT_USAGE;
+    }
+
+    struct enterprise* enterprise = cli_read(path);
+    if (enterprise == NULL) return CLI_EXIT_FAILURE;
+    bool exported = strcmp(export_path, "-") == 0 \
+    ? enterprise_export(enterprise, table, format, stdout, NULL) \
+    : enterprise_export_file(enterprise, table, format, export_path, \
+    NULL);
+    enterprise_quit(enterprise);
+    if (exported == false) {
+        fprintf(stderr, "Failed to write '%s'.\n", export_path);
+        return CLI_EXIT_FAILURE;
+    }
+    return CLI_EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv) {
+    const char* path = ENTERPRISE_DATABASE_FILE;
+    int argument = 1;
+    if (argc > 2 && strcmp(argv[1], "-f") == 0) {
+        path = argv[2];
+        argument = 3;
+    }
+    if (argument >= argc) {
+        cli_usage();
+        return CLI_EXIT_USAGE;
+    }
+
+    const char* command = argv[argument];
+    int count = argc - argument - 1;
+    char** arguments = argv + argument + 1;
+    if (strcmp(command, "report") == 0 && count == 0) {
+        return cli_report(path);
+    }
+    if (strcmp(command, "query") == 0 && (count == 1 || count == 2)) {
+        return cli_query(path, arguments[0], count == 2 ? arguments[1] : NULL);
+    }
+    if (strcmp(command, "export") == 0 && count == 1) {
+        return cli_export(path, arguments[0]);
+    }
+    if (strcmp(command, "import") == 0 && count == 1) {
+        return cli_import(path, arguments[0]);
+    }
+    if (strcmp(command, "import-csv") == 0 && count == 2) {
+        return cli_import_csv(path, arguments[0], arguments[1]);
+    }
+    if (strcmp(command, "export-csv") == 0 && count == 2) {
+        return cli_export_table(path, arguments[0], arguments[1], \
+        export_format_csv);
+    }
+    if (strcmp(command, "export-json") == 0 && count == 2) {
+        return cli_export_table(path, arguments[0], arguments[1], \
+        export_format_json);
+    }
+    if (strcmp(command, "compact") == 0 && count == 0) {
+        return cli_compact(path);
+    }
+    if (strcmp(command, "generate") == 0 && count == 1) {
+        return cli_generate(path, arguments[0]);
+    }
+    if (strcmp(command, "memory") == 0 && count == 0) {
+        return cli_memory(path);
+    }
+    if (strcmp(command, "valuation") == 0 && count == 0) {
+        return cli_valuation(path);
+    }
+    if (strcmp(command, "references") == 0 && count == 1) {
+        return cli_references(path, arguments[0]);
+    }
+    if (strcmp(command, "delete-facility") == 0 && (count == 1 || \
+    (count == 2 && strcmp(arguments[1], "cascade") == 0))) {
+        return cli_delete_facility(path, arguments[0], count == 2);
+    }
+    cli_usage();
+    return CLI_EXIT_USAGE;
+}
@@ -1,14 +0,0 @@
-#define WINDOW_WIDTH 800
-#define WINDOW_HEIGHT 600
-
-#define MAX_VERTEX_MEMORY 512 * 1024
-#define MAX_ELEMENT_MEMORY 128 * 1024
-
-#define UNUSED(a) (void)a
-#define MIN(a,b) ((a) < (b) ? (a) : (b))
-#define MAX(a,b) ((a) < (b) ? (b) : (a))
-#define LEN(a) (sizeof(a)/sizeof(a)[0])
-
-#define ENTERPRISE_STRING_LENGTH 1024
-#define ENTERPRISE_FONT_SIZE 25
-#define ENTERPRISE_WIDGET_HEIGHT 40
\ No newline at end of file
@@ -0,0 +1,23 @@
+#define WINDOW_WIDTH 800
+#define WINDOW_HEIGHT 600
+
+#define MAX_VERTEX_MEMORY 512 * 1024
+#define MAX_ELEMENT_MEMORY 128 * 1024
+
+#define UNUSED(a) (void)a
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+#define MAX(a,b) ((a) < (b) ? (b) : (a))
+#define LEN(a) (sizeof(a)/sizeof(a)[0])
+
+#define ENTERPRISE_STRING_LENGTH 1024
+#define ENTERPRISE_FONT_SIZE 25
+#define ENTERPRISE_WIDGET_HEIGHT 40
+#define ENTERPRISE_TABLE_HEIGHT (WINDOW_HEIGHT - 3 * ENTERPRISE_WIDGET_HEIGHT)
+#define ENTERPRISE_FRAME_TIME_INTERVAL 1000
+#define ENTERPRISE_SETTLE_FRAMES 2
+#define ENTERPRISE_IDLE_TIMEOUT 250
+#define ENTERPRISE_PROGRESS_STEPS 1000
+#ifndef ENTERPRISE_MAX_FPS
+#define ENTERPRISE_MAX_FPS 60
+#endif
+#define ENTERPRISE_DATABASE_FILE "enterprise.db"
\ No newline at end of file
@@ -0,0 +1,396 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_CSV
+#define ENTERPRISE_CSV
+#include "csv.h"
+#endif
+
+// Initialise a reader that reads CSV from file.
+// Returns true on success, or false on failure.
+bool csv_reader_init(struct csv_reader* reader, FILE* file) {
+    if (reader == NULL || file == NULL) return false;
+    memset(reader, 0, sizeof(struct csv_reader));
+    reader->file = file;
+    reader->line = 1;
+    reader->capacity = CSV_CHUNK_SIZE * 2;
+    reader->buffer = malloc(reader->capacity);
+    return reader->buffer != NULL;
+}
+
+// Free all memory associated with a reader. The file is left open.
+void csv_reader_free(struct csv_reader* reader) {
+    if (reader == NULL) return;
+    free(reader->buffer);
+    reader->buffer = NULL;
+}
+
+// Read the next chunk of the file after the bytes not yet split into records,
+// moving them to the start of the buffer first.
+// Returns true if anything was read, or false at the end of the file.
+static bool csv_reader_fill(struct csv_reader* reader) {
+    if (reader->end_of_file) return false;
+    size_t unread = reader->used - reader->position;
+    memmove(reader->buffer, reader->buffer + reader->position, unread);
+    reader->used = unread;
+    reader->position = 0;
+
+    // One byte is always kept free, to end a last field that has no line
+    // break after it.
+    if (reader->capacity - reader->used < CSV_CHUNK_SIZE + 1) {
+        size_t capacity = reader->capacity * 2;
+        char* buffer = realloc(reader->buffer, capacity);
+        if (buffer == NULL) {
+            reader->failed = true;
+            reader->end_of_file = true;
+            return false;
+        }
+        reader->buffer = buffer;
+        reader->capacity = capacity;
+    }
+
+    size_t size = fread(reader->buffer + reader->used, 1, CSV_CHUNK_SIZE, \
+    reader->file);
+    reader->used += size;
+    if (size < CSV_CHUNK_SIZE) {
+        if (ferror(reader->file)) reader->failed = true;
+        reader->end_of_file = true;
+    }
+    return size > 0;
+}
+
+// Returns the position of the line break that ends the record starting at the
+// reader's position, or the end of the buffer if the record does not end in
+// it. Line breaks between an odd number of quotes are inside a quoted field.
+static size_t csv_record_end(struct csv_reader* reader) {
+    const char* start = reader->buffer + reader->position;
+    const char* end = reader->buffer + reader->used;
+    const char* search = start;
+    bool quoted = false;
+    while (search < end) {
+        const char* line_break = memchr(search, '\n', (size_t)(end - search));
+        if (line_break == NULL) line_break = end;
+        for (const char* quote = memchr(search, '"', \
+        (size_t)(line_break - search)); quote != NULL; quote = memchr(quote + \
+        1, '"', (size_t)(line_break - quote - 1))) {
+            quoted = !quoted;
+        }
+        if (quoted == false || line_break == end) {
+            return (size_t)(line_break - reader->buffer);
+        }
+        search = line_break + 1;
+    }
+    return reader->used;
+}
+
+// Split the bytes from start up to end into the reader's fields, in place.
+// Returns true on success, or false if the record is malformed.
+static bool csv_split_record(struct csv_reader* reader, char* start, \
+char* end) {
+    reader->field_count = 0;
+    char* read = start;
+    for (;;) {
+        if (reader->field_count == CSV_MAX_FIELDS) {
+            reader->error = "The record has too many fields.";
+            return false;
+        }
+        char* field = read;
+        char* write = read;
+        if (read < end && *read == '"') {
+            // Copy a quoted field back over its quotes, one quote for each
+            // pair inside it.
+            read++;
+            for (;;) {
+                if (read == end) {
+                    reader->error = "A quoted field is never closed.";
+                    return false;
+                }
+                if (*read == '"') {
+                    if (read + 1 < end && read[1] == '"') {
+                        *write++ = '"';
+                        read += 2;
+                        continue;
+                    }
+                    read++;
+                    break;
+                }
+                *write++ = *read++;
+            }
+            if (read < end && *read != ',') {
+                reader->error = "A quoted field is followed by more text.";
+                return false;
+            }
+        }
+        else {
+            while (read < end && *read != ',') read++;
+            write = read;
+        }
+
+        reader->fields[reader->field_count++] = field;
+        if (read == end) {
+            *write = '\0';
+            return true;
+        }
+        *write = '\0';
+        read++;
+    }
+}
+
+// Read the next record of the file into the reader's fields. Blank lines are
+// skipped.
+// Returns csv_status_record if a record was read, csv_status_error if the
+// record was malformed, which is then skipped and described by the reader's
+// error, or csv_status_end at the end of the file or if it can not be read.
+enum csv_status csv_read_record(struct csv_reader* reader) {
+    if (reader == NULL || reader->buffer == NULL) return csv_status_end;
+    for (;;) {
+        size_t end = csv_record_end(reader);
+        if (end == reader->used && reader->end_of_file == false) {
+            csv_reader_fill(reader);
+            continue;
+        }
+        if (reader->position == reader->used) return csv_status_end;
+
+        // Split off the record, without its line break.
+        char* start = reader->buffer + reader->position;
+        char* record_end = reader->buffer + end;
+        reader->position = end < reader->used ? end + 1 : end;
+        reader->record_line = reader->line;
+        for (char* character = memchr(start, '\n', \
+        (size_t)(record_end - start)); character != NULL; \
+        character = memchr(character + 1, '\n', \
+        (size_t)(record_end - character - 1))) {
+            reader->line++;
+        }
+        if (end < reader->used) reader->line++;
+        if (record_end > start && record_end[-1] == '\r') record_end--;
+        if (record_end == start) continue;
+
+        reader->error = NULL;
+        return csv_split_record(reader, start, record_end) \
+        ? csv_status_record : csv_status_error;
+    }
+}
+
+// Returns whether two column names are the same, ignoring the case of ASCII
+// letters and spaces around the first.
+static bool csv_same_name(const char* text, const char* name) {
+    while (*text == ' ') text++;
+    for (; *name != '\0'; text++, name++) {
+        char character = *text;
+        if (character >= 'A' && character <= 'Z') character += 'a' - 'A';
+        if (character != *name) return false;
+    }
+    while (*text == ' ') text++;
+    return *text == '\0';
+}
+
+// Import every record of a CSV file into a list. The header names which of
+// the list's column_count columns each field belongs to, and add_row adds a
+// record to the list from them. Records that can not be added are reported
+// to errors, if it is not NULL, and skipped.
+// Returns true on success, or false if the header has none of the columns or
+// the file could not be read.
+bool csv_import_list(struct csv_reader* reader, const char* const* columns, \
+uint32_t column_count, csv_import_row add_row, void* list, FILE* errors, \
+struct csv_import* import) {
+    if (reader == NULL || columns == NULL || column_count > CSV_MAX_FIELDS || \
+    add_row == NULL || import == NULL) return false;
+    import->imported = 0;
+    import->skipped = 0;
+
+    // Find the field that holds each column.
+    int positions[CSV_MAX_FIELDS];
+    bool known = false;
+    if (csv_read_record(reader) != csv_status_record) {
+        if (errors != NULL) fprintf(errors, "The header can not be read.\n");
+        return false;
+    }
+    for (uint32_t column = 0; column < column_count; column++) {
+        positions[column] = -1;
+        for (uint32_t field = 0; field < reader->field_count; field++) {
+            if (csv_same_name(reader->fields[field], columns[column])) {
+                positions[column] = (int)field;
+                known = true;
+            }
+        }
+    }
+    if (known == false) {
+        if (errors != NULL) {
+            fprintf(errors, "The header names none of the columns:");
+            for (uint32_t column = 0; column < column_count; column++) {
+                fprintf(errors, " %s", columns[column]);
+            }
+            fprintf(errors, ".\n");
+        }
+        return false;
+    }
+    uint32_t header_count = reader->field_count;
+
+    const char* fields[CSV_MAX_FIELDS];
+    for (;;) {
+        enum csv_status status = csv_read_record(reader);
+        if (status == csv_status_end) break;
+
+        const char* error = reader->error;
+        if (status == csv_status_record && \
+        reader->field_count != header_count) {
+            error = "The record does not have a field for every column.";
+            status = csv_status_error;
+        }
+        if (status == csv_status_record) {
+            for (uint32_t column = 0; column < column_count; column++) {
+                fields[column] = positions[column] < 0 \
+                ? "" : reader->fields[positions[column]];
+                if (strlen(fields[column]) >= ENTERPRISE_STRING_LENGTH) {
+                    error = "A field is too long.";
+                    status = csv_status_error;
+                }
+            }
+        }
+        if (status == csv_status_record && \
+        add_row(list, fields, &error) == false) status = csv_status_error;
+
+        if (status == csv_status_record) import->imported++;
+        else {
+            import->skipped++;
+            if (errors != NULL) {
+                fprintf(errors, "Line %llu: %s\n", \
+                (unsigned long long)reader->record_line, error);
+            }
+        }
+    }
+    if (reader->failed && errors != NULL) {
+        fprintf(errors, "The file could not be read to the end.\n");
+    }
+    return reader->failed == false;
+}
+
+// The columns that facilities are imported from.
+const char* const csv_facility_columns[CSV_FACILITY_COLUMN_COUNT] = \
+{"name", "email", "phone", "address", "type"};
+
+// Add a facility from its fields.
+// Returns true on success, or false on failure.
+bool csv_add_facility(void* list, const char** fields, const char** error) {
+    struct facility_list* facility_list = list;
+
+    // Facility types are named as they are in the facility editor.
+    const char* const types[] = {"office", "store", "warehouse"};
+    enum facility_type type = facility_type_office;
+    bool typed = fields[4][0] == '\0';
+    for (size_t index = 0; index < LEN(types); index++) {
+        if (csv_same_name(fields[4], types[index])) {
+            type = (enum facility_type)index;
+            typed = true;
+        }
+    }
+    if (typed == false) {
+        *error = "The type is not Office, Store or Warehouse.";
+        return false;
+    }
+
+    facility_list_append(facility_list);
+    struct facility_node* facility = \
+    facility_list_get_node(facility_list, facility_list->id_last_assigned);
+    if (facility == NULL) {
+        *error = "There is not enough memory for the facility.";
+        return false;
+    }
+    struct string_pool* string_pool = facility_list->string_pool;
+    string_pool_assign(string_pool, &facility->name, fields[0]);
+    string_pool_assign(string_pool, &facility->email, fields[1]);
+    string_pool_assign(string_pool, &facility->phone, fields[2]);
+    string_pool_assign(string_pool, &facility->address, fields[3]);
+    facility->type = type;
+    facility_list->version++;
+    return true;
+}
+
+// The columns that customers are imported from.
+const char* const csv_customer_columns[CSV_CUSTOMER_COLUMN_COUNT] = \
+{"name", "email", "phone", "address"};
+
+// Add a customer from its fields.
+// Returns true on success, or false on failure.
+bool csv_add_customer(void* list, const char** fields, const char** error) {
+    struct customer_list* customer_list = list;
+    customer_list_append(customer_list);
+    struct customer_node* customer = \
+    customer_list_get_node(customer_list, customer_list->id_last_assigned);
+    if (customer == NULL) {
+        *error = "There is not enough memory for the customer.";
+        return false;
+    }
+    struct string_pool* string_pool = customer_list->string_pool;
+    string_pool_assign(string_pool, &customer->name, fields[0]);
+    string_pool_assign(string_pool, &customer->email, fields[1]);
+    string_pool_assign(string_pool, &customer->phone, fields[2]);
+    string_pool_assign(string_pool, &customer->address, fields[3]);
+    customer_list->version++;
+    customer_list_index_node(customer_list, customer);
+    customer_list_sort_node(customer_list, customer);
+    return true;
+}
+
+// The columns that suppliers are imported from.
+const char* const csv_supplier_columns[CSV_SUPPLIER_COLUMN_COUNT] = \
+{"name", "email", "phone", "address"};
+
+// Add a supplier from its fields.
+// Returns true on success, or false on failure.
+bool csv_add_supplier(void* list, const char** fields, const char** error) {
+    struct supplier_list* supplier_list = list;
+    supplier_list_append(supplier_list);
+    struct supplier_node* supplier = \
+    supplier_list_get_node(supplier_list, supplier_list->id_last_assigned);
+    if (supplier == NULL) {
+        *error = "There is not enough memory for the supplier.";
+        return false;
+    }
+    struct string_pool* string_pool = supplier_list->string_pool;
+    string_pool_assign(string_pool, &supplier->name, fields[0]);
+    string_pool_assign(string_pool, &supplier->email, fields[1]);
+    string_pool_assign(string_pool, &supplier->phone, fields[2]);
+    string_pool_assign(string_pool, &supplier->address, fields[3]);
+    supplier_list->version++;
+    supplier_list_index_node(supplier_list, supplier);
+    return true;
+}
+
+// The columns that items are imported from.
+const char* const csv_item_columns[CSV_ITEM_COLUMN_COUNT] = \
+{"name", "retail_price", "internal_cost"};
+
+// Add an item from its fields.
+// Returns true on success, or false on failure.
+bool csv_add_item(void* list, const char** fields, const char** error) {
+    struct item_list* item_list = list;
+    enterprise_cents retail_price;
+    enterprise_cents internal_cost;
+    if (enterprise_cents_parse(fields[1], &retail_price) == false) {
+        *error = "The retail price is not an amount such as 12.34.";
+        return false;
+    }
+    if (enterprise_cents_parse(fields[2], &internal_cost) == false) {
+        *error = "The internal cost is not an amount such as 12.34.";
+        return false;
+    }
+
+    item_list_append(item_list);
+    struct item_node* item = \
+    item_list_get_node(item_list, item_list->id_last_assigned);
+    if (item == NULL) {
+        *error = "There is not enough memory for the item.";
+        return false;
+    }
+    string_pool_assign(item_list->string_pool, &item->name, fields[0]);
+    item->retail_price = retail_price;
+    item->internal_cost = internal_cost;
+    item_list->version++;
+    item_list_sort_node(item_list, item);
+    return true;
+}
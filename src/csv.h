@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_FACILITIES
+#define ENTERPRISE_FACILITIES
+#include "facilities.h"
+#endif
+
+#ifndef ENTERPRISE_ITEMS
+#define ENTERPRISE_ITEMS
+#include "inventory.h"
+#endif
+
+#ifndef ENTERPRISE_CUSTOMERS
+#define ENTERPRISE_CUSTOMERS
+#include "customers.h"
+#endif
+
+#ifndef ENTERPRISE_SUPPLIERS
+#define ENTERPRISE_SUPPLIERS
+#include "suppliers.h"
+#endif
+
+/* How CSV files work.
+Facilities, customers, suppliers and items can be imported from comma
+separated values, so that an existing list does not have to be typed in record
+by record. Fields are separated by commas and records by line breaks. A field
+may be quoted with double quotes, in which case it can hold commas and line
+breaks, and a double quote inside it is written twice.
+
+The first record is a header naming the columns, which may come in any order
+and in any case. Columns the list does not have, such as an ID, are ignored:
+every imported record is given the next ID of its list. Columns that are left
+out are left empty.
+
+Files are read in chunks of CSV_CHUNK_SIZE bytes into a buffer that only grows
+if a single record does not fit. Records are split in place: the end of each
+field is overwritten with a terminating 0 and the quotes of a quoted field are
+removed by moving its text back, so fields are used straight from the buffer
+without being copied. A record that runs off the end of the buffer is moved to
+the start and the next chunk is read after it.
+
+A record that can not be imported, for example because a price is not an
+amount, is reported with the line it starts on and skipped, and the import
+carries on with the next record.
+
+Data structures:
+csv_reader: A CSV file being read, its buffer and the fields of its record.
+csv_import: How many records an import added and skipped.
+*/
+
+#define CSV_CHUNK_SIZE (256 * 1024)
+#define CSV_MAX_FIELDS 64
+
+// The number of columns of each list that can be imported.
+#define CSV_FACILITY_COLUMN_COUNT 5
+#define CSV_CUSTOMER_COLUMN_COUNT 4
+#define CSV_SUPPLIER_COLUMN_COUNT 4
+#define CSV_ITEM_COLUMN_COUNT 3
+
+// What reading a record found.
+enum csv_status {csv_status_record, csv_status_error, csv_status_end};
+
+// CSV reader structure.
+struct csv_reader {
+    FILE* file;
+    bool end_of_file;
+    bool failed;
+
+    // The bytes read from the file, and the first one not split into records.
+    char* buffer;
+    size_t capacity;
+    size_t used;
+    size_t position;
+
+    // The line the next record starts on, and the line the record last read
+    // started on.
+    uint64_t line;
+    uint64_t record_line;
+
+    // The fields of the record last read, and why it could not be read if
+    // it could not.
+    const char* fields[CSV_MAX_FIELDS];
+    uint32_t field_count;
+    const char* error;
+};
+
+// How many records an import added, and how many it skipped.
+struct csv_import {
+    uint64_t imported;
+    uint64_t skipped;
+};
+
+// Adds a row of a list from fields, given in the order of the list's columns.
+// Returns true on success, or false with error pointing at why not.
+typedef bool (*csv_import_row)(void* list, const char** fields, \
+const char** error);
+
+bool csv_reader_init(struct csv_reader* reader, FILE* file);
+void csv_reader_free(struct csv_reader* reader);
+enum csv_status csv_read_record(struct csv_reader* reader);
+bool csv_import_list(struct csv_reader* reader, const char* const* columns, \
+uint32_t column_count, csv_import_row add_row, void* list, FILE* errors, \
+struct csv_import* import);
+extern const char* const csv_facility_columns[CSV_FACILITY_COLUMN_COUNT];
+bool csv_add_facility(void* list, const char** fields, const char** error);
+extern const char* const csv_customer_columns[CSV_CUSTOMER_COLUMN_COUNT];
+bool csv_add_customer(void* list, const char** fields, const char** error);
+extern const char* const csv_supplier_columns[CSV_SUPPLIER_COLUMN_COUNT];
+bool csv_add_supplier(void* list, const char** fields, const char** error);
+extern const char* const csv_item_columns[CSV_ITEM_COLUMN_COUNT];
+bool csv_add_item(void* list, const char** fields, const char** error);
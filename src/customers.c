@@ -9,153 +9,214 @@
 #include <limits.h>
 #include <time.h>
 
-#include "constants.c"
-
-#ifndef PROGRAM_STATES
-#define PROGRAM_STATES
-#include "program_states.c"
+// Import Nuklear, unless building without the GUI.
+#if !defined(ENTERPRISE_NUKLEAR_LIBRARY_IMPORT) \
+&& !defined(ENTERPRISE_HEADLESS)
+#define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
+#include "nuklear_import.h"
 #endif
 
-
-// Import Nuklear.
-#ifndef ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-#define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-    #define NK_INCLUDE_FIXED_TYPES
-    #define NK_INCLUDE_STANDARD_IO
-    #define NK_INCLUDE_STANDARD_VARARGS
-    #define NK_INCLUDE_DEFAULT_ALLOCATOR
-    #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    #define NK_INCLUDE_FONT_BAKING
-    #define NK_INCLUDE_DEFAULT_FONT
-    #define NK_IMPLEMENTATION
-    #define NK_SDL_GLES2_IMPLEMENTATION
-    #include "../third_party/Nuklear/nuklear.h"
-    #include "../third_party/Nuklear/demo/sdl_opengles2/nuklear_sdl_gles2.h"
-    #include "../third_party/Nuklear/demo/common/style.c"
+#ifndef ENTERPRISE_CUSTOMERS
+#define ENTERPRISE_CUSTOMERS
+#include "customers.h"
 #endif
 
-/* How customers work.
-customers are stored in a struct that contains a pointer to the head of a
-linked list containing all the customers. The struct that stores the linked
-list is directly added to the enterprise struct and stores metadata about the
-list. All customers are assigned a unique ID, no two customers can have the
-same ID, the customer_list structure keeps track of that.
-
-Data structures:
-customer_node: An individual customer.
-customer_list: A structure holding important metadata about the customer
-linked list.
-
-customer list metadata:
-customer_list->id_last_assigned: This is incremented by 1 every time a new
-customer is added in order to ensure no two customers ever have the same ID.
-
-customer_list->id_currently_selected: This is the ID that is selected in the
-customer editor dialogue.
-*/
-
-struct customer_node {
-    char id[ENTERPRISE_STRING_LENGTH];
-    char name[ENTERPRISE_STRING_LENGTH];
-    char email[ENTERPRISE_STRING_LENGTH];
-    char phone[ENTERPRISE_STRING_LENGTH];
-    char address[ENTERPRISE_STRING_LENGTH];
-
-    struct customer_node* prev;
-    struct customer_node* next;
-};
-
-// customer node constructor and initialiser.
+// Customer node constructor and initialiser.
+// The node is added to the end of the passed in record store.
 // Returns customer node on success, or NULL on failure.
-struct customer_node *customer_node_new() {
-    struct customer_node* customer = malloc(sizeof(struct customer_node));
+struct customer_node *customer_node_new(struct record_store* store) {
+    struct customer_node* customer = record_store_append(store);
     if (customer == NULL) return NULL;
-    strcpy(customer->id, "");
-    strcpy(customer->name, "");
-    strcpy(customer->email, "");
-    strcpy(customer->phone, "");
-    strcpy(customer->address, "");
-
-    customer->prev = NULL;
-    customer->next = NULL;
+    customer->id = ENTERPRISE_ID_NONE;
+    customer->name = "";
+    customer->email = "";
+    customer->phone = "";
+    customer->address = "";
 
     return customer;
 }
 
-// customer list metadata structure.
-struct customer_list {
-    struct customer_node *head;
-    char id_last_assigned[ENTERPRISE_STRING_LENGTH];
-    char id_currently_selected[ENTERPRISE_STRING_LENGTH];
-    bool deletion_requested;
-};
+// Free everything associated with a customer and remove it from its store.
+void customer_node_free(struct string_pool* string_pool,\
+struct record_store* store, struct customer_node* customer) {
+    if (customer == NULL) return;
+    string_pool_release(string_pool, customer->name);
+    string_pool_release(string_pool, customer->email);
+    string_pool_release(string_pool, customer->phone);
+    string_pool_release(string_pool, customer->address);
+    record_store_remove(store, customer);
+}
+
+// Returns the sort key of a customer's ID.
+uint64_t customer_key_id(const void* customer) {
+    return sort_index_integer_key(((const struct customer_node*)customer)->id);
+}
+
+// Returns the sort key of a customer's name.
+uint64_t customer_key_name(const void* customer) {
+    return sort_index_text_key(((const struct customer_node*)customer)->name);
+}
 
-// customer list constructor.
+// Returns the sort key of a customer's email.
+uint64_t customer_key_email(const void* customer) {
+    return sort_index_text_key(((const struct customer_node*)customer)->email);
+}
+
+// Returns the sort key of a customer's phone number.
+uint64_t customer_key_phone(const void* customer) {
+    return sort_index_text_key(((const struct customer_node*)customer)->phone);
+}
+
+// Returns the sort key of a customer's address.
+uint64_t customer_key_address(const void* customer) {
+    return sort_index_text_key\
+    (((const struct customer_node*)customer)->address);
+}
+
+// Compare two customers by ID for sorting.
+int customer_compare_id(const void* a, const void* b) {
+    enterprise_id id_a = ((const struct customer_node*)a)->id;
+    enterprise_id id_b = ((const struct customer_node*)b)->id;
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+// Compare two customers by name for sorting, then by ID.
+int customer_compare_name(const void* a, const void* b) {
+    const struct customer_node* customer_a = a;
+    const struct customer_node* customer_b = b;
+    int order = sort_index_compare_text(customer_a->name, customer_b->name);
+    return order != 0 ? order : customer_compare_id(a, b);
+}
+
+// Compare two customers by email for sorting, then by ID.
+int customer_compare_email(const void* a, const void* b) {
+    const struct customer_node* customer_a = a;
+    const struct customer_node* customer_b = b;
+    int order = sort_index_compare_text(customer_a->email, customer_b->email);
+    return order != 0 ? order : customer_compare_id(a, b);
+}
+
+// Compare two customers by phone number for sorting, then by ID.
+int customer_compare_phone(const void* a, const void* b) {
+    const struct customer_node* customer_a = a;
+    const struct customer_node* customer_b = b;
+    int order = sort_index_compare_text(customer_a->phone, customer_b->phone);
+    return order != 0 ? order : customer_compare_id(a, b);
+}
+
+// Compare two customers by address for sorting, then by ID.
+int customer_compare_address(const void* a, const void* b) {
+    const struct customer_node* customer_a = a;
+    const struct customer_node* customer_b = b;
+    int order = \
+    sort_index_compare_text(customer_a->address, customer_b->address);
+    return order != 0 ? order : customer_compare_id(a, b);
+}
+
+// Customer list constructor.
 // Returns customer list on success, or NULL on failure.
-struct customer_list* customer_list_new() {
+struct customer_list* customer_list_new(struct string_pool* string_pool) {
     struct customer_list* customer_list = malloc(sizeof(struct customer_list));
     if (customer_list == NULL) return NULL;
-    customer_list->head = NULL;
-    strcpy(customer_list->id_last_assigned, "0");
-    strcpy(customer_list->id_currently_selected, "0");
+    record_store_init(&customer_list->store, sizeof(struct customer_node));
+    id_index_init(&customer_list->id_index);
+    customer_list->journal = NULL;
+    customer_list->version = 0;
+    row_labels_init(&customer_list->row_labels);
+    text_search_init(&customer_list->search);
+    text_index_init(&customer_list->text_index);
+    customer_list->sort_column = customer_column_id;
+    customer_list->sort_descending = false;
+    sort_index_init(&customer_list->sort_indexes[customer_column_id], \
+    customer_key_id, customer_compare_id);
+    sort_index_init(&customer_list->sort_indexes[customer_column_name], \
+    customer_key_name, customer_compare_name);
+    sort_index_init(&customer_list->sort_indexes[customer_column_email], \
+    customer_key_email, customer_compare_email);
+    sort_index_init(&customer_list->sort_indexes[customer_column_phone], \
+    customer_key_phone, customer_compare_phone);
+    sort_index_init(&customer_list->sort_indexes[customer_column_address], \
+    customer_key_address, customer_compare_address);
+    customer_list->string_pool = string_pool;
+    customer_list->edit_id = ENTERPRISE_ID_NONE;
+    strcpy(customer_list->edit_name, "");
+    strcpy(customer_list->edit_email, "");
+    strcpy(customer_list->edit_phone, "");
+    strcpy(customer_list->edit_address, "");
+    customer_list->id_last_assigned = ENTERPRISE_ID_NONE;
+    customer_list->id_currently_selected = ENTERPRISE_ID_NONE;
+    customer_list->handle_currently_selected = RECORD_STORE_NONE;
     customer_list->deletion_requested = false;
     return customer_list;
 }
 
-// Free an entire customer linked list
-void customer_node_linked_list_free(struct customer_node* customer) {
-    if (customer == NULL) return;
-    struct customer_node* next = NULL;
-    while (customer != NULL) {
-        next = customer->next;
-        free(customer);
-        customer = next;
-    }
-}
-
 // Free all memory associated with a customer list.
 void customer_list_free(struct customer_list* customer_list) {
     if (customer_list == NULL) return;
 
-    if (customer_list->head != NULL) {
-        customer_node_linked_list_free(customer_list->head);
+    // Free every customer, giving their text back to the string pool. There is
+    // nothing to give back if the pool is being dropped, and the record store
+    // frees every customer at once.
+    if (string_pool_is_dropping(customer_list->string_pool) == false) {
+        struct customer_node* customer = \
+        record_store_first(&customer_list->store);
+        while (customer != NULL) {
+            struct customer_node* next = \
+            record_store_next(&customer_list->store, customer);
+            customer_node_free(customer_list->string_pool, \
+            &customer_list->store, customer);
+            customer = next;
+        }
     }
 
+    row_labels_free(&customer_list->row_labels);
+    text_search_free(&customer_list->search);
+    text_index_free(&customer_list->text_index);
+    for (int column = 0; column < customer_column_count; column++) {
+        sort_index_free(&customer_list->sort_indexes[column]);
+    }
+    id_index_free(&customer_list->id_index);
+    record_store_free(&customer_list->store);
     free(customer_list);
     return;
 }
 
+// Move a customer to its place in every sort index of the list, after it was
+// added or edited.
+void customer_list_sort_node(struct customer_list* customer_list, \
+struct customer_node* customer) {
+    if (customer_list == NULL || customer == NULL) return;
+    for (int column = 0; column < customer_column_count; column++) {
+        sort_index_update(&customer_list->sort_indexes[column], customer);
+    }
+}
+
 // Append a new customer to a customer list.
 void customer_list_append(struct customer_list* customer_list) {
     if (customer_list == NULL) return;
 
     // Increment unique ID by 1.
-    char buffer[ENTERPRISE_STRING_LENGTH];
-    sprintf(buffer, "%lld", atoll(customer_list->id_last_assigned) + 1);
-    strcpy(customer_list->id_last_assigned, buffer);
-
-    // Add new node to start of customer list if customer linked list does
-    // not exist.
-    if (customer_list->head == NULL) {
-        customer_list->head = customer_node_new();
-        strcpy(customer_list->head->id, customer_list->id_last_assigned);
-        strcpy(customer_list->id_currently_selected,
-        customer_list->id_last_assigned);
+    customer_list->id_last_assigned++;
+
+    // Add the new node to the end of the list.
+    struct customer_node* customer = customer_node_new(&customer_list->store);
+    if (customer == NULL) return;
+
+    customer->id = customer_list->id_last_assigned;
+
+    // Index the new node by its ID so it can be found without a search.
+    if (id_index_insert(&customer_list->id_index, customer->id, \
+    record_store_handle(customer)) == false) {
+        record_store_remove(&customer_list->store, customer);
         return;
     }
 
-    // Else add the new node to the end of the list.
-    struct customer_node* customer = customer_list->head;
-    while (customer->next != NULL) {
-        customer = customer->next;
-    }
-    
-    customer->next = customer_node_new();
-    customer->next->prev = customer;
+    customer_list->id_currently_selected = customer_list->id_last_assigned;
 
-    strcpy(customer->next->id, customer_list->id_last_assigned);
-    strcpy(customer_list->id_currently_selected,
-    customer_list->id_last_assigned);
+    customer_list->version++;
+    customer_list_sort_node(customer_list, customer);
+    journal_put(customer_list->journal, journal_list_customers, \
+    ENTERPRISE_ID_NONE, customer->id);
 
     return;
 }
@@ -163,151 +224,321 @@ void customer_list_append(struct customer_list* customer_list) {
 // Get the number of customer nodes in the customer list
 int customer_list_get_num_customer_nodes(struct customer_list* customer_list) {
     if (customer_list == NULL) return 0;
-    if (customer_list->head == NULL) return 0;
+    return (int)customer_list->store.count;
+}
 
-    struct customer_node* customer = customer_list->head;
-    int customer_count = 0;
-    while (customer != NULL) {
-        customer_count++;
-        customer = customer->next;
-    }
-    return customer_count;
+// Make room in a customer list and its ID index for count more customers.
+// Returns true on success, or false on failure.
+bool customer_list_reserve(struct customer_list* customer_list, \
+uint32_t count) {
+    if (customer_list == NULL) return false;
+    return record_store_reserve(&customer_list->store, count) \
+    && id_index_reserve(&customer_list->id_index, count);
 }
 
 // Return a pointer to a customer node according to ID.
 // Returns NULL on failure.
 struct customer_node *customer_list_get_node\
-(struct customer_list *customer_list, char *id) {
-    if (customer_list == NULL || id == NULL) return NULL;
-    if (customer_list->head == NULL) return NULL;
+(struct customer_list *customer_list, enterprise_id id) {
+    if (customer_list == NULL) return NULL;
+    return record_store_get\
+    (&customer_list->store, id_index_find(&customer_list->id_index, id));
+}
 
-    struct customer_node* customer = customer_list->head;
-    while (customer != NULL) {
-        if (strcmp(customer->id, id) == 0) return customer;
-        customer = customer->next;
+// Return a pointer to the currently selected customer node.
+// The selected customer's handle is checked before its ID is looked up, so this
+// only searches the ID index after the selection was changed by ID.
+// Returns NULL if no customer is selected.
+struct customer_node *customer_list_get_selected_node\
+(struct customer_list *customer_list) {
+    if (customer_list == NULL) return NULL;
+
+    struct customer_node* customer = record_store_get\
+    (&customer_list->store, customer_list->handle_currently_selected);
+    if (customer == NULL \
+    || customer->id != customer_list->id_currently_selected) {
+        customer = customer_list_get_node\
+        (customer_list, customer_list->id_currently_selected);
+        customer_list->handle_currently_selected = \
+        record_store_handle(customer);
     }
-    return NULL;
+    return customer;
 }
 
 // Searches for a customer by ID and deletes it
-void customer_list_delete_node(struct customer_list *customer_list, char *id) {
-    if (customer_list == NULL || id == NULL) return;
-    if (customer_list->head == NULL) return;
-
-    // Delete the head if it is the ID that is requested to be deleted.
-    if (strcmp(id, customer_list->head->id) == 0) {
-        if (customer_list->head->next == NULL) {
-            free(customer_list->head);
-            customer_list->head = NULL;
-            return;
-        }
-
-        struct customer_node *next = customer_list->head->next;
-        free(customer_list->head);
-        customer_list->head = next;
-        return;
-    }
+void customer_list_delete_node\
+(struct customer_list *customer_list, enterprise_id id) {
+    if (customer_list == NULL) return;
 
-    // Else search for the customer to delete.
-    struct customer_node* customer = customer_list->head;
-    while (customer != NULL) {
-        if (strcmp(customer->id, id) == 0) break;
-        customer = customer->next;
-    }
+    struct customer_node* customer = customer_list_get_node(customer_list, id);
     if (customer == NULL) return;
 
-    // Fix the pointers of the next and previous nodes to the customer to be
-    // deleted in order to ensure that traversal still works.
-
-    struct customer_node* prev = customer->prev;
-    struct customer_node* next = customer->next;
-
-    if (prev != NULL) {
-        if (next == NULL) {
-            prev->next = NULL;
-            strcpy(customer_list->id_currently_selected, prev->id);
-        }
-        if (next != NULL) {
-            prev->next = next;
-            next->prev = prev;
-            strcpy(customer_list->id_currently_selected, next->id);
-        }
+    // Select the node after the deleted customer, or the node before it if the
+    // deleted customer is the last one.
+    struct customer_node* prev = record_store_prev(&customer_list->store, customer);
+    struct customer_node* next = record_store_next(&customer_list->store, customer);
+    if (next != NULL) {
+        customer_list->id_currently_selected = next->id;
     }
-
-    if (prev == NULL) {
-        if (next != NULL) {
-            next->prev = NULL;
-            strcpy(customer_list->id_currently_selected, next->id);
-        }
+    else if (prev != NULL) {
+        customer_list->id_currently_selected = prev->id;
     }
 
+    customer_list->version++;
+    journal_delete(customer_list->journal, journal_list_customers, \
+    ENTERPRISE_ID_NONE, customer->id);
+
     // Delete the customer
-    free(customer);
+    for (int column = 0; column < customer_column_count; column++) {
+        sort_index_remove(&customer_list->sort_indexes[column], customer);
+    }
+    id_index_remove(&customer_list->id_index, customer->id);
+    customer_node_free(customer_list->string_pool, \
+    &customer_list->store, customer);
     return;
 }
 
-// Select the previous node as the currently selected item.
+// Return the customer after the passed in one in the order the customer table
+// is sorted in, or the one before it if backwards is set, wrapping around at
+// either end.
+// The table's search is ignored, so this steps through every customer.
+static struct customer_node* customer_list_step\
+(struct customer_list* customer_list, struct customer_node* customer, \
+bool backwards) {
+    struct record_store* store = &customer_list->store;
+    struct sort_index* index = \
+    &customer_list->sort_indexes[customer_list->sort_column];
+    if (customer_list->sort_descending) backwards = backwards == false;
+
+    // Sorting by ID lists customers in the order they were added.
+    uint32_t row = customer_list->sort_column == customer_column_id \
+    ? SORT_INDEX_NONE : sort_index_row(index, customer);
+    if (row == SORT_INDEX_NONE) {
+        struct customer_node* step = backwards \
+        ? record_store_prev(store, customer) \
+        : record_store_next(store, customer);
+        if (step != NULL) return step;
+        return backwards ? record_store_last(store) : record_store_first(store);
+    }
+    if (backwards) row = row == 0 ? index->count - 1 : row - 1;
+    else row = row + 1 == index->count ? 0 : row + 1;
+    return (void*)sort_index_record(index, row);
+}
+
+// Select the customer before the selected one in the customer table.
 void customer_list_select_previous_node(struct customer_list *customer_list) {
     if (customer_list == NULL) return;
-    if (customer_list->head == NULL) return;
 
-    struct customer_node* customer = customer_list->head;
-    while (customer != NULL) {
-        if (strcmp(customer->id, customer_list->id_currently_selected) == 0) {
-            if (customer->prev != NULL) {
-                strcpy(customer_list->id_currently_selected, customer->prev->id);
-                return;
-            }
-            if (customer->prev == NULL) {
-                struct customer_node* temp = customer;
-                while (temp->next != NULL) {
-                    temp = temp->next;
-                }
-                strcpy(customer_list->id_currently_selected, temp->id);
-                return;
-            }
-        }
-        customer = customer->next;
-    }
+    struct customer_node* customer = \
+    customer_list_get_selected_node(customer_list);
+    if (customer == NULL) return;
+
+    struct customer_node* prev = \
+    customer_list_step(customer_list, customer, true);
+    customer_list->id_currently_selected = prev->id;
+    customer_list->handle_currently_selected = record_store_handle(prev);
 }
 
-// Select the next node as the currently selected item.
+// Select the customer after the selected one in the customer table.
 void customer_list_select_next_node(struct customer_list *customer_list) {
     if (customer_list == NULL) return;
-    if (customer_list->head == NULL) return;
 
-    struct customer_node* customer = customer_list->head;
-    while (customer != NULL) {
-        if (strcmp(customer->id, customer_list->id_currently_selected) == 0) {
-            if (customer->next != NULL) {
-                strcpy(customer_list->id_currently_selected, customer->next->id);
-                return;
-            }
-            if (customer->next == NULL) {
-                strcpy(customer_list->id_currently_selected,\
-                customer_list->head->id);
-                return;
-            }
-        }
-        customer = customer->next;
-    }
+    struct customer_node* customer = \
+    customer_list_get_selected_node(customer_list);
+    if (customer == NULL) return;
+
+    struct customer_node* next = \
+    customer_list_step(customer_list, customer, false);
+    customer_list->id_currently_selected = next->id;
+    customer_list->handle_currently_selected = record_store_handle(next);
 }
 
 // Change the currently selected ID to the passed in ID in the customer list.
 void customer_list_set_selected_id\
-(struct customer_list *customer_list, char* id) {
-    if (customer_list == NULL || id == NULL) return;
-    if (customer_list->head == NULL) return;
+(struct customer_list *customer_list, enterprise_id id) {
+    if (customer_list == NULL) return;
 
-    struct customer_node* customer = customer_list->head;
-    while (customer != NULL) {
-        if (strcmp(customer->id, id) == 0) {
-            strcpy(customer_list->id_currently_selected, id);
+    if (customer_list_get_node(customer_list, id) != NULL) {
+        customer_list->id_currently_selected = id;
+    }
+}
+
+// Add the text of a customer to the list's search index, after it was added
+// or edited. Does nothing until the list is first searched.
+void customer_list_index_node(struct customer_list* customer_list, \
+struct customer_node* customer) {
+    if (customer_list == NULL || customer == NULL) return;
+    struct text_index* index = &customer_list->text_index;
+    if (index->built == false) return;
+
+    uint32_t handle = record_store_handle(customer);
+    if (text_index_add(index, handle, customer->name) == false || \
+    text_index_add(index, handle, customer->email) == false || \
+    text_index_add(index, handle, customer->phone) == false || \
+    text_index_add(index, handle, customer->address) == false) {
+        // Build the index again on the next search rather than miss matches.
+        index->built = false;
+    }
+}
+
+// Put the matches of the list's search in the order of the column the table is
+// sorted by.
+// Returns true on success, or false on failure.
+bool customer_list_sort_matches(struct customer_list* customer_list) {
+    if (customer_list == NULL) return false;
+    struct text_search* search = &customer_list->search;
+    if (customer_list->sort_column == customer_column_id) {
+        text_search_finish(search);
+        return true;
+    }
+
+    struct sort_index* index = \
+    &customer_list->sort_indexes[customer_list->sort_column];
+    struct sort_index_entry* matches = \
+    malloc(sizeof(struct sort_index_entry) * (search->count + 1));
+    if (matches == NULL) return false;
+    for (uint32_t match = 0; match < search->count; match++) {
+        matches[match].record = \
+        customer_list_get_node(customer_list, search->ids[match]);
+        matches[match].key = index->key(matches[match].record);
+    }
+    bool sorted = sort_index_sort(index, matches, search->count);
+    if (sorted) {
+        for (uint32_t match = 0; match < search->count; match++) {
+            search->ids[match] = \
+            ((const struct customer_node*)matches[match].record)->id;
         }
-        customer = customer->next;
+    }
+    free(matches);
+    return sorted;
+}
+
+// Returns true if a customer's name, email, phone or address contain query,
+// ignoring case.
+bool customer_node_matches(struct customer_node* customer, const char* query) {
+    return text_index_contains(customer->name, query) || \
+    text_index_contains(customer->email, query) || \
+    text_index_contains(customer->phone, query) || \
+    text_index_contains(customer->address, query);
+}
+
+// Search the customers for the text in the list's search box, and keep the IDs
+// of the customers whose name, email, phone or address contain it.
+// Returns true on success, or false on failure.
+bool customer_list_search(struct customer_list* customer_list) {
+    if (customer_list == NULL) return false;
+    struct text_search* search = &customer_list->search;
+    text_search_begin(search, customer_list->version);
+    row_labels_invalidate(&customer_list->row_labels);
+    if (search->active == false) return true;
+
+    // Build the index from every customer the first time the list is searched.
+    struct text_index* index = &customer_list->text_index;
+    if (text_index_due(index)) {
+        text_index_clear(index);
+        index->built = true;
+        struct customer_node* customer = \
+        record_store_first(&customer_list->store);
+        while (customer != NULL && index->built) {
+            customer_list_index_node(customer_list, customer);
+            customer = record_store_next(&customer_list->store, customer);
+        }
+        if (index->built) text_index_finish(index);
+    }
+
+    // Only check the customers that hold the rarest trigram of the search.
+    const uint32_t* candidates = NULL;
+    uint32_t candidate_count = 0;
+    if (index->built && text_index_candidates(index, search->query, \
+    &candidates, &candidate_count)) {
+        for (uint32_t candidate = 0; candidate < candidate_count; \
+        candidate++) {
+            struct customer_node* customer = \
+            record_store_get(&customer_list->store, candidates[candidate]);
+            if (customer == NULL || \
+            customer_node_matches(customer, search->query) == false) continue;
+            if (text_search_add(search, customer->id) == false) return false;
+        }
+        text_search_finish(search);
+        return customer_list_sort_matches(customer_list);
+    }
+
+    // Short searches, or searches without an index, check every customer.
+    struct customer_node* customer = record_store_first(&customer_list->store);
+    while (customer != NULL) {
+        if (customer_node_matches(customer, search->query) && \
+        text_search_add(search, customer->id) == false) return false;
+        customer = record_store_next(&customer_list->store, customer);
+    }
+    return customer_list_sort_matches(customer_list);
+}
+
+// Sort the customer table by a column, in descending order if descending is
+// true. The column's sort index is built the first time it is sorted by.
+// Returns true on success, or false on failure, in which case the table is
+// left in the order it was.
+bool customer_list_sort(struct customer_list* customer_list, \
+enum customer_column column, bool descending) {
+    if (customer_list == NULL || column >= customer_column_count) return false;
+    struct sort_index* index = &customer_list->sort_indexes[column];
+    if (column != customer_column_id && index->built == false && \
+    sort_index_build(index, &customer_list->store) == false) return false;
+
+    customer_list->sort_column = column;
+    customer_list->sort_descending = descending;
+    row_labels_invalidate(&customer_list->row_labels);
+    if (customer_list->search.active) {
+        return customer_list_sort_matches(customer_list);
+    }
+    return true;
+}
+
+// Return the customer shown at a row of the customer table, which depends on
+// the search and the column the table is sorted by.
+// Returns NULL if there is no such row.
+struct customer_node* customer_list_get_row_node\
+(struct customer_list* customer_list, uint32_t row) {
+    if (customer_list == NULL) return NULL;
+    struct text_search* search = &customer_list->search;
+    uint32_t rows = search->active ? search->count : customer_list->store.count;
+    if (row >= rows) return NULL;
+    if (customer_list->sort_descending) row = rows - 1 - row;
+
+    // While searching, the rows are the matches of the search.
+    if (search->active) {
+        return customer_list_get_node\
+        (customer_list, text_search_id(search, row));
+    }
+    if (customer_list->sort_column == customer_column_id) {
+        return record_store_seek(&customer_list->store, row);
+    }
+    return (void*)sort_index_record\
+    (&customer_list->sort_indexes[customer_list->sort_column], row);
+}
+
+// Make the labels of row_count rows of the customer table, starting at
+// first_row, unless they are cached already.
+void customer_list_label_rows(struct customer_list* customer_list, \
+uint32_t first_row, uint32_t row_count) {
+    if (customer_list == NULL) return;
+    struct row_labels* labels = &customer_list->row_labels;
+    if (row_labels_current(labels, customer_list->version, first_row, \
+    row_count)) return;
+
+    row_labels_begin(labels, customer_list->version, first_row, row_count);
+    for (uint32_t row = 0; row < row_count; row++) {
+        struct customer_node* customer = \
+        customer_list_get_row_node(customer_list, first_row + row);
+        if (customer == NULL || row_labels_add(labels, customer->id, \
+        "ID: %lld Name: %s Email: %s Phone: %s Address: %s",\
+        customer->id, customer->name, customer->email, \
+        customer->phone, customer->address) == false) break;
     }
 }
 
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+
 // Render the customer table GUI.
 // This function displays a list of customers as a table that can be selected.
 // It is an overview.
@@ -330,31 +561,69 @@ struct customer_list* customer_list) {
     }
 
     // If there are no customers, warn the user.
-    if (customer_list->head == NULL) {
+    if (record_store_first(&customer_list->store) == NULL) {
         nk_label(ctx, "No customers found.", NK_TEXT_CENTERED);
         return program_status_customer_table;
     }
 
-    /* If there are customers, go through the linked list of customers.
-    Copy the data from each customer and make it a button label.
-    When the button is pressed, set the currently selected customer to that
-    customer and switch to customer editor.*/
-    struct customer_node* customer = customer_list->head;
-    char* print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-    while (customer != NULL) {
-        sprintf(print_buffer, \
-        "ID: %s Name: %s Email: %s Phone: %s Address: %s",customer->id,\
-        customer->name, customer->email, customer->phone, customer->address);
+    // Search box. While it holds text, only the matching customers are listed.
+    nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
+    customer_list->search.query, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    if (text_search_due(&customer_list->search, customer_list->version)) {
+        customer_list_search(customer_list);
+    }
 
-        if (nk_button_label(ctx, print_buffer)) {
-            strcpy(customer_list->id_currently_selected, customer->id);
-            free(print_buffer);
-            return program_status_customer_editor;
+    // Sort controls, picking the column to sort by and the direction.
+    const char* columns[] = {"Sort by ID", "Sort by Name", "Sort by Email", \
+    "Sort by Phone", "Sort by Address"};
+    nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 2);
+    int column = nk_combo(ctx, columns, NK_LEN(columns), \
+    (int)customer_list->sort_column, ENTERPRISE_WIDGET_HEIGHT, \
+    nk_vec2(WINDOW_WIDTH / 2, 200));
+    bool descending = customer_list->sort_descending;
+    if (nk_button_label(ctx, descending ? "Descending" : "Ascending")) {
+        descending = !descending;
+    }
+    if (column != (int)customer_list->sort_column || \
+    descending != customer_list->sort_descending) {
+        customer_list_sort(customer_list, (enum customer_column)column, \
+        descending);
+    }
+    nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+    if (customer_list->search.active && customer_list->search.count == 0) {
+        nk_label(ctx, "No customers match the search.", NK_TEXT_CENTERED);
+        return program_status_customer_table;
+    }
+
+    /* If there are customers, make a button for each customer in view.
+    Only the rows scrolled into view are drawn, and their labels are only
+    formatted again when different rows come into view or the list changes.
+    When a button is pressed, set the currently selected customer to that
+    customer and switch to customer editor.*/
+    enum program_status status = program_status_customer_table;
+    struct nk_list_view view;
+    uint32_t row_total = customer_list->search.active \
+    ? customer_list->search.count : customer_list->store.count;
+    int rows = row_total > INT_MAX ? INT_MAX : (int)row_total;
+    nk_layout_row_dynamic(ctx, \
+    ENTERPRISE_TABLE_HEIGHT - 2 * ENTERPRISE_WIDGET_HEIGHT, 1);
+    if (nk_list_view_begin(ctx, &view, "customer_table", \
+    NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+        nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+        struct row_labels* labels = &customer_list->row_labels;
+        customer_list_label_rows(customer_list, \
+        (uint32_t)view.begin, (uint32_t)view.count);
+
+        for (uint32_t row = 0; row < labels->count; row++) {
+            if (nk_button_label(ctx, row_labels_text(labels, row))) {
+                customer_list_set_selected_id\
+                (customer_list, row_labels_id(labels, row));
+                status = program_status_customer_editor;
+            }
         }
-        customer = customer->next;
+        nk_list_view_end(&view);
     }
-    free(print_buffer);
-    return program_status_customer_table;
+    return status;
 }
 
 // Render the customer editor GUI.
@@ -372,14 +641,15 @@ struct customer_list* customer_list) {
     nk_label(ctx, "Customer Editor", NK_TEXT_CENTERED);
     
     // Select currently selected customer.
-    struct customer_node* customer = customer_list_get_node\
-    (customer_list, customer_list->id_currently_selected);
+    struct customer_node* customer = \
+    customer_list_get_selected_node(customer_list);
 
     // If the currently selected customer does not exist:
     if (customer == NULL) {
         // Select the first customer instead.
-        if (customer_list->head != NULL) {
-            strcpy(customer_list->id_currently_selected, customer_list->head->id);
+        customer = record_store_first(&customer_list->store);
+        if (customer != NULL) {
+            customer_list->id_currently_selected = customer->id;
             return program_status_customer_editor;
         }
 
@@ -394,31 +664,60 @@ struct customer_list* customer_list) {
         }
     }
 
+    // Copy the selected customer's text into the edit buffers whenever a
+    // different customer is selected.
+    if (customer_list->edit_id != customer->id) {
+        customer_list->edit_id = customer->id;
+        strcpy(customer_list->edit_name, customer->name);
+        strcpy(customer_list->edit_email, customer->email);
+        strcpy(customer_list->edit_phone, customer->phone);
+        strcpy(customer_list->edit_address, customer->address);
+    }
+
     // Display edit fields to edit customer entries.
     nk_layout_row_template_begin(ctx, ENTERPRISE_WIDGET_HEIGHT);
     nk_layout_row_template_push_static(ctx, 150);
     nk_layout_row_template_push_dynamic(ctx);
     nk_layout_row_template_end(ctx);
 
+    char id_text[ENTERPRISE_ID_TEXT_LENGTH];
+    enterprise_id_format(customer->id, id_text);
     nk_label(ctx, "ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_READ_ONLY, \
-    customer->id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Name: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    customer->name, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    customer_list->edit_name, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Phone: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    customer->phone, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    customer_list->edit_phone, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Email: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    customer->email, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    customer_list->edit_email, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Address: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    customer->address, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    customer_list->edit_address, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+
+    // Store any edits back into the customer, and note them in the journal.
+    bool edited = string_pool_assign(customer_list->string_pool, \
+    &customer->name, customer_list->edit_name);
+    edited |= string_pool_assign(customer_list->string_pool, \
+    &customer->email, customer_list->edit_email);
+    edited |= string_pool_assign(customer_list->string_pool, \
+    &customer->phone, customer_list->edit_phone);
+    edited |= string_pool_assign(customer_list->string_pool, \
+    &customer->address, customer_list->edit_address);
+    if (edited) {
+        customer_list->version++;
+        customer_list_index_node(customer_list, customer);
+        customer_list_sort_node(customer_list, customer);
+        journal_put(customer_list->journal, journal_list_customers, \
+        ENTERPRISE_ID_NONE, customer->id);
+    }
 
     // Move between next and previous customers.
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 2);
@@ -458,4 +757,6 @@ struct customer_list* customer_list) {
     }
     
     return program_status_customer_editor;
-}
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_STRING_POOL
+#define ENTERPRISE_STRING_POOL
+#include "string_pool.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+#ifndef ENTERPRISE_JOURNAL
+#define ENTERPRISE_JOURNAL
+#include "journal.h"
+#endif
+
+#ifndef ENTERPRISE_ROW_LABELS
+#define ENTERPRISE_ROW_LABELS
+#include "row_labels.h"
+#endif
+
+#ifndef ENTERPRISE_TEXT_INDEX
+#define ENTERPRISE_TEXT_INDEX
+#include "text_index.h"
+#endif
+
+#ifndef ENTERPRISE_SORT_INDEX
+#define ENTERPRISE_SORT_INDEX
+#include "sort_index.h"
+#endif
+
+#ifndef PROGRAM_STATES
+#define PROGRAM_STATES
+#include "program_states.h"
+#endif
+
+// Nuklear's context, taken by the GUI functions. Only the sources of
+// those functions import Nuklear itself.
+struct nk_context;
+
+/* How customers work.
+A customer has a name and contact details, and orders can be sent to them. The
+customer list is laid out like every other list of the enterprise (see
+record_store.c). Its table can be sorted by any of its columns, and searched
+by name, email, phone and address through a trigram index (see text_index.c).
+
+Data structures:
+customer_node: A customer.
+customer_list: The customers of the enterprise.
+*/
+
+struct customer_node {
+    enterprise_id id;
+    const char* name;
+    const char* email;
+    const char* phone;
+    const char* address;
+};
+
+// The columns of the customer table.
+enum customer_column {customer_column_id, customer_column_name, \
+customer_column_email, customer_column_phone, customer_column_address, \
+customer_column_count};
+
+// Customer list metadata structure.
+struct customer_list {
+    struct record_store store;
+    struct id_index id_index;
+    struct string_pool* string_pool;
+
+    // Where changes to the list are recorded, or NULL if they are not.
+    struct journal* journal;
+
+    // Bumped whenever a node is appended, edited or deleted, so that the
+    // labels cached for the list's table know when they are stale.
+    uint64_t version;
+    struct row_labels row_labels;
+
+    // The search box of the list's table, and the index used to search it.
+    struct text_search search;
+    struct text_index text_index;
+
+    // The column the list's table is sorted by, and an index of the list
+    // sorted by each column. Indexes are built when first sorted by.
+    enum customer_column sort_column;
+    bool sort_descending;
+    struct sort_index sort_indexes[customer_column_count];
+
+    // Editable copies of the text of the node open in the editor.
+    enterprise_id edit_id;
+    char edit_name[ENTERPRISE_STRING_LENGTH];
+    char edit_email[ENTERPRISE_STRING_LENGTH];
+    char edit_phone[ENTERPRISE_STRING_LENGTH];
+    char edit_address[ENTERPRISE_STRING_LENGTH];
+
+    enterprise_id id_last_assigned;
+    enterprise_id id_currently_selected;
+    uint32_t handle_currently_selected;
+    bool deletion_requested;
+};
+
+struct customer_node *customer_node_new(struct record_store* store);
+void customer_node_free(struct string_pool* string_pool,\
+struct record_store* store, struct customer_node* customer);
+uint64_t customer_key_id(const void* customer);
+uint64_t customer_key_name(const void* customer);
+uint64_t customer_key_email(const void* customer);
+uint64_t customer_key_phone(const void* customer);
+uint64_t customer_key_address(const void* customer);
+int customer_compare_id(const void* a, const void* b);
+int customer_compare_name(const void* a, const void* b);
+int customer_compare_email(const void* a, const void* b);
+int customer_compare_phone(const void* a, const void* b);
+int customer_compare_address(const void* a, const void* b);
+struct customer_list* customer_list_new(struct string_pool* string_pool);
+void customer_list_free(struct customer_list* customer_list);
+void customer_list_sort_node(struct customer_list* customer_list, \
+struct customer_node* customer);
+void customer_list_append(struct customer_list* customer_list);
+int customer_list_get_num_customer_nodes(struct customer_list* customer_list);
+bool customer_list_reserve(struct customer_list* customer_list, \
+uint32_t count);
+struct customer_node *customer_list_get_node\
+(struct customer_list *customer_list, enterprise_id id);
+struct customer_node *customer_list_get_selected_node\
+(struct customer_list *customer_list);
+void customer_list_delete_node\
+(struct customer_list *customer_list, enterprise_id id);
+void customer_list_select_previous_node(struct customer_list *customer_list);
+void customer_list_select_next_node(struct customer_list *customer_list);
+void customer_list_set_selected_id\
+(struct customer_list *customer_list, enterprise_id id);
+void customer_list_index_node(struct customer_list* customer_list, \
+struct customer_node* customer);
+bool customer_list_sort_matches(struct customer_list* customer_list);
+bool customer_node_matches(struct customer_node* customer, const char* query);
+bool customer_list_search(struct customer_list* customer_list);
+bool customer_list_sort(struct customer_list* customer_list, \
+enum customer_column column, bool descending);
+struct customer_node* customer_list_get_row_node\
+(struct customer_list* customer_list, uint32_t row);
+void customer_list_label_rows(struct customer_list* customer_list, \
+uint32_t first_row, uint32_t row_count);
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+enum program_status customer_table(struct nk_context* ctx,\
+struct customer_list* customer_list);
+enum program_status customer_editor(struct nk_context* ctx,\
+struct customer_list* customer_list);
+#endif
@@ -9,328 +9,253 @@
 #include <limits.h>
 #include <time.h>
 
-#include "constants.c"
-
-#ifndef PROGRAM_STATES
-#define PROGRAM_STATES
-#include "program_states.c"
-#endif
-
-
-// Import Nuklear.
-#ifndef ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
+// Import Nuklear, unless building without the GUI.
+#if !defined(ENTERPRISE_NUKLEAR_LIBRARY_IMPORT) \
+&& !defined(ENTERPRISE_HEADLESS)
 #define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-    #define NK_INCLUDE_FIXED_TYPES
-    #define NK_INCLUDE_STANDARD_IO
-    #define NK_INCLUDE_STANDARD_VARARGS
-    #define NK_INCLUDE_DEFAULT_ALLOCATOR
-    #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    #define NK_INCLUDE_FONT_BAKING
-    #define NK_INCLUDE_DEFAULT_FONT
-    #define NK_IMPLEMENTATION
-    #define NK_SDL_GLES2_IMPLEMENTATION
-    #include "../third_party/Nuklear/nuklear.h"
-    #include "../third_party/Nuklear/demo/sdl_opengles2/nuklear_sdl_gles2.h"
-    #include "../third_party/Nuklear/demo/common/style.c"
+#include "nuklear_import.h"
 #endif
 
-#ifndef ENTERPRISE_LIBRARIES
-#define ENTERPRISE_LIBRARIES
-#include "constants.c"
-#include "facilities.c"
-#include "employees.c"
-#include "inventory.c"
-#include "customers.c"
-#include "suppliers.c"
-#include "expenses.c"
-#include "orders.c"
+#ifndef ENTERPRISE_EMPLOYEE_FACILITIES
+#define ENTERPRISE_EMPLOYEE_FACILITIES
+#include "employee_facilities.h"
 #endif
 
-/* How employee_facilitys work.
-employee_facilitys are stored in a struct that contains a pointer to the head of a
-linked list containing all the employee_facilitys. The struct that stores the linked
-list is directly added to the enterprise struct and stores metadata about the
-list. All employee_facilitys are assigned a unique ID, no two employee_facilitys can have the
-same ID, the employee_facility_list structure keeps track of that.
-
-Data structures:
-employee_facility_node: An individual employee_facility.
-employee_facility_list: A structure holding important metadata about the employee_facility
-linked list.
-
-employee_facility list metadata:
-employee_facility_list->id_last_assigned: This is incremented by 1 every time a new
-employee_facility is added in order to ensure no two employee_facilitys ever have the same ID.
-
-employee_facility_list->id_currently_selected: This is the ID that is selected in the
-employee_facility editor dialogue.
-*/
-
-struct employee_facility_node {
-    char id[ENTERPRISE_STRING_LENGTH];
-    char facility_id[ENTERPRISE_STRING_LENGTH];
-
-    struct employee_facility_node* prev;
-    struct employee_facility_node* next;
-};
-
-// employee_facility node constructor and initialiser.
-// Returns employee_facility node on success, or NULL on failure.
-struct employee_facility_node *employee_facility_node_new() {
-    struct employee_facility_node* employee_facility = malloc(sizeof(struct employee_facility_node));
+// Employee facility node constructor and initialiser.
+// The node is added to the end of the passed in record store.
+// Returns employee facility node on success, or NULL on failure.
+struct employee_facility_node *employee_facility_node_new(struct record_store* store) {
+    struct employee_facility_node* employee_facility = record_store_append(store);
     if (employee_facility == NULL) return NULL;
-    strcpy(employee_facility->id, "");
-    strcpy(employee_facility->facility_id, "");
-
-    employee_facility->prev = NULL;
-    employee_facility->next = NULL;
+    employee_facility->id = ENTERPRISE_ID_NONE;
+    employee_facility->facility_id = ENTERPRISE_ID_NONE;
 
     return employee_facility;
 }
 
-// employee_facility list metadata structure.
-struct employee_facility_list {
-    struct employee_facility_node *head;
-    char id_last_assigned[ENTERPRISE_STRING_LENGTH];
-    char id_currently_selected[ENTERPRISE_STRING_LENGTH];
-    bool deletion_requested;
-    bool addition_requested;
-};
-
-// employee_facility list constructor.
-// Returns employee_facility list on success, or NULL on failure.
-struct employee_facility_list* employee_facility_list_new() {
+// Employee facility list constructor. Changes to the list are recorded in
+// journal as changes to the facilities of the employee with ID owner_id, and
+// the facilities it works at are counted in references.
+// Returns employee facility list on success, or NULL on failure.
+struct employee_facility_list* employee_facility_list_new\
+(struct journal* journal, struct facility_references* references, \
+enterprise_id owner_id) {
     struct employee_facility_list* employee_facility_list = malloc(sizeof(struct employee_facility_list));
     if (employee_facility_list == NULL) return NULL;
-    employee_facility_list->head = NULL;
-    strcpy(employee_facility_list->id_last_assigned, "0");
-    strcpy(employee_facility_list->id_currently_selected, "0");
+    record_store_init(&employee_facility_list->store, sizeof(struct employee_facility_node));
+    id_index_init(&employee_facility_list->id_index);
+    employee_facility_list->journal = journal;
+    employee_facility_list->owner_id = owner_id;
+    employee_facility_list->references = references;
+    employee_facility_list->version = 0;
+    row_labels_init(&employee_facility_list->row_labels);
+    row_labels_init(&employee_facility_list->addition_labels);
+    employee_facility_list->id_last_assigned = ENTERPRISE_ID_NONE;
+    employee_facility_list->id_currently_selected = ENTERPRISE_ID_NONE;
+    employee_facility_list->handle_currently_selected = RECORD_STORE_NONE;
     employee_facility_list->deletion_requested = false;
     employee_facility_list->addition_requested = false;
     return employee_facility_list;
 }
 
-// Free an entire employee_facility linked list
-void employee_facility_node_linked_list_free(struct employee_facility_node* employee_facility) {
-    if (employee_facility == NULL) return;
-    struct employee_facility_node* next = NULL;
-    while (employee_facility != NULL) {
-        next = employee_facility->next;
-        free(employee_facility);
-        employee_facility = next;
-    }
-}
-
-// Free all memory associated with a employee_facility list.
+// Free all memory associated with an employee facility list.
 void employee_facility_list_free(struct employee_facility_list* employee_facility_list) {
     if (employee_facility_list == NULL) return;
-
-    if (employee_facility_list->head != NULL) {
-        employee_facility_node_linked_list_free(employee_facility_list->head);
-    }
-
+    row_labels_free(&employee_facility_list->row_labels);
+    row_labels_free(&employee_facility_list->addition_labels);
+    id_index_free(&employee_facility_list->id_index);
+    record_store_free(&employee_facility_list->store);
     free(employee_facility_list);
     return;
 }
 
-// Append a new employee_facility to a employee_facility list.
+// Append a new employee facility to an employee facility list.
 void employee_facility_list_append(struct employee_facility_list* employee_facility_list) {
     if (employee_facility_list == NULL) return;
 
     // Increment unique ID by 1.
-    char buffer[ENTERPRISE_STRING_LENGTH];
-    sprintf(buffer, "%lld", atoll(employee_facility_list->id_last_assigned) + 1);
-    strcpy(employee_facility_list->id_last_assigned, buffer);
-
-    // Add new node to start of employee_facility list if employee_facility linked list does
-    // not exist.
-    if (employee_facility_list->head == NULL) {
-        employee_facility_list->head = employee_facility_node_new();
-        strcpy(employee_facility_list->head->id, employee_facility_list->id_last_assigned);
-        strcpy(employee_facility_list->id_currently_selected,
-        employee_facility_list->id_last_assigned);
+    employee_facility_list->id_last_assigned++;
+
+    // Add the new node to the end of the list.
+    struct employee_facility_node* employee_facility = employee_facility_node_new(&employee_facility_list->store);
+    if (employee_facility == NULL) return;
+
+    employee_facility->id = employee_facility_list->id_last_assigned;
+
+    // Index the new node by its ID so it can be found without a search.
+    if (id_index_insert(&employee_facility_list->id_index, employee_facility->id, \
+    record_store_handle(employee_facility)) == false) {
+        record_store_remove(&employee_facility_list->store, employee_facility);
         return;
     }
 
-    // Else add the new node to the end of the list.
-    struct employee_facility_node* employee_facility = employee_facility_list->head;
-    while (employee_facility->next != NULL) {
-        employee_facility = employee_facility->next;
-    }
-    
-    employee_facility->next = employee_facility_node_new();
-    employee_facility->next->prev = employee_facility;
+    employee_facility_list->id_currently_selected = \
+    employee_facility_list->id_last_assigned;
 
-    strcpy(employee_facility->next->id, employee_facility_list->id_last_assigned);
-    strcpy(employee_facility_list->id_currently_selected,
-    employee_facility_list->id_last_assigned);
+    employee_facility_list->version++;
+    journal_put(employee_facility_list->journal, \
+    journal_list_employee_facilities, employee_facility_list->owner_id, \
+    employee_facility->id);
 
     return;
 }
 
-// Get the number of employee_facility nodes in the employee_facility list
+// Get the number of employee facility nodes in the employee facility list
 int employee_facility_list_get_num_employee_facility_nodes(struct employee_facility_list* employee_facility_list) {
     if (employee_facility_list == NULL) return 0;
-    if (employee_facility_list->head == NULL) return 0;
-
-    struct employee_facility_node* employee_facility = employee_facility_list->head;
-    int employee_facility_count = 0;
-    while (employee_facility != NULL) {
-        employee_facility_count++;
-        employee_facility = employee_facility->next;
-    }
-    return employee_facility_count;
+    return (int)employee_facility_list->store.count;
 }
 
-// Return a pointer to a employee_facility node according to ID.
+// Return a pointer to an employee facility node according to ID.
 // Returns NULL on failure.
 struct employee_facility_node *employee_facility_list_get_node\
-(struct employee_facility_list *employee_facility_list, char *id) {
-    if (employee_facility_list == NULL || id == NULL) return NULL;
-    if (employee_facility_list->head == NULL) return NULL;
+(struct employee_facility_list *employee_facility_list, enterprise_id id) {
+    if (employee_facility_list == NULL) return NULL;
+    return record_store_get(&employee_facility_list->store,\
+    id_index_find(&employee_facility_list->id_index, id));
+}
 
-    struct employee_facility_node* employee_facility = employee_facility_list->head;
-    while (employee_facility != NULL) {
-        if (strcmp(employee_facility->id, id) == 0) return employee_facility;
-        employee_facility = employee_facility->next;
+// Return a pointer to the currently selected employee facility node.
+// The selected employee facility's handle is checked before its ID is looked
+// up, so this only searches the ID index after the selection was changed by ID.
+// Returns NULL if no employee facility is selected.
+struct employee_facility_node *employee_facility_list_get_selected_node\
+(struct employee_facility_list *employee_facility_list) {
+    if (employee_facility_list == NULL) return NULL;
+
+    struct employee_facility_node* employee_facility = record_store_get\
+    (&employee_facility_list->store, employee_facility_list->handle_currently_selected);
+    if (employee_facility == NULL || employee_facility->id != employee_facility_list->id_currently_selected) {
+        employee_facility = employee_facility_list_get_node(employee_facility_list, employee_facility_list->id_currently_selected);
+        employee_facility_list->handle_currently_selected = record_store_handle(employee_facility);
     }
-    return NULL;
+    return employee_facility;
 }
 
-// Return a pointer to a employee_facility node according to facility ID.
+// Return a pointer to an employee facility node according to facility ID.
 // Returns NULL on failure.
 struct employee_facility_node *employee_facility_list_get_node_by_facility_id\
-(struct employee_facility_list *employee_facility_list, char *id) {
-    if (employee_facility_list == NULL || id == NULL) return NULL;
-    if (employee_facility_list->head == NULL) return NULL;
+(struct employee_facility_list *employee_facility_list, enterprise_id id) {
+    if (employee_facility_list == NULL) return NULL;
 
-    struct employee_facility_node* employee_facility = employee_facility_list->head;
+    struct employee_facility_node* employee_facility = record_store_first(&employee_facility_list->store);
     while (employee_facility != NULL) {
-        if (strcmp(employee_facility->facility_id, id) == 0) return employee_facility;
-        employee_facility = employee_facility->next;
+        if (employee_facility->facility_id == id) return employee_facility;
+        employee_facility = record_store_next(&employee_facility_list->store, employee_facility);
     }
     return NULL;
 }
 
-// Searches for a employee_facility by ID and deletes it
-void employee_facility_list_delete_node(struct employee_facility_list *employee_facility_list, char *id) {
-    if (employee_facility_list == NULL || id == NULL) return;
-    if (employee_facility_list->head == NULL) return;
-
-    // Delete the head if it is the ID that is requested to be deleted.
-    if (strcmp(id, employee_facility_list->head->id) == 0) {
-        if (employee_facility_list->head->next == NULL) {
-            free(employee_facility_list->head);
-            employee_facility_list->head = NULL;
-            return;
-        }
-
-        struct employee_facility_node *next = employee_facility_list->head->next;
-        free(employee_facility_list->head);
-        employee_facility_list->head = next;
-        return;
-    }
+// Set the facility that an employee facility refers to, counting it in the
+// facility references and noting the change in the journal.
+void employee_facility_list_set_facility\
+(struct employee_facility_list* employee_facility_list, \
+struct employee_facility_node* employee_facility, enterprise_id facility_id) {
+    if (employee_facility_list == NULL || employee_facility == NULL) return;
+    if (employee_facility->facility_id == facility_id) return;
+
+    facility_references_move(employee_facility_list->references, \
+    facility_reference_employee, employee_facility_list->owner_id, \
+    employee_facility->facility_id, facility_id);
+    employee_facility->facility_id = facility_id;
+
+    employee_facility_list->version++;
+    journal_put(employee_facility_list->journal, \
+    journal_list_employee_facilities, employee_facility_list->owner_id, \
+    employee_facility->id);
+}
 
-    // Else search for the employee_facility to delete.
-    struct employee_facility_node* employee_facility = employee_facility_list->head;
+// Remove every facility of a list from the facility references, before the
+// list is freed along with its employee.
+void employee_facility_list_unlink\
+(struct employee_facility_list* employee_facility_list) {
+    if (employee_facility_list == NULL) return;
+    struct employee_facility_node* employee_facility = \
+    record_store_first(&employee_facility_list->store);
     while (employee_facility != NULL) {
-        if (strcmp(employee_facility->id, id) == 0) break;
-        employee_facility = employee_facility->next;
+        facility_references_remove(employee_facility_list->references, \
+        employee_facility->facility_id, facility_reference_employee, \
+        employee_facility_list->owner_id);
+        employee_facility = record_store_next\
+        (&employee_facility_list->store, employee_facility);
     }
-    if (employee_facility == NULL) return;
+}
 
-    // Fix the pointers of the next and previous nodes to the employee_facility to be
-    // deleted in order to ensure that traversal still works.
+// Searches for an employee facility by ID and deletes it
+void employee_facility_list_delete_node\
+(struct employee_facility_list *employee_facility_list, enterprise_id id) {
+    if (employee_facility_list == NULL) return;
 
-    struct employee_facility_node* prev = employee_facility->prev;
-    struct employee_facility_node* next = employee_facility->next;
+    struct employee_facility_node* employee_facility = employee_facility_list_get_node(employee_facility_list, id);
+    if (employee_facility == NULL) return;
 
-    if (prev != NULL) {
-        if (next == NULL) {
-            prev->next = NULL;
-            strcpy(employee_facility_list->id_currently_selected, prev->id);
-        }
-        if (next != NULL) {
-            prev->next = next;
-            next->prev = prev;
-            strcpy(employee_facility_list->id_currently_selected, next->id);
-        }
+    // Select the node after the deleted employee facility, or the node before
+    // it if the deleted employee facility is the last one.
+    struct employee_facility_node* prev = record_store_prev(&employee_facility_list->store, employee_facility);
+    struct employee_facility_node* next = record_store_next(&employee_facility_list->store, employee_facility);
+    if (next != NULL) {
+        employee_facility_list->id_currently_selected = next->id;
     }
-
-    if (prev == NULL) {
-        if (next != NULL) {
-            next->prev = NULL;
-            strcpy(employee_facility_list->id_currently_selected, next->id);
-        }
+    else if (prev != NULL) {
+        employee_facility_list->id_currently_selected = prev->id;
     }
 
-    // Delete the employee_facility
-    free(employee_facility);
+    employee_facility_list->version++;
+    journal_delete(employee_facility_list->journal, \
+    journal_list_employee_facilities, employee_facility_list->owner_id, \
+    employee_facility->id);
+    facility_references_remove(employee_facility_list->references, \
+    employee_facility->facility_id, facility_reference_employee, \
+    employee_facility_list->owner_id);
+
+    // Delete the employee facility
+    id_index_remove(&employee_facility_list->id_index, employee_facility->id);
+    record_store_remove(&employee_facility_list->store, employee_facility);
     return;
 }
 
 // Select the previous node as the currently selected item.
 void employee_facility_list_select_previous_node(struct employee_facility_list *employee_facility_list) {
     if (employee_facility_list == NULL) return;
-    if (employee_facility_list->head == NULL) return;
 
-    struct employee_facility_node* employee_facility = employee_facility_list->head;
-    while (employee_facility != NULL) {
-        if (strcmp(employee_facility->id, employee_facility_list->id_currently_selected) == 0) {
-            if (employee_facility->prev != NULL) {
-                strcpy(employee_facility_list->id_currently_selected, employee_facility->prev->id);
-                return;
-            }
-            if (employee_facility->prev == NULL) {
-                struct employee_facility_node* temp = employee_facility;
-                while (temp->next != NULL) {
-                    temp = temp->next;
-                }
-                strcpy(employee_facility_list->id_currently_selected, temp->id);
-                return;
-            }
-        }
-        employee_facility = employee_facility->next;
-    }
+    struct employee_facility_node* employee_facility = employee_facility_list_get_selected_node(employee_facility_list);
+    if (employee_facility == NULL) return;
+
+    // Wrap around to the last employee facility if the first one is selected.
+    struct employee_facility_node* prev = record_store_prev(&employee_facility_list->store, employee_facility);
+    if (prev == NULL) prev = record_store_last(&employee_facility_list->store);
+    employee_facility_list->id_currently_selected = prev->id;
+    employee_facility_list->handle_currently_selected = record_store_handle(prev);
 }
 
 // Select the next node as the currently selected item.
 void employee_facility_list_select_next_node(struct employee_facility_list *employee_facility_list) {
     if (employee_facility_list == NULL) return;
-    if (employee_facility_list->head == NULL) return;
 
-    struct employee_facility_node* employee_facility = employee_facility_list->head;
-    while (employee_facility != NULL) {
-        if (strcmp(employee_facility->id, employee_facility_list->id_currently_selected) == 0) {
-            if (employee_facility->next != NULL) {
-                strcpy(employee_facility_list->id_currently_selected, employee_facility->next->id);
-                return;
-            }
-            if (employee_facility->next == NULL) {
-                strcpy(employee_facility_list->id_currently_selected,\
-                employee_facility_list->head->id);
-                return;
-            }
-        }
-        employee_facility = employee_facility->next;
-    }
+    struct employee_facility_node* employee_facility = employee_facility_list_get_selected_node(employee_facility_list);
+    if (employee_facility == NULL) return;
+
+    // Wrap around to the first employee facility if the last one is selected.
+    struct employee_facility_node* next = record_store_next(&employee_facility_list->store, employee_facility);
+    if (next == NULL) next = record_store_first(&employee_facility_list->store);
+    employee_facility_list->id_currently_selected = next->id;
+    employee_facility_list->handle_currently_selected = record_store_handle(next);
 }
 
-// Change the currently selected ID to the passed in ID in the employee_facility list.
+// Change the currently selected ID to the passed in ID in the employee facility
+// list.
 void employee_facility_list_set_selected_id\
-(struct employee_facility_list *employee_facility_list, char* id) {
-    if (employee_facility_list == NULL || id == NULL) return;
-    if (employee_facility_list->head == NULL) return;
+(struct employee_facility_list *employee_facility_list, enterprise_id id) {
+    if (employee_facility_list == NULL) return;
 
-    struct employee_facility_node* employee_facility = employee_facility_list->head;
-    while (employee_facility != NULL) {
-        if (strcmp(employee_facility->id, id) == 0) {
-            strcpy(employee_facility_list->id_currently_selected, id);
-        }
-        employee_facility = employee_facility->next;
+    if (employee_facility_list_get_node(employee_facility_list, id) != NULL) {
+        employee_facility_list->id_currently_selected = id;
     }
 }
 
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+
 // Render the employee facilities table GUI.
 // This is an overview of the facilities that an employee works at.
 enum program_status employee_facility_table(struct nk_context* ctx,\
@@ -346,7 +271,7 @@ struct facility_list* facility_list) {
     }
 
     // Handle case where there are no facilities.
-    if (facility_list->head == NULL) {
+    if (record_store_first(&facility_list->store) == NULL) {
         nk_label(ctx, "There are no facilities available to add employee to.",\
         NK_TEXT_CENTERED);
         if (nk_button_label(ctx, "Go to facility table.")) {
@@ -359,28 +284,52 @@ struct facility_list* facility_list) {
         nk_label(ctx, "Employee Facilities Menu", NK_TEXT_CENTERED);
         nk_label(ctx, "Facilities employee currently works at: ", NK_TEXT_CENTERED);
 
-        // Present all facilities that the employee works for.
-        struct employee_facility_node* employee_facility\
-        = employee_facility_list->head;
-        char* print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-        while (employee_facility != NULL) {
-
-            struct facility_node* facility = facility_list_get_node(\
-            facility_list, employee_facility->id);
-            if (facility == NULL) break;
-
-            sprintf(print_buffer, "Facility ID: %s Name: %s", \
-            employee_facility->id, facility->name);
+        /* Present all facilities that the employee works for.
+        Only the rows scrolled into view are drawn, and their labels are only
+        formatted again when different rows come into view or either list
+        changes. Both versions only ever grow, so their sum changes whenever
+        either of them does.*/
+        enum program_status status = program_status_employee_facility_table;
+        struct nk_list_view view;
+        uint64_t version = \
+        employee_facility_list->version + facility_list->version;
+        int rows = employee_facility_list->store.count > INT_MAX \
+        ? INT_MAX : (int)employee_facility_list->store.count;
+        nk_layout_row_dynamic(ctx, ENTERPRISE_TABLE_HEIGHT / 2, 1);
+        if (nk_list_view_begin(ctx, &view, "employee_facility_table", \
+        NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+            nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+            struct row_labels* labels = &employee_facility_list->row_labels;
+            if (row_labels_current(labels, version, \
+            (uint32_t)view.begin, (uint32_t)view.count) == false) {
+                row_labels_begin(labels, version, \
+                (uint32_t)view.begin, (uint32_t)view.count);
+                struct employee_facility_node* employee_facility = \
+                record_store_seek(&employee_facility_list->store, \
+                (uint32_t)view.begin);
+                for (int row = 0; row < view.count \
+                && employee_facility != NULL; row++) {
+                    struct facility_node* facility = facility_list_get_node(\
+                    facility_list, employee_facility->facility_id);
+                    if (row_labels_add(labels, employee_facility->id, \
+                    "Facility ID: %lld Name: %s", \
+                    employee_facility->facility_id, \
+                    facility == NULL ? "" : facility->name) == false) break;
+                    employee_facility = record_store_next\
+                    (&employee_facility_list->store, employee_facility);
+                }
+            }
 
-            if (nk_button_label(ctx, print_buffer)) {
-                strcpy(employee_facility_list->id_currently_selected,\
-                employee_facility->id);
-                free(print_buffer);
-                return program_status_employee_facility_editor;
+            for (uint32_t row = 0; row < labels->count; row++) {
+                if (nk_button_label(ctx, row_labels_text(labels, row))) {
+                    employee_facility_list->id_currently_selected = \
+                    row_labels_id(labels, row);
+                    status = program_status_employee_facility_editor;
+                }
             }
-            employee_facility = employee_facility->next;
+            nk_list_view_end(&view);
         }
-        free(print_buffer);
+        if (status != program_status_employee_facility_table) return status;
 
         // Create button to add new employee facilities to the table.
         nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
@@ -393,70 +342,95 @@ struct facility_list* facility_list) {
         }
 
         /* If we want to add a new facility.
-        Search through all the facilities in the facility table, display the 
-        facilities that aren't currently worked for by the employee, and 
-        if clicked on, add it to the list of facilities the current employee 
-        works for. */
+        Go through the facilities in view in the facility table. Facilities
+        the employee already works at are shown as labels, so that every
+        facility keeps its row. Facilities the employee doesn't work at yet are
+        shown as buttons, and if clicked on, added to the list of facilities
+        the employee works at. */
         if (employee_facility_list->addition_requested == true) {
-            print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-            struct facility_node* facility = facility_list->head;
-
-            while (facility != NULL) {
-                bool show = false;
-                sprintf(print_buffer, "ID : %s Facility Name: %s",\
-                facility->id, facility->name);
-                if (employee_facility_list_get_node_by_facility_id(\
-                employee_facility_list,facility->id) == NULL) show = true;
-                    if (show == true) {
-                        if (nk_button_label(ctx, print_buffer)) {
-                            employee_facility_list_append(employee_facility_list);
-
-                            strcpy(employee_facility_list_get_node\
-                            (employee_facility_list,\
-                            employee_facility_list->id_currently_selected)\
-                            ->facility_id, facility->id);
-                            employee_facility_list->addition_requested = false;
+            rows = facility_list->store.count > INT_MAX \
+            ? INT_MAX : (int)facility_list->store.count;
+            nk_layout_row_dynamic(ctx, ENTERPRISE_TABLE_HEIGHT / 2, 1);
+            if (nk_list_view_begin(ctx, &view, "employee_facility_addition", \
+            NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+                nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+                struct row_labels* labels = \
+                &employee_facility_list->addition_labels;
+                if (row_labels_current(labels, version, \
+                (uint32_t)view.begin, (uint32_t)view.count) == false) {
+                    row_labels_begin(labels, version, \
+                    (uint32_t)view.begin, (uint32_t)view.count);
+                    struct facility_node* facility = record_store_seek\
+                    (&facility_list->store, (uint32_t)view.begin);
+                    for (int row = 0; row < view.count && facility != NULL; \
+                    row++) {
+                        // Facilities that are already added have no ID.
+                        enterprise_id id = facility->id;
+                        if (employee_facility_list_get_node_by_facility_id(\
+                        employee_facility_list, facility->id) != NULL) {
+                            id = ENTERPRISE_ID_NONE;
                         }
+                        if (row_labels_add(labels, id, \
+                        "ID : %lld Facility Name: %s", facility->id, \
+                        facility->name) == false) break;
+                        facility = record_store_next(&facility_list->store, \
+                        facility);
+                    }
+                }
+
+                for (uint32_t row = 0; row < labels->count; row++) {
+                    enterprise_id id = row_labels_id(labels, row);
+                    if (id == ENTERPRISE_ID_NONE) {
+                        nk_label(ctx, row_labels_text(labels, row), \
+                        NK_TEXT_LEFT);
+                    }
+                    else if (nk_button_label(ctx, \
+                    row_labels_text(labels, row))) {
+                        employee_facility_list_append(employee_facility_list);
+                        employee_facility_list_set_facility\
+                        (employee_facility_list, \
+                        employee_facility_list_get_selected_node\
+                        (employee_facility_list), id);
+                        employee_facility_list->addition_requested = false;
                     }
-                facility = facility->next;
+                }
+                nk_list_view_end(&view);
             }
-            free(print_buffer);
         }
     }
     return program_status_employee_facility_table;
 }
 
-// Render the employee_facility editor GUI.
-// It gives the user an opportunity to edit a currently selected employee_facility.
+// Render the employee facility editor GUI. It gives the user an opportunity to
+// edit a currently selected employee facility.
 enum program_status employee_facility_editor(struct nk_context* ctx,\
 struct employee_facility_list* employee_facility_list, \
 struct facility_list* facility_list) {
     if (ctx == NULL || employee_facility_list == NULL)
         return program_status_enterprise_menu;
 
-    // Display title and return to employee_facility table button.
+    // Display title and return to employee facility table button.
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
     if (nk_button_label(ctx, "Return to Employee Facility Table")) {
         return program_status_employee_facility_table;
     }
     nk_label(ctx, "Employee Facility Editor", NK_TEXT_CENTERED);
     
-    // Select currently selected employee_facility.
+    // Select currently selected employee facility.
     struct employee_facility_node* employee_facility = \
-    employee_facility_list_get_node(employee_facility_list,\
-    employee_facility_list->id_currently_selected);
+    employee_facility_list_get_selected_node(employee_facility_list);
 
-    // If the currently selected employee_facility does not exist:
+    // If the currently selected employee facility does not exist:
     if (employee_facility == NULL) {
-        // Select the first employee_facility instead.
-        if (employee_facility_list->head != NULL) {
-            strcpy(employee_facility_list->id_currently_selected, \
-            employee_facility_list->head->id);
+        // Select the first employee facility instead.
+        employee_facility = record_store_first(&employee_facility_list->store);
+        if (employee_facility != NULL) {
+            employee_facility_list->id_currently_selected = employee_facility->id;
             return program_status_employee_facility_editor;
         }
 
-        // Else tell the user to create a new employee_facility 
-        // if the first employee_facility doesn't exist.
+        // Else tell the user to create a new employee facility 
+        // if the first employee facility doesn't exist.
         else {
             nk_label(ctx, "No facilities found.", NK_TEXT_CENTERED);
             if (nk_button_label(ctx, "New Facility")) {
@@ -467,17 +441,22 @@ struct facility_list* facility_list) {
         }
     }
 
-    // Display edit fields to edit employee_facility entries.
+    // Display edit fields to edit employee facility entries.
     nk_layout_row_template_begin(ctx, ENTERPRISE_WIDGET_HEIGHT);
     nk_layout_row_template_push_static(ctx, 150);
     nk_layout_row_template_push_dynamic(ctx);
     nk_layout_row_template_end(ctx);
 
+    // Store any edit to the facility ID, and note it in the journal.
+    char id_text[ENTERPRISE_ID_TEXT_LENGTH];
+    enterprise_id_format(employee_facility->facility_id, id_text);
     nk_label(ctx, "Facility ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    employee_facility->facility_id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_decimal);
+    employee_facility_list_set_facility(employee_facility_list, \
+    employee_facility, enterprise_id_parse(id_text));
 
-    // Move between next and previous employee_facilitys.
+    // Move between next and previous employee facilities.
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 2);
     if (nk_button_symbol_label\
     (ctx, NK_SYMBOL_TRIANGLE_LEFT, "prev", NK_TEXT_RIGHT)) {
@@ -521,30 +500,31 @@ struct facility_list* facility_list) {
 
     if (employee_facility_list->addition_requested == true) {
             char* print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-            struct facility_node* facility = facility_list->head;
+            struct facility_node* facility = record_store_first(&facility_list->store);
 
             while (facility != NULL) {
                 bool show = false;
-                sprintf(print_buffer, "ID : %s Facility Name: %s",\
+                sprintf(print_buffer, "ID : %lld Facility Name: %s",\
                 facility->id, facility->name);
                 if (employee_facility_list_get_node_by_facility_id(\
                 employee_facility_list,facility->id) == NULL) show = true;
                     if (show == true) {
                         if (nk_button_label(ctx, print_buffer)) {
                             employee_facility_list_append(employee_facility_list);
-
-                            strcpy(employee_facility_list_get_node\
-                            (employee_facility_list,\
-                            employee_facility_list->id_currently_selected)\
-                            ->facility_id, facility->id);
+                            employee_facility_list_set_facility\
+                            (employee_facility_list, \
+                            employee_facility_list_get_selected_node\
+                            (employee_facility_list), facility->id);
                             employee_facility_list->addition_requested = false;
                         }
                     }
-                facility = facility->next;
+                facility = record_store_next(&facility_list->store, facility);
             }
             free(print_buffer);
             
         }
     
     return program_status_employee_facility_editor;
-}
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+#ifndef ENTERPRISE_FACILITY_REFERENCES
+#define ENTERPRISE_FACILITY_REFERENCES
+#include "facility_references.h"
+#endif
+
+#ifndef ENTERPRISE_JOURNAL
+#define ENTERPRISE_JOURNAL
+#include "journal.h"
+#endif
+
+#ifndef ENTERPRISE_ROW_LABELS
+#define ENTERPRISE_ROW_LABELS
+#include "row_labels.h"
+#endif
+
+#ifndef PROGRAM_STATES
+#define PROGRAM_STATES
+#include "program_states.h"
+#endif
+
+#ifndef ENTERPRISE_FACILITIES
+#define ENTERPRISE_FACILITIES
+#include "facilities.h"
+#endif
+
+// Nuklear's context, taken by the GUI functions. Only the sources of
+// those functions import Nuklear itself.
+struct nk_context;
+
+/* How employee facility links work.
+An employee can work at any number of facilities. Each employee owns a list of
+employee facility links, and each link holds the ID of one facility the
+employee works at. The list is laid out like every other list of the
+enterprise (see record_store.c), but it belongs to its employee rather than to
+the enterprise, and link IDs only have to be unique within it.
+
+Adding or removing a link adds or removes the employee's reference to the
+facility (see facility_references.c), and is recorded in the journal as a
+change to the employee's facilities.
+
+Data structures:
+employee_facility_node: A link to one facility.
+employee_facility_list: The facility links of one employee.
+*/
+
+struct employee_facility_node {
+    enterprise_id id;
+    enterprise_id facility_id;
+};
+
+// Employee facility list metadata structure.
+struct employee_facility_list {
+    struct record_store store;
+    struct id_index id_index;
+
+    // Where changes to the list are recorded, or NULL if they are not, and the
+    // ID of the node that owns the list.
+    struct journal* journal;
+    enterprise_id owner_id;
+
+    // The facility references that the list's facilities are counted in, or
+    // NULL if they are not.
+    struct facility_references* references;
+
+    // Bumped whenever a node is appended, edited or deleted, so that the
+    // labels cached for the list's table and for the facilities that can be
+    // added to it know when they are stale.
+    uint64_t version;
+    struct row_labels row_labels;
+    struct row_labels addition_labels;
+
+    enterprise_id id_last_assigned;
+    enterprise_id id_currently_selected;
+    uint32_t handle_currently_selected;
+    bool deletion_requested;
+    bool addition_requested;
+};
+
+struct employee_facility_node *employee_facility_node_new(struct record_store* store);
+struct employee_facility_list* employee_facility_list_new\
+(struct journal* journal, struct facility_references* references, \
+enterprise_id owner_id);
+void employee_facility_list_free(struct employee_facility_list* employee_facility_list);
+void employee_facility_list_append(struct employee_facility_list* employee_facility_list);
+int employee_facility_list_get_num_employee_facility_nodes(struct employee_facility_list* employee_facility_list);
+struct employee_facility_node *employee_facility_list_get_node\
+(struct employee_facility_list *employee_facility_list, enterprise_id id);
+struct employee_facility_node *employee_facility_list_get_selected_node\
+(struct employee_facility_list *employee_facility_list);
+struct employee_facility_node *employee_facility_list_get_node_by_facility_id\
+(struct employee_facility_list *employee_facility_list, enterprise_id id);
+void employee_facility_list_set_facility\
+(struct employee_facility_list* employee_facility_list, \
+struct employee_facility_node* employee_facility, enterprise_id facility_id);
+void employee_facility_list_unlink\
+(struct employee_facility_list* employee_facility_list);
+void employee_facility_list_delete_node\
+(struct employee_facility_list *employee_facility_list, enterprise_id id);
+void employee_facility_list_select_previous_node(struct employee_facility_list *employee_facility_list);
+void employee_facility_list_select_next_node(struct employee_facility_list *employee_facility_list);
+void employee_facility_list_set_selected_id\
+(struct employee_facility_list *employee_facility_list, enterprise_id id);
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+enum program_status employee_facility_table(struct nk_context* ctx,\
+struct employee_facility_list* employee_facility_list, \
+struct facility_list* facility_list);
+enum program_status employee_facility_editor(struct nk_context* ctx,\
+struct employee_facility_list* employee_facility_list, \
+struct facility_list* facility_list);
+#endif
@@ -9,169 +9,131 @@
 #include <limits.h>
 #include <time.h>
 
-#include "constants.c"
-
-#ifndef PROGRAM_STATES
-#define PROGRAM_STATES
-#include "program_states.c"
+// Import Nuklear, unless building without the GUI.
+#if !defined(ENTERPRISE_NUKLEAR_LIBRARY_IMPORT) \
+&& !defined(ENTERPRISE_HEADLESS)
+#define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
+#include "nuklear_import.h"
 #endif
 
-
-// Import Nuklear.
-#ifndef ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-#define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-    #define NK_INCLUDE_FIXED_TYPES
-    #define NK_INCLUDE_STANDARD_IO
-    #define NK_INCLUDE_STANDARD_VARARGS
-    #define NK_INCLUDE_DEFAULT_ALLOCATOR
-    #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    #define NK_INCLUDE_FONT_BAKING
-    #define NK_INCLUDE_DEFAULT_FONT
-    #define NK_IMPLEMENTATION
-    #define NK_SDL_GLES2_IMPLEMENTATION
-    #include "../third_party/Nuklear/nuklear.h"
-    #include "../third_party/Nuklear/demo/sdl_opengles2/nuklear_sdl_gles2.h"
-    #include "../third_party/Nuklear/demo/common/style.c"
+#ifndef ENTERPRISE_EMPLOYEES
+#define ENTERPRISE_EMPLOYEES
+#include "employees.h"
 #endif
 
-#include "employee_facilities.c"
-
-/* How employees work.
-employees are stored in a struct that contains a pointer to the head of a
-linked list containing all the employees. The struct that stores the linked
-list is directly added to the enterprise struct and stores metadata about the
-list. All employees are assigned a unique ID, no two employees can have the
-same ID, the employee_list structure keeps track of that.
-
-Data structures:
-employee_node: An individual employee.
-employee_list: A structure holding important metadata about the employee
-linked list.
-
-employee list metadata:
-employee_list->id_last_assigned: This is incremented by 1 every time a new
-employee is added in order to ensure no two employees ever have the same ID.
-
-employee_list->id_currently_selected: This is the ID that is selected in the
-employee editor dialogue.
-*/
-
-struct employee_node {
-    char id[ENTERPRISE_STRING_LENGTH];
-    char name[ENTERPRISE_STRING_LENGTH];
-    char email[ENTERPRISE_STRING_LENGTH];
-    char phone[ENTERPRISE_STRING_LENGTH];
-    char address[ENTERPRISE_STRING_LENGTH];
-
-    struct employee_facility_list* employee_facility_list;
-    struct employee_node* prev;
-    struct employee_node* next;
-};
-
-// employee node constructor and initialiser.
+// Employee node constructor and initialiser.
+// The node is added to the end of the passed in record store.
 // Returns employee node on success, or NULL on failure.
-struct employee_node *employee_node_new() {
-    struct employee_node* employee = malloc(sizeof(struct employee_node));
+struct employee_node *employee_node_new(struct record_store* store) {
+    struct employee_node* employee = record_store_append(store);
     if (employee == NULL) return NULL;
-    strcpy(employee->id, "");
-    strcpy(employee->name, "");
-    strcpy(employee->email, "");
-    strcpy(employee->phone, "");
-    strcpy(employee->address, "");
+    employee->id = ENTERPRISE_ID_NONE;
+    employee->name = "";
+    employee->email = "";
+    employee->phone = "";
+    employee->address = "";
 
     employee->employee_facility_list = NULL;
 
-    employee->prev = NULL;
-    employee->next = NULL;
-
     return employee;
 }
 
-// Free everything associated with an employee.
-void employee_node_free(struct employee_node* employee) {
+// Free everything associated with an employee and remove it from its store.
+void employee_node_free(struct string_pool* string_pool,\
+struct record_store* store, struct employee_node* employee) {
     if (employee == NULL) return;
+    string_pool_release(string_pool, employee->name);
+    string_pool_release(string_pool, employee->email);
+    string_pool_release(string_pool, employee->phone);
+    string_pool_release(string_pool, employee->address);
     if (employee->employee_facility_list != NULL) {
         employee_facility_list_free(employee->employee_facility_list);
     }
-    free(employee);
+    record_store_remove(store, employee);
 }
 
-// employee list metadata structure.
-struct employee_list {
-    struct employee_node *head;
-    char id_last_assigned[ENTERPRISE_STRING_LENGTH];
-    char id_currently_selected[ENTERPRISE_STRING_LENGTH];
-    bool deletion_requested;
-};
-
-// employee list constructor.
+// Employee list constructor.
 // Returns employee list on success, or NULL on failure.
-struct employee_list* employee_list_new() {
+struct employee_list* employee_list_new(struct string_pool* string_pool) {
     struct employee_list* employee_list = malloc(sizeof(struct employee_list));
     if (employee_list == NULL) return NULL;
-    employee_list->head = NULL;
-    strcpy(employee_list->id_last_assigned, "0");
-    strcpy(employee_list->id_currently_selected, "0");
+    record_store_init(&employee_list->store, sizeof(struct employee_node));
+    id_index_init(&employee_list->id_index);
+    employee_list->journal = NULL;
+    employee_list->facility_references = NULL;
+    employee_list->version = 0;
+    row_labels_init(&employee_list->row_labels);
+    text_search_init(&employee_list->search);
+    text_index_init(&employee_list->text_index);
+    employee_list->string_pool = string_pool;
+    employee_list->edit_id = ENTERPRISE_ID_NONE;
+    strcpy(employee_list->edit_name, "");
+    strcpy(employee_list->edit_email, "");
+    strcpy(employee_list->edit_phone, "");
+    strcpy(employee_list->edit_address, "");
+    employee_list->id_last_assigned = ENTERPRISE_ID_NONE;
+    employee_list->id_currently_selected = ENTERPRISE_ID_NONE;
+    employee_list->handle_currently_selected = RECORD_STORE_NONE;
     employee_list->deletion_requested = false;
     return employee_list;
 }
 
-
-
-// Free an entire employee linked list
-void employee_node_linked_list_free(struct employee_node* employee) {
-    if (employee == NULL) return;
-    struct employee_node* next = NULL;
-    while (employee != NULL) {
-        next = employee->next;
-        employee_node_free(employee);
-        employee = next;
-    }
-}
-
-// Free all memory associated with a employee list.
+// Free all memory associated with an employee list.
 void employee_list_free(struct employee_list* employee_list) {
     if (employee_list == NULL) return;
 
-    if (employee_list->head != NULL) {
-        employee_node_linked_list_free(employee_list->head);
+    // Free every employee, giving their text back to the string pool. If the
+    // pool is being dropped only the employees' facility lists need freeing,
+    // as the record store frees every employee at once.
+    bool dropping = string_pool_is_dropping(employee_list->string_pool);
+    struct employee_node* employee = record_store_first(&employee_list->store);
+    while (employee != NULL) {
+        struct employee_node* next = \
+        record_store_next(&employee_list->store, employee);
+        if (dropping) {
+            employee_facility_list_free(employee->employee_facility_list);
+        }
+        else {
+            employee_node_free(employee_list->string_pool, \
+            &employee_list->store, employee);
+        }
+        employee = next;
     }
 
+    row_labels_free(&employee_list->row_labels);
+    text_search_free(&employee_list->search);
+    text_index_free(&employee_list->text_index);
+    id_index_free(&employee_list->id_index);
+    record_store_free(&employee_list->store);
     free(employee_list);
     return;
 }
 
-// Append a new employee to a employee list.
+// Append a new employee to an employee list.
 void employee_list_append(struct employee_list* employee_list) {
     if (employee_list == NULL) return;
 
     // Increment unique ID by 1.
-    char buffer[ENTERPRISE_STRING_LENGTH];
-    sprintf(buffer, "%lld", atoll(employee_list->id_last_assigned) + 1);
-    strcpy(employee_list->id_last_assigned, buffer);
-
-    // Add new node to start of employee list if employee linked list does
-    // not exist.
-    if (employee_list->head == NULL) {
-        employee_list->head = employee_node_new();
-        strcpy(employee_list->head->id, employee_list->id_last_assigned);
-        strcpy(employee_list->id_currently_selected,
-        employee_list->id_last_assigned);
+    employee_list->id_last_assigned++;
+
+    // Add the new node to the end of the list.
+    struct employee_node* employee = employee_node_new(&employee_list->store);
+    if (employee == NULL) return;
+
+    employee->id = employee_list->id_last_assigned;
+
+    // Index the new node by its ID so it can be found without a search.
+    if (id_index_insert(&employee_list->id_index, employee->id, \
+    record_store_handle(employee)) == false) {
+        record_store_remove(&employee_list->store, employee);
         return;
     }
 
-    // Else add the new node to the end of the list.
-    struct employee_node* employee = employee_list->head;
-    while (employee->next != NULL) {
-        employee = employee->next;
-    }
-    
-    employee->next = employee_node_new();
-    employee->next->prev = employee;
+    employee_list->id_currently_selected = employee_list->id_last_assigned;
 
-    strcpy(employee->next->id, employee_list->id_last_assigned);
-    strcpy(employee_list->id_currently_selected,
-    employee_list->id_last_assigned);
+    employee_list->version++;
+    journal_put(employee_list->journal, journal_list_employees, \
+    ENTERPRISE_ID_NONE, employee->id);
 
     return;
 }
@@ -179,151 +141,227 @@ void employee_list_append(struct employee_list* employee_list) {
 // Get the number of employee nodes in the employee list
 int employee_list_get_num_employee_nodes(struct employee_list* employee_list) {
     if (employee_list == NULL) return 0;
-    if (employee_list->head == NULL) return 0;
+    return (int)employee_list->store.count;
+}
 
-    struct employee_node* employee = employee_list->head;
-    int employee_count = 0;
-    while (employee != NULL) {
-        employee_count++;
-        employee = employee->next;
-    }
-    return employee_count;
+// Make room in an employee list and its ID index for count more employees.
+// Returns true on success, or false on failure.
+bool employee_list_reserve(struct employee_list* employee_list, \
+uint32_t count) {
+    if (employee_list == NULL) return false;
+    return record_store_reserve(&employee_list->store, count) \
+    && id_index_reserve(&employee_list->id_index, count);
 }
 
-// Return a pointer to a employee node according to ID.
+// Return a pointer to an employee node according to ID.
 // Returns NULL on failure.
 struct employee_node *employee_list_get_node\
-(struct employee_list *employee_list, char *id) {
-    if (employee_list == NULL || id == NULL) return NULL;
-    if (employee_list->head == NULL) return NULL;
-
-    struct employee_node* employee = employee_list->head;
-    while (employee != NULL) {
-        if (strcmp(employee->id, id) == 0) return employee;
-        employee = employee->next;
-    }
-    return NULL;
+(struct employee_list *employee_list, enterprise_id id) {
+    if (employee_list == NULL) return NULL;
+    return record_store_get\
+    (&employee_list->store, id_index_find(&employee_list->id_index, id));
 }
 
-// Searches for a employee by ID and deletes it
-void employee_list_delete_node(struct employee_list *employee_list, char *id) {
-    if (employee_list == NULL || id == NULL) return;
-    if (employee_list->head == NULL) return;
-
-    // Delete the head if it is the ID that is requested to be deleted.
-    if (strcmp(id, employee_list->head->id) == 0) {
-        if (employee_list->head->next == NULL) {
-            employee_node_free(employee_list->head);
-            employee_list->head = NULL;
-            return;
-        }
-
-        struct employee_node *next = employee_list->head->next;
-        employee_node_free(employee_list->head);
-        employee_list->head = next;
-        return;
-    }
+// Return a pointer to the currently selected employee node.
+// The selected employee's handle is checked before its ID is looked up, so this
+// only searches the ID index after the selection was changed by ID.
+// Returns NULL if no employee is selected.
+struct employee_node *employee_list_get_selected_node\
+(struct employee_list *employee_list) {
+    if (employee_list == NULL) return NULL;
 
-    // Else search for the employee to delete.
-    struct employee_node* employee = employee_list->head;
-    while (employee != NULL) {
-        if (strcmp(employee->id, id) == 0) break;
-        employee = employee->next;
+    struct employee_node* employee = record_store_get\
+    (&employee_list->store, employee_list->handle_currently_selected);
+    if (employee == NULL \
+    || employee->id != employee_list->id_currently_selected) {
+        employee = employee_list_get_node\
+        (employee_list, employee_list->id_currently_selected);
+        employee_list->handle_currently_selected = \
+        record_store_handle(employee);
     }
-    if (employee == NULL) return;
+    return employee;
+}
 
-    // Fix the pointers of the next and previous nodes to the employee to be
-    // deleted in order to ensure that traversal still works.
+// Searches for an employee by ID and deletes it
+void employee_list_delete_node\
+(struct employee_list *employee_list, enterprise_id id) {
+    if (employee_list == NULL) return;
 
-    struct employee_node* prev = employee->prev;
-    struct employee_node* next = employee->next;
+    struct employee_node* employee = employee_list_get_node(employee_list, id);
+    if (employee == NULL) return;
 
-    if (prev != NULL) {
-        if (next == NULL) {
-            prev->next = NULL;
-            strcpy(employee_list->id_currently_selected, prev->id);
-        }
-        if (next != NULL) {
-            prev->next = next;
-            next->prev = prev;
-            strcpy(employee_list->id_currently_selected, next->id);
-        }
+    // Select the node after the deleted employee, or the node before it if the
+    // deleted employee is the last one.
+    struct employee_node* prev = record_store_prev(&employee_list->store, employee);
+    struct employee_node* next = record_store_next(&employee_list->store, employee);
+    if (next != NULL) {
+        employee_list->id_currently_selected = next->id;
     }
-
-    if (prev == NULL) {
-        if (next != NULL) {
-            next->prev = NULL;
-            strcpy(employee_list->id_currently_selected, next->id);
-        }
+    else if (prev != NULL) {
+        employee_list->id_currently_selected = prev->id;
     }
 
+    employee_list->version++;
+    journal_delete(employee_list->journal, journal_list_employees, \
+    ENTERPRISE_ID_NONE, employee->id);
+    employee_facility_list_unlink(employee->employee_facility_list);
+
     // Delete the employee
-    employee_node_free(employee);
+    id_index_remove(&employee_list->id_index, employee->id);
+    employee_node_free(employee_list->string_pool, \
+    &employee_list->store, employee);
     return;
 }
 
 // Select the previous node as the currently selected item.
 void employee_list_select_previous_node(struct employee_list *employee_list) {
     if (employee_list == NULL) return;
-    if (employee_list->head == NULL) return;
 
-    struct employee_node* employee = employee_list->head;
-    while (employee != NULL) {
-        if (strcmp(employee->id, employee_list->id_currently_selected) == 0) {
-            if (employee->prev != NULL) {
-                strcpy(employee_list->id_currently_selected, employee->prev->id);
-                return;
-            }
-            if (employee->prev == NULL) {
-                struct employee_node* temp = employee;
-                while (temp->next != NULL) {
-                    temp = temp->next;
-                }
-                strcpy(employee_list->id_currently_selected, temp->id);
-                return;
-            }
-        }
-        employee = employee->next;
-    }
+    struct employee_node* employee = \
+    employee_list_get_selected_node(employee_list);
+    if (employee == NULL) return;
+
+    // Wrap around to the last employee if the first one is selected.
+    struct employee_node* prev = record_store_prev(&employee_list->store, employee);
+    if (prev == NULL) prev = record_store_last(&employee_list->store);
+    employee_list->id_currently_selected = prev->id;
+    employee_list->handle_currently_selected = record_store_handle(prev);
 }
 
 // Select the next node as the currently selected item.
 void employee_list_select_next_node(struct employee_list *employee_list) {
     if (employee_list == NULL) return;
-    if (employee_list->head == NULL) return;
 
-    struct employee_node* employee = employee_list->head;
-    while (employee != NULL) {
-        if (strcmp(employee->id, employee_list->id_currently_selected) == 0) {
-            if (employee->next != NULL) {
-                strcpy(employee_list->id_currently_selected, employee->next->id);
-                return;
-            }
-            if (employee->next == NULL) {
-                strcpy(employee_list->id_currently_selected,\
-                employee_list->head->id);
-                return;
-            }
-        }
-        employee = employee->next;
-    }
+    struct employee_node* employee = \
+    employee_list_get_selected_node(employee_list);
+    if (employee == NULL) return;
+
+    // Wrap around to the first employee if the last one is selected.
+    struct employee_node* next = record_store_next(&employee_list->store, employee);
+    if (next == NULL) next = record_store_first(&employee_list->store);
+    employee_list->id_currently_selected = next->id;
+    employee_list->handle_currently_selected = record_store_handle(next);
 }
 
 // Change the currently selected ID to the passed in ID in the employee list.
 void employee_list_set_selected_id\
-(struct employee_list *employee_list, char* id) {
-    if (employee_list == NULL || id == NULL) return;
-    if (employee_list->head == NULL) return;
+(struct employee_list *employee_list, enterprise_id id) {
+    if (employee_list == NULL) return;
+
+    if (employee_list_get_node(employee_list, id) != NULL) {
+        employee_list->id_currently_selected = id;
+    }
+}
+
+// Add the text of an employee to the list's search index, after it was added
+// or edited. Does nothing until the list is first searched.
+void employee_list_index_node(struct employee_list* employee_list, \
+struct employee_node* employee) {
+    if (employee_list == NULL || employee == NULL) return;
+    struct text_index* index = &employee_list->text_index;
+    if (index->built == false) return;
+
+    uint32_t handle = record_store_handle(employee);
+    if (text_index_add(index, handle, employee->name) == false || \
+    text_index_add(index, handle, employee->email) == false || \
+    text_index_add(index, handle, employee->phone) == false || \
+    text_index_add(index, handle, employee->address) == false) {
+        // Build the index again on the next search rather than miss matches.
+        index->built = false;
+    }
+}
+
+// Returns true if an employee's name, email, phone or address contain query,
+// ignoring case.
+bool employee_node_matches(struct employee_node* employee, const char* query) {
+    return text_index_contains(employee->name, query) || \
+    text_index_contains(employee->email, query) || \
+    text_index_contains(employee->phone, query) || \
+    text_index_contains(employee->address, query);
+}
+
+// Search the employees for the text in the list's search box, and keep the IDs
+// of the employees whose name, email, phone or address contain it.
+// Returns true on success, or false on failure.
+bool employee_list_search(struct employee_list* employee_list) {
+    if (employee_list == NULL) return false;
+    struct text_search* search = &employee_list->search;
+    text_search_begin(search, employee_list->version);
+    row_labels_invalidate(&employee_list->row_labels);
+    if (search->active == false) return true;
+
+    // Build the index from every employee the first time the list is searched.
+    struct text_index* index = &employee_list->text_index;
+    if (text_index_due(index)) {
+        text_index_clear(index);
+        index->built = true;
+        struct employee_node* employee = \
+        record_store_first(&employee_list->store);
+        while (employee != NULL && index->built) {
+            employee_list_index_node(employee_list, employee);
+            employee = record_store_next(&employee_list->store, employee);
+        }
+        if (index->built) text_index_finish(index);
+    }
+
+    // Only check the employees that hold the rarest trigram of the search.
+    const uint32_t* candidates = NULL;
+    uint32_t candidate_count = 0;
+    if (index->built && text_index_candidates(index, search->query, \
+    &candidates, &candidate_count)) {
+        for (uint32_t candidate = 0; candidate < candidate_count; \
+        candidate++) {
+            struct employee_node* employee = \
+            record_store_get(&employee_list->store, candidates[candidate]);
+            if (employee == NULL || \
+            employee_node_matches(employee, search->query) == false) continue;
+            if (text_search_add(search, employee->id) == false) return false;
+        }
+        text_search_finish(search);
+        return true;
+    }
 
-    struct employee_node* employee = employee_list->head;
+    // Short searches, or searches without an index, check every employee.
+    struct employee_node* employee = record_store_first(&employee_list->store);
     while (employee != NULL) {
-        if (strcmp(employee->id, id) == 0) {
-            strcpy(employee_list->id_currently_selected, id);
+        if (employee_node_matches(employee, search->query) && \
+        text_search_add(search, employee->id) == false) return false;
+        employee = record_store_next(&employee_list->store, employee);
+    }
+    return true;
+}
+
+// Make the labels of row_count rows of the employee table, starting at
+// first_row, unless they are cached already.
+void employee_list_label_rows(struct employee_list* employee_list, \
+uint32_t first_row, uint32_t row_count) {
+    if (employee_list == NULL) return;
+    struct row_labels* labels = &employee_list->row_labels;
+    if (row_labels_current(labels, employee_list->version, first_row, \
+    row_count)) return;
+
+    // While searching, the rows are the matches of the search.
+    row_labels_begin(labels, employee_list->version, first_row, row_count);
+    struct text_search* search = &employee_list->search;
+    struct employee_node* employee = search->active \
+    ? employee_list_get_node(employee_list, text_search_id(search, first_row)) \
+    : record_store_seek(&employee_list->store, first_row);
+    for (uint32_t row = 0; row < row_count && employee != NULL; row++) {
+        if (row_labels_add(labels, employee->id, \
+        "ID: %lld Name: %s Email: %s Phone: %s Address: %s",\
+        employee->id, employee->name, employee->email, \
+        employee->phone, employee->address) == false) break;
+        if (search->active) {
+            employee = employee_list_get_node\
+            (employee_list, text_search_id(search, first_row + row + 1));
         }
-        employee = employee->next;
+        else employee = record_store_next(&employee_list->store, employee);
     }
 }
 
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+
 // Render the employee table GUI.
 // This function displays a list of employees as a table that can be selected.
 // It is an overview.
@@ -346,31 +384,51 @@ struct employee_list* employee_list) {
     }
 
     // If there are no employees, warn the user.
-    if (employee_list->head == NULL) {
+    if (record_store_first(&employee_list->store) == NULL) {
         nk_label(ctx, "No Employees found.", NK_TEXT_CENTERED);
         return program_status_employee_table;
     }
 
-    /* If there are employees, go through the linked list of employees.
-    Copy the data from each employee and make it a button label.
-    When the button is pressed, set the currently selected employee to that
-    employee and switch to employee editor.*/
-    struct employee_node* employee = employee_list->head;
-    char* print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-    while (employee != NULL) {
-        sprintf(print_buffer, \
-        "ID: %s Name: %s Email: %s Phone: %s Address: %s",employee->id,\
-        employee->name, employee->email, employee->phone, employee->address);
+    // Search box. While it holds text, only the matching employees are listed.
+    nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
+    employee_list->search.query, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    if (text_search_due(&employee_list->search, employee_list->version)) {
+        employee_list_search(employee_list);
+    }
+    if (employee_list->search.active && employee_list->search.count == 0) {
+        nk_label(ctx, "No employees match the search.", NK_TEXT_CENTERED);
+        return program_status_employee_table;
+    }
 
-        if (nk_button_label(ctx, print_buffer)) {
-            strcpy(employee_list->id_currently_selected, employee->id);
-            free(print_buffer);
-            return program_status_employee_editor;
+    /* If there are employees, make a button for each employee in view.
+    Only the rows scrolled into view are drawn, and their labels are only
+    formatted again when different rows come into view or the list changes.
+    When a button is pressed, set the currently selected employee to that
+    employee and switch to employee editor.*/
+    enum program_status status = program_status_employee_table;
+    struct nk_list_view view;
+    uint32_t row_total = employee_list->search.active \
+    ? employee_list->search.count : employee_list->store.count;
+    int rows = row_total > INT_MAX ? INT_MAX : (int)row_total;
+    nk_layout_row_dynamic(ctx, \
+    ENTERPRISE_TABLE_HEIGHT - ENTERPRISE_WIDGET_HEIGHT, 1);
+    if (nk_list_view_begin(ctx, &view, "employee_table", \
+    NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+        nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+        struct row_labels* labels = &employee_list->row_labels;
+        employee_list_label_rows(employee_list, \
+        (uint32_t)view.begin, (uint32_t)view.count);
+
+        for (uint32_t row = 0; row < labels->count; row++) {
+            if (nk_button_label(ctx, row_labels_text(labels, row))) {
+                employee_list_set_selected_id\
+                (employee_list, row_labels_id(labels, row));
+                status = program_status_employee_editor;
+            }
         }
-        employee = employee->next;
+        nk_list_view_end(&view);
     }
-    free(print_buffer);
-    return program_status_employee_table;
+    return status;
 }
 
 // Render the employee editor GUI.
@@ -388,14 +446,15 @@ struct employee_list* employee_list) {
     nk_label(ctx, "Employee Editor", NK_TEXT_CENTERED);
     
     // Select currently selected employee.
-    struct employee_node* employee = employee_list_get_node\
-    (employee_list, employee_list->id_currently_selected);
+    struct employee_node* employee = \
+    employee_list_get_selected_node(employee_list);
 
     // If the currently selected employee does not exist:
     if (employee == NULL) {
         // Select the first employee instead.
-        if (employee_list->head != NULL) {
-            strcpy(employee_list->id_currently_selected, employee_list->head->id);
+        employee = record_store_first(&employee_list->store);
+        if (employee != NULL) {
+            employee_list->id_currently_selected = employee->id;
             return program_status_employee_editor;
         }
 
@@ -410,36 +469,66 @@ struct employee_list* employee_list) {
         }
     }
 
+    // Copy the selected employee's text into the edit buffers whenever a
+    // different employee is selected.
+    if (employee_list->edit_id != employee->id) {
+        employee_list->edit_id = employee->id;
+        strcpy(employee_list->edit_name, employee->name);
+        strcpy(employee_list->edit_email, employee->email);
+        strcpy(employee_list->edit_phone, employee->phone);
+        strcpy(employee_list->edit_address, employee->address);
+    }
+
     // Display edit fields to edit employee entries.
     nk_layout_row_template_begin(ctx, ENTERPRISE_WIDGET_HEIGHT);
     nk_layout_row_template_push_static(ctx, 150);
     nk_layout_row_template_push_dynamic(ctx);
     nk_layout_row_template_end(ctx);
 
+    char id_text[ENTERPRISE_ID_TEXT_LENGTH];
+    enterprise_id_format(employee->id, id_text);
     nk_label(ctx, "ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_READ_ONLY, \
-    employee->id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Name: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    employee->name, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    employee_list->edit_name, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Phone: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    employee->phone, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    employee_list->edit_phone, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Email: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    employee->email, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    employee_list->edit_email, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Address: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    employee->address, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    employee_list->edit_address, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+
+    // Store any edits back into the employee, and note them in the journal.
+    bool edited = string_pool_assign(employee_list->string_pool, \
+    &employee->name, employee_list->edit_name);
+    edited |= string_pool_assign(employee_list->string_pool, \
+    &employee->email, employee_list->edit_email);
+    edited |= string_pool_assign(employee_list->string_pool, \
+    &employee->phone, employee_list->edit_phone);
+    edited |= string_pool_assign(employee_list->string_pool, \
+    &employee->address, employee_list->edit_address);
+    if (edited) {
+        employee_list->version++;
+        employee_list_index_node(employee_list, employee);
+        journal_put(employee_list->journal, journal_list_employees, \
+        ENTERPRISE_ID_NONE, employee->id);
+    }
 
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
     if (nk_button_label(ctx, "Facilities")) {
         if (employee->employee_facility_list == NULL) {
-            employee->employee_facility_list = employee_facility_list_new();
+            employee->employee_facility_list = employee_facility_list_new\
+            (employee_list->journal, employee_list->facility_references, \
+            employee->id);
         }
         return program_status_employee_facility_table;
     }
@@ -482,4 +571,6 @@ struct employee_list* employee_list) {
     }
     
     return program_status_employee_editor;
-}
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_STRING_POOL
+#define ENTERPRISE_STRING_POOL
+#include "string_pool.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+#ifndef ENTERPRISE_FACILITY_REFERENCES
+#define ENTERPRISE_FACILITY_REFERENCES
+#include "facility_references.h"
+#endif
+
+#ifndef ENTERPRISE_JOURNAL
+#define ENTERPRISE_JOURNAL
+#include "journal.h"
+#endif
+
+#ifndef ENTERPRISE_ROW_LABELS
+#define ENTERPRISE_ROW_LABELS
+#include "row_labels.h"
+#endif
+
+#ifndef ENTERPRISE_TEXT_INDEX
+#define ENTERPRISE_TEXT_INDEX
+#include "text_index.h"
+#endif
+
+#ifndef PROGRAM_STATES
+#define PROGRAM_STATES
+#include "program_states.h"
+#endif
+
+#ifndef ENTERPRISE_EMPLOYEE_FACILITIES
+#define ENTERPRISE_EMPLOYEE_FACILITIES
+#include "employee_facilities.h"
+#endif
+
+// Nuklear's context, taken by the GUI functions. Only the sources of
+// those functions import Nuklear itself.
+struct nk_context;
+
+/* How employees work.
+An employee has a name and contact details, and the facilities they work at
+(see employee_facilities.c). The employee list is laid out like every other
+list of the enterprise (see record_store.c). Its table can be searched by
+name, email, phone and address through a trigram index (see text_index.c).
+
+Data structures:
+employee_node: An employee.
+employee_list: The employees of the enterprise.
+*/
+
+struct employee_node {
+    enterprise_id id;
+    const char* name;
+    const char* email;
+    const char* phone;
+    const char* address;
+
+    struct employee_facility_list* employee_facility_list;
+};
+
+// Employee list metadata structure.
+struct employee_list {
+    struct record_store store;
+    struct id_index id_index;
+    struct string_pool* string_pool;
+
+    // Where changes to the list are recorded, or NULL if they are not.
+    struct journal* journal;
+
+    // The facility references that the facilities of the list's employees
+    // are counted in, or NULL if they are not.
+    struct facility_references* facility_references;
+
+    // Bumped whenever a node is appended, edited or deleted, so that the
+    // labels cached for the list's table know when they are stale.
+    uint64_t version;
+    struct row_labels row_labels;
+
+    // The search box of the list's table, and the index used to search it.
+    struct text_search search;
+    struct text_index text_index;
+
+    // Editable copies of the text of the node open in the editor.
+    enterprise_id edit_id;
+    char edit_name[ENTERPRISE_STRING_LENGTH];
+    char edit_email[ENTERPRISE_STRING_LENGTH];
+    char edit_phone[ENTERPRISE_STRING_LENGTH];
+    char edit_address[ENTERPRISE_STRING_LENGTH];
+
+    enterprise_id id_last_assigned;
+    enterprise_id id_currently_selected;
+    uint32_t handle_currently_selected;
+    bool deletion_requested;
+};
+
+struct employee_node *employee_node_new(struct record_store* store);
+void employee_node_free(struct string_pool* string_pool,\
+struct record_store* store, struct employee_node* employee);
+struct employee_list* employee_list_new(struct string_pool* string_pool);
+void employee_list_free(struct employee_list* employee_list);
+void employee_list_append(struct employee_list* employee_list);
+int employee_list_get_num_employee_nodes(struct employee_list* employee_list);
+bool employee_list_reserve(struct employee_list* employee_list, \
+uint32_t count);
+struct employee_node *employee_list_get_node\
+(struct employee_list *employee_list, enterprise_id id);
+struct employee_node *employee_list_get_selected_node\
+(struct employee_list *employee_list);
+void employee_list_delete_node\
+(struct employee_list *employee_list, enterprise_id id);
+void employee_list_select_previous_node(struct employee_list *employee_list);
+void employee_list_select_next_node(struct employee_list *employee_list);
+void employee_list_set_selected_id\
+(struct employee_list *employee_list, enterprise_id id);
+void employee_list_index_node(struct employee_list* employee_list, \
+struct employee_node* employee);
+bool employee_node_matches(struct employee_node* employee, const char* query);
+bool employee_list_search(struct employee_list* employee_list);
+void employee_list_label_rows(struct employee_list* employee_list, \
+uint32_t first_row, uint32_t row_count);
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+enum program_status employee_table(struct nk_context* ctx,\
+struct employee_list* employee_list);
+enum program_status employee_editor(struct nk_context* ctx,\
+struct employee_list* employee_list);
+#endif
@@ -1,4 +1,3 @@
-
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -8,59 +7,80 @@
 #include <assert.h>
 #include <limits.h>
 #include <time.h>
+#if !defined(_WIN32)
+    #include <unistd.h>
+#endif
 
-// Import Nuklear.
-#ifndef ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
+// Import Nuklear, unless building without the GUI.
+#if !defined(ENTERPRISE_NUKLEAR_LIBRARY_IMPORT) \
+&& !defined(ENTERPRISE_HEADLESS)
 #define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-    #define NK_INCLUDE_FIXED_TYPES
-    #define NK_INCLUDE_STANDARD_IO
-    #define NK_INCLUDE_STANDARD_VARARGS
-    #define NK_INCLUDE_DEFAULT_ALLOCATOR
-    #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    #define NK_INCLUDE_FONT_BAKING
-    #define NK_INCLUDE_DEFAULT_FONT
-    #define NK_IMPLEMENTATION
-    #define NK_SDL_GLES2_IMPLEMENTATION
-    #include "../third_party/Nuklear/nuklear.h"
-    #include "../third_party/Nuklear/demo/sdl_opengles2/nuklear_sdl_gles2.h"
-    #include "../third_party/Nuklear/demo/common/style.c"
+#include "nuklear_import.h"
 #endif
 
-#ifndef PROGRAM_STATES
-#define PROGRAM_STATES
-#include "program_states.c"
+#ifndef ENTERPRISE_DATABASE
+#define ENTERPRISE_DATABASE
+#include "enterprise.h"
 #endif
 
-#ifndef ENTERPRISE_LIBRARIES
-#define ENTERPRISE_LIBRARIES
-#include "constants.c"
-#include "facilities.c"
-#include "employees.c"
-#include "inventory.c"
-#include "customers.c"
-#include "suppliers.c"
-#include "expenses.c"
-#include "orders.c"
-#endif
+// The lists of an enterprise, in the order they are saved.
+const char* const enterprise_list_names[ENTERPRISE_LIST_COUNT] = \
+{"facilities", "employees", "items", "customers", "suppliers", "expenses", \
+"orders"};
 
-/* What does this file do?
-It provides the enterprise data structure, which holds all the data related to
-the enterprise. It stores lists of everything needed in an enterprise.
-*/
+// Add every reference to a facility in an enterprise to references: the
+// facilities of each employee and item, and the facility of each expense.
+// Runs when the facility list's references are first needed.
+// Returns true on success, or false on failure.
+static bool enterprise_gather_facility_references\
+(void* context, struct facility_references* references) {
+    struct enterprise* enterprise = context;
 
-// The enterprise struct.
-// This holds all relevant database information about the enterprise.
-struct enterprise {
-    char name[ENTERPRISE_STRING_LENGTH];
-    char balance[ENTERPRISE_STRING_LENGTH];
-    struct facility_list* facility_list;
-    struct employee_list* employee_list;
-    struct item_list* item_list;
-    struct customer_list* customer_list;
-    struct supplier_list* supplier_list;
-    struct expense_list* expense_list;
-    struct order_list* order_list;
-};
+    struct employee_node* employee = \
+    record_store_first(&enterprise->employee_list->store);
+    while (employee != NULL) {
+        struct employee_facility_list* employee_facility_list = \
+        employee->employee_facility_list;
+        struct employee_facility_node* employee_facility = \
+        employee_facility_list == NULL ? NULL : \
+        record_store_first(&employee_facility_list->store);
+        while (employee_facility != NULL) {
+            if (facility_references_add(references, \
+            employee_facility->facility_id, facility_reference_employee, \
+            employee->id) == false) return false;
+            employee_facility = record_store_next\
+            (&employee_facility_list->store, employee_facility);
+        }
+        employee = \
+        record_store_next(&enterprise->employee_list->store, employee);
+    }
+
+    struct item_node* item = record_store_first(&enterprise->item_list->store);
+    while (item != NULL) {
+        struct item_facility_list* item_facility_list = \
+        item->item_facility_list;
+        struct item_facility_node* item_facility = \
+        item_facility_list == NULL ? NULL : \
+        record_store_first(&item_facility_list->store);
+        while (item_facility != NULL) {
+            if (facility_references_add(references, \
+            item_facility->facility_id, facility_reference_item, item->id) \
+            == false) return false;
+            item_facility = record_store_next\
+            (&item_facility_list->store, item_facility);
+        }
+        item = record_store_next(&enterprise->item_list->store, item);
+    }
+
+    struct expense_node* expense = \
+    record_store_first(&enterprise->expense_list->store);
+    while (expense != NULL) {
+        if (facility_references_add(references, expense->facility_id, \
+        facility_reference_expense, expense->id) == false) return false;
+        expense = record_store_next(&enterprise->expense_list->store, expense);
+    }
+    return true;
+}
 
 // Enterprise instance constructor.
 // Returns pointer to enterprise on success, else returns NULL.
@@ -69,20 +89,214 @@ struct enterprise* enterprise_new() {
     if (enterprise == NULL) return NULL;
 
     strcpy(enterprise->name, "");
-    strcpy(enterprise->balance, "");
-    enterprise->facility_list = facility_list_new();
-    enterprise->employee_list = employee_list_new();
-    enterprise->item_list = item_list_new();
-    enterprise->customer_list = customer_list_new();
-    enterprise->supplier_list = supplier_list_new();
+    enterprise->balance = 0;
+    enterprise_cents_format(0, enterprise->edit_balance);
+    enterprise->edit_balance_value = 0;
+    strcpy(enterprise->file_path, ENTERPRISE_DATABASE_FILE);
+    enterprise->journal = NULL;
+    enterprise->generation = 0;
+    strcpy(enterprise->snapshot_path, "");
+    memset(&enterprise->load_times, 0, \
+    sizeof(struct enterprise_load_times));
+    enterprise->export_table = export_table_facilities;
+    enterprise->export_format = export_format_csv;
+
+    // Text fields of every list are kept in one shared string pool.
+    enterprise->string_pool = string_pool_new();
+    if (enterprise->string_pool == NULL) {free(enterprise); return NULL;}
+
+    enterprise->facility_list = facility_list_new(enterprise->string_pool);
+    enterprise->employee_list = employee_list_new(enterprise->string_pool);
+    enterprise->item_list = item_list_new(enterprise->string_pool);
+    enterprise->customer_list = customer_list_new(enterprise->string_pool);
+    enterprise->supplier_list = supplier_list_new(enterprise->string_pool);
     enterprise->expense_list = expense_list_new();
     enterprise->order_list = order_list_new();
+
+    // The lists that refer to facilities keep the facility list's references
+    // up to date, which are gathered from the whole enterprise when built.
+    if (enterprise->facility_list != NULL) {
+        struct facility_references* references = \
+        &enterprise->facility_list->references;
+        facility_references_init(references, \
+        enterprise_gather_facility_references, enterprise);
+        if (enterprise->employee_list != NULL) {
+            enterprise->employee_list->facility_references = references;
+        }
+        if (enterprise->item_list != NULL) {
+            enterprise->item_list->facility_references = references;
+        }
+        if (enterprise->expense_list != NULL) {
+            enterprise->expense_list->facility_references = references;
+        }
+    }
     return enterprise;
 }
 
-// Frees memory associated with enterprise.
+// Record changes to every list of the enterprise in journal, or stop recording
+// them if journal is NULL. Does not close the previous journal.
+void enterprise_set_journal\
+(struct enterprise* enterprise, struct journal* journal) {
+    enterprise->journal = journal;
+    enterprise->facility_list->journal = journal;
+    enterprise->employee_list->journal = journal;
+    enterprise->item_list->journal = journal;
+    enterprise->customer_list->journal = journal;
+    enterprise->supplier_list->journal = journal;
+    enterprise->expense_list->journal = journal;
+    enterprise->order_list->journal = journal;
+
+    struct employee_node* employee = \
+    record_store_first(&enterprise->employee_list->store);
+    while (employee != NULL) {
+        if (employee->employee_facility_list != NULL) {
+            employee->employee_facility_list->journal = journal;
+        }
+        employee = \
+        record_store_next(&enterprise->employee_list->store, employee);
+    }
+    struct item_node* item = record_store_first(&enterprise->item_list->store);
+    while (item != NULL) {
+        if (item->item_facility_list != NULL) {
+            item->item_facility_list->journal = journal;
+        }
+        item = record_store_next(&enterprise->item_list->store, item);
+    }
+}
+
+// Remove one reference to the facility with ID facility_id from the node
+// that holds it: the employee stops working at the facility, the item's stock
+// there is removed, or the expense is left without a facility.
+static void enterprise_unlink_facility(struct enterprise* enterprise, \
+enterprise_id facility_id, struct facility_reference reference) {
+    if (reference.type == facility_reference_employee) {
+        struct employee_node* employee = \
+        employee_list_get_node(enterprise->employee_list, reference.owner_id);
+        if (employee == NULL) return;
+        struct employee_facility_node* employee_facility = \
+        employee_facility_list_get_node_by_facility_id\
+        (employee->employee_facility_list, facility_id);
+        if (employee_facility == NULL) return;
+        employee_facility_list_delete_node(employee->employee_facility_list, \
+        employee_facility->id);
+    }
+    else if (reference.type == facility_reference_item) {
+        struct item_node* item = \
+        item_list_get_node(enterprise->item_list, reference.owner_id);
+        if (item == NULL) return;
+        struct item_facility_node* item_facility = \
+        item_facility_list_get_node_by_facility_id\
+        (item->item_facility_list, facility_id);
+        if (item_facility == NULL) return;
+        item_facility_list_delete_node(item->item_facility_list, \
+        item_facility->id);
+    }
+    else if (reference.type == facility_reference_expense) {
+        expense_list_set_facility(enterprise->expense_list, \
+        expense_list_get_node(enterprise->expense_list, reference.owner_id), \
+        ENTERPRISE_ID_NONE);
+    }
+}
+
+// Delete the facility with ID facility_id from an enterprise along with every
+// reference to it, found through the facility list's references: it is taken
+// off the facilities of its employees and items, and its expenses are left
+// without a facility. Only the facility's own references are visited.
+// Returns true on success, or false if the references can not be built, in
+// which case nothing is deleted.
+bool enterprise_delete_facility\
+(struct enterprise* enterprise, enterprise_id facility_id) {
+    if (enterprise == NULL) return false;
+    struct facility_references* references = \
+    &enterprise->facility_list->references;
+    if (facility_references_build(references) == false) return false;
+
+    // The facility's references are detached before its nodes are unlinked,
+    // so unlinking a node does not search them for its reference.
+    struct facility_reference_set set;
+    facility_references_detach(references, facility_id, &set);
+    for (uint32_t index = 0; index < set.count; index++) {
+        enterprise_unlink_facility(enterprise, facility_id, \
+        set.references[index]);
+    }
+    facility_reference_set_free(&set);
+
+    facility_list_delete_node(enterprise->facility_list, facility_id);
+    return true;
+}
+
+// Write a journal entry for a change to the enterprise.
+static void enterprise_write_change\
+(struct enterprise* enterprise, const struct journal_change* change) {
+    struct journal* journal = enterprise->journal;
+    if (change->operation == journal_operation_delete) {
+        journal_write_entry(journal, change, NULL, 0);
+        return;
+    }
+
+    if (change->list == journal_list_enterprise) {
+        struct snapshot_enterprise record;
+        memset(&record, 0, sizeof(struct snapshot_enterprise));
+        record.name = journal_text(journal, enterprise->name);
+        record.balance = enterprise->balance;
+        journal_write_entry(journal, change, &record, \
+        sizeof(struct snapshot_enterprise));
+    }
+    if (change->list == journal_list_facilities) {
+        journal_write_facility(journal, change, enterprise->facility_list);
+    }
+    if (change->list == journal_list_employees) {
+        journal_write_employee(journal, change, enterprise->employee_list);
+    }
+    if (change->list == journal_list_employee_facilities) {
+        journal_write_employee_facility(journal, change, \
+        enterprise->employee_list);
+    }
+    if (change->list == journal_list_items) {
+        journal_write_item(journal, change, enterprise->item_list);
+    }
+    if (change->list == journal_list_item_facilities) {
+        journal_write_item_facility(journal, change, enterprise->item_list);
+    }
+    if (change->list == journal_list_customers) {
+        journal_write_customer(journal, change, enterprise->customer_list);
+    }
+    if (change->list == journal_list_suppliers) {
+        journal_write_supplier(journal, change, enterprise->supplier_list);
+    }
+    if (change->list == journal_list_expenses) {
+        journal_write_expense(journal, change, enterprise->expense_list);
+    }
+    if (change->list == journal_list_orders) {
+        journal_write_order(journal, change, enterprise->order_list);
+    }
+}
+
+// Commit the changes waiting in the enterprise's journal.
+// Returns true on success, or false on failure.
+bool enterprise_commit(struct enterprise* enterprise) {
+    if (enterprise == NULL || enterprise->journal == NULL) return false;
+    struct journal* journal = enterprise->journal;
+    for (uint32_t change = 0; change < journal->change_count; change++) {
+        enterprise_write_change(enterprise, &journal->changes[change]);
+    }
+    return journal_commit(journal);
+}
+
+// Frees memory associated with enterprise. Changes waiting in the journal are
+// committed first.
 void enterprise_quit(struct enterprise* enterprise) {
     if (enterprise == NULL) return;
+    if (enterprise->journal != NULL) {
+        if (enterprise_commit(enterprise) == false) {
+            printf("Failed to write journal of '%s'.\n", 
+            enterprise->snapshot_path);
+        }
+        journal_close(enterprise->journal);
+    }
+    // The string pool is freed right after the lists, so drop it first and
+    // let the lists skip giving their text back.
+    string_pool_drop(enterprise->string_pool);
     if (enterprise->facility_list != NULL) 
         {facility_list_free(enterprise->facility_list);}
     if (enterprise->employee_list != NULL) 
@@ -97,10 +311,549 @@ void enterprise_quit(struct enterprise* enterprise) {
         {expense_list_free(enterprise->expense_list);}
     if (enterprise->order_list != NULL) 
         {order_list_free(enterprise->order_list);}
+
+    // Free the string pool last, as the lists still point into it.
+    string_pool_free(enterprise->string_pool);
     free(enterprise);
     return;
 }
 
+// Write the path of the journal belonging to the snapshot at path into a
+// buffer of ENTERPRISE_JOURNAL_PATH_LENGTH characters.
+void enterprise_journal_path(const char* path, char* journal_path) {
+    snprintf(journal_path, ENTERPRISE_JOURNAL_PATH_LENGTH, "%s.journal", path);
+}
+
+// Start recording changes to the enterprise in the journal belonging to the
+// snapshot at path, closing the journal used until now. The journal is
+// started again empty if truncate is true.
+// Returns true on success, or false on failure.
+bool enterprise_start_journal\
+(struct enterprise* enterprise, const char* path, bool truncate) {
+    if (enterprise == NULL || path == NULL) return false;
+    journal_close(enterprise->journal);
+    enterprise_set_journal(enterprise, NULL);
+    snprintf(enterprise->snapshot_path, ENTERPRISE_STRING_LENGTH, "%s", path);
+
+    char journal_path[ENTERPRISE_JOURNAL_PATH_LENGTH];
+    enterprise_journal_path(path, journal_path);
+    struct journal* journal = \
+    journal_open(journal_path, truncate, enterprise->generation);
+    if (journal == NULL) {
+        printf("Failed to open journal '%s', changes will only be kept by "
+        "saving.\n", journal_path);
+        return false;
+    }
+    enterprise_set_journal(enterprise, journal);
+    return true;
+}
+
+// Save the whole enterprise to a snapshot file at path. The snapshot is
+// written next to the file first and moved over it once complete, so a failed
+// save never destroys the previous one. Saving compacts the journal.
+// Each list written is noted in progress, unless it is NULL.
+// Returns true on success, or false on failure.
+bool enterprise_save(struct enterprise* enterprise, const char* path, \
+struct worker_pool_progress* progress) {
+    if (enterprise == NULL || path == NULL) return false;
+    worker_pool_progress_begin(progress, ENTERPRISE_LIST_COUNT * 2);
+    char temporary_path[ENTERPRISE_STRING_LENGTH + 8];
+    snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", path);
+
+    FILE* file = fopen(temporary_path, "wb");
+    if (file == NULL) return false;
+    struct snapshot_writer writer;
+    if (snapshot_writer_init(&writer, file) == false) {
+        fclose(file);
+        remove(temporary_path);
+        return false;
+    }
+    uint64_t generation = snapshot_next_generation(enterprise->generation);
+    writer.generation = generation;
+
+    // The first pass collects text into the string table, the second writes.
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) snapshot_write_header(&writer);
+
+        struct snapshot_enterprise record;
+        memset(&record, 0, sizeof(struct snapshot_enterprise));
+        record.name = snapshot_text(&writer, enterprise->name);
+        record.balance = enterprise->balance;
+        snapshot_write_section(&writer, snapshot_tag_enterprise, \
+        sizeof(struct snapshot_enterprise), 1, ENTERPRISE_ID_NONE);
+        snapshot_write(&writer, &record, sizeof(struct snapshot_enterprise));
+
+        snapshot_write_facility_list(&writer, enterprise->facility_list);
+        worker_pool_progress_add(progress, 1);
+        snapshot_write_employee_list(&writer, enterprise->employee_list);
+        worker_pool_progress_add(progress, 1);
+        snapshot_write_item_list(&writer, enterprise->item_list);
+        worker_pool_progress_add(progress, 1);
+        snapshot_write_customer_list(&writer, enterprise->customer_list);
+        worker_pool_progress_add(progress, 1);
+        snapshot_write_supplier_list(&writer, enterprise->supplier_list);
+        worker_pool_progress_add(progress, 1);
+        snapshot_write_expense_list(&writer, enterprise->expense_list);
+        worker_pool_progress_add(progress, 1);
+        snapshot_write_order_list(&writer, enterprise->order_list);
+        worker_pool_progress_add(progress, 1);
+    }
+    snapshot_flush(&writer);
+    bool saved = writer.failed == false && fflush(file) == 0;
+    #if !defined(_WIN32)
+        if (saved) saved = fsync(fileno(file)) == 0;
+    #endif
+    snapshot_writer_free(&writer);
+    if (fclose(file) != 0) saved = false;
+
+    if (saved) saved = rename(temporary_path, path) == 0;
+    if (saved == false) remove(temporary_path);
+    else enterprise->generation = generation;
+
+    // Everything in the journal is in the snapshot now, so start the journal
+    // again empty next to the snapshot.
+    if (saved && enterprise->journal != NULL) {
+        enterprise_start_journal(enterprise, path, true);
+    }
+    return saved;
+}
+
+// Export one table of the enterprise to file in format. The file is left open.
+// The records written are noted in progress, unless it is NULL.
+// Returns true if the whole table was written, or false on failure.
+bool enterprise_export(struct enterprise* enterprise, enum export_table table, \
+enum export_format format, FILE* file, struct worker_pool_progress* progress) {
+    if (enterprise == NULL || file == NULL) return false;
+    struct export_writer writer;
+    if (export_writer_init(&writer, file, format) == false) return false;
+    writer.progress = progress;
+
+    switch (table) {
+        case export_table_facilities:
+            export_facility_list(&writer, enterprise->facility_list);
+            break;
+        case export_table_employees:
+            export_employee_list(&writer, enterprise->employee_list);
+            break;
+        case export_table_employee_facilities:
+            export_employee_facilities(&writer, enterprise->employee_list);
+            break;
+        case export_table_items:
+            export_item_list(&writer, enterprise->item_list);
+            break;
+        case export_table_item_facilities:
+            export_item_facilities(&writer, enterprise->item_list);
+            break;
+        case export_table_customers:
+            export_customer_list(&writer, enterprise->customer_list);
+            break;
+        case export_table_suppliers:
+            export_supplier_list(&writer, enterprise->supplier_list);
+            break;
+        case export_table_expenses:
+            export_expense_list(&writer, enterprise->expense_list);
+            break;
+        case export_table_orders:
+            export_order_list(&writer, enterprise->order_list);
+            break;
+        default:
+            export_writer_free(&writer);
+            return false;
+    }
+    bool exported = export_end_table(&writer);
+    export_writer_free(&writer);
+    return exported;
+}
+
+// Export one table of the enterprise to a new file at path in format.
+// The records written are noted in progress, unless it is NULL.
+// Returns true on success, or false on failure.
+bool enterprise_export_file(struct enterprise* enterprise, \
+enum export_table table, enum export_format format, const char* path, \
+struct worker_pool_progress* progress) {
+    if (enterprise == NULL || path == NULL) return false;
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return false;
+    bool exported = \
+    enterprise_export(enterprise, table, format, file, progress);
+    if (fclose(file) != 0) exported = false;
+    if (exported == false) remove(path);
+    return exported;
+}
+
+// Load one list of an enterprise from its own reader of the snapshot.
+// Runs as a worker pool job.
+static void enterprise_load_list(void* data) {
+    struct enterprise_load_job* job = data;
+    struct enterprise* enterprise = job->enterprise;
+    double start = worker_pool_clock();
+    job->loaded = false;
+    FILE* file = fopen(job->path, "rb");
+    if (file == NULL) return;
+    struct snapshot_reader reader;
+    if (snapshot_reader_init(&reader, file, enterprise->string_pool) \
+    == false) {
+        fclose(file);
+        return;
+    }
+    if (job->strings != NULL) {
+        snapshot_reader_share_strings(&reader, job->strings);
+    }
+
+    bool loaded = snapshot_reader_seek(&reader, job->offset);
+    switch (job->list) {
+        case 0:
+            loaded = loaded && \
+            snapshot_read_facility_list(&reader, enterprise->facility_list);
+            break;
+        case 1:
+            loaded = loaded && \
+            snapshot_read_employee_list(&reader, enterprise->employee_list);
+            break;
+        case 2:
+            loaded = loaded && \
+            snapshot_read_item_list(&reader, enterprise->item_list);
+            break;
+        case 3:
+            loaded = loaded && \
+            snapshot_read_customer_list(&reader, enterprise->customer_list);
+            break;
+        case 4:
+            loaded = loaded && \
+            snapshot_read_supplier_list(&reader, enterprise->supplier_list);
+            break;
+        case 5:
+            loaded = loaded && \
+            snapshot_read_expense_list(&reader, enterprise->expense_list);
+            break;
+        case 6:
+            loaded = loaded && \
+            snapshot_read_order_list(&reader, enterprise->order_list);
+            break;
+        default:
+            loaded = false;
+    }
+    job->loaded = loaded && reader.failed == false;
+    snapshot_reader_free(&reader);
+    fclose(file);
+    job->seconds = worker_pool_clock() - start;
+    worker_pool_progress_add(job->progress, 1);
+}
+
+// Load a whole enterprise from a snapshot file at path.
+// Every list is read on its own thread with its own reader of the file. Lists
+// without text start straight away, and the rest once the string table has
+// been read, as they refer to its strings. The string table and each list
+// loaded are noted in progress, unless it is NULL.
+// Returns pointer to the loaded enterprise on success, or NULL on failure.
+struct enterprise* enterprise_load\
+(const char* path, struct worker_pool_progress* progress) {
+    if (path == NULL) return NULL;
+    double start = worker_pool_clock();
+    worker_pool_progress_begin(progress, ENTERPRISE_LIST_COUNT + 1);
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+
+    struct enterprise* enterprise = enterprise_new();
+    struct snapshot_reader reader;
+    if (enterprise == NULL || snapshot_reader_init(&reader, file, \
+    enterprise->string_pool) == false) {
+        enterprise_quit(enterprise);
+        fclose(file);
+        return NULL;
+    }
+
+    uint64_t offsets[SNAPSHOT_TAG_COUNT];
+    const uint32_t tags[ENTERPRISE_LIST_COUNT] = {snapshot_tag_facilities, \
+    snapshot_tag_employees, snapshot_tag_items, snapshot_tag_customers, \
+    snapshot_tag_suppliers, snapshot_tag_expenses, snapshot_tag_orders};
+    const bool has_text[ENTERPRISE_LIST_COUNT] = \
+    {true, true, true, true, true, false, false};
+    struct enterprise_load_job jobs[ENTERPRISE_LIST_COUNT];
+    bool loaded = snapshot_find_sections(&reader, offsets);
+    for (uint32_t list = 0; list < ENTERPRISE_LIST_COUNT; list++) {
+        jobs[list].enterprise = enterprise;
+        jobs[list].list = list;
+        jobs[list].path = path;
+        jobs[list].offset = offsets[tags[list]];
+        jobs[list].strings = has_text[list] ? &reader : NULL;
+        jobs[list].progress = progress;
+        jobs[list].loaded = false;
+        jobs[list].seconds = 0.0;
+    }
+
+    struct worker_pool pool;
+    // A single core only loses time switching between threads.
+    uint32_t threads = worker_pool_cores();
+    if (threads > ENTERPRISE_LIST_COUNT) threads = ENTERPRISE_LIST_COUNT;
+    if (threads == 1) threads = 0;
+    worker_pool_init(&pool, loaded ? threads : 0);
+    for (uint32_t list = 0; loaded && list < ENTERPRISE_LIST_COUNT; list++) {
+        if (has_text[list] == false) {
+            worker_pool_submit(&pool, enterprise_load_list, &jobs[list]);
+        }
+    }
+
+    struct snapshot_section section;
+    struct snapshot_enterprise record;
+    double strings_start = worker_pool_clock();
+    loaded = loaded && snapshot_read_header(&reader);
+    enterprise->load_times.strings = worker_pool_clock() - strings_start;
+    worker_pool_progress_add(progress, 1);
+    loaded = loaded && \
+    snapshot_read_section(&reader, &section, snapshot_tag_enterprise, \
+    sizeof(struct snapshot_enterprise)) && section.count == 1 && \
+    snapshot_read(&reader, &record, sizeof(struct snapshot_enterprise));
+    if (loaded) {
+        snapshot_read_text_into(&reader, record.name, enterprise->name);
+        enterprise->balance = record.balance;
+        enterprise->generation = reader.generation;
+        snprintf(enterprise->file_path, ENTERPRISE_STRING_LENGTH, "%s", path);
+    }
+
+    for (uint32_t list = 0; loaded && list < ENTERPRISE_LIST_COUNT; list++) {
+        if (has_text[list]) {
+            worker_pool_submit(&pool, enterprise_load_list, &jobs[list]);
+        }
+    }
+    worker_pool_wait(&pool);
+    enterprise->load_times.threads = pool.thread_count;
+    worker_pool_free(&pool);
+    for (uint32_t list = 0; list < ENTERPRISE_LIST_COUNT; list++) {
+        loaded = loaded && jobs[list].loaded;
+        enterprise->load_times.lists[list] = jobs[list].seconds;
+    }
+    loaded = loaded && reader.failed == false;
+
+    snapshot_reader_free(&reader);
+    fclose(file);
+    if (loaded == false) {
+        enterprise_quit(enterprise);
+        return NULL;
+    }
+    enterprise->load_times.total = worker_pool_clock() - start;
+    return enterprise;
+}
+
+// Print how long loading the enterprise's snapshot took, if it was loaded.
+void enterprise_print_load_times(struct enterprise* enterprise) {
+    if (enterprise == NULL || enterprise->load_times.total <= 0.0) return;
+    struct enterprise_load_times* times = &enterprise->load_times;
+    printf("Loaded '%s' in %.1f ms", enterprise->file_path, \
+    times->total * 1000.0);
+    if (times->threads > 0) printf(" on %u threads", times->threads);
+    printf(".\n");
+    printf("  %-12s %8.1f ms\n", "strings", times->strings * 1000.0);
+    for (uint32_t list = 0; list < ENTERPRISE_LIST_COUNT; list++) {
+        printf("  %-12s %8.1f ms\n", enterprise_list_names[list], \
+        times->lists[list] * 1000.0);
+    }
+}
+
+// Apply a journal entry to the enterprise.
+// Returns true on success, or false if the entry is damaged.
+static bool enterprise_apply_entry(struct enterprise* enterprise, \
+const struct journal_replay_entry* entry) {
+    uint32_t list = entry->header.list;
+    if (entry->header.operation != journal_operation_put && \
+    entry->header.operation != journal_operation_delete) return false;
+
+    if (list == journal_list_enterprise) {
+        struct snapshot_enterprise record;
+        if (entry->header.operation != journal_operation_put || \
+        journal_entry_record(entry, &record, \
+        sizeof(struct snapshot_enterprise)) == false) return false;
+        const char* name = journal_entry_text(entry, record.name);
+        if (name == NULL) return false;
+        snprintf(enterprise->name, ENTERPRISE_STRING_LENGTH, "%s", name);
+        enterprise->balance = record.balance;
+        return true;
+    }
+    if (list == journal_list_facilities) {
+        return journal_apply_facility(enterprise->facility_list, entry);
+    }
+    if (list == journal_list_employees) {
+        return journal_apply_employee(enterprise->employee_list, entry);
+    }
+    if (list == journal_list_employee_facilities) {
+        return journal_apply_employee_facility\
+        (enterprise->employee_list, entry);
+    }
+    if (list == journal_list_items) {
+        return journal_apply_item(enterprise->item_list, entry);
+    }
+    if (list == journal_list_item_facilities) {
+        return journal_apply_item_facility(enterprise->item_list, entry);
+    }
+    if (list == journal_list_customers) {
+        return journal_apply_customer(enterprise->customer_list, entry);
+    }
+    if (list == journal_list_suppliers) {
+        return journal_apply_supplier(enterprise->supplier_list, entry);
+    }
+    if (list == journal_list_expenses) {
+        return journal_apply_expense(enterprise->expense_list, entry);
+    }
+    if (list == journal_list_orders) {
+        return journal_apply_order(enterprise->order_list, entry);
+    }
+    return false;
+}
+
+// Replay the journal at journal_path onto the enterprise. A journal that
+// belongs to another snapshot than the enterprise was loaded from is ignored.
+// Returns true if the whole journal was replayed, or false if it ends in a
+// damaged entry.
+bool enterprise_replay\
+(struct enterprise* enterprise, const char* journal_path) {
+    if (enterprise == NULL || journal_path == NULL) return false;
+    struct journal_reader reader;
+    if (journal_reader_open(&reader, journal_path, enterprise->generation) \
+    == false) return true;
+
+    struct journal_replay_entry entry;
+    while (journal_read_entry(&reader, &entry)) {
+        if (enterprise_apply_entry(enterprise, &entry) == false) {
+            reader.damaged = true;
+            break;
+        }
+    }
+    bool replayed = reader.damaged == false;
+    journal_reader_free(&reader);
+    return replayed;
+}
+
+// Returns true if a file can be opened for reading at path.
+static bool enterprise_file_exists(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return false;
+    fclose(file);
+    return true;
+}
+
+// Open the enterprise kept at path: load its snapshot, if there is one yet,
+// replay its journal on top and record further changes in the journal.
+// If neither the snapshot nor its journal exist, a new enterprise is started
+// at path when create is set, and nothing is opened otherwise.
+// Loading the snapshot is noted in progress, unless it is NULL.
+// Returns pointer to the enterprise on success, or NULL on failure.
+struct enterprise* enterprise_open\
+(const char* path, bool create, struct worker_pool_progress* progress) {
+    if (path == NULL) return NULL;
+    char journal_path[ENTERPRISE_JOURNAL_PATH_LENGTH];
+    enterprise_journal_path(path, journal_path);
+    struct enterprise* enterprise = enterprise_load(path, progress);
+    if (enterprise == NULL) {
+        // Never replace a snapshot that is there but can not be loaded.
+        if (enterprise_file_exists(path)) return NULL;
+        if (create == false && enterprise_file_exists(journal_path) == false) {
+            return NULL;
+        }
+        enterprise = enterprise_new();
+        if (enterprise == NULL) return NULL;
+        snprintf(enterprise->file_path, ENTERPRISE_STRING_LENGTH, "%s", path);
+    }
+
+    if (enterprise_replay(enterprise, journal_path)) {
+        enterprise_start_journal(enterprise, path, false);
+        return enterprise;
+    }
+
+    // New entries can not follow a damaged one, so what could be replayed
+    // is saved and the journal started again.
+    printf("Journal '%s' is damaged, keeping the changes before the damage.\n",
+    journal_path);
+    if (enterprise_save(enterprise, path, NULL)) {
+        enterprise_start_journal(enterprise, path, true);
+    }
+    else printf("Failed to save enterprise to '%s'.\n", path);
+    return enterprise;
+}
+
+// Returns true once the enterprise's journal has grown large or can no longer
+// be written to, so it should be compacted into a snapshot.
+bool enterprise_compaction_due(struct enterprise* enterprise) {
+    if (enterprise == NULL || enterprise->journal == NULL) return false;
+    return enterprise->journal->failed || \
+    enterprise->journal->size > JOURNAL_COMPACT_SIZE;
+}
+
+// Compact the enterprise's journal into its snapshot. If the snapshot can not
+// be saved, journaling stops rather than retrying the save over and over.
+// Each list written is noted in progress, unless it is NULL.
+// Returns true on success, or false on failure.
+bool enterprise_compact\
+(struct enterprise* enterprise, struct worker_pool_progress* progress) {
+    if (enterprise == NULL || enterprise->journal == NULL) return false;
+    if (enterprise_save(enterprise, enterprise->snapshot_path, progress)) {
+        return true;
+    }
+    printf("Failed to save enterprise to '%s', changes will only be kept "
+    "by saving.\n", enterprise->snapshot_path);
+    journal_close(enterprise->journal);
+    enterprise_set_journal(enterprise, NULL);
+    return false;
+}
+
+// Commit the changes in the enterprise's journal once they have waited long
+// enough, given the current time in milliseconds, and compact the journal
+// into a snapshot once it grows large or can no longer be written to.
+void enterprise_tick(struct enterprise* enterprise, uint64_t milliseconds) {
+    if (enterprise == NULL || enterprise->journal == NULL) return;
+    if (journal_due(enterprise->journal, milliseconds)) {
+        enterprise_commit(enterprise);
+    }
+    if (enterprise_compaction_due(enterprise)) {
+        enterprise_compact(enterprise, NULL);
+    }
+}
+
+// Count the records and memory of every type of node in an enterprise.
+// The links between employees or items and facilities are summed over every
+// employee or item.
+void enterprise_get_memory\
+(struct enterprise* enterprise, struct enterprise_memory* memory) {
+    if (enterprise == NULL || memory == NULL) return;
+    memset(memory, 0, sizeof(struct enterprise_memory));
+
+    record_store_add_stats(&enterprise->facility_list->store, \
+    &memory->facilities);
+    record_store_add_stats(&enterprise->employee_list->store, \
+    &memory->employees);
+    struct employee_node* employee = \
+    record_store_first(&enterprise->employee_list->store);
+    while (employee != NULL) {
+        if (employee->employee_facility_list != NULL) {
+            record_store_add_stats(&employee->employee_facility_list->store, \
+            &memory->employee_facilities);
+        }
+        employee = \
+        record_store_next(&enterprise->employee_list->store, employee);
+    }
+    record_store_add_stats(&enterprise->item_list->store, &memory->items);
+    struct item_node* item = record_store_first(&enterprise->item_list->store);
+    while (item != NULL) {
+        if (item->item_facility_list != NULL) {
+            record_store_add_stats(&item->item_facility_list->store, \
+            &memory->item_facilities);
+        }
+        item = record_store_next(&enterprise->item_list->store, item);
+    }
+    record_store_add_stats(&enterprise->customer_list->store, \
+    &memory->customers);
+    record_store_add_stats(&enterprise->supplier_list->store, \
+    &memory->suppliers);
+    record_store_add_stats(&enterprise->expense_list->store, \
+    &memory->expenses);
+    record_store_add_stats(&enterprise->order_list->store, &memory->orders);
+
+    memory->strings = enterprise->string_pool->count;
+    memory->string_bytes = string_pool_get_bytes_used(enterprise->string_pool);
+}
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+
 // Render the enterprise menu GUI.
 enum program_status enterprise_menu\
 (struct nk_context* ctx, struct enterprise* enterprise) {
@@ -114,14 +867,75 @@ enum program_status enterprise_menu\
     nk_layout_row_template_push_dynamic(ctx);
     nk_layout_row_template_end(ctx);
 
+    // Fields are edited in place, so keep copies to tell if they change.
+    char name[ENTERPRISE_STRING_LENGTH];
+    enterprise_cents balance = enterprise->balance;
+    strcpy(name, enterprise->name);
+
     nk_label(ctx, "Name: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, enterprise->name,\
     ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
+    // The balance is typed into its own buffer, which is only written again
+    // when the balance was changed by something else, such as the journal.
+    if (enterprise->edit_balance_value != enterprise->balance) {
+        enterprise_cents_format(enterprise->balance, enterprise->edit_balance);
+        enterprise->edit_balance_value = enterprise->balance;
+    }
     nk_label(ctx, "Balance: ", NK_TEXT_LEFT);
-    nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, enterprise->balance,\
+    nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
+    enterprise->edit_balance, ENTERPRISE_CENTS_TEXT_LENGTH, nk_filter_float);
+    if (enterprise_cents_parse(enterprise->edit_balance, \
+    &enterprise->balance)) {
+        enterprise->edit_balance_value = enterprise->balance;
+    }
+    else {
+        nk_label(ctx, "", NK_TEXT_LEFT);
+        nk_label(ctx, "The balance must be an amount such as 12.34", \
+        NK_TEXT_LEFT);
+    }
+
+    // Note any edits in the journal.
+    if (strcmp(name, enterprise->name) != 0 || \
+    enterprise->balance != balance) {
+        journal_put(enterprise->journal, journal_list_enterprise, \
+        ENTERPRISE_ID_NONE, ENTERPRISE_ID_NONE);
+    }
+
+    nk_label(ctx, "File: ", NK_TEXT_LEFT);
+    nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, enterprise->file_path,\
     ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
+    // Saving, loading and exporting run on a worker thread, and opening a file
+    // read only replaces the menus, so all of them are left to the program
+    // loop.
+    nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 3);
+    if (nk_button_label(ctx, "Save")) {
+        return program_status_enterprise_save;
+    }
+    if (nk_button_label(ctx, "Load")) {
+        return program_status_enterprise_load;
+    }
+    if (nk_button_label(ctx, "Open Read Only")) {
+        return program_status_snapshot_map_open;
+    }
+
+    // Exports are written to the working directory, named after the table.
+    // See export_table_names.
+    const char* tables[] = {"Facilities", "Employees", "Employee Facilities", \
+    "Items", "Item Facilities", "Customers", "Suppliers", "Expenses", \
+    "Orders"};
+    const char* formats[] = {"CSV", "JSON"};
+    enterprise->export_table = (enum export_table)nk_combo(ctx, tables, \
+    NK_LEN(tables), (int)enterprise->export_table, ENTERPRISE_WIDGET_HEIGHT, \
+    nk_vec2(WINDOW_WIDTH / 3, 300));
+    enterprise->export_format = (enum export_format)nk_combo(ctx, formats, \
+    NK_LEN(formats), (int)enterprise->export_format, \
+    ENTERPRISE_WIDGET_HEIGHT, nk_vec2(WINDOW_WIDTH / 3, 100));
+    if (nk_button_label(ctx, "Export")) {
+        return program_status_enterprise_export;
+    }
+
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
     if (nk_button_label(ctx, "Facilities")) {
         return program_status_facility_table;
@@ -132,6 +946,9 @@ enum program_status enterprise_menu\
     if (nk_button_label(ctx, "Inventory")) {
         return program_status_item_table;
     }
+    if (nk_button_label(ctx, "Stock Valuation")) {
+        return program_status_stock_valuation;
+    }
     if (nk_button_label(ctx, "Customers")) {
         return program_status_customer_table;
     }
@@ -145,4 +962,6 @@ enum program_status enterprise_menu\
         return program_status_order_table;
     }
     return program_status_enterprise_menu;
-}
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,220 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+#if !defined(_WIN32)
+    #include <unistd.h>
+#endif
+
+#ifndef ENTERPRISE_AMOUNTS
+#define ENTERPRISE_AMOUNTS
+#include "enterprise_amount.h"
+#endif
+
+#ifndef PROGRAM_STATES
+#define PROGRAM_STATES
+#include "program_states.h"
+#endif
+
+#ifndef ENTERPRISE_FACILITIES
+#define ENTERPRISE_FACILITIES
+#include "facilities.h"
+#endif
+
+#ifndef ENTERPRISE_EMPLOYEES
+#define ENTERPRISE_EMPLOYEES
+#include "employees.h"
+#endif
+
+#ifndef ENTERPRISE_ITEMS
+#define ENTERPRISE_ITEMS
+#include "inventory.h"
+#endif
+
+#ifndef ENTERPRISE_CUSTOMERS
+#define ENTERPRISE_CUSTOMERS
+#include "customers.h"
+#endif
+
+#ifndef ENTERPRISE_SUPPLIERS
+#define ENTERPRISE_SUPPLIERS
+#include "suppliers.h"
+#endif
+
+#ifndef ENTERPRISE_EXPENSES
+#define ENTERPRISE_EXPENSES
+#include "expenses.h"
+#endif
+
+#ifndef ENTERPRISE_ORDERS
+#define ENTERPRISE_ORDERS
+#include "orders.h"
+#endif
+
+#ifndef ENTERPRISE_SNAPSHOTS
+#define ENTERPRISE_SNAPSHOTS
+#include "snapshot.h"
+#endif
+
+#ifndef ENTERPRISE_SNAPSHOT_MAP
+#define ENTERPRISE_SNAPSHOT_MAP
+#include "snapshot_map.h"
+#endif
+
+#ifndef ENTERPRISE_JOURNAL_RECORDS
+#define ENTERPRISE_JOURNAL_RECORDS
+#include "journal_records.h"
+#endif
+
+#ifndef ENTERPRISE_CSV
+#define ENTERPRISE_CSV
+#include "csv.h"
+#endif
+
+#ifndef ENTERPRISE_EXPORT
+#define ENTERPRISE_EXPORT
+#include "export.h"
+#endif
+
+#ifndef ENTERPRISE_WORKER_POOL
+#define ENTERPRISE_WORKER_POOL
+#include "worker_pool.h"
+#endif
+
+// Nuklear's context, taken by the GUI functions. Only the sources of
+// those functions import Nuklear itself.
+struct nk_context;
+
+/* What does this file do?
+It provides the enterprise data structure, which holds all the data related to
+the enterprise. It stores lists of everything needed in an enterprise.
+
+An enterprise opened with enterprise_open is kept on disk as a snapshot (see
+snapshot.c) and a journal of the changes made since (see journal.c). Every
+list records its changes in the enterprise's journal, enterprise_tick commits
+them, and enterprise_save compacts them into a new snapshot.
+*/
+
+#define ENTERPRISE_JOURNAL_PATH_LENGTH (ENTERPRISE_STRING_LENGTH + 16)
+#define ENTERPRISE_LIST_COUNT 7
+
+// How long loading an enterprise's snapshot took, in seconds: the string
+// table, each list, and the whole load. Lists load at the same time on
+// threads, so the whole load takes less than the sum of its parts.
+struct enterprise_load_times {
+    double strings;
+    double lists[ENTERPRISE_LIST_COUNT];
+    double total;
+    uint32_t threads;
+};
+
+// The enterprise struct.
+// This holds all relevant database information about the enterprise.
+struct enterprise {
+    char name[ENTERPRISE_STRING_LENGTH];
+    enterprise_cents balance;
+    char file_path[ENTERPRISE_STRING_LENGTH];
+
+    // The balance as typed into the enterprise menu, and the balance it was
+    // last written from, so that it is written again when the balance is
+    // changed some other way.
+    char edit_balance[ENTERPRISE_CENTS_TEXT_LENGTH];
+    enterprise_cents edit_balance_value;
+    struct string_pool* string_pool;
+
+    // The journal that changes are recorded in, or NULL if they are not, and
+    // the snapshot that the journal belongs to and its generation, which is
+    // 0 until the enterprise is loaded or saved.
+    struct journal* journal;
+    char snapshot_path[ENTERPRISE_STRING_LENGTH];
+    uint64_t generation;
+
+    struct facility_list* facility_list;
+    struct employee_list* employee_list;
+    struct item_list* item_list;
+    struct customer_list* customer_list;
+    struct supplier_list* supplier_list;
+    struct expense_list* expense_list;
+    struct order_list* order_list;
+
+    // How long the snapshot took to load, all zero if it was not loaded.
+    struct enterprise_load_times load_times;
+
+    // The table and format picked in the enterprise menu for exporting.
+    enum export_table export_table;
+    enum export_format export_format;
+};
+
+// A list of an enterprise being loaded from a snapshot on its own thread.
+struct enterprise_load_job {
+    struct enterprise* enterprise;
+    uint32_t list;
+    const char* path;
+    uint64_t offset;
+
+    // The reader that read the snapshot's string table, or NULL if the list
+    // has no text.
+    const struct snapshot_reader* strings;
+    struct worker_pool_progress* progress;
+    bool loaded;
+    double seconds;
+};
+
+// Memory used by the records of each type of node in an enterprise.
+struct enterprise_memory {
+    struct record_store_stats facilities;
+    struct record_store_stats employees;
+    struct record_store_stats employee_facilities;
+    struct record_store_stats items;
+    struct record_store_stats item_facilities;
+    struct record_store_stats customers;
+    struct record_store_stats suppliers;
+    struct record_store_stats expenses;
+    struct record_store_stats orders;
+    uint64_t strings;
+    uint64_t string_bytes;
+};
+
+extern const char* const enterprise_list_names[ENTERPRISE_LIST_COUNT];
+struct enterprise* enterprise_new();
+void enterprise_set_journal\
+(struct enterprise* enterprise, struct journal* journal);
+bool enterprise_delete_facility\
+(struct enterprise* enterprise, enterprise_id facility_id);
+bool enterprise_commit(struct enterprise* enterprise);
+void enterprise_quit(struct enterprise* enterprise);
+void enterprise_journal_path(const char* path, char* journal_path);
+bool enterprise_start_journal\
+(struct enterprise* enterprise, const char* path, bool truncate);
+bool enterprise_save(struct enterprise* enterprise, const char* path, \
+struct worker_pool_progress* progress);
+bool enterprise_export(struct enterprise* enterprise, enum export_table table, \
+enum export_format format, FILE* file, struct worker_pool_progress* progress);
+bool enterprise_export_file(struct enterprise* enterprise, \
+enum export_table table, enum export_format format, const char* path, \
+struct worker_pool_progress* progress);
+struct enterprise* enterprise_load\
+(const char* path, struct worker_pool_progress* progress);
+void enterprise_print_load_times(struct enterprise* enterprise);
+bool enterprise_replay\
+(struct enterprise* enterprise, const char* journal_path);
+struct enterprise* enterprise_open\
+(const char* path, bool create, struct worker_pool_progress* progress);
+bool enterprise_compaction_due(struct enterprise* enterprise);
+bool enterprise_compact\
+(struct enterprise* enterprise, struct worker_pool_progress* progress);
+void enterprise_tick(struct enterprise* enterprise, uint64_t milliseconds);
+void enterprise_get_memory\
+(struct enterprise* enterprise, struct enterprise_memory* memory);
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+enum program_status enterprise_menu\
+(struct nk_context* ctx, struct enterprise* enterprise);
+#endif
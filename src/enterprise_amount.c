@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <limits.h>
+
+#ifndef ENTERPRISE_AMOUNTS
+#define ENTERPRISE_AMOUNTS
+#include "enterprise_amount.h"
+#endif
+
+// Write an amount of money as text into a buffer of at least
+// ENTERPRISE_CENTS_TEXT_LENGTH characters.
+void enterprise_cents_format(enterprise_cents cents, char* buffer) {
+    if (buffer == NULL) return;
+    unsigned long long magnitude = cents < 0 \
+    ? 0ULL - (unsigned long long)cents : (unsigned long long)cents;
+    snprintf(buffer, ENTERPRISE_CENTS_TEXT_LENGTH, "%s%llu.%02llu", \
+    cents < 0 ? "-" : "", magnitude / 100, magnitude % 100);
+}
+
+// Read an amount of money typed in by the user, such as "12", "12.3" or
+// "-0.05". Empty text is read as 0.
+// Returns true on success, or false if the text is not a valid amount, in
+// which case cents is left alone.
+bool enterprise_cents_parse(const char* text, enterprise_cents* cents) {
+    if (text == NULL || cents == NULL) return false;
+    while (isspace((unsigned char)*text)) text++;
+    if (*text == '\0') {
+        *cents = 0;
+        return true;
+    }
+    bool negative = *text == '-';
+    if (negative) text++;
+
+    // Count whole units, then up to two decimal places.
+    unsigned long long magnitude = 0;
+    bool digits = false;
+    while (isdigit((unsigned char)*text)) {
+        if (magnitude > (LLONG_MAX / 100 - 10) / 10) return false;
+        magnitude = magnitude * 10 + (unsigned long long)(*text++ - '0');
+        digits = true;
+    }
+    magnitude *= 100;
+    if (*text == '.') {
+        text++;
+        if (isdigit((unsigned char)*text)) {
+            magnitude += (unsigned long long)(*text++ - '0') * 10;
+            digits = true;
+        }
+        if (isdigit((unsigned char)*text)) {
+            magnitude += (unsigned long long)(*text++ - '0');
+        }
+    }
+    while (isspace((unsigned char)*text)) text++;
+    if (*text != '\0' || digits == false) return false;
+
+    *cents = negative ? -(enterprise_cents)magnitude \
+    : (enterprise_cents)magnitude;
+    return true;
+}
+
+// Write a quantity as text into a buffer of at least
+// ENTERPRISE_QUANTITY_TEXT_LENGTH characters.
+void enterprise_quantity_format(enterprise_quantity quantity, char* buffer) {
+    if (buffer == NULL) return;
+    snprintf(buffer, ENTERPRISE_QUANTITY_TEXT_LENGTH, "%lld", quantity);
+}
+
+// Read a quantity typed in by the user, which must be a whole number that is
+// not negative. Empty text is read as 0.
+// Returns true on success, or false if the text is not a valid quantity, in
+// which case quantity is left alone.
+bool enterprise_quantity_parse(const char* text, \
+enterprise_quantity* quantity) {
+    if (text == NULL || quantity == NULL) return false;
+    while (isspace((unsigned char)*text)) text++;
+
+    enterprise_quantity value = 0;
+    while (isdigit((unsigned char)*text)) {
+        if (value > (LLONG_MAX - 9) / 10) return false;
+        value = value * 10 + (*text++ - '0');
+    }
+    while (isspace((unsigned char)*text)) text++;
+    if (*text != '\0') return false;
+
+    *quantity = value;
+    return true;
+}
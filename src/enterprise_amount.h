@@ -0,0 +1,29 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <limits.h>
+
+/* How amounts work.
+Money, such as prices, costs and the enterprise's balance, is stored as a 64
+bit integer number of cents. Stock is stored as a 64 bit integer number of
+units. Sums and comparisons are then plain integer arithmetic, which never
+rounds and needs no parsing, and a column of amounts can be added up with
+vector instructions.
+
+Like IDs, amounts are only turned into text at the edge of the program, when
+they are shown to the user or typed in by the user. Money is written with two
+decimal places, such as "-12.30".
+*/
+
+typedef long long enterprise_cents;
+typedef long long enterprise_quantity;
+
+#define ENTERPRISE_CENTS_TEXT_LENGTH 32
+#define ENTERPRISE_QUANTITY_TEXT_LENGTH 24
+
+void enterprise_cents_format(enterprise_cents cents, char* buffer);
+bool enterprise_cents_parse(const char* text, enterprise_cents* cents);
+void enterprise_quantity_format(enterprise_quantity quantity, char* buffer);
+bool enterprise_quantity_parse(const char* text, \
+enterprise_quantity* quantity);
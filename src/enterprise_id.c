@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <ctype.h>
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+// Write an ID as text into a buffer of at least ENTERPRISE_ID_TEXT_LENGTH
+// characters. ENTERPRISE_ID_NONE is written as an empty string so that unset
+// references show up as empty fields.
+void enterprise_id_format(enterprise_id id, char* buffer) {
+    if (buffer == NULL) return;
+    if (id == ENTERPRISE_ID_NONE) {
+        buffer[0] = '\0';
+        return;
+    }
+    snprintf(buffer, ENTERPRISE_ID_TEXT_LENGTH, "%lld", id);
+}
+
+// Read an ID typed in by the user.
+// Returns ENTERPRISE_ID_NONE if the text is not a valid ID.
+enterprise_id enterprise_id_parse(const char* text) {
+    if (text == NULL) return ENTERPRISE_ID_NONE;
+    while (isspace((unsigned char)*text)) text++;
+    if (isdigit((unsigned char)*text) == 0) return ENTERPRISE_ID_NONE;
+
+    char* end = NULL;
+    enterprise_id id = strtoll(text, &end, 10);
+    while (isspace((unsigned char)*end)) end++;
+    if (*end != '\0' || id < 0) return ENTERPRISE_ID_NONE;
+    return id;
+}
@@ -0,0 +1,22 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <ctype.h>
+
+/* How IDs work.
+Every node in the enterprise is identified by a 64 bit integer ID. Each list
+hands out IDs counting up from 1, so ENTERPRISE_ID_NONE (0) never refers to a
+node. It is used for references, like an expense's facility, that have not been
+set yet.
+
+IDs are only turned into text at the edge of the program, when they are shown
+to the user or typed in by the user.
+*/
+
+typedef long long enterprise_id;
+
+#define ENTERPRISE_ID_NONE 0
+#define ENTERPRISE_ID_TEXT_LENGTH 24
+
+void enterprise_id_format(enterprise_id id, char* buffer);
+enterprise_id enterprise_id_parse(const char* text);
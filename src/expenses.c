@@ -9,154 +9,85 @@
 #include <limits.h>
 #include <time.h>
 
-#include "constants.c"
-
-#ifndef PROGRAM_STATES
-#define PROGRAM_STATES
-#include "program_states.c"
-#endif
-
-
-// Import Nuklear.
-#ifndef ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
+// Import Nuklear, unless building without the GUI.
+#if !defined(ENTERPRISE_NUKLEAR_LIBRARY_IMPORT) \
+&& !defined(ENTERPRISE_HEADLESS)
 #define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-    #define NK_INCLUDE_FIXED_TYPES
-    #define NK_INCLUDE_STANDARD_IO
-    #define NK_INCLUDE_STANDARD_VARARGS
-    #define NK_INCLUDE_DEFAULT_ALLOCATOR
-    #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    #define NK_INCLUDE_FONT_BAKING
-    #define NK_INCLUDE_DEFAULT_FONT
-    #define NK_IMPLEMENTATION
-    #define NK_SDL_GLES2_IMPLEMENTATION
-    #include "../third_party/Nuklear/nuklear.h"
-    #include "../third_party/Nuklear/demo/sdl_opengles2/nuklear_sdl_gles2.h"
-    #include "../third_party/Nuklear/demo/common/style.c"
+#include "nuklear_import.h"
 #endif
 
-/* How expenses work.
-expenses are stored in a struct that contains a pointer to the head of a
-linked list containing all the expenses. The struct that stores the linked
-list is directly added to the enterprise struct and stores metadata about the
-list. All expenses are assigned a unique ID, no two expenses can have the
-same ID, the expense_list structure keeps track of that.
-
-Data structures:
-expense_node: An individual expense.
-expense_list: A structure holding important metadata about the expense
-linked list.
-
-expense list metadata:
-expense_list->id_last_assigned: This is incremented by 1 every time a new
-expense is added in order to ensure no two expenses ever have the same ID.
-
-expense_list->id_currently_selected: This is the ID that is selected in the
-expense editor dialogue.
-*/
-
-enum expense_type {expense_type_rent, expense_type_wage, expense_type_insurance,
-expense_type_energy, expense_type_misc};
-
-struct expense_node {
-    char id[ENTERPRISE_STRING_LENGTH];
-    char facility_id[ENTERPRISE_STRING_LENGTH];
-    char supplier_id[ENTERPRISE_STRING_LENGTH];
-    enum expense_type type;
-
-    struct expense_node* prev;
-    struct expense_node* next;
-};
+#ifndef ENTERPRISE_EXPENSES
+#define ENTERPRISE_EXPENSES
+#include "expenses.h"
+#endif
 
-// expense node constructor and initialiser.
+// Expense node constructor and initialiser.
+// The node is added to the end of the passed in record store.
 // Returns expense node on success, or NULL on failure.
-struct expense_node *expense_node_new() {
-    struct expense_node* expense = malloc(sizeof(struct expense_node));
+struct expense_node *expense_node_new(struct record_store* store) {
+    struct expense_node* expense = record_store_append(store);
     if (expense == NULL) return NULL;
-    strcpy(expense->id, "");
-    strcpy(expense->facility_id, "");
-    strcpy(expense->supplier_id, "");
+    expense->id = ENTERPRISE_ID_NONE;
+    expense->facility_id = ENTERPRISE_ID_NONE;
+    expense->supplier_id = ENTERPRISE_ID_NONE;
     expense->type = expense_type_misc;
 
-    expense->prev = NULL;
-    expense->next = NULL;
-
     return expense;
 }
 
-// expense list metadata structure.
-struct expense_list {
-    struct expense_node *head;
-    char id_last_assigned[ENTERPRISE_STRING_LENGTH];
-    char id_currently_selected[ENTERPRISE_STRING_LENGTH];
-    bool deletion_requested;
-};
-
-// expense list constructor.
+// Expense list constructor.
 // Returns expense list on success, or NULL on failure.
 struct expense_list* expense_list_new() {
     struct expense_list* expense_list = malloc(sizeof(struct expense_list));
     if (expense_list == NULL) return NULL;
-    expense_list->head = NULL;
-    strcpy(expense_list->id_last_assigned, "0");
-    strcpy(expense_list->id_currently_selected, "0");
+    record_store_init(&expense_list->store, sizeof(struct expense_node));
+    id_index_init(&expense_list->id_index);
+    expense_list->journal = NULL;
+    expense_list->facility_references = NULL;
+    expense_list->version = 0;
+    row_labels_init(&expense_list->row_labels);
+    expense_list->id_last_assigned = ENTERPRISE_ID_NONE;
+    expense_list->id_currently_selected = ENTERPRISE_ID_NONE;
+    expense_list->handle_currently_selected = RECORD_STORE_NONE;
     expense_list->deletion_requested = false;
     return expense_list;
 }
 
-// Free an entire expense linked list
-void expense_node_linked_list_free(struct expense_node* expense) {
-    if (expense == NULL) return;
-    struct expense_node* next = NULL;
-    while (expense != NULL) {
-        next = expense->next;
-        free(expense);
-        expense = next;
-    }
-}
-
-// Free all memory associated with a expense list.
+// Free all memory associated with an expense list.
 void expense_list_free(struct expense_list* expense_list) {
     if (expense_list == NULL) return;
-
-    if (expense_list->head != NULL) {
-        expense_node_linked_list_free(expense_list->head);
-    }
-
+    row_labels_free(&expense_list->row_labels);
+    id_index_free(&expense_list->id_index);
+    record_store_free(&expense_list->store);
     free(expense_list);
     return;
 }
 
-// Append a new expense to a expense list.
+// Append a new expense to an expense list.
 void expense_list_append(struct expense_list* expense_list) {
     if (expense_list == NULL) return;
 
     // Increment unique ID by 1.
-    char buffer[ENTERPRISE_STRING_LENGTH];
-    sprintf(buffer, "%lld", atoll(expense_list->id_last_assigned) + 1);
-    strcpy(expense_list->id_last_assigned, buffer);
-
-    // Add new node to start of expense list if expense linked list does
-    // not exist.
-    if (expense_list->head == NULL) {
-        expense_list->head = expense_node_new();
-        strcpy(expense_list->head->id, expense_list->id_last_assigned);
-        strcpy(expense_list->id_currently_selected,
-        expense_list->id_last_assigned);
+    expense_list->id_last_assigned++;
+
+    // Add the new node to the end of the list.
+    struct expense_node* expense = expense_node_new(&expense_list->store);
+    if (expense == NULL) return;
+
+    expense->id = expense_list->id_last_assigned;
+
+    // Index the new node by its ID so it can be found without a search.
+    if (id_index_insert(&expense_list->id_index, expense->id, \
+    record_store_handle(expense)) == false) {
+        record_store_remove(&expense_list->store, expense);
         return;
     }
 
-    // Else add the new node to the end of the list.
-    struct expense_node* expense = expense_list->head;
-    while (expense->next != NULL) {
-        expense = expense->next;
-    }
-    
-    expense->next = expense_node_new();
-    expense->next->prev = expense;
+    expense_list->id_currently_selected = expense_list->id_last_assigned;
 
-    strcpy(expense->next->id, expense_list->id_last_assigned);
-    strcpy(expense_list->id_currently_selected,
-    expense_list->id_last_assigned);
+    expense_list->version++;
+    journal_put(expense_list->journal, journal_list_expenses, \
+    ENTERPRISE_ID_NONE, expense->id);
 
     return;
 }
@@ -164,154 +95,137 @@ void expense_list_append(struct expense_list* expense_list) {
 // Get the number of expense nodes in the expense list
 int expense_list_get_num_expense_nodes(struct expense_list* expense_list) {
     if (expense_list == NULL) return 0;
-    if (expense_list->head == NULL) return 0;
+    return (int)expense_list->store.count;
+}
 
-    struct expense_node* expense = expense_list->head;
-    int expense_count = 0;
-    while (expense != NULL) {
-        expense_count++;
-        expense = expense->next;
-    }
-    return expense_count;
+// Make room in an expense list and its ID index for count more expenses.
+// Returns true on success, or false on failure.
+bool expense_list_reserve(struct expense_list* expense_list, uint32_t count) {
+    if (expense_list == NULL) return false;
+    return record_store_reserve(&expense_list->store, count) \
+    && id_index_reserve(&expense_list->id_index, count);
 }
 
-// Return a pointer to a expense node according to ID.
+// Return a pointer to an expense node according to ID.
 // Returns NULL on failure.
 struct expense_node *expense_list_get_node\
-(struct expense_list *expense_list, char *id) {
-    if (expense_list == NULL || id == NULL) return NULL;
-    if (expense_list->head == NULL) return NULL;
-
-    struct expense_node* expense = expense_list->head;
-    while (expense != NULL) {
-        if (strcmp(expense->id, id) == 0) return expense;
-        expense = expense->next;
-    }
-    return NULL;
+(struct expense_list *expense_list, enterprise_id id) {
+    if (expense_list == NULL) return NULL;
+    return record_store_get\
+    (&expense_list->store, id_index_find(&expense_list->id_index, id));
 }
 
-// Searches for a expense by ID and deletes it
-void expense_list_delete_node(struct expense_list *expense_list, char *id) {
-    if (expense_list == NULL || id == NULL) return;
-    if (expense_list->head == NULL) return;
-
-    // Delete the head if it is the ID that is requested to be deleted.
-    if (strcmp(id, expense_list->head->id) == 0) {
-        if (expense_list->head->next == NULL) {
-            free(expense_list->head);
-            expense_list->head = NULL;
-            return;
-        }
+// Return a pointer to the currently selected expense node.
+// The selected expense's handle is checked before its ID is looked up, so this
+// only searches the ID index after the selection was changed by ID.
+// Returns NULL if no expense is selected.
+struct expense_node *expense_list_get_selected_node\
+(struct expense_list *expense_list) {
+    if (expense_list == NULL) return NULL;
 
-        struct expense_node *next = expense_list->head->next;
-        free(expense_list->head);
-        expense_list->head = next;
-        return;
+    struct expense_node* expense = record_store_get\
+    (&expense_list->store, expense_list->handle_currently_selected);
+    if (expense == NULL || expense->id != expense_list->id_currently_selected) {
+        expense = expense_list_get_node\
+        (expense_list, expense_list->id_currently_selected);
+        expense_list->handle_currently_selected = \
+        record_store_handle(expense);
     }
+    return expense;
+}
 
-    // Else search for the expense to delete.
-    struct expense_node* expense = expense_list->head;
-    while (expense != NULL) {
-        if (strcmp(expense->id, id) == 0) break;
-        expense = expense->next;
-    }
-    if (expense == NULL) return;
+// Set the facility that an expense was made at, counting it in the facility
+// references and noting the change in the journal.
+void expense_list_set_facility(struct expense_list* expense_list, \
+struct expense_node* expense, enterprise_id facility_id) {
+    if (expense_list == NULL || expense == NULL) return;
+    if (expense->facility_id == facility_id) return;
+
+    facility_references_move(expense_list->facility_references, \
+    facility_reference_expense, expense->id, expense->facility_id, \
+    facility_id);
+    expense->facility_id = facility_id;
+
+    expense_list->version++;
+    journal_put(expense_list->journal, journal_list_expenses, \
+    ENTERPRISE_ID_NONE, expense->id);
+}
 
-    // Fix the pointers of the next and previous nodes to the expense to be
-    // deleted in order to ensure that traversal still works.
+// Searches for an expense by ID and deletes it
+void expense_list_delete_node\
+(struct expense_list *expense_list, enterprise_id id) {
+    if (expense_list == NULL) return;
 
-    struct expense_node* prev = expense->prev;
-    struct expense_node* next = expense->next;
+    struct expense_node* expense = expense_list_get_node(expense_list, id);
+    if (expense == NULL) return;
 
-    if (prev != NULL) {
-        if (next == NULL) {
-            prev->next = NULL;
-            strcpy(expense_list->id_currently_selected, prev->id);
-        }
-        if (next != NULL) {
-            prev->next = next;
-            next->prev = prev;
-            strcpy(expense_list->id_currently_selected, next->id);
-        }
+    // Select the node after the deleted expense, or the node before it if the
+    // deleted expense is the last one.
+    struct expense_node* prev = record_store_prev(&expense_list->store, expense);
+    struct expense_node* next = record_store_next(&expense_list->store, expense);
+    if (next != NULL) {
+        expense_list->id_currently_selected = next->id;
     }
-
-    if (prev == NULL) {
-        if (next != NULL) {
-            next->prev = NULL;
-            strcpy(expense_list->id_currently_selected, next->id);
-        }
+    else if (prev != NULL) {
+        expense_list->id_currently_selected = prev->id;
     }
 
+    expense_list->version++;
+    journal_delete(expense_list->journal, journal_list_expenses, \
+    ENTERPRISE_ID_NONE, expense->id);
+    facility_references_remove(expense_list->facility_references, \
+    expense->facility_id, facility_reference_expense, expense->id);
+
     // Delete the expense
-    free(expense);
+    id_index_remove(&expense_list->id_index, expense->id);
+    record_store_remove(&expense_list->store, expense);
     return;
 }
 
 // Select the previous node as the currently selected item.
 void expense_list_select_previous_node(struct expense_list *expense_list) {
     if (expense_list == NULL) return;
-    if (expense_list->head == NULL) return;
-
-    struct expense_node* expense = expense_list->head;
-    while (expense != NULL) {
-        if (strcmp(expense->id, expense_list->id_currently_selected) == 0) {
-            if (expense->prev != NULL) {
-                strcpy(expense_list->id_currently_selected, expense->prev->id);
-                return;
-            }
-            if (expense->prev == NULL) {
-                struct expense_node* temp = expense;
-                while (temp->next != NULL) {
-                    temp = temp->next;
-                }
-                strcpy(expense_list->id_currently_selected, temp->id);
-                return;
-            }
-        }
-        expense = expense->next;
-    }
+
+    struct expense_node* expense = \
+    expense_list_get_selected_node(expense_list);
+    if (expense == NULL) return;
+
+    // Wrap around to the last expense if the first one is selected.
+    struct expense_node* prev = record_store_prev(&expense_list->store, expense);
+    if (prev == NULL) prev = record_store_last(&expense_list->store);
+    expense_list->id_currently_selected = prev->id;
+    expense_list->handle_currently_selected = record_store_handle(prev);
 }
 
 // Select the next node as the currently selected item.
 void expense_list_select_next_node(struct expense_list *expense_list) {
     if (expense_list == NULL) return;
-    if (expense_list->head == NULL) return;
-
-    struct expense_node* expense = expense_list->head;
-    while (expense != NULL) {
-        if (strcmp(expense->id, expense_list->id_currently_selected) == 0) {
-            if (expense->next != NULL) {
-                strcpy(expense_list->id_currently_selected, expense->next->id);
-                return;
-            }
-            if (expense->next == NULL) {
-                strcpy(expense_list->id_currently_selected,\
-                expense_list->head->id);
-                return;
-            }
-        }
-        expense = expense->next;
-    }
+
+    struct expense_node* expense = \
+    expense_list_get_selected_node(expense_list);
+    if (expense == NULL) return;
+
+    // Wrap around to the first expense if the last one is selected.
+    struct expense_node* next = record_store_next(&expense_list->store, expense);
+    if (next == NULL) next = record_store_first(&expense_list->store);
+    expense_list->id_currently_selected = next->id;
+    expense_list->handle_currently_selected = record_store_handle(next);
 }
 
 // Change the currently selected ID to the passed in ID in the expense list.
 void expense_list_set_selected_id\
-(struct expense_list *expense_list, char* id) {
-    if (expense_list == NULL || id == NULL) return;
-    if (expense_list->head == NULL) return;
-
-    struct expense_node* expense = expense_list->head;
-    while (expense != NULL) {
-        if (strcmp(expense->id, id) == 0) {
-            strcpy(expense_list->id_currently_selected, id);
-        }
-        expense = expense->next;
+(struct expense_list *expense_list, enterprise_id id) {
+    if (expense_list == NULL) return;
+
+    if (expense_list_get_node(expense_list, id) != NULL) {
+        expense_list->id_currently_selected = id;
     }
 }
 
 // Get the expense type back as a string:
-char* expense_list_get_node_type(struct expense_list* expense_list, char* id) {
-    if (expense_list == NULL || id == NULL) return "";
+char* expense_list_get_node_type\
+(struct expense_list* expense_list, enterprise_id id) {
+    if (expense_list == NULL) return "";
     
     struct expense_node* expense = expense_list_get_node(expense_list, id);
     if (expense == NULL) return "";
@@ -324,6 +238,30 @@ char* expense_list_get_node_type(struct expense_list* expense_list, char* id) {
     return "";
 }
 
+// Make the labels of row_count rows of the expense table, starting at
+// first_row, unless they are cached already.
+void expense_list_label_rows(struct expense_list* expense_list, \
+uint32_t first_row, uint32_t row_count) {
+    if (expense_list == NULL) return;
+    struct row_labels* labels = &expense_list->row_labels;
+    if (row_labels_current(labels, expense_list->version, first_row, \
+    row_count)) return;
+
+    row_labels_begin(labels, expense_list->version, first_row, row_count);
+    struct expense_node* expense = \
+    record_store_seek(&expense_list->store, first_row);
+    for (uint32_t row = 0; row < row_count && expense != NULL; row++) {
+        if (row_labels_add(labels, expense->id, \
+        "ID: %lld Type: %s Facility ID: %lld Supplier ID: %lld",\
+        expense->id, \
+        expense_list_get_node_type(expense_list, expense->id),\
+        expense->facility_id, expense->supplier_id) == false) break;
+        expense = record_store_next(&expense_list->store, expense);
+    }
+}
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
 
 // Render the expense table GUI.
 // This function displays a list of expenses as a table that can be selected.
@@ -347,32 +285,38 @@ struct expense_list* expense_list) {
     }
 
     // If there are no expenses, warn the user.
-    if (expense_list->head == NULL) {
+    if (record_store_first(&expense_list->store) == NULL) {
         nk_label(ctx, "No Expenses found.", NK_TEXT_CENTERED);
         return program_status_expense_table;
     }
 
-    /* If there are expenses, go through the linked list of expenses.
-    Copy the data from each expense and make it a button label.
-    When the button is pressed, set the currently selected expense to that
+    /* If there are expenses, make a button for each expense in view.
+    Only the rows scrolled into view are drawn, and their labels are only
+    formatted again when different rows come into view or the list changes.
+    When a button is pressed, set the currently selected expense to that
     expense and switch to expense editor.*/
-    struct expense_node* expense = expense_list->head;
-    char* print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-    while (expense != NULL) {
-        sprintf(print_buffer, \
-        "ID: %s Type: %s Facility ID: %s Supplier ID: %s",expense->id,\
-        expense_list_get_node_type(expense_list, expense->id),\
-        expense->facility_id, expense->supplier_id);
-
-        if (nk_button_label(ctx, print_buffer)) {
-            strcpy(expense_list->id_currently_selected, expense->id);
-            free(print_buffer);
-            return program_status_expense_editor;
+    enum program_status status = program_status_expense_table;
+    struct nk_list_view view;
+    int rows = expense_list->store.count > INT_MAX \
+    ? INT_MAX : (int)expense_list->store.count;
+    nk_layout_row_dynamic(ctx, ENTERPRISE_TABLE_HEIGHT, 1);
+    if (nk_list_view_begin(ctx, &view, "expense_table", \
+    NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+        nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+        struct row_labels* labels = &expense_list->row_labels;
+        expense_list_label_rows(expense_list, \
+        (uint32_t)view.begin, (uint32_t)view.count);
+
+        for (uint32_t row = 0; row < labels->count; row++) {
+            if (nk_button_label(ctx, row_labels_text(labels, row))) {
+                expense_list->id_currently_selected = \
+                row_labels_id(labels, row);
+                status = program_status_expense_editor;
+            }
         }
-        expense = expense->next;
+        nk_list_view_end(&view);
     }
-    free(print_buffer);
-    return program_status_expense_table;
+    return status;
 }
 
 // Render the expense editor GUI.
@@ -390,14 +334,15 @@ struct expense_list* expense_list) {
     nk_label(ctx, "Expense Editor", NK_TEXT_CENTERED);
     
     // Select currently selected expense.
-    struct expense_node* expense = expense_list_get_node\
-    (expense_list, expense_list->id_currently_selected);
+    struct expense_node* expense = \
+    expense_list_get_selected_node(expense_list);
 
     // If the currently selected expense does not exist:
     if (expense == NULL) {
         // Select the first expense instead.
-        if (expense_list->head != NULL) {
-            strcpy(expense_list->id_currently_selected, expense_list->head->id);
+        expense = record_store_first(&expense_list->store);
+        if (expense != NULL) {
+            expense_list->id_currently_selected = expense->id;
             return program_status_expense_editor;
         }
 
@@ -418,6 +363,11 @@ struct expense_list* expense_list) {
     nk_layout_row_template_push_dynamic(ctx);
     nk_layout_row_template_end(ctx);
 
+    // Fields are edited in place, so keep copies to tell if they change.
+    enum expense_type type_before = expense->type;
+    enterprise_id facility_id = expense->facility_id;
+    enterprise_id supplier_id = expense->supplier_id;
+
     // Expense type editor.
     int type = 0;
     if (expense->type == expense_type_rent) type = 0;
@@ -435,17 +385,34 @@ struct expense_list* expense_list) {
     if (type == 3) expense->type = expense_type_energy;
     if (type == 4) expense->type = expense_type_misc;
 
+    char id_text[ENTERPRISE_ID_TEXT_LENGTH];
+    enterprise_id_format(expense->id, id_text);
     nk_label(ctx, "ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_READ_ONLY, \
-    expense->id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_default);
 
+    enterprise_id_format(expense->facility_id, id_text);
     nk_label(ctx, "Facility ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    expense->facility_id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_decimal);
+    expense->facility_id = enterprise_id_parse(id_text);
 
+    enterprise_id_format(expense->supplier_id, id_text);
     nk_label(ctx, "Supplier ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    expense->supplier_id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_decimal);
+    expense->supplier_id = enterprise_id_parse(id_text);
+
+    // Note any edits in the journal.
+    if (expense->type != type_before || expense->facility_id != facility_id \
+    || expense->supplier_id != supplier_id) {
+        facility_references_move(expense_list->facility_references, \
+        facility_reference_expense, expense->id, facility_id, \
+        expense->facility_id);
+        expense_list->version++;
+        journal_put(expense_list->journal, journal_list_expenses, \
+        ENTERPRISE_ID_NONE, expense->id);
+    }
 
     // Move between next and previous expenses.
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 2);
@@ -485,4 +452,6 @@ struct expense_list* expense_list) {
     }
     
     return program_status_expense_editor;
-}
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+#ifndef ENTERPRISE_FACILITY_REFERENCES
+#define ENTERPRISE_FACILITY_REFERENCES
+#include "facility_references.h"
+#endif
+
+#ifndef ENTERPRISE_JOURNAL
+#define ENTERPRISE_JOURNAL
+#include "journal.h"
+#endif
+
+#ifndef ENTERPRISE_ROW_LABELS
+#define ENTERPRISE_ROW_LABELS
+#include "row_labels.h"
+#endif
+
+#ifndef PROGRAM_STATES
+#define PROGRAM_STATES
+#include "program_states.h"
+#endif
+
+// Nuklear's context, taken by the GUI functions. Only the sources of
+// those functions import Nuklear itself.
+struct nk_context;
+
+/* How expenses work.
+An expense is rent, wages, insurance, energy or another cost, made at a
+facility and paid to a supplier, each referred to by its ID. The expense list
+is laid out like every other list of the enterprise (see record_store.c).
+
+Data structures:
+expense_node: An expense.
+expense_list: The expenses of the enterprise.
+*/
+
+enum expense_type {expense_type_rent, expense_type_wage, expense_type_insurance,
+expense_type_energy, expense_type_misc};
+
+struct expense_node {
+    enterprise_id id;
+    enterprise_id facility_id;
+    enterprise_id supplier_id;
+    enum expense_type type;
+};
+
+// Expense list metadata structure.
+struct expense_list {
+    struct record_store store;
+    struct id_index id_index;
+
+    // Where changes to the list are recorded, or NULL if they are not.
+    struct journal* journal;
+
+    // The facility references that the facilities of the list's expenses are
+    // counted in, or NULL if they are not.
+    struct facility_references* facility_references;
+
+    // Bumped whenever a node is appended, edited or deleted, so that the
+    // labels cached for the list's table know when they are stale.
+    uint64_t version;
+    struct row_labels row_labels;
+
+    enterprise_id id_last_assigned;
+    enterprise_id id_currently_selected;
+    uint32_t handle_currently_selected;
+    bool deletion_requested;
+};
+
+struct expense_node *expense_node_new(struct record_store* store);
+struct expense_list* expense_list_new();
+void expense_list_free(struct expense_list* expense_list);
+void expense_list_append(struct expense_list* expense_list);
+int expense_list_get_num_expense_nodes(struct expense_list* expense_list);
+bool expense_list_reserve(struct expense_list* expense_list, uint32_t count);
+struct expense_node *expense_list_get_node\
+(struct expense_list *expense_list, enterprise_id id);
+struct expense_node *expense_list_get_selected_node\
+(struct expense_list *expense_list);
+void expense_list_set_facility(struct expense_list* expense_list, \
+struct expense_node* expense, enterprise_id facility_id);
+void expense_list_delete_node\
+(struct expense_list *expense_list, enterprise_id id);
+void expense_list_select_previous_node(struct expense_list *expense_list);
+void expense_list_select_next_node(struct expense_list *expense_list);
+void expense_list_set_selected_id\
+(struct expense_list *expense_list, enterprise_id id);
+char* expense_list_get_node_type\
+(struct expense_list* expense_list, enterprise_id id);
+void expense_list_label_rows(struct expense_list* expense_list, \
+uint32_t first_row, uint32_t row_count);
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+enum program_status expense_table(struct nk_context* ctx,\
+struct expense_list* expense_list);
+enum program_status expense_editor(struct nk_context* ctx,\
+struct expense_list* expense_list);
+#endif
@@ -0,0 +1,448 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef ENTERPRISE_EXPORT
+#define ENTERPRISE_EXPORT
+#include "export.h"
+#endif
+
+// The name of each format, which is also the extension of its files.
+const char* const export_format_names[export_format_count] = {"csv", "json"};
+
+// The name of each table.
+const char* const export_table_names[export_table_count] = \
+{"facilities", "employees", "employee_facilities", "items", "item_facilities", \
+"customers", "suppliers", "expenses", "orders"};
+
+// Initialise a writer that exports tables in format to file.
+// Returns true on success, or false on failure.
+bool export_writer_init(struct export_writer* writer, FILE* file, \
+enum export_format format) {
+    if (writer == NULL || file == NULL) return false;
+    memset(writer, 0, sizeof(struct export_writer));
+    writer->file = file;
+    writer->format = format;
+    writer->buffer = malloc(EXPORT_BUFFER_SIZE);
+    return writer->buffer != NULL;
+}
+
+// Write everything in the writer's buffer to its file.
+void export_flush(struct export_writer* writer) {
+    if (writer == NULL || writer->used == 0) return;
+    if (writer->failed == false && \
+    fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) {
+        writer->failed = true;
+    }
+    writer->used = 0;
+}
+
+// Free all memory associated with a writer, writing what is left in its
+// buffer first. The file is left open.
+void export_writer_free(struct export_writer* writer) {
+    if (writer == NULL) return;
+    export_flush(writer);
+    free(writer->buffer);
+    writer->buffer = NULL;
+}
+
+// Add size bytes to the export.
+static void export_put(struct export_writer* writer, const char* bytes, \
+size_t size) {
+    if (writer->used + size > EXPORT_BUFFER_SIZE) {
+        export_flush(writer);
+        if (size > EXPORT_BUFFER_SIZE) {
+            if (writer->failed == false && \
+            fwrite(bytes, 1, size, writer->file) != size) {
+                writer->failed = true;
+            }
+            return;
+        }
+    }
+    memcpy(writer->buffer + writer->used, bytes, size);
+    writer->used += size;
+}
+
+// Add a single character to the export.
+static inline void export_put_character(struct export_writer* writer, \
+char character) {
+    if (writer->used == EXPORT_BUFFER_SIZE) export_flush(writer);
+    writer->buffer[writer->used++] = character;
+}
+
+// Start the value of the next column, after the last one.
+static void export_next_column(struct export_writer* writer) {
+    if (writer->column > 0) export_put_character(writer, ',');
+    if (writer->format == export_format_json) {
+        if (writer->column == 0) export_put_character(writer, '{');
+        export_put_character(writer, '"');
+        const char* name = writer->columns[writer->column];
+        export_put(writer, name, strlen(name));
+        export_put(writer, "\":", 2);
+    }
+    writer->column++;
+}
+
+// Start a table with column_count named columns, which is going to have
+// record_count records.
+void export_begin_table(struct export_writer* writer, \
+const char* const* columns, uint32_t column_count, uint64_t record_count) {
+    if (writer == NULL) return;
+    worker_pool_progress_begin(writer->progress, record_count);
+    writer->columns = columns;
+    writer->column_count = column_count;
+    writer->column = 0;
+    writer->records = 0;
+    if (writer->format == export_format_json) {
+        export_put(writer, "[\n", 2);
+        return;
+    }
+    for (uint32_t column = 0; column < column_count; column++) {
+        if (column > 0) export_put_character(writer, ',');
+        export_put(writer, columns[column], strlen(columns[column]));
+    }
+    export_put_character(writer, '\n');
+}
+
+// End the record whose values were just added.
+void export_end_record(struct export_writer* writer) {
+    if (writer == NULL) return;
+    if (writer->format == export_format_json) {
+        export_put_character(writer, '}');
+    }
+    writer->column = 0;
+    writer->records++;
+    if (writer->records % EXPORT_PROGRESS_INTERVAL == 0) {
+        worker_pool_progress_add(writer->progress, EXPORT_PROGRESS_INTERVAL);
+    }
+}
+
+// End a table, and write everything left in the buffer to the file.
+// Returns true if the whole table was written, or false if it was not.
+bool export_end_table(struct export_writer* writer) {
+    if (writer == NULL) return false;
+    if (writer->format == export_format_json) {
+        export_put(writer, writer->records > 0 ? "\n]\n" : "]\n", \
+        writer->records > 0 ? 3 : 2);
+    }
+    else if (writer->records > 0) export_put_character(writer, '\n');
+    export_flush(writer);
+    return writer->failed == false && fflush(writer->file) == 0;
+}
+
+// Start a record. Records are written on their own line.
+void export_begin_record(struct export_writer* writer) {
+    if (writer == NULL || writer->records == 0) return;
+    if (writer->format == export_format_json) export_put(writer, ",\n", 2);
+    else export_put_character(writer, '\n');
+}
+
+// Add text as the value of the next column.
+void export_text(struct export_writer* writer, const char* text) {
+    if (writer == NULL) return;
+    if (text == NULL) text = "";
+    export_next_column(writer);
+
+    if (writer->format == export_format_csv) {
+        // Quote text that would otherwise be split, and double its quotes.
+        size_t plain = strcspn(text, ",\"\r\n");
+        if (text[plain] == '\0') {
+            export_put(writer, text, plain);
+            return;
+        }
+        export_put_character(writer, '"');
+        for (;;) {
+            size_t run = strcspn(text, "\"");
+            export_put(writer, text, run);
+            if (text[run] == '\0') break;
+            export_put(writer, "\"\"", 2);
+            text += run + 1;
+        }
+        export_put_character(writer, '"');
+        return;
+    }
+
+    // Escape quotes, backslashes and control characters in JSON strings.
+    export_put_character(writer, '"');
+    for (;;) {
+        const char* run = text;
+        while ((unsigned char)*run >= 0x20 && *run != '"' && *run != '\\') {
+            run++;
+        }
+        export_put(writer, text, (size_t)(run - text));
+        if (*run == '\0') break;
+
+        char escape[8] = {'\\', *run, 0};
+        size_t size = 2;
+        if (*run == '\n') escape[1] = 'n';
+        else if (*run == '\r') escape[1] = 'r';
+        else if (*run == '\t') escape[1] = 't';
+        else if (*run != '"' && *run != '\\') {
+            const char* digits = "0123456789abcdef";
+            memcpy(escape, "\\u00", 4);
+            escape[4] = digits[(unsigned char)*run >> 4];
+            escape[5] = digits[(unsigned char)*run & 15];
+            size = 6;
+        }
+        export_put(writer, escape, size);
+        text = run + 1;
+    }
+    export_put_character(writer, '"');
+}
+
+// Write the digits of value into the end of a buffer of 24 characters.
+// Returns the first digit.
+static char* export_format_integer(long long value, char* buffer) {
+    char* digit = buffer + 24;
+    unsigned long long magnitude = value < 0 \
+    ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        *--digit = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) *--digit = '-';
+    return digit;
+}
+
+// Add an integer, such as an ID or a quantity, as the value of the next
+// column.
+void export_integer(struct export_writer* writer, long long value) {
+    if (writer == NULL) return;
+    export_next_column(writer);
+    char buffer[24];
+    char* digits = export_format_integer(value, buffer);
+    export_put(writer, digits, (size_t)(buffer + 24 - digits));
+}
+
+// Add an amount of money as the value of the next column.
+void export_cents(struct export_writer* writer, enterprise_cents cents) {
+    if (writer == NULL) return;
+    export_next_column(writer);
+    char buffer[ENTERPRISE_CENTS_TEXT_LENGTH];
+    enterprise_cents_format(cents, buffer);
+    export_put(writer, buffer, strlen(buffer));
+}
+
+// Add a yes or no answer as the value of the next column.
+void export_boolean(struct export_writer* writer, bool value) {
+    if (writer == NULL) return;
+    export_next_column(writer);
+    if (value) export_put(writer, "true", 4);
+    else export_put(writer, "false", 5);
+}
+
+// Add a time as the value of the next column, in UTC. A time of 0 means the
+// time is not known, which is left empty in CSV and is null in JSON.
+void export_time(struct export_writer* writer, time_t time) {
+    if (writer == NULL) return;
+    struct tm* parts = time == 0 ? NULL : gmtime(&time);
+    char text[32] = "";
+    if (parts != NULL) {
+        strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", parts);
+    }
+    if (writer->format == export_format_json && text[0] == '\0') {
+        export_next_column(writer);
+        export_put(writer, "null", 4);
+        return;
+    }
+    export_text(writer, text);
+}
+
+// Export every facility.
+void export_facility_list(struct export_writer* writer, \
+struct facility_list* facility_list) {
+    const char* const columns[] = \
+    {"id", "type", "name", "email", "phone", "address"};
+    const char* const types[] = {"Office", "Store", "Warehouse"};
+    struct record_store* store = &facility_list->store;
+    export_begin_table(writer, columns, LEN(columns), store->count);
+    for (struct facility_node* facility = record_store_first(store); \
+    facility != NULL; facility = record_store_next(store, facility)) {
+        export_begin_record(writer);
+        export_integer(writer, facility->id);
+        export_text(writer, (uint32_t)facility->type < LEN(types) \
+        ? types[facility->type] : "");
+        export_text(writer, facility->name);
+        export_text(writer, facility->email);
+        export_text(writer, facility->phone);
+        export_text(writer, facility->address);
+        export_end_record(writer);
+    }
+}
+
+// Export every employee.
+void export_employee_list(struct export_writer* writer, \
+struct employee_list* employee_list) {
+    const char* const columns[] = {"id", "name", "email", "phone", "address"};
+    struct record_store* store = &employee_list->store;
+    export_begin_table(writer, columns, LEN(columns), store->count);
+    for (struct employee_node* employee = record_store_first(store); \
+    employee != NULL; employee = record_store_next(store, employee)) {
+        export_begin_record(writer);
+        export_integer(writer, employee->id);
+        export_text(writer, employee->name);
+        export_text(writer, employee->email);
+        export_text(writer, employee->phone);
+        export_text(writer, employee->address);
+        export_end_record(writer);
+    }
+}
+
+// Export the facilities of every employee.
+void export_employee_facilities(struct export_writer* writer, \
+struct employee_list* employee_list) {
+    const char* const columns[] = {"employee_id", "id", "facility_id"};
+    struct record_store* store = &employee_list->store;
+    uint64_t count = 0;
+    for (struct employee_node* employee = record_store_first(store); \
+    employee != NULL; employee = record_store_next(store, employee)) {
+        if (employee->employee_facility_list == NULL) continue;
+        count += employee->employee_facility_list->store.count;
+    }
+    export_begin_table(writer, columns, LEN(columns), count);
+    for (struct employee_node* employee = record_store_first(store); \
+    employee != NULL; employee = record_store_next(store, employee)) {
+        if (employee->employee_facility_list == NULL) continue;
+        struct record_store* facilities = \
+        &employee->employee_facility_list->store;
+        for (struct employee_facility_node* employee_facility = \
+        record_store_first(facilities); employee_facility != NULL; \
+        employee_facility = record_store_next\
+        (facilities, employee_facility)) {
+            export_begin_record(writer);
+            export_integer(writer, employee->id);
+            export_integer(writer, employee_facility->id);
+            export_integer(writer, employee_facility->facility_id);
+            export_end_record(writer);
+        }
+    }
+}
+
+// Export every item.
+void export_item_list(struct export_writer* writer, \
+struct item_list* item_list) {
+    const char* const columns[] = \
+    {"id", "name", "retail_price", "internal_cost"};
+    struct record_store* store = &item_list->store;
+    export_begin_table(writer, columns, LEN(columns), store->count);
+    for (struct item_node* item = record_store_first(store); item != NULL; \
+    item = record_store_next(store, item)) {
+        export_begin_record(writer);
+        export_integer(writer, item->id);
+        export_text(writer, item->name);
+        export_cents(writer, item->retail_price);
+        export_cents(writer, item->internal_cost);
+        export_end_record(writer);
+    }
+}
+
+// Export the facilities every item is stocked at.
+void export_item_facilities(struct export_writer* writer, \
+struct item_list* item_list) {
+    const char* const columns[] = \
+    {"item_id", "id", "facility_id", "quantity"};
+    struct record_store* store = &item_list->store;
+    uint64_t count = 0;
+    for (struct item_node* item = record_store_first(store); item != NULL; \
+    item = record_store_next(store, item)) {
+        if (item->item_facility_list == NULL) continue;
+        count += item->item_facility_list->store.count;
+    }
+    export_begin_table(writer, columns, LEN(columns), count);
+    for (struct item_node* item = record_store_first(store); item != NULL; \
+    item = record_store_next(store, item)) {
+        if (item->item_facility_list == NULL) continue;
+        struct record_store* facilities = &item->item_facility_list->store;
+        for (struct item_facility_node* item_facility = \
+        record_store_first(facilities); item_facility != NULL; \
+        item_facility = record_store_next(facilities, item_facility)) {
+            export_begin_record(writer);
+            export_integer(writer, item->id);
+            export_integer(writer, item_facility->id);
+            export_integer(writer, item_facility->facility_id);
+            export_integer(writer, item_facility->quantity);
+            export_end_record(writer);
+        }
+    }
+}
+
+// Export every customer.
+void export_customer_list(struct export_writer* writer, \
+struct customer_list* customer_list) {
+    const char* const columns[] = {"id", "name", "email", "phone", "address"};
+    struct record_store* store = &customer_list->store;
+    export_begin_table(writer, columns, LEN(columns), store->count);
+    for (struct customer_node* customer = record_store_first(store); \
+    customer != NULL; customer = record_store_next(store, customer)) {
+        export_begin_record(writer);
+        export_integer(writer, customer->id);
+        export_text(writer, customer->name);
+        export_text(writer, customer->email);
+        export_text(writer, customer->phone);
+        export_text(writer, customer->address);
+        export_end_record(writer);
+    }
+}
+
+// Export every supplier.
+void export_supplier_list(struct export_writer* writer, \
+struct supplier_list* supplier_list) {
+    const char* const columns[] = {"id", "name", "email", "phone", "address"};
+    struct record_store* store = &supplier_list->store;
+    export_begin_table(writer, columns, LEN(columns), store->count);
+    for (struct supplier_node* supplier = record_store_first(store); \
+    supplier != NULL; supplier = record_store_next(store, supplier)) {
+        export_begin_record(writer);
+        export_integer(writer, supplier->id);
+        export_text(writer, supplier->name);
+        export_text(writer, supplier->email);
+        export_text(writer, supplier->phone);
+        export_text(writer, supplier->address);
+        export_end_record(writer);
+    }
+}
+
+// Export every expense.
+void export_expense_list(struct export_writer* writer, \
+struct expense_list* expense_list) {
+    const char* const columns[] = {"id", "type", "facility_id", "supplier_id"};
+    const char* const types[] = {"Rent", "Wage", "Insurance", "Energy", "Misc"};
+    struct record_store* store = &expense_list->store;
+    export_begin_table(writer, columns, LEN(columns), store->count);
+    for (struct expense_node* expense = record_store_first(store); \
+    expense != NULL; expense = record_store_next(store, expense)) {
+        export_begin_record(writer);
+        export_integer(writer, expense->id);
+        export_text(writer, (uint32_t)expense->type < LEN(types) \
+        ? types[expense->type] : "");
+        export_integer(writer, expense->facility_id);
+        export_integer(writer, expense->supplier_id);
+        export_end_record(writer);
+    }
+}
+
+// Export every order.
+void export_order_list(struct export_writer* writer, \
+struct order_list* order_list) {
+    const char* const columns[] = {"id", "supplier_type", "supplier_id", \
+    "recipient_type", "recipient_id", "time_order_placed", "delivered"};
+    struct record_store* store = &order_list->store;
+    export_begin_table(writer, columns, LEN(columns), store->count);
+    for (struct order_node* order = record_store_first(store); \
+    order != NULL; order = record_store_next(store, order)) {
+        export_begin_record(writer);
+        export_integer(writer, order->id);
+        export_text(writer, order->supplier_type == order_supplier_facility \
+        ? "Facility" : "Supplier");
+        export_integer(writer, order->supplier_id);
+        export_text(writer, order->recipient_type == order_recipient_customer \
+        ? "Customer" : "Facility");
+        export_integer(writer, order->recipient_id);
+        export_time(writer, order->time_order_placed);
+        export_boolean(writer, order->delivered);
+        export_end_record(writer);
+    }
+}
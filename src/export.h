@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_FACILITIES
+#define ENTERPRISE_FACILITIES
+#include "facilities.h"
+#endif
+
+#ifndef ENTERPRISE_EMPLOYEES
+#define ENTERPRISE_EMPLOYEES
+#include "employees.h"
+#endif
+
+#ifndef ENTERPRISE_ITEMS
+#define ENTERPRISE_ITEMS
+#include "inventory.h"
+#endif
+
+#ifndef ENTERPRISE_CUSTOMERS
+#define ENTERPRISE_CUSTOMERS
+#include "customers.h"
+#endif
+
+#ifndef ENTERPRISE_SUPPLIERS
+#define ENTERPRISE_SUPPLIERS
+#include "suppliers.h"
+#endif
+
+#ifndef ENTERPRISE_EXPENSES
+#define ENTERPRISE_EXPENSES
+#include "expenses.h"
+#endif
+
+#ifndef ENTERPRISE_ORDERS
+#define ENTERPRISE_ORDERS
+#include "orders.h"
+#endif
+
+#ifndef ENTERPRISE_WORKER_POOL
+#define ENTERPRISE_WORKER_POOL
+#include "worker_pool.h"
+#endif
+
+/* How exports work.
+Every list of the enterprise, and the facilities of every employee and item,
+can be exported as a table for other programs, such as a spreadsheet, in
+either CSV or JSON.
+
+A CSV export starts with a header line naming the columns, followed by a line
+per record. Text holding commas, quotes or line breaks is quoted, in the same
+way the CSV import (see csv.c) reads it, and the columns of facilities,
+customers, suppliers and items have the names the import looks for.
+
+A JSON export is an array holding an object per record, one record per line,
+with a member per column. IDs, quantities and amounts are numbers, amounts
+with two decimal places, and times are text in ISO 8601 form.
+
+Records are formatted straight into a buffer of EXPORT_BUFFER_SIZE bytes that
+is written to the file each time it fills up, so a table is never held in
+memory whatever its size, and no record is formatted with printf.
+
+Data structures:
+export_writer: The file being exported to, its buffer and the current table.
+*/
+
+#define EXPORT_BUFFER_SIZE (256 * 1024)
+#define EXPORT_PROGRESS_INTERVAL 4096
+
+// The formats tables can be exported in.
+enum export_format {export_format_csv, export_format_json, \
+export_format_count};
+
+// The tables that can be exported.
+enum export_table {export_table_facilities, export_table_employees, \
+export_table_employee_facilities, export_table_items, \
+export_table_item_facilities, export_table_customers, export_table_suppliers, \
+export_table_expenses, export_table_orders, export_table_count};
+
+// Export writer structure.
+struct export_writer {
+    FILE* file;
+    enum export_format format;
+    bool failed;
+
+    char* buffer;
+    size_t used;
+
+    // The columns of the table being written, the column of the next value,
+    // and how many records have been written.
+    const char* const* columns;
+    uint32_t column_count;
+    uint32_t column;
+    uint64_t records;
+
+    // Where the records written are noted every EXPORT_PROGRESS_INTERVAL
+    // records, or NULL.
+    struct worker_pool_progress* progress;
+};
+
+extern const char* const export_format_names[export_format_count];
+extern const char* const export_table_names[export_table_count];
+bool export_writer_init(struct export_writer* writer, FILE* file, \
+enum export_format format);
+void export_flush(struct export_writer* writer);
+void export_writer_free(struct export_writer* writer);
+void export_begin_table(struct export_writer* writer, \
+const char* const* columns, uint32_t column_count, uint64_t record_count);
+void export_end_record(struct export_writer* writer);
+bool export_end_table(struct export_writer* writer);
+void export_begin_record(struct export_writer* writer);
+void export_text(struct export_writer* writer, const char* text);
+void export_integer(struct export_writer* writer, long long value);
+void export_cents(struct export_writer* writer, enterprise_cents cents);
+void export_boolean(struct export_writer* writer, bool value);
+void export_time(struct export_writer* writer, time_t time);
+void export_facility_list(struct export_writer* writer, \
+struct facility_list* facility_list);
+void export_employee_list(struct export_writer* writer, \
+struct employee_list* employee_list);
+void export_employee_facilities(struct export_writer* writer, \
+struct employee_list* employee_list);
+void export_item_list(struct export_writer* writer, \
+struct item_list* item_list);
+void export_item_facilities(struct export_writer* writer, \
+struct item_list* item_list);
+void export_customer_list(struct export_writer* writer, \
+struct customer_list* customer_list);
+void export_supplier_list(struct export_writer* writer, \
+struct supplier_list* supplier_list);
+void export_expense_list(struct export_writer* writer, \
+struct expense_list* expense_list);
+void export_order_list(struct export_writer* writer, \
+struct order_list* order_list);
@@ -9,127 +9,93 @@
 #include <limits.h>
 #include <time.h>
 
-#include "constants.c"
-
-#ifndef PROGRAM_STATES
-#define PROGRAM_STATES
-#include "program_states.c"
-#endif
-
-
-// Import Nuklear.
-#ifndef ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
+// Import Nuklear, unless building without the GUI.
+#if !defined(ENTERPRISE_NUKLEAR_LIBRARY_IMPORT) \
+&& !defined(ENTERPRISE_HEADLESS)
 #define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-    #define NK_INCLUDE_FIXED_TYPES
-    #define NK_INCLUDE_STANDARD_IO
-    #define NK_INCLUDE_STANDARD_VARARGS
-    #define NK_INCLUDE_DEFAULT_ALLOCATOR
-    #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    #define NK_INCLUDE_FONT_BAKING
-    #define NK_INCLUDE_DEFAULT_FONT
-    #define NK_IMPLEMENTATION
-    #define NK_SDL_GLES2_IMPLEMENTATION
-    #include "../third_party/Nuklear/nuklear.h"
-    #include "../third_party/Nuklear/demo/sdl_opengles2/nuklear_sdl_gles2.h"
-    #include "../third_party/Nuklear/demo/common/style.c"
+#include "nuklear_import.h"
 #endif
 
-
-/* How facilities work.
-Facilities are stored in a struct that contains a pointer to the head of a
-linked list containing all the facilities. The struct that stores the linked
-list is directly added to the enterprise struct and stores metadata about the
-list. All facilities are assigned a unique ID, no two facilities can have the
-same ID, the facility_list structure keeps track of that.
-
-Data structures:
-Facility_node: An individual facility.
-Facility_list: A structure holding important metadata about the facility
-linked list.
-
-Facility list metadata:
-facility_list->id_last_assigned: This is incremented by 1 every time a new
-facility is added in order to ensure no two facilities ever have the same ID.
-
-facility_list->id_currently_selected: This is the ID that is selected in the
-facility editor dialogue.
-*/
-
-// Facility node.
-enum facility_type \
-{facility_type_office, facility_type_store, facility_type_warehouse};
-
-struct facility_node {
-    char id[ENTERPRISE_STRING_LENGTH];
-    char name[ENTERPRISE_STRING_LENGTH];
-    char email[ENTERPRISE_STRING_LENGTH];
-    char phone[ENTERPRISE_STRING_LENGTH];
-    char address[ENTERPRISE_STRING_LENGTH];
-
-    enum facility_type type;
-
-    struct facility_node* prev;
-    struct facility_node* next;
-};
+#ifndef ENTERPRISE_FACILITIES
+#define ENTERPRISE_FACILITIES
+#include "facilities.h"
+#endif
 
 // Facility node constructor and initialiser.
+// The node is added to the end of the passed in record store.
 // Returns facility node on success, or NULL on failure.
-struct facility_node *facility_node_new() {
-    struct facility_node* facility = malloc(sizeof(struct facility_node));
+struct facility_node *facility_node_new(struct record_store* store) {
+    struct facility_node* facility = record_store_append(store);
     if (facility == NULL) return NULL;
-    strcpy(facility->id, "");
-    strcpy(facility->name, "");
-    strcpy(facility->email, "");
-    strcpy(facility->phone, "");
-    strcpy(facility->address, "");
+    facility->id = ENTERPRISE_ID_NONE;
+    facility->name = "";
+    facility->email = "";
+    facility->phone = "";
+    facility->address = "";
     
     facility->type = facility_type_office;
 
-    facility->prev = NULL;
-    facility->next = NULL;
-
     return facility;
 }
 
-// Facility list metadata structure.
-struct facility_list {
-    struct facility_node *head;
-    char id_last_assigned[ENTERPRISE_STRING_LENGTH];
-    char id_currently_selected[ENTERPRISE_STRING_LENGTH];
-    bool deletion_requested;
-};
+// Free everything associated with a facility and remove it from its store.
+void facility_node_free(struct string_pool* string_pool,\
+struct record_store* store, struct facility_node* facility) {
+    if (facility == NULL) return;
+    string_pool_release(string_pool, facility->name);
+    string_pool_release(string_pool, facility->email);
+    string_pool_release(string_pool, facility->phone);
+    string_pool_release(string_pool, facility->address);
+    record_store_remove(store, facility);
+}
 
 // Facility list constructor.
 // Returns facility list on success, or NULL on failure.
-struct facility_list* facility_list_new() {
+struct facility_list* facility_list_new(struct string_pool* string_pool) {
     struct facility_list* facility_list = malloc(sizeof(struct facility_list));
     if (facility_list == NULL) return NULL;
-    facility_list->head = NULL;
-    strcpy(facility_list->id_last_assigned, "0");
-    strcpy(facility_list->id_currently_selected, "0");
+    record_store_init(&facility_list->store, sizeof(struct facility_node));
+    id_index_init(&facility_list->id_index);
+    facility_list->journal = NULL;
+    facility_references_init(&facility_list->references, NULL, NULL);
+    facility_list->version = 0;
+    row_labels_init(&facility_list->row_labels);
+    facility_list->string_pool = string_pool;
+    facility_list->edit_id = ENTERPRISE_ID_NONE;
+    strcpy(facility_list->edit_name, "");
+    strcpy(facility_list->edit_email, "");
+    strcpy(facility_list->edit_phone, "");
+    strcpy(facility_list->edit_address, "");
+    facility_list->id_last_assigned = ENTERPRISE_ID_NONE;
+    facility_list->id_currently_selected = ENTERPRISE_ID_NONE;
+    facility_list->handle_currently_selected = RECORD_STORE_NONE;
     facility_list->deletion_requested = false;
     return facility_list;
 }
 
-// Free an entire facility linked list
-void facility_node_linked_list_free(struct facility_node* facility) {
-    if (facility == NULL) return;
-    struct facility_node* next = NULL;
-    while (facility != NULL) {
-        next = facility->next;
-        free(facility);
-        facility = next;
-    }
-}
-
 // Free all memory associated with a facility list.
 void facility_list_free(struct facility_list* facility_list) {
     if (facility_list == NULL) return;
 
-    if (facility_list->head != NULL) {
-        facility_node_linked_list_free(facility_list->head);
+    // Free every facility, giving their text back to the string pool. There is
+    // nothing to give back if the pool is being dropped, and the record store
+    // frees every facility at once.
+    if (string_pool_is_dropping(facility_list->string_pool) == false) {
+        struct facility_node* facility = \
+        record_store_first(&facility_list->store);
+        while (facility != NULL) {
+            struct facility_node* next = \
+            record_store_next(&facility_list->store, facility);
+            facility_node_free(facility_list->string_pool, \
+            &facility_list->store, facility);
+            facility = next;
+        }
     }
 
+    row_labels_free(&facility_list->row_labels);
+    facility_references_free(&facility_list->references);
+    id_index_free(&facility_list->id_index);
+    record_store_free(&facility_list->store);
     free(facility_list);
     return;
 }
@@ -139,32 +105,26 @@ void facility_list_append(struct facility_list* facility_list) {
     if (facility_list == NULL) return;
 
     // Increment unique ID by 1.
-    char buffer[ENTERPRISE_STRING_LENGTH];
-    sprintf(buffer, "%lld", atoll(facility_list->id_last_assigned) + 1);
-    strcpy(facility_list->id_last_assigned, buffer);
-
-    // Add new node to start of facility list if facility linked list does
-    // not exist.
-    if (facility_list->head == NULL) {
-        facility_list->head = facility_node_new();
-        strcpy(facility_list->head->id, facility_list->id_last_assigned);
-        strcpy(facility_list->id_currently_selected,
-        facility_list->id_last_assigned);
+    facility_list->id_last_assigned++;
+
+    // Add the new node to the end of the list.
+    struct facility_node* facility = facility_node_new(&facility_list->store);
+    if (facility == NULL) return;
+
+    facility->id = facility_list->id_last_assigned;
+
+    // Index the new node by its ID so it can be found without a search.
+    if (id_index_insert(&facility_list->id_index, facility->id, \
+    record_store_handle(facility)) == false) {
+        record_store_remove(&facility_list->store, facility);
         return;
     }
 
-    // Else add the new node to the end of the list.
-    struct facility_node* facility = facility_list->head;
-    while (facility->next != NULL) {
-        facility = facility->next;
-    }
-    
-    facility->next = facility_node_new();
-    facility->next->prev = facility;
+    facility_list->id_currently_selected = facility_list->id_last_assigned;
 
-    strcpy(facility->next->id, facility_list->id_last_assigned);
-    strcpy(facility_list->id_currently_selected,
-    facility_list->id_last_assigned);
+    facility_list->version++;
+    journal_put(facility_list->journal, journal_list_facilities, \
+    ENTERPRISE_ID_NONE, facility->id);
 
     return;
 }
@@ -172,154 +132,122 @@ void facility_list_append(struct facility_list* facility_list) {
 // Get the number of facility nodes in the facility list
 int facility_list_get_num_facility_nodes(struct facility_list* facility_list) {
     if (facility_list == NULL) return 0;
-    if (facility_list->head == NULL) return 0;
+    return (int)facility_list->store.count;
+}
 
-    struct facility_node* facility = facility_list->head;
-    int facility_count = 0;
-    while (facility != NULL) {
-        facility_count++;
-        facility = facility->next;
-    }
-    return facility_count;
+// Make room in a facility list and its ID index for count more facilities.
+// Returns true on success, or false on failure.
+bool facility_list_reserve(struct facility_list* facility_list, \
+uint32_t count) {
+    if (facility_list == NULL) return false;
+    return record_store_reserve(&facility_list->store, count) \
+    && id_index_reserve(&facility_list->id_index, count);
 }
 
 // Return a pointer to a facility node according to ID.
 // Returns NULL on failure.
 struct facility_node *facility_list_get_node\
-(struct facility_list *facility_list, char *id) {
-    if (facility_list == NULL || id == NULL) return NULL;
-    if (facility_list->head == NULL) return NULL;
-
-    struct facility_node* facility = facility_list->head;
-    while (facility != NULL) {
-        if (strcmp(facility->id, id) == 0) return facility;
-        facility = facility->next;
-    }
-    return NULL;
+(struct facility_list *facility_list, enterprise_id id) {
+    if (facility_list == NULL) return NULL;
+    return record_store_get\
+    (&facility_list->store, id_index_find(&facility_list->id_index, id));
 }
 
-// Searches for a facility by ID and deletes it
-void facility_list_delete_node(struct facility_list *facility_list, char *id) {
-    if (facility_list == NULL || id == NULL) return;
-    if (facility_list->head == NULL) return;
-
-    // Delete the head if it is the ID that is requested to be deleted.
-    if (strcmp(id, facility_list->head->id) == 0) {
-        if (facility_list->head->next == NULL) {
-            free(facility_list->head);
-            facility_list->head = NULL;
-            return;
-        }
-
-        struct facility_node *next = facility_list->head->next;
-        free(facility_list->head);
-        facility_list->head = next;
-        return;
-    }
+// Return a pointer to the currently selected facility node.
+// The selected facility's handle is checked before its ID is looked up, so this
+// only searches the ID index after the selection was changed by ID.
+// Returns NULL if no facility is selected.
+struct facility_node *facility_list_get_selected_node\
+(struct facility_list *facility_list) {
+    if (facility_list == NULL) return NULL;
 
-    // Else search for the facility to delete.
-    struct facility_node* facility = facility_list->head;
-    while (facility != NULL) {
-        if (strcmp(facility->id, id) == 0) break;
-        facility = facility->next;
+    struct facility_node* facility = record_store_get\
+    (&facility_list->store, facility_list->handle_currently_selected);
+    if (facility == NULL \
+    || facility->id != facility_list->id_currently_selected) {
+        facility = facility_list_get_node\
+        (facility_list, facility_list->id_currently_selected);
+        facility_list->handle_currently_selected = \
+        record_store_handle(facility);
     }
-    if (facility == NULL) return;
+    return facility;
+}
 
-    // Fix the pointers of the next and previous nodes to the facility to be
-    // deleted in order to ensure that traversal still works.
+// Searches for a facility by ID and deletes it
+void facility_list_delete_node\
+(struct facility_list *facility_list, enterprise_id id) {
+    if (facility_list == NULL) return;
 
-    struct facility_node* prev = facility->prev;
-    struct facility_node* next = facility->next;
+    struct facility_node* facility = facility_list_get_node(facility_list, id);
+    if (facility == NULL) return;
 
-    if (prev != NULL) {
-        if (next == NULL) {
-            prev->next = NULL;
-            strcpy(facility_list->id_currently_selected, prev->id);
-        }
-        if (next != NULL) {
-            prev->next = next;
-            next->prev = prev;
-            strcpy(facility_list->id_currently_selected, next->id);
-        }
+    // Select the node after the deleted facility, or the node before it if the
+    // deleted facility is the last one.
+    struct facility_node* prev = record_store_prev(&facility_list->store, facility);
+    struct facility_node* next = record_store_next(&facility_list->store, facility);
+    if (next != NULL) {
+        facility_list->id_currently_selected = next->id;
     }
-
-    if (prev == NULL) {
-        if (next != NULL) {
-            next->prev = NULL;
-            strcpy(facility_list->id_currently_selected, next->id);
-        }
+    else if (prev != NULL) {
+        facility_list->id_currently_selected = prev->id;
     }
 
-    // Delete the facility
-    free(facility);
+    facility_list->version++;
+    journal_delete(facility_list->journal, journal_list_facilities, \
+    ENTERPRISE_ID_NONE, facility->id);
+
+    // Delete the facility, and forget whatever still refers to it.
+    facility_references_forget(&facility_list->references, facility->id);
+    id_index_remove(&facility_list->id_index, facility->id);
+    facility_node_free(facility_list->string_pool, \
+    &facility_list->store, facility);
     return;
 }
 
 // Select the previous node as the currently selected item.
 void facility_list_select_previous_node(struct facility_list *facility_list) {
     if (facility_list == NULL) return;
-    if (facility_list->head == NULL) return;
-
-    struct facility_node* facility = facility_list->head;
-    while (facility != NULL) {
-        if (strcmp(facility->id, facility_list->id_currently_selected) == 0) {
-            if (facility->prev != NULL) {
-                strcpy(facility_list->id_currently_selected, facility->prev->id);
-                return;
-            }
-            if (facility->prev == NULL) {
-                struct facility_node* temp = facility;
-                while (temp->next != NULL) {
-                    temp = temp->next;
-                }
-                strcpy(facility_list->id_currently_selected, temp->id);
-                return;
-            }
-        }
-        facility = facility->next;
-    }
+
+    struct facility_node* facility = \
+    facility_list_get_selected_node(facility_list);
+    if (facility == NULL) return;
+
+    // Wrap around to the last facility if the first one is selected.
+    struct facility_node* prev = record_store_prev(&facility_list->store, facility);
+    if (prev == NULL) prev = record_store_last(&facility_list->store);
+    facility_list->id_currently_selected = prev->id;
+    facility_list->handle_currently_selected = record_store_handle(prev);
 }
 
 // Select the next node as the currently selected item.
 void facility_list_select_next_node(struct facility_list *facility_list) {
     if (facility_list == NULL) return;
-    if (facility_list->head == NULL) return;
-
-    struct facility_node* facility = facility_list->head;
-    while (facility != NULL) {
-        if (strcmp(facility->id, facility_list->id_currently_selected) == 0) {
-            if (facility->next != NULL) {
-                strcpy(facility_list->id_currently_selected, facility->next->id);
-                return;
-            }
-            if (facility->next == NULL) {
-                strcpy(facility_list->id_currently_selected,\
-                facility_list->head->id);
-                return;
-            }
-        }
-        facility = facility->next;
-    }
+
+    struct facility_node* facility = \
+    facility_list_get_selected_node(facility_list);
+    if (facility == NULL) return;
+
+    // Wrap around to the first facility if the last one is selected.
+    struct facility_node* next = record_store_next(&facility_list->store, facility);
+    if (next == NULL) next = record_store_first(&facility_list->store);
+    facility_list->id_currently_selected = next->id;
+    facility_list->handle_currently_selected = record_store_handle(next);
 }
 
 // Change the currently selected ID to the passed in ID in the facility list.
 void facility_list_set_selected_id\
-(struct facility_list *facility_list, char* id) {
-    if (facility_list == NULL || id == NULL) return;
-    if (facility_list->head == NULL) return;
-
-    struct facility_node* facility = facility_list->head;
-    while (facility != NULL) {
-        if (strcmp(facility->id, id) == 0) {
-            strcpy(facility_list->id_currently_selected, id);
-        }
-        facility = facility->next;
+(struct facility_list *facility_list, enterprise_id id) {
+    if (facility_list == NULL) return;
+
+    if (facility_list_get_node(facility_list, id) != NULL) {
+        facility_list->id_currently_selected = id;
     }
 }
 
 // Get the facility type back as a string:
-char* facility_list_get_node_type(struct facility_list* facility_list, char* id) {
-    if (facility_list == NULL || id == NULL) return NULL;
+char* facility_list_get_node_type\
+(struct facility_list* facility_list, enterprise_id id) {
+    if (facility_list == NULL) return NULL;
     
     struct facility_node* facility = facility_list_get_node(facility_list, id);
     if (facility == NULL) return NULL;
@@ -331,6 +259,32 @@ char* facility_list_get_node_type(struct facility_list* facility_list, char* id)
     return NULL;
 }
 
+// Make the labels of row_count rows of the facility table, starting at
+// first_row, unless they are cached already.
+void facility_list_label_rows(struct facility_list* facility_list, \
+uint32_t first_row, uint32_t row_count) {
+    if (facility_list == NULL) return;
+    struct row_labels* labels = &facility_list->row_labels;
+    if (row_labels_current(labels, facility_list->version, first_row, \
+    row_count)) return;
+
+    row_labels_begin(labels, facility_list->version, first_row, row_count);
+    struct facility_node* facility = \
+    record_store_seek(&facility_list->store, first_row);
+    for (uint32_t row = 0; row < row_count && facility != NULL; row++) {
+        if (row_labels_add(labels, facility->id, \
+        "ID: %lld Type: %s Name: %s Email: %s Phone: %s Address: %s",\
+        facility->id, \
+        facility_list_get_node_type(facility_list, facility->id),\
+        facility->name, facility->email, facility->phone, \
+        facility->address) == false) break;
+        facility = record_store_next(&facility_list->store, facility);
+    }
+}
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+
 // Render the facility table GUI.
 // This function displays a list of facilities as a table that can be selected.
 // It is an overview.
@@ -353,32 +307,38 @@ struct facility_list* facility_list) {
     }
 
     // If there are no facilities, warn the user.
-    if (facility_list->head == NULL) {
+    if (record_store_first(&facility_list->store) == NULL) {
         nk_label(ctx, "No facilities found.", NK_TEXT_CENTERED);
         return program_status_facility_table;
     }
 
-    /* If there are facilities, go through the linked list of facilities.
-    Copy the data from each facility and make it a button label.
-    When the button is pressed, set the currently selected facility to that
+    /* If there are facilities, make a button for each facility in view.
+    Only the rows scrolled into view are drawn, and their labels are only
+    formatted again when different rows come into view or the list changes.
+    When a button is pressed, set the currently selected facility to that
     facility and switch to facility editor.*/
-    struct facility_node* facility = facility_list->head;
-    char* print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-    while (facility != NULL) {
-        sprintf(print_buffer, \
-        "ID: %s Type: %s Name: %s Email: %s Phone: %s Address: %s",facility->id,\
-        facility_list_get_node_type(facility_list, facility->id),
-        facility->name, facility->email, facility->phone, facility->address);
-
-        if (nk_button_label(ctx, print_buffer)) {
-            strcpy(facility_list->id_currently_selected, facility->id);
-            free(print_buffer);
-            return program_status_facility_editor;
+    enum program_status status = program_status_facility_table;
+    struct nk_list_view view;
+    int rows = facility_list->store.count > INT_MAX \
+    ? INT_MAX : (int)facility_list->store.count;
+    nk_layout_row_dynamic(ctx, ENTERPRISE_TABLE_HEIGHT, 1);
+    if (nk_list_view_begin(ctx, &view, "facility_table", \
+    NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+        nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+        struct row_labels* labels = &facility_list->row_labels;
+        facility_list_label_rows(facility_list, \
+        (uint32_t)view.begin, (uint32_t)view.count);
+
+        for (uint32_t row = 0; row < labels->count; row++) {
+            if (nk_button_label(ctx, row_labels_text(labels, row))) {
+                facility_list->id_currently_selected = \
+                row_labels_id(labels, row);
+                status = program_status_facility_editor;
+            }
         }
-        facility = facility->next;
+        nk_list_view_end(&view);
     }
-    free(print_buffer);
-    return program_status_facility_table;
+    return status;
 }
 
 // Render the facility editor GUI.
@@ -396,14 +356,15 @@ struct facility_list* facility_list) {
     nk_label(ctx, "Facility Editor", NK_TEXT_CENTERED);
     
     // Select currently selected facility.
-    struct facility_node* facility = facility_list_get_node\
-    (facility_list, facility_list->id_currently_selected);
+    struct facility_node* facility = \
+    facility_list_get_selected_node(facility_list);
 
     // If the currently selected facility does not exist:
     if (facility == NULL) {
         // Select the first facility instead.
-        if (facility_list->head != NULL) {
-            strcpy(facility_list->id_currently_selected, facility_list->head->id);
+        facility = record_store_first(&facility_list->store);
+        if (facility != NULL) {
+            facility_list->id_currently_selected = facility->id;
             return program_status_facility_editor;
         }
 
@@ -418,6 +379,16 @@ struct facility_list* facility_list) {
         }
     }
 
+    // Copy the selected facility's text into the edit buffers whenever a
+    // different facility is selected.
+    if (facility_list->edit_id != facility->id) {
+        facility_list->edit_id = facility->id;
+        strcpy(facility_list->edit_name, facility->name);
+        strcpy(facility_list->edit_email, facility->email);
+        strcpy(facility_list->edit_phone, facility->phone);
+        strcpy(facility_list->edit_address, facility->address);
+    }
+
     // Display edit fields to edit facility entries.
     nk_layout_row_template_begin(ctx, ENTERPRISE_WIDGET_HEIGHT);
     nk_layout_row_template_push_static(ctx, 150);
@@ -435,29 +406,64 @@ struct facility_list* facility_list) {
     type = nk_combo(ctx, facility_types, NK_LEN(facility_types), type, \
     ENTERPRISE_WIDGET_HEIGHT, nk_vec2(WINDOW_WIDTH, 200));
 
+    enum facility_type type_before = facility->type;
     if (type == 0) facility->type = facility_type_office;
     if (type == 1) facility->type = facility_type_store;
     if (type == 2) facility->type = facility_type_warehouse;
 
+    char id_text[ENTERPRISE_ID_TEXT_LENGTH];
+    enterprise_id_format(facility->id, id_text);
     nk_label(ctx, "ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_READ_ONLY, \
-    facility->id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Name: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    facility->name, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    facility_list->edit_name, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Phone: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    facility->phone, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    facility_list->edit_phone, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Email: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    facility->email, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    facility_list->edit_email, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Address: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    facility->address, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    facility_list->edit_address, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+
+    // Store any edits back into the facility, and note them in the journal.
+    bool edited = facility->type != type_before;
+    edited |= string_pool_assign(facility_list->string_pool, \
+    &facility->name, facility_list->edit_name);
+    edited |= string_pool_assign(facility_list->string_pool, \
+    &facility->email, facility_list->edit_email);
+    edited |= string_pool_assign(facility_list->string_pool, \
+    &facility->phone, facility_list->edit_phone);
+    edited |= string_pool_assign(facility_list->string_pool, \
+    &facility->address, facility_list->edit_address);
+    if (edited) {
+        facility_list->version++;
+        journal_put(facility_list->journal, journal_list_facilities, \
+        ENTERPRISE_ID_NONE, facility->id);
+    }
+
+    // Show how much refers to the facility. The references are built the
+    // first time a facility is shown, and only counted after that.
+    struct facility_references* references = &facility_list->references;
+    uint32_t employee_count = facility_references_count(references, \
+    facility->id, facility_reference_employee);
+    uint32_t item_count = facility_references_count(references, \
+    facility->id, facility_reference_item);
+    uint32_t expense_count = facility_references_count(references, \
+    facility->id, facility_reference_expense);
+    char references_text[ENTERPRISE_STRING_LENGTH];
+    snprintf(references_text, sizeof(references_text), \
+    "Employees: %u Items: %u Expenses: %u", \
+    employee_count, item_count, expense_count);
+    nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+    nk_label(ctx, references_text, NK_TEXT_CENTERED);
 
     // Move between next and previous facilities.
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 2);
@@ -479,17 +485,25 @@ struct facility_list* facility_list) {
 
     // Create deletion button.
     // This will ask the user to confirm whether they want to delete the node.
+    // Everything that refers to the facility is deleted along with it, which
+    // needs the other lists, so the deletion is handed to the program loop.
     if (nk_button_label(ctx, "Delete Facility")) {
         facility_list->deletion_requested = true;
     }
 
     if (facility_list->deletion_requested == true) {
-        nk_label(ctx, "Confirm deletion?", NK_TEXT_CENTERED);
+        if (employee_count + item_count + expense_count == 0) {
+            nk_label(ctx, "Confirm deletion?", NK_TEXT_CENTERED);
+        }
+        else {
+            nk_label(ctx, "Confirm deletion? The facility will be removed "
+            "from its employees, items and expenses.", NK_TEXT_CENTERED);
+        }
         nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 2);
 
         if (nk_button_label(ctx, "Yes")) {
-            facility_list_delete_node(facility_list, facility->id);
             facility_list->deletion_requested = false;
+            return program_status_facility_delete;
         }
         if (nk_button_label(ctx, "No")) {
             facility_list->deletion_requested = false;
@@ -497,4 +511,6 @@ struct facility_list* facility_list) {
     }
     
     return program_status_facility_editor;
-}
\ No newline at end of file
+}
+
+#endif
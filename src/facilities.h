@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_STRING_POOL
+#define ENTERPRISE_STRING_POOL
+#include "string_pool.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+#ifndef ENTERPRISE_FACILITY_REFERENCES
+#define ENTERPRISE_FACILITY_REFERENCES
+#include "facility_references.h"
+#endif
+
+#ifndef ENTERPRISE_JOURNAL
+#define ENTERPRISE_JOURNAL
+#include "journal.h"
+#endif
+
+#ifndef ENTERPRISE_ROW_LABELS
+#define ENTERPRISE_ROW_LABELS
+#include "row_labels.h"
+#endif
+
+#ifndef PROGRAM_STATES
+#define PROGRAM_STATES
+#include "program_states.h"
+#endif
+
+// Nuklear's context, taken by the GUI functions. Only the sources of
+// those functions import Nuklear itself.
+struct nk_context;
+
+/* How facilities work.
+A facility is an office, store or warehouse of the enterprise. Employees work
+at facilities, items are stocked at them, expenses are made at them, and
+orders can be sent from or to them. The facility list is laid out like every
+other list of the enterprise (see record_store.c).
+
+The facility list also keeps the facility references: the employees, items and
+expenses that refer to each facility (see facility_references.c).
+
+Data structures:
+facility_node: A facility.
+facility_list: The facilities of the enterprise.
+*/
+
+// Facility node.
+enum facility_type \
+{facility_type_office, facility_type_store, facility_type_warehouse};
+
+struct facility_node {
+    enterprise_id id;
+    const char* name;
+    const char* email;
+    const char* phone;
+    const char* address;
+
+    enum facility_type type;
+};
+
+// Facility list metadata structure.
+struct facility_list {
+    struct record_store store;
+    struct id_index id_index;
+    struct string_pool* string_pool;
+
+    // Where changes to the list are recorded, or NULL if they are not.
+    struct journal* journal;
+
+    // What refers to each facility, kept up to date by the lists that refer
+    // to facilities once it is built.
+    struct facility_references references;
+
+    // Bumped whenever a node is appended, edited or deleted, so that the
+    // labels cached for the list's table know when they are stale.
+    uint64_t version;
+    struct row_labels row_labels;
+
+    // Editable copies of the text of the node open in the editor.
+    enterprise_id edit_id;
+    char edit_name[ENTERPRISE_STRING_LENGTH];
+    char edit_email[ENTERPRISE_STRING_LENGTH];
+    char edit_phone[ENTERPRISE_STRING_LENGTH];
+    char edit_address[ENTERPRISE_STRING_LENGTH];
+
+    enterprise_id id_last_assigned;
+    enterprise_id id_currently_selected;
+    uint32_t handle_currently_selected;
+    bool deletion_requested;
+};
+
+struct facility_node *facility_node_new(struct record_store* store);
+void facility_node_free(struct string_pool* string_pool,\
+struct record_store* store, struct facility_node* facility);
+struct facility_list* facility_list_new(struct string_pool* string_pool);
+void facility_list_free(struct facility_list* facility_list);
+void facility_list_append(struct facility_list* facility_list);
+int facility_list_get_num_facility_nodes(struct facility_list* facility_list);
+bool facility_list_reserve(struct facility_list* facility_list, \
+uint32_t count);
+struct facility_node *facility_list_get_node\
+(struct facility_list *facility_list, enterprise_id id);
+struct facility_node *facility_list_get_selected_node\
+(struct facility_list *facility_list);
+void facility_list_delete_node\
+(struct facility_list *facility_list, enterprise_id id);
+void facility_list_select_previous_node(struct facility_list *facility_list);
+void facility_list_select_next_node(struct facility_list *facility_list);
+void facility_list_set_selected_id\
+(struct facility_list *facility_list, enterprise_id id);
+char* facility_list_get_node_type\
+(struct facility_list* facility_list, enterprise_id id);
+void facility_list_label_rows(struct facility_list* facility_list, \
+uint32_t first_row, uint32_t row_count);
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+enum program_status facility_table(struct nk_context* ctx,\
+struct facility_list* facility_list);
+enum program_status facility_editor(struct nk_context* ctx,\
+struct facility_list* facility_list);
+#endif
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_FACILITY_REFERENCES
+#define ENTERPRISE_FACILITY_REFERENCES
+#include "facility_references.h"
+#endif
+
+// Initialise empty facility references that are built by gather, passing it
+// context.
+void facility_references_init(struct facility_references* references, \
+facility_references_gather gather, void* context) {
+    if (references == NULL) return;
+    memset(references, 0, sizeof(struct facility_references));
+    references->gather = gather;
+    references->context = context;
+    id_index_init(&references->facility_index);
+}
+
+// Free all memory associated with facility references.
+// The references are left empty and unbuilt, and can be reused.
+void facility_references_free(struct facility_references* references) {
+    if (references == NULL) return;
+    for (uint32_t position = 0; position < references->set_count; \
+    position++) {
+        free(references->sets[position].references);
+    }
+    free(references->sets);
+    id_index_free(&references->facility_index);
+    facility_references_init(references, references->gather, \
+    references->context);
+}
+
+// Returns the position of a facility's references, adding an empty set for it
+// if it has none yet, or UINT32_MAX on failure.
+static uint32_t facility_references_set\
+(struct facility_references* references, enterprise_id facility_id) {
+    uint32_t position = \
+    id_index_find(&references->facility_index, facility_id);
+    if (position != RECORD_STORE_NONE) return position;
+
+    if (references->set_count == references->set_capacity) {
+        uint32_t capacity = references->set_capacity == 0 \
+        ? FACILITY_REFERENCES_FIRST_CAPACITY : references->set_capacity * 2;
+        struct facility_reference_set* sets = realloc(references->sets, \
+        sizeof(struct facility_reference_set) * capacity);
+        if (sets == NULL) return UINT32_MAX;
+        references->sets = sets;
+        references->set_capacity = capacity;
+    }
+
+    position = references->set_count;
+    if (id_index_insert(&references->facility_index, facility_id, position) \
+    == false) return UINT32_MAX;
+    struct facility_reference_set* set = &references->sets[position];
+    memset(set, 0, sizeof(struct facility_reference_set));
+    set->facility_id = facility_id;
+    references->set_count++;
+    return position;
+}
+
+// Add a reference of type by the node with ID owner_id to the facility with
+// ID facility_id. References to no facility are not kept.
+// Does nothing until the references are built. On failure the references
+// are freed so that they are built again the next time they are used.
+// Returns true on success, or false on failure.
+bool facility_references_add(struct facility_references* references, \
+enterprise_id facility_id, enum facility_reference_type type, \
+enterprise_id owner_id) {
+    if (references == NULL || references->built == false || \
+    facility_id == ENTERPRISE_ID_NONE) return true;
+
+    uint32_t position = facility_references_set(references, facility_id);
+    if (position == UINT32_MAX) {
+        facility_references_free(references);
+        return false;
+    }
+    struct facility_reference_set* set = &references->sets[position];
+    if (set->count == set->capacity) {
+        uint32_t capacity = set->capacity == 0 \
+        ? FACILITY_REFERENCES_FIRST_CAPACITY : set->capacity * 2;
+        struct facility_reference* grown = realloc(set->references, \
+        sizeof(struct facility_reference) * capacity);
+        if (grown == NULL) {
+            facility_references_free(references);
+            return false;
+        }
+        set->references = grown;
+        set->capacity = capacity;
+    }
+    set->references[set->count].type = type;
+    set->references[set->count].owner_id = owner_id;
+    set->count++;
+    set->type_counts[type]++;
+    return true;
+}
+
+// Remove one reference of type by the node with ID owner_id from the
+// facility with ID facility_id, if there is one.
+// Does nothing until the references are built.
+void facility_references_remove(struct facility_references* references, \
+enterprise_id facility_id, enum facility_reference_type type, \
+enterprise_id owner_id) {
+    if (references == NULL || references->built == false || \
+    facility_id == ENTERPRISE_ID_NONE) return;
+
+    uint32_t position = \
+    id_index_find(&references->facility_index, facility_id);
+    if (position == RECORD_STORE_NONE) return;
+    struct facility_reference_set* set = &references->sets[position];
+    for (uint32_t reference = 0; reference < set->count; reference++) {
+        if (set->references[reference].type == type && \
+        set->references[reference].owner_id == owner_id) {
+            set->references[reference] = set->references[set->count - 1];
+            set->count--;
+            set->type_counts[type]--;
+            return;
+        }
+    }
+}
+
+// Take the references to the facility with ID facility_id out of the
+// references and return them in set, which the caller frees with
+// facility_reference_set_free. Removing a reference to the facility afterwards
+// does nothing, so the references in set can be unlinked one by one.
+// Returns true if the facility had references, or false if it had none.
+bool facility_references_detach(struct facility_references* references, \
+enterprise_id facility_id, struct facility_reference_set* set) {
+    memset(set, 0, sizeof(struct facility_reference_set));
+    if (references == NULL || references->built == false) return false;
+    uint32_t position = \
+    id_index_find(&references->facility_index, facility_id);
+    if (position == RECORD_STORE_NONE) return false;
+    *set = references->sets[position];
+    id_index_remove(&references->facility_index, facility_id);
+
+    // Move the last set into the gap. Two IDs were just removed from the
+    // index, so adding one back never grows it and can not fail.
+    uint32_t last = references->set_count - 1;
+    if (position != last) {
+        enterprise_id moved_id = references->sets[last].facility_id;
+        references->sets[position] = references->sets[last];
+        id_index_remove(&references->facility_index, moved_id);
+        id_index_insert(&references->facility_index, moved_id, position);
+    }
+    references->set_count--;
+    return set->count > 0;
+}
+
+// Free the references of a set detached with facility_references_detach.
+void facility_reference_set_free(struct facility_reference_set* set) {
+    if (set == NULL) return;
+    free(set->references);
+    memset(set, 0, sizeof(struct facility_reference_set));
+}
+
+// Forget every reference to the facility with ID facility_id, once the
+// facility is deleted.
+void facility_references_forget(struct facility_references* references, \
+enterprise_id facility_id) {
+    struct facility_reference_set set;
+    facility_references_detach(references, facility_id, &set);
+    facility_reference_set_free(&set);
+}
+
+// Move a reference of type by the node with ID owner_id from the facility
+// with ID from to the facility with ID to.
+// Does nothing until the references are built.
+void facility_references_move(struct facility_references* references, \
+enum facility_reference_type type, enterprise_id owner_id, \
+enterprise_id from, enterprise_id to) {
+    if (from == to) return;
+    facility_references_remove(references, from, type, owner_id);
+    facility_references_add(references, to, type, owner_id);
+}
+
+// Build facility references from scratch, unless they are built already.
+// Returns true on success, or false on failure.
+bool facility_references_build(struct facility_references* references) {
+    if (references == NULL) return false;
+    if (references->built) return true;
+    if (references->gather == NULL) return false;
+
+    // References are only added once the references are built.
+    references->built = true;
+    if (references->gather(references->context, references) == false || \
+    references->built == false) {
+        facility_references_free(references);
+        return false;
+    }
+    return true;
+}
+
+// Return the references to the facility with ID facility_id, building the
+// references first if they are not built yet.
+// Returns NULL if nothing refers to the facility, or on failure.
+const struct facility_reference_set* facility_references_find\
+(struct facility_references* references, enterprise_id facility_id) {
+    if (facility_references_build(references) == false) return NULL;
+    uint32_t position = \
+    id_index_find(&references->facility_index, facility_id);
+    if (position == RECORD_STORE_NONE) return NULL;
+    const struct facility_reference_set* set = &references->sets[position];
+    return set->count == 0 ? NULL : set;
+}
+
+// Returns how many references of type there are to the facility with ID
+// facility_id, building the references first if they are not built yet.
+uint32_t facility_references_count(struct facility_references* references, \
+enterprise_id facility_id, enum facility_reference_type type) {
+    const struct facility_reference_set* set = \
+    facility_references_find(references, facility_id);
+    return set == NULL ? 0 : set->type_counts[type];
+}
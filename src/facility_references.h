@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+/* How facility references work.
+Employees work at facilities, items are stocked at them and expenses are made
+at them, each by holding the facility's ID. Finding everything that refers to
+one facility that way means walking every employee, every item and every
+expense, so the facility list keeps facility references: for every facility,
+the employees, items and expenses that refer to it.
+
+The references are built the first time they are needed, by walking the
+enterprise once. After that the employee facility, item facility and expense
+lists add and remove references as their facility IDs are set, changed and
+deleted. Deleting a facility along with everything that refers to it, or
+listing who works at a facility, then only visits that facility's references.
+Changes are not counted until the references are built, so loading a snapshot
+and replaying its journal cost nothing extra.
+
+An owner is referenced once for every link it has to a facility. A facility's
+references are kept in an array, and removing one moves the last reference
+into its place. Deleting a facility detaches its whole array first, so that
+unlinking each of its references does not search the array again.
+
+Data structures:
+facility_reference: An employee, item or expense that refers to a facility.
+facility_reference_set: The references to a single facility.
+facility_references: The references to every facility.
+*/
+
+#define FACILITY_REFERENCES_FIRST_CAPACITY 4
+
+// The kinds of node that refer to facilities.
+enum facility_reference_type {facility_reference_employee, \
+facility_reference_item, facility_reference_expense};
+#define FACILITY_REFERENCE_TYPE_COUNT (facility_reference_expense + 1)
+
+// A node that refers to a facility: the employee working at it, the item
+// stocked at it or the expense made at it.
+struct facility_reference {
+    enum facility_reference_type type;
+    enterprise_id owner_id;
+};
+
+// The references to a single facility, and how many there are of each type.
+struct facility_reference_set {
+    enterprise_id facility_id;
+    struct facility_reference* references;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t type_counts[FACILITY_REFERENCE_TYPE_COUNT];
+};
+
+struct facility_references;
+
+// Adds every reference to a facility in the enterprise with
+// facility_references_add, passing it context.
+// Returns true on success, or false on failure.
+typedef bool (*facility_references_gather)\
+(void* context, struct facility_references* references);
+
+// Facility references structure.
+struct facility_references {
+    bool built;
+
+    // Gathers the references when they are built.
+    facility_references_gather gather;
+    void* context;
+
+    // The references to each facility. A facility's position in the sets is
+    // found with the facility index.
+    struct id_index facility_index;
+    struct facility_reference_set* sets;
+    uint32_t set_count;
+    uint32_t set_capacity;
+};
+
+void facility_references_init(struct facility_references* references, \
+facility_references_gather gather, void* context);
+void facility_references_free(struct facility_references* references);
+bool facility_references_add(struct facility_references* references, \
+enterprise_id facility_id, enum facility_reference_type type, \
+enterprise_id owner_id);
+void facility_references_remove(struct facility_references* references, \
+enterprise_id facility_id, enum facility_reference_type type, \
+enterprise_id owner_id);
+bool facility_references_detach(struct facility_references* references, \
+enterprise_id facility_id, struct facility_reference_set* set);
+void facility_reference_set_free(struct facility_reference_set* set);
+void facility_references_forget(struct facility_references* references, \
+enterprise_id facility_id);
+void facility_references_move(struct facility_references* references, \
+enum facility_reference_type type, enterprise_id owner_id, \
+enterprise_id from, enterprise_id to);
+bool facility_references_build(struct facility_references* references);
+const struct facility_reference_set* facility_references_find\
+(struct facility_references* references, enterprise_id facility_id);
+uint32_t facility_references_count(struct facility_references* references, \
+enterprise_id facility_id, enum facility_reference_type type);
@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+// Initialise an empty ID index.
+void id_index_init(struct id_index* index) {
+    if (index == NULL) return;
+    index->entries = NULL;
+    index->capacity = 0;
+    index->count = 0;
+}
+
+// Free all memory associated with an ID index.
+void id_index_free(struct id_index* index) {
+    if (index == NULL) return;
+    free(index->entries);
+    id_index_init(index);
+}
+
+// Place an entry in the first free slot of its probe sequence.
+static void id_index_place(struct id_index* index, struct id_index_entry entry) {
+    uint32_t mask = index->capacity - 1;
+    uint32_t slot = id_index_hash(entry.id) & mask;
+    while (index->entries[slot].handle != RECORD_STORE_NONE) {
+        slot = (slot + 1) & mask;
+    }
+    index->entries[slot] = entry;
+}
+
+// Resize the hash table to the given capacity, which must be a power of two.
+// Returns true on success, or false on failure.
+static bool id_index_resize(struct id_index* index, uint32_t capacity) {
+    struct id_index_entry* old_entries = index->entries;
+    uint32_t old_capacity = index->capacity;
+
+    index->entries = malloc(sizeof(struct id_index_entry) * capacity);
+    if (index->entries == NULL) {
+        index->entries = old_entries;
+        return false;
+    }
+    index->capacity = capacity;
+    for (uint32_t slot = 0; slot < capacity; slot++) {
+        index->entries[slot].handle = RECORD_STORE_NONE;
+    }
+
+    for (uint32_t slot = 0; slot < old_capacity; slot++) {
+        if (old_entries[slot].handle != RECORD_STORE_NONE) {
+            id_index_place(index, old_entries[slot]);
+        }
+    }
+    free(old_entries);
+    return true;
+}
+
+// Make room in the index for count more IDs, so that adding many IDs at once
+// does not grow the table over and over.
+// Returns true on success, or false on failure.
+bool id_index_reserve(struct id_index* index, uint32_t count) {
+    if (index == NULL) return false;
+    uint64_t needed = ((uint64_t)index->count + count) * 2;
+    if (needed <= index->capacity) return true;
+
+    uint64_t capacity = index->capacity == 0 ? \
+    ID_INDEX_MIN_CAPACITY : index->capacity;
+    while (capacity < needed) capacity *= 2;
+    if (capacity > UINT32_MAX) return false;
+    return id_index_resize(index, (uint32_t)capacity);
+}
+
+// Add an ID and the handle of its node to the index.
+// Returns true on success, or false on failure.
+bool id_index_insert(struct id_index* index, enterprise_id id, uint32_t handle) {
+    if (index == NULL || handle == RECORD_STORE_NONE) return false;
+
+    // Keep the table at most half full.
+    if ((index->count + 1) * 2 > index->capacity) {
+        uint32_t capacity = index->capacity == 0 ? \
+        ID_INDEX_MIN_CAPACITY : index->capacity * 2;
+        if (id_index_resize(index, capacity) == false) return false;
+    }
+
+    struct id_index_entry entry;
+    entry.id = id;
+    entry.handle = handle;
+    id_index_place(index, entry);
+    index->count++;
+    return true;
+}
+
+// Remove an ID from the index.
+void id_index_remove(struct id_index* index, enterprise_id id) {
+    if (index == NULL || index->count == 0) return;
+
+    uint32_t mask = index->capacity - 1;
+    uint32_t slot = id_index_hash(id) & mask;
+    while (index->entries[slot].handle != RECORD_STORE_NONE) {
+        if (index->entries[slot].id == id) break;
+        slot = (slot + 1) & mask;
+    }
+    if (index->entries[slot].handle == RECORD_STORE_NONE) return;
+
+    // Shift later entries of the same probe run back into the gap so that
+    // lookups never stop early at an empty slot.
+    uint32_t gap = slot;
+    uint32_t next = (gap + 1) & mask;
+    while (index->entries[next].handle != RECORD_STORE_NONE) {
+        uint32_t home = id_index_hash(index->entries[next].id) & mask;
+        bool movable = (next > gap) ? \
+        (home <= gap || home > next) : (home <= gap && home > next);
+        if (movable) {
+            index->entries[gap] = index->entries[next];
+            gap = next;
+        }
+        next = (next + 1) & mask;
+    }
+    index->entries[gap].handle = RECORD_STORE_NONE;
+    index->count--;
+}
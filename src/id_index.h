@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+/* How the ID index works.
+Every list keeps an ID index next to its record store so that a node can be
+found by its ID without walking the whole list. The index is an open
+addressing hash table using linear probing. Each entry holds a node's ID and
+the node's handle in the record store, so a lookup never has to touch the
+nodes themselves.
+
+The table is kept at most half full so probes stay short. Removing an entry
+shifts the following entries back into place instead of leaving tombstones,
+so lookups do not slow down after many deletions.
+
+Data structures:
+id_index_entry: A single slot in the hash table.
+id_index: The hash table.
+*/
+
+#define ID_INDEX_MIN_CAPACITY 16
+
+// A single slot in the ID index. Empty slots have a handle of
+// RECORD_STORE_NONE.
+struct id_index_entry {
+    enterprise_id id;
+    uint32_t handle;
+};
+
+// ID index structure.
+struct id_index {
+    struct id_index_entry* entries;
+    uint32_t capacity;
+    uint32_t count;
+};
+
+void id_index_init(struct id_index* index);
+void id_index_free(struct id_index* index);
+
+// Hash an ID by Fibonacci hashing, which spreads the sequential IDs handed
+// out by lists evenly over the table.
+static inline uint32_t id_index_hash(enterprise_id id) {
+    return (uint32_t)(((uint64_t)id * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+// Hint that the passed in ID is about to be added or looked up, so that its
+// part of the table can be fetched from memory while other work is done.
+static inline void id_index_prefetch(struct id_index* index, enterprise_id id) {
+    #if defined(__GNUC__)
+        if (index->capacity == 0) return;
+        __builtin_prefetch(&index->entries[id_index_hash(id) & \
+        (index->capacity - 1)]);
+    #else
+        UNUSED(index);
+        UNUSED(id);
+    #endif
+}
+
+bool id_index_reserve(struct id_index* index, uint32_t count);
+bool id_index_insert(struct id_index* index, enterprise_id id, uint32_t handle);
+
+// Return the handle of the node with the passed in ID.
+// Returns RECORD_STORE_NONE if no node in the index has that ID.
+static inline uint32_t id_index_find(struct id_index* index, enterprise_id id) {
+    if (index == NULL || index->count == 0) return RECORD_STORE_NONE;
+
+    uint32_t mask = index->capacity - 1;
+    uint32_t slot = id_index_hash(id) & mask;
+    while (index->entries[slot].handle != RECORD_STORE_NONE) {
+        if (index->entries[slot].id == id) return index->entries[slot].handle;
+        slot = (slot + 1) & mask;
+    }
+    return RECORD_STORE_NONE;
+}
+
+void id_index_remove(struct id_index* index, enterprise_id id);
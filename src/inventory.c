@@ -9,165 +9,263 @@
 #include <limits.h>
 #include <time.h>
 
-#include "constants.c"
-
-#ifndef PROGRAM_STATES
-#define PROGRAM_STATES
-#include "program_states.c"
+// Import Nuklear, unless building without the GUI.
+#if !defined(ENTERPRISE_NUKLEAR_LIBRARY_IMPORT) \
+&& !defined(ENTERPRISE_HEADLESS)
+#define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
+#include "nuklear_import.h"
 #endif
 
-#include "inventory_facility.c"
-
-
-// Import Nuklear.
-#ifndef ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-#define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-    #define NK_INCLUDE_FIXED_TYPES
-    #define NK_INCLUDE_STANDARD_IO
-    #define NK_INCLUDE_STANDARD_VARARGS
-    #define NK_INCLUDE_DEFAULT_ALLOCATOR
-    #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    #define NK_INCLUDE_FONT_BAKING
-    #define NK_INCLUDE_DEFAULT_FONT
-    #define NK_IMPLEMENTATION
-    #define NK_SDL_GLES2_IMPLEMENTATION
-    #include "../third_party/Nuklear/nuklear.h"
-    #include "../third_party/Nuklear/demo/sdl_opengles2/nuklear_sdl_gles2.h"
-    #include "../third_party/Nuklear/demo/common/style.c"
+#ifndef ENTERPRISE_ITEMS
+#define ENTERPRISE_ITEMS
+#include "inventory.h"
 #endif
 
-/* How items work.
-items are stored in a struct that contains a pointer to the head of a
-linked list containing all the items. The struct that stores the linked
-list is directly added to the enterprise struct and stores metadata about the
-list. All items are assigned a unique ID, no two items can have the
-same ID, the item_list structure keeps track of that.
+// Item node constructor and initialiser.
+// The node is added to the end of the passed in record store.
+// Returns item node on success, or NULL on failure.
+struct item_node *item_node_new(struct record_store* store) {
+    struct item_node* item = record_store_append(store);
+    if (item == NULL) return NULL;
+    item->id = ENTERPRISE_ID_NONE;
+    item->name = "";
+    item->retail_price = 0;
+    item->internal_cost = 0;
 
-Data structures:
-item_node: An individual item.
-item_list: A structure holding important metadata about the item
-linked list.
+    item->item_facility_list = NULL;
 
-item list metadata:
-item_list->id_last_assigned: This is incremented by 1 every time a new
-item is added in order to ensure no two items ever have the same ID.
+    return item;
+}
 
-item_list->id_currently_selected: This is the ID that is selected in the
-item editor dialogue.
-*/
+// Returns the sort key of an item's ID.
+uint64_t item_key_id(const void* item) {
+    return sort_index_integer_key(((const struct item_node*)item)->id);
+}
 
-struct item_node {
-    char id[ENTERPRISE_STRING_LENGTH];
-    char name[ENTERPRISE_STRING_LENGTH];
-    char retail_price[ENTERPRISE_STRING_LENGTH];
-    char internal_cost[ENTERPRISE_STRING_LENGTH];
+// Returns the sort key of an item's name.
+uint64_t item_key_name(const void* item) {
+    return sort_index_text_key(((const struct item_node*)item)->name);
+}
 
-    struct item_facility_list* item_facility_list;
+// Returns the sort key of an item's retail price.
+uint64_t item_key_retail_price(const void* item) {
+    return sort_index_integer_key\
+    (((const struct item_node*)item)->retail_price);
+}
 
-    struct item_node* prev;
-    struct item_node* next;
-};
+// Returns the sort key of an item's internal cost.
+uint64_t item_key_internal_cost(const void* item) {
+    return sort_index_integer_key\
+    (((const struct item_node*)item)->internal_cost);
+}
 
-// item node constructor and initialiser.
-// Returns item node on success, or NULL on failure.
-struct item_node *item_node_new() {
-    struct item_node* item = malloc(sizeof(struct item_node));
-    if (item == NULL) return NULL;
-    strcpy(item->id, "");
-    strcpy(item->name, "");
-    strcpy(item->retail_price, "");
-    strcpy(item->internal_cost, "");
+// Compare two items by ID for sorting.
+int item_compare_id(const void* a, const void* b) {
+    enterprise_id id_a = ((const struct item_node*)a)->id;
+    enterprise_id id_b = ((const struct item_node*)b)->id;
+    return (id_a > id_b) - (id_a < id_b);
+}
 
-    item->item_facility_list = NULL;
+// Compare two items by name for sorting, then by ID.
+int item_compare_name(const void* a, const void* b) {
+    const struct item_node* item_a = a;
+    const struct item_node* item_b = b;
+    int order = sort_index_compare_text(item_a->name, item_b->name);
+    return order != 0 ? order : item_compare_id(a, b);
+}
 
-    item->prev = NULL;
-    item->next = NULL;
+// Compare two items by retail price for sorting, then by ID.
+int item_compare_retail_price(const void* a, const void* b) {
+    enterprise_cents price_a = ((const struct item_node*)a)->retail_price;
+    enterprise_cents price_b = ((const struct item_node*)b)->retail_price;
+    int order = (price_a > price_b) - (price_a < price_b);
+    return order != 0 ? order : item_compare_id(a, b);
+}
 
-    return item;
+// Compare two items by internal cost for sorting, then by ID.
+int item_compare_internal_cost(const void* a, const void* b) {
+    enterprise_cents cost_a = ((const struct item_node*)a)->internal_cost;
+    enterprise_cents cost_b = ((const struct item_node*)b)->internal_cost;
+    int order = (cost_a > cost_b) - (cost_a < cost_b);
+    return order != 0 ? order : item_compare_id(a, b);
 }
 
-// item list metadata structure.
-struct item_list {
-    struct item_node *head;
-    char id_last_assigned[ENTERPRISE_STRING_LENGTH];
-    char id_currently_selected[ENTERPRISE_STRING_LENGTH];
-    bool deletion_requested;
-};
+// Find the prices of the item with ID item_id in an item list, for the list's
+// stock valuation.
+// Returns true on success, or false if there is no such item.
+bool item_list_prices(void* list, enterprise_id item_id, \
+enterprise_cents* retail_price, enterprise_cents* internal_cost) {
+    struct item_list* item_list = list;
+    struct item_node* item = record_store_get\
+    (&item_list->store, id_index_find(&item_list->id_index, item_id));
+    if (item == NULL) return false;
+    *retail_price = item->retail_price;
+    *internal_cost = item->internal_cost;
+    return true;
+}
 
-// item list constructor.
+// Item list constructor.
 // Returns item list on success, or NULL on failure.
-struct item_list* item_list_new() {
+struct item_list* item_list_new(struct string_pool* string_pool) {
     struct item_list* item_list = malloc(sizeof(struct item_list));
     if (item_list == NULL) return NULL;
-    item_list->head = NULL;
-    strcpy(item_list->id_last_assigned, "0");
-    strcpy(item_list->id_currently_selected, "0");
+    record_store_init(&item_list->store, sizeof(struct item_node));
+    id_index_init(&item_list->id_index);
+    item_list->journal = NULL;
+    item_list->facility_references = NULL;
+    item_list->version = 0;
+    row_labels_init(&item_list->row_labels);
+    item_list->sort_column = item_column_id;
+    item_list->sort_descending = false;
+    sort_index_init(&item_list->sort_indexes[item_column_id], \
+    item_key_id, item_compare_id);
+    sort_index_init(&item_list->sort_indexes[item_column_name], \
+    item_key_name, item_compare_name);
+    sort_index_init(&item_list->sort_indexes[item_column_retail_price], \
+    item_key_retail_price, item_compare_retail_price);
+    sort_index_init(&item_list->sort_indexes[item_column_internal_cost], \
+    item_key_internal_cost, item_compare_internal_cost);
+    stock_valuation_init(&item_list->valuation, item_list_prices, item_list);
+    row_labels_init(&item_list->valuation_labels);
+    item_list->string_pool = string_pool;
+    item_list->edit_id = ENTERPRISE_ID_NONE;
+    strcpy(item_list->edit_name, "");
+    strcpy(item_list->edit_retail_price, "");
+    strcpy(item_list->edit_internal_cost, "");
+    item_list->id_last_assigned = ENTERPRISE_ID_NONE;
+    item_list->id_currently_selected = ENTERPRISE_ID_NONE;
+    item_list->handle_currently_selected = RECORD_STORE_NONE;
     item_list->deletion_requested = false;
     return item_list;
 }
 
-void item_node_free(struct item_node* item) {
+void item_node_free(struct string_pool* string_pool,\
+struct record_store* store, struct item_node* item) {
     if (item == NULL) return;
+    string_pool_release(string_pool, item->name);
     if (item->item_facility_list != NULL) {
         item_facility_list_free(item->item_facility_list);
     }
-    free(item);
+    record_store_remove(store, item);
 }
 
-// Free an entire item linked list
-void item_node_linked_list_free(struct item_node* item) {
-    if (item == NULL) return;
-    struct item_node* next = NULL;
+// Free all memory associated with an item list.
+void item_list_free(struct item_list* item_list) {
+    if (item_list == NULL) return;
+
+    // Free every item, giving their text back to the string pool. If the pool
+    // is being dropped only the items' facility lists need freeing, as the
+    // record store frees every item at once.
+    bool dropping = string_pool_is_dropping(item_list->string_pool);
+    struct item_node* item = record_store_first(&item_list->store);
     while (item != NULL) {
-        next = item->next;
-        item_node_free(item);
+        struct item_node* next = \
+        record_store_next(&item_list->store, item);
+        if (dropping) {
+            item_facility_list_free(item->item_facility_list);
+        }
+        else {
+            item_node_free(item_list->string_pool, &item_list->store, item);
+        }
         item = next;
     }
+
+    row_labels_free(&item_list->row_labels);
+    for (int column = 0; column < item_column_count; column++) {
+        sort_index_free(&item_list->sort_indexes[column]);
+    }
+    stock_valuation_free(&item_list->valuation);
+    row_labels_free(&item_list->valuation_labels);
+    id_index_free(&item_list->id_index);
+    record_store_free(&item_list->store);
+    free(item_list);
+    return;
 }
 
-// Free all memory associated with a item list.
-void item_list_free(struct item_list* item_list) {
-    if (item_list == NULL) return;
+// Move an item to its place in every sort index of the list, after it was
+// added or edited.
+void item_list_sort_node(struct item_list* item_list, struct item_node* item) {
+    if (item_list == NULL || item == NULL) return;
+    for (int column = 0; column < item_column_count; column++) {
+        sort_index_update(&item_list->sort_indexes[column], item);
+    }
+}
 
-    if (item_list->head != NULL) {
-        item_node_linked_list_free(item_list->head);
+// Count all of an item's stock in the list's stock valuation at the item's
+// current prices, or take it away if sign is -1.
+void item_list_value_stock(struct item_list* item_list, \
+struct item_node* item, int sign) {
+    if (item_list == NULL || item == NULL || \
+    item->item_facility_list == NULL) return;
+    struct record_store* store = &item->item_facility_list->store;
+    for (struct item_facility_node* item_facility = record_store_first(store); \
+    item_facility != NULL; \
+    item_facility = record_store_next(store, item_facility)) {
+        stock_valuation_change(&item_list->valuation, \
+        item_facility->facility_id, sign * item_facility->quantity, \
+        item->retail_price, item->internal_cost);
     }
+}
 
-    free(item_list);
-    return;
+// Build the list's stock valuation from every item's stock.
+// Returns true on success, or false on failure.
+bool item_list_value(struct item_list* item_list) {
+    if (item_list == NULL) return false;
+
+    // Count the rows first so that the columns are only allocated once.
+    uint64_t count = 0;
+    struct item_node* item = record_store_first(&item_list->store);
+    for (; item != NULL; item = record_store_next(&item_list->store, item)) {
+        if (item->item_facility_list != NULL) {
+            count += item->item_facility_list->store.count;
+        }
+    }
+    if (count > UINT32_MAX || \
+    stock_valuation_begin(&item_list->valuation, (uint32_t)count) == false) {
+        return false;
+    }
+
+    item = record_store_first(&item_list->store);
+    for (; item != NULL; item = record_store_next(&item_list->store, item)) {
+        if (item->item_facility_list == NULL) continue;
+        struct record_store* store = &item->item_facility_list->store;
+        for (struct item_facility_node* item_facility = \
+        record_store_first(store); item_facility != NULL; \
+        item_facility = record_store_next(store, item_facility)) {
+            stock_valuation_gather(&item_list->valuation, \
+            item_facility->facility_id, item_facility->quantity, \
+            item->retail_price, item->internal_cost);
+        }
+    }
+    return stock_valuation_end(&item_list->valuation);
 }
 
-// Append a new item to a item list.
+// Append a new item to an item list.
 void item_list_append(struct item_list* item_list) {
     if (item_list == NULL) return;
 
     // Increment unique ID by 1.
-    char buffer[ENTERPRISE_STRING_LENGTH];
-    sprintf(buffer, "%lld", atoll(item_list->id_last_assigned) + 1);
-    strcpy(item_list->id_last_assigned, buffer);
-
-    // Add new node to start of item list if item linked list does
-    // not exist.
-    if (item_list->head == NULL) {
-        item_list->head = item_node_new();
-        strcpy(item_list->head->id, item_list->id_last_assigned);
-        strcpy(item_list->id_currently_selected,
-        item_list->id_last_assigned);
+    item_list->id_last_assigned++;
+
+    // Add the new node to the end of the list.
+    struct item_node* item = item_node_new(&item_list->store);
+    if (item == NULL) return;
+
+    item->id = item_list->id_last_assigned;
+
+    // Index the new node by its ID so it can be found without a search.
+    if (id_index_insert(&item_list->id_index, item->id, \
+    record_store_handle(item)) == false) {
+        record_store_remove(&item_list->store, item);
         return;
     }
 
-    // Else add the new node to the end of the list.
-    struct item_node* item = item_list->head;
-    while (item->next != NULL) {
-        item = item->next;
-    }
-    
-    item->next = item_node_new();
-    item->next->prev = item;
+    item_list->id_currently_selected = item_list->id_last_assigned;
 
-    strcpy(item->next->id, item_list->id_last_assigned);
-    strcpy(item_list->id_currently_selected,
-    item_list->id_last_assigned);
+    item_list->version++;
+    item_list_sort_node(item_list, item);
+    journal_put(item_list->journal, journal_list_items, \
+    ENTERPRISE_ID_NONE, item->id);
 
     return;
 }
@@ -175,151 +273,199 @@ void item_list_append(struct item_list* item_list) {
 // Get the number of item nodes in the item list
 int item_list_get_num_item_nodes(struct item_list* item_list) {
     if (item_list == NULL) return 0;
-    if (item_list->head == NULL) return 0;
+    return (int)item_list->store.count;
+}
 
-    struct item_node* item = item_list->head;
-    int item_count = 0;
-    while (item != NULL) {
-        item_count++;
-        item = item->next;
-    }
-    return item_count;
+// Make room in an item list and its ID index for count more items.
+// Returns true on success, or false on failure.
+bool item_list_reserve(struct item_list* item_list, uint32_t count) {
+    if (item_list == NULL) return false;
+    return record_store_reserve(&item_list->store, count) \
+    && id_index_reserve(&item_list->id_index, count);
 }
 
-// Return a pointer to a item node according to ID.
+// Return a pointer to an item node according to ID.
 // Returns NULL on failure.
 struct item_node *item_list_get_node\
-(struct item_list *item_list, char *id) {
-    if (item_list == NULL || id == NULL) return NULL;
-    if (item_list->head == NULL) return NULL;
+(struct item_list *item_list, enterprise_id id) {
+    if (item_list == NULL) return NULL;
+    return record_store_get\
+    (&item_list->store, id_index_find(&item_list->id_index, id));
+}
 
-    struct item_node* item = item_list->head;
-    while (item != NULL) {
-        if (strcmp(item->id, id) == 0) return item;
-        item = item->next;
+// Return a pointer to the currently selected item node.
+// The selected item's handle is checked before its ID is looked up, so this
+// only searches the ID index after the selection was changed by ID.
+// Returns NULL if no item is selected.
+struct item_node *item_list_get_selected_node\
+(struct item_list *item_list) {
+    if (item_list == NULL) return NULL;
+
+    struct item_node* item = record_store_get\
+    (&item_list->store, item_list->handle_currently_selected);
+    if (item == NULL || item->id != item_list->id_currently_selected) {
+        item = item_list_get_node\
+        (item_list, item_list->id_currently_selected);
+        item_list->handle_currently_selected = \
+        record_store_handle(item);
     }
-    return NULL;
+    return item;
 }
 
-// Searches for a item by ID and deletes it
-void item_list_delete_node(struct item_list *item_list, char *id) {
-    if (item_list == NULL || id == NULL) return;
-    if (item_list->head == NULL) return;
+// Searches for an item by ID and deletes it
+void item_list_delete_node\
+(struct item_list *item_list, enterprise_id id) {
+    if (item_list == NULL) return;
 
-    // Delete the head if it is the ID that is requested to be deleted.
-    if (strcmp(id, item_list->head->id) == 0) {
-        if (item_list->head->next == NULL) {
-            item_node_free(item_list->head);
-            item_list->head = NULL;
-            return;
-        }
+    struct item_node* item = item_list_get_node(item_list, id);
+    if (item == NULL) return;
 
-        struct item_node *next = item_list->head->next;
-        item_node_free(item_list->head);
-        item_list->head = next;
-        return;
+    // Select the node after the deleted item, or the node before it if the
+    // deleted item is the last one.
+    struct item_node* prev = record_store_prev(&item_list->store, item);
+    struct item_node* next = record_store_next(&item_list->store, item);
+    if (next != NULL) {
+        item_list->id_currently_selected = next->id;
     }
-
-    // Else search for the item to delete.
-    struct item_node* item = item_list->head;
-    while (item != NULL) {
-        if (strcmp(item->id, id) == 0) break;
-        item = item->next;
+    else if (prev != NULL) {
+        item_list->id_currently_selected = prev->id;
     }
-    if (item == NULL) return;
 
-    // Fix the pointers of the next and previous nodes to the item to be
-    // deleted in order to ensure that traversal still works.
+    item_list->version++;
+    journal_delete(item_list->journal, journal_list_items, \
+    ENTERPRISE_ID_NONE, item->id);
 
-    struct item_node* prev = item->prev;
-    struct item_node* next = item->next;
-
-    if (prev != NULL) {
-        if (next == NULL) {
-            prev->next = NULL;
-            strcpy(item_list->id_currently_selected, prev->id);
-        }
-        if (next != NULL) {
-            prev->next = next;
-            next->prev = prev;
-            strcpy(item_list->id_currently_selected, next->id);
-        }
+    // Delete the item
+    for (int column = 0; column < item_column_count; column++) {
+        sort_index_remove(&item_list->sort_indexes[column], item);
     }
+    item_list_value_stock(item_list, item, -1);
+    item_facility_list_unlink(item->item_facility_list);
+    id_index_remove(&item_list->id_index, item->id);
+    item_node_free(item_list->string_pool, \
+    &item_list->store, item);
+    return;
+}
 
-    if (prev == NULL) {
-        if (next != NULL) {
-            next->prev = NULL;
-            strcpy(item_list->id_currently_selected, next->id);
-        }
+// Return the item after the passed in one in the order the item table is
+// sorted in, or the one before it if backwards is set, wrapping around at
+// either end.
+static struct item_node* item_list_step(struct item_list* item_list, \
+struct item_node* item, bool backwards) {
+    struct record_store* store = &item_list->store;
+    struct sort_index* index = \
+    &item_list->sort_indexes[item_list->sort_column];
+    if (item_list->sort_descending) backwards = backwards == false;
+
+    // Sorting by ID lists items in the order they were added.
+    uint32_t row = item_list->sort_column == item_column_id \
+    ? SORT_INDEX_NONE : sort_index_row(index, item);
+    if (row == SORT_INDEX_NONE) {
+        struct item_node* step = backwards \
+        ? record_store_prev(store, item) : record_store_next(store, item);
+        if (step != NULL) return step;
+        return backwards ? record_store_last(store) : record_store_first(store);
     }
-
-    // Delete the item
-    item_node_free(item);
-    return;
+    if (backwards) row = row == 0 ? index->count - 1 : row - 1;
+    else row = row + 1 == index->count ? 0 : row + 1;
+    return (void*)sort_index_record(index, row);
 }
 
-// Select the previous node as the currently selected item.
+// Select the item before the selected one in the item table.
 void item_list_select_previous_node(struct item_list *item_list) {
     if (item_list == NULL) return;
-    if (item_list->head == NULL) return;
 
-    struct item_node* item = item_list->head;
-    while (item != NULL) {
-        if (strcmp(item->id, item_list->id_currently_selected) == 0) {
-            if (item->prev != NULL) {
-                strcpy(item_list->id_currently_selected, item->prev->id);
-                return;
-            }
-            if (item->prev == NULL) {
-                struct item_node* temp = item;
-                while (temp->next != NULL) {
-                    temp = temp->next;
-                }
-                strcpy(item_list->id_currently_selected, temp->id);
-                return;
-            }
-        }
-        item = item->next;
-    }
+    struct item_node* item = \
+    item_list_get_selected_node(item_list);
+    if (item == NULL) return;
+
+    struct item_node* prev = item_list_step(item_list, item, true);
+    item_list->id_currently_selected = prev->id;
+    item_list->handle_currently_selected = record_store_handle(prev);
 }
 
-// Select the next node as the currently selected item.
+// Select the item after the selected one in the item table.
 void item_list_select_next_node(struct item_list *item_list) {
     if (item_list == NULL) return;
-    if (item_list->head == NULL) return;
 
-    struct item_node* item = item_list->head;
-    while (item != NULL) {
-        if (strcmp(item->id, item_list->id_currently_selected) == 0) {
-            if (item->next != NULL) {
-                strcpy(item_list->id_currently_selected, item->next->id);
-                return;
-            }
-            if (item->next == NULL) {
-                strcpy(item_list->id_currently_selected,\
-                item_list->head->id);
-                return;
-            }
-        }
-        item = item->next;
-    }
+    struct item_node* item = \
+    item_list_get_selected_node(item_list);
+    if (item == NULL) return;
+
+    struct item_node* next = item_list_step(item_list, item, false);
+    item_list->id_currently_selected = next->id;
+    item_list->handle_currently_selected = record_store_handle(next);
 }
 
 // Change the currently selected ID to the passed in ID in the item list.
 void item_list_set_selected_id\
-(struct item_list *item_list, char* id) {
-    if (item_list == NULL || id == NULL) return;
-    if (item_list->head == NULL) return;
+(struct item_list *item_list, enterprise_id id) {
+    if (item_list == NULL) return;
 
-    struct item_node* item = item_list->head;
-    while (item != NULL) {
-        if (strcmp(item->id, id) == 0) {
-            strcpy(item_list->id_currently_selected, id);
-        }
-        item = item->next;
+    if (item_list_get_node(item_list, id) != NULL) {
+        item_list->id_currently_selected = id;
     }
 }
 
+// Sort the item table by a column, in descending order if descending is true.
+// The column's sort index is built the first time it is sorted by.
+// Returns true on success, or false on failure, in which case the table is
+// left in the order it was.
+bool item_list_sort(struct item_list* item_list, enum item_column column, \
+bool descending) {
+    if (item_list == NULL || column >= item_column_count) return false;
+    struct sort_index* index = &item_list->sort_indexes[column];
+    if (column != item_column_id && index->built == false && \
+    sort_index_build(index, &item_list->store) == false) return false;
+
+    item_list->sort_column = column;
+    item_list->sort_descending = descending;
+    row_labels_invalidate(&item_list->row_labels);
+    return true;
+}
+
+// Return the item shown at a row of the item table, which depends on the
+// column the table is sorted by.
+// Returns NULL if there is no such row.
+struct item_node* item_list_get_row_node(struct item_list* item_list, \
+uint32_t row) {
+    if (item_list == NULL || row >= item_list->store.count) return NULL;
+    if (item_list->sort_descending) row = item_list->store.count - 1 - row;
+    if (item_list->sort_column == item_column_id) {
+        return record_store_seek(&item_list->store, row);
+    }
+    return (void*)sort_index_record\
+    (&item_list->sort_indexes[item_list->sort_column], row);
+}
+
+// Make the labels of row_count rows of the item table, starting at
+// first_row, unless they are cached already.
+void item_list_label_rows(struct item_list* item_list, \
+uint32_t first_row, uint32_t row_count) {
+    if (item_list == NULL) return;
+    struct row_labels* labels = &item_list->row_labels;
+    if (row_labels_current(labels, item_list->version, first_row, \
+    row_count)) return;
+
+    row_labels_begin(labels, item_list->version, first_row, row_count);
+    for (uint32_t row = 0; row < row_count; row++) {
+        struct item_node* item = \
+        item_list_get_row_node(item_list, first_row + row);
+        if (item == NULL) break;
+
+        char retail_price[ENTERPRISE_CENTS_TEXT_LENGTH];
+        char internal_cost[ENTERPRISE_CENTS_TEXT_LENGTH];
+        enterprise_cents_format(item->retail_price, retail_price);
+        enterprise_cents_format(item->internal_cost, internal_cost);
+        if (row_labels_add(labels, item->id, \
+        "ID: %lld Name: %s Retail Price: %s Internal Cost: %s",\
+        item->id, item->name, retail_price, internal_cost) == false) break;
+    }
+}
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+
 // Render the item table GUI.
 // This function displays a list of items as a table that can be selected.
 // It is an overview.
@@ -342,31 +488,55 @@ struct item_list* item_list) {
     }
 
     // If there are no items, warn the user.
-    if (item_list->head == NULL) {
+    if (record_store_first(&item_list->store) == NULL) {
         nk_label(ctx, "No Items found.", NK_TEXT_CENTERED);
         return program_status_item_table;
     }
 
-    /* If there are items, go through the linked list of items.
-    Copy the data from each item and make it a button label.
-    When the button is pressed, set the currently selected item to that
-    item and switch to item editor.*/
-    struct item_node* item = item_list->head;
-    char* print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-    while (item != NULL) {
-        sprintf(print_buffer, \
-        "ID: %s Name: %s Retail Price: %s Internal Cost: %s",item->id,\
-        item->name, item->retail_price, item->internal_cost);
+    // Sort controls, picking the column to sort by and the direction.
+    const char* columns[] = {"Sort by ID", "Sort by Name", \
+    "Sort by Retail Price", "Sort by Internal Cost"};
+    nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 2);
+    int column = nk_combo(ctx, columns, NK_LEN(columns), \
+    (int)item_list->sort_column, ENTERPRISE_WIDGET_HEIGHT, \
+    nk_vec2(WINDOW_WIDTH / 2, 200));
+    bool descending = item_list->sort_descending;
+    if (nk_button_label(ctx, descending ? "Descending" : "Ascending")) {
+        descending = !descending;
+    }
+    if (column != (int)item_list->sort_column || \
+    descending != item_list->sort_descending) {
+        item_list_sort(item_list, (enum item_column)column, descending);
+    }
 
-        if (nk_button_label(ctx, print_buffer)) {
-            strcpy(item_list->id_currently_selected, item->id);
-            free(print_buffer);
-            return program_status_item_editor;
+    /* If there are items, make a button for each item in view.
+    Only the rows scrolled into view are drawn, and their labels are only
+    formatted again when different rows come into view or the list changes.
+    When a button is pressed, set the currently selected item to that
+    item and switch to item editor.*/
+    enum program_status status = program_status_item_table;
+    struct nk_list_view view;
+    int rows = item_list->store.count > INT_MAX \
+    ? INT_MAX : (int)item_list->store.count;
+    nk_layout_row_dynamic(ctx, \
+    ENTERPRISE_TABLE_HEIGHT - ENTERPRISE_WIDGET_HEIGHT, 1);
+    if (nk_list_view_begin(ctx, &view, "item_table", \
+    NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+        nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+        struct row_labels* labels = &item_list->row_labels;
+        item_list_label_rows(item_list, \
+        (uint32_t)view.begin, (uint32_t)view.count);
+
+        for (uint32_t row = 0; row < labels->count; row++) {
+            if (nk_button_label(ctx, row_labels_text(labels, row))) {
+                item_list->id_currently_selected = \
+                row_labels_id(labels, row);
+                status = program_status_item_editor;
+            }
         }
-        item = item->next;
+        nk_list_view_end(&view);
     }
-    free(print_buffer);
-    return program_status_item_table;
+    return status;
 }
 
 // Render the item editor GUI.
@@ -384,14 +554,15 @@ struct item_list* item_list) {
     nk_label(ctx, "Inventory Item Editor", NK_TEXT_CENTERED);
     
     // Select currently selected item.
-    struct item_node* item = item_list_get_node\
-    (item_list, item_list->id_currently_selected);
+    struct item_node* item = \
+    item_list_get_selected_node(item_list);
 
     // If the currently selected item does not exist:
     if (item == NULL) {
         // Select the first item instead.
-        if (item_list->head != NULL) {
-            strcpy(item_list->id_currently_selected, item_list->head->id);
+        item = record_store_first(&item_list->store);
+        if (item != NULL) {
+            item_list->id_currently_selected = item->id;
             return program_status_item_editor;
         }
 
@@ -406,32 +577,80 @@ struct item_list* item_list) {
         }
     }
 
+    // Copy the selected item's text into the edit buffers whenever a
+    // different item is selected.
+    if (item_list->edit_id != item->id) {
+        item_list->edit_id = item->id;
+        strcpy(item_list->edit_name, item->name);
+        enterprise_cents_format(item->retail_price, \
+        item_list->edit_retail_price);
+        enterprise_cents_format(item->internal_cost, \
+        item_list->edit_internal_cost);
+    }
+
     // Display edit fields to edit item entries.
     nk_layout_row_template_begin(ctx, ENTERPRISE_WIDGET_HEIGHT);
     nk_layout_row_template_push_static(ctx, 200);
     nk_layout_row_template_push_dynamic(ctx);
     nk_layout_row_template_end(ctx);
 
+    char id_text[ENTERPRISE_ID_TEXT_LENGTH];
+    enterprise_id_format(item->id, id_text);
     nk_label(ctx, "ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_READ_ONLY, \
-    item->id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Name: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    item->name, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    item_list->edit_name, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
+    // Only digits, a sign and a decimal point can be typed into prices.
     nk_label(ctx, "Retail Price: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    item->retail_price, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    item_list->edit_retail_price, ENTERPRISE_CENTS_TEXT_LENGTH, \
+    nk_filter_float);
 
     nk_label(ctx, "Internal Cost: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    item->internal_cost, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    item_list->edit_internal_cost, ENTERPRISE_CENTS_TEXT_LENGTH, \
+    nk_filter_float);
+
+    // Store any edits back into the item, and note them in the journal.
+    // Prices that are not valid amounts yet are left as they were.
+    enterprise_cents retail_price = item->retail_price;
+    enterprise_cents internal_cost = item->internal_cost;
+    bool prices_valid = \
+    enterprise_cents_parse(item_list->edit_retail_price, &retail_price);
+    prices_valid &= \
+    enterprise_cents_parse(item_list->edit_internal_cost, &internal_cost);
+    bool edited = string_pool_assign(item_list->string_pool, &item->name, \
+    item_list->edit_name);
+    bool repriced = retail_price != item->retail_price || \
+    internal_cost != item->internal_cost;
+    if (repriced) {
+        item_list_value_stock(item_list, item, -1);
+        item->retail_price = retail_price;
+        item->internal_cost = internal_cost;
+        item_list_value_stock(item_list, item, 1);
+        edited = true;
+    }
+    if (prices_valid == false) {
+        nk_label(ctx, "", NK_TEXT_LEFT);
+        nk_label(ctx, "Prices must be amounts such as 12.34", NK_TEXT_LEFT);
+    }
+    if (edited) {
+        item_list->version++;
+        item_list_sort_node(item_list, item);
+        journal_put(item_list->journal, journal_list_items, \
+        ENTERPRISE_ID_NONE, item->id);
+    }
 
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
     if (nk_button_label(ctx, "Stock")) {
         if (item->item_facility_list == NULL) {
-            item->item_facility_list = item_facility_list_new();
+            item->item_facility_list = item_facility_list_new\
+            (item_list->journal, &item_list->valuation, \
+            item_list->facility_references, item->id);
         }
         return program_status_item_facility_table;
     }
@@ -474,4 +693,92 @@ struct item_list* item_list) {
     }
     
     return program_status_item_editor;
-}
\ No newline at end of file
+}
+
+// Render the stock valuation report GUI.
+// This shows how much stock each facility holds and what it is worth, and the
+// totals of the whole enterprise.
+enum program_status item_valuation_table(struct nk_context* ctx, \
+struct item_list* item_list, struct facility_list* facility_list) {
+    if (ctx == NULL || item_list == NULL || facility_list == NULL) {
+        return program_status_enterprise_menu;
+    }
+
+    // Button to return to enterprise menu.
+    nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+    if (nk_button_label(ctx, "Return to Enterprise Menu")) {
+        return program_status_enterprise_menu;
+    }
+    nk_label(ctx, "Stock Valuation", NK_TEXT_CENTERED);
+
+    // The valuation is built the first time it is shown, and kept up to date
+    // as stock and prices change after that.
+    struct stock_valuation* valuation = &item_list->valuation;
+    if (valuation->built == false && item_list_value(item_list) == false) {
+        nk_label(ctx, "Failed to value the stock.", NK_TEXT_CENTERED);
+        return program_status_stock_valuation;
+    }
+
+    char retail_value[ENTERPRISE_CENTS_TEXT_LENGTH];
+    char internal_value[ENTERPRISE_CENTS_TEXT_LENGTH];
+    char total[ENTERPRISE_STRING_LENGTH];
+    enterprise_cents_format(valuation->retail_value, retail_value);
+    enterprise_cents_format(valuation->internal_value, internal_value);
+    snprintf(total, sizeof(total), \
+    "Total Stock: %lld Retail Value: %s Internal Value: %s", \
+    valuation->quantity, retail_value, internal_value);
+    nk_label(ctx, total, NK_TEXT_CENTERED);
+
+    /* Present the totals of every facility that holds stock.
+    Only the rows scrolled into view are drawn, and their labels are only
+    formatted again when different rows come into view or either the
+    valuation or the facilities change. Both versions only ever grow, so
+    their sum changes whenever either of them does. When a button is
+    pressed, open that facility in the facility editor.*/
+    enum program_status status = program_status_stock_valuation;
+    struct nk_list_view view;
+    uint64_t version = valuation->version + facility_list->version;
+    int rows = valuation->facility_count > INT_MAX \
+    ? INT_MAX : (int)valuation->facility_count;
+    nk_layout_row_dynamic(ctx, \
+    ENTERPRISE_TABLE_HEIGHT - ENTERPRISE_WIDGET_HEIGHT, 1);
+    if (nk_list_view_begin(ctx, &view, "item_valuation_table", \
+    NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+        nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+        struct row_labels* labels = &item_list->valuation_labels;
+        if (row_labels_current(labels, version, \
+        (uint32_t)view.begin, (uint32_t)view.count) == false) {
+            row_labels_begin(labels, version, \
+            (uint32_t)view.begin, (uint32_t)view.count);
+            for (uint32_t row = (uint32_t)view.begin; \
+            row < (uint32_t)view.begin + (uint32_t)view.count && \
+            row < valuation->facility_count; row++) {
+                struct facility_node* facility = facility_list_get_node\
+                (facility_list, valuation->facility_ids[row]);
+                enterprise_cents_format\
+                (valuation->retail_values[row], retail_value);
+                enterprise_cents_format\
+                (valuation->internal_values[row], internal_value);
+                if (row_labels_add(labels, valuation->facility_ids[row], \
+                "Facility ID: %lld Name: %s Stock: %lld "
+                "Retail Value: %s Internal Value: %s", \
+                valuation->facility_ids[row], \
+                facility == NULL ? "" : facility->name, \
+                valuation->quantities[row], retail_value, \
+                internal_value) == false) break;
+            }
+        }
+
+        for (uint32_t row = 0; row < labels->count; row++) {
+            if (nk_button_label(ctx, row_labels_text(labels, row))) {
+                facility_list->id_currently_selected = \
+                row_labels_id(labels, row);
+                status = program_status_facility_editor;
+            }
+        }
+        nk_list_view_end(&view);
+    }
+    return status;
+}
+
+#endif
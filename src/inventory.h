@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_STRING_POOL
+#define ENTERPRISE_STRING_POOL
+#include "string_pool.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+#ifndef ENTERPRISE_AMOUNTS
+#define ENTERPRISE_AMOUNTS
+#include "enterprise_amount.h"
+#endif
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+#ifndef ENTERPRISE_FACILITY_REFERENCES
+#define ENTERPRISE_FACILITY_REFERENCES
+#include "facility_references.h"
+#endif
+
+#ifndef ENTERPRISE_STOCK_VALUATION
+#define ENTERPRISE_STOCK_VALUATION
+#include "stock_valuation.h"
+#endif
+
+#ifndef ENTERPRISE_JOURNAL
+#define ENTERPRISE_JOURNAL
+#include "journal.h"
+#endif
+
+#ifndef ENTERPRISE_ROW_LABELS
+#define ENTERPRISE_ROW_LABELS
+#include "row_labels.h"
+#endif
+
+#ifndef ENTERPRISE_SORT_INDEX
+#define ENTERPRISE_SORT_INDEX
+#include "sort_index.h"
+#endif
+
+#ifndef PROGRAM_STATES
+#define PROGRAM_STATES
+#include "program_states.h"
+#endif
+
+#ifndef ENTERPRISE_ITEM_FACILITIES
+#define ENTERPRISE_ITEM_FACILITIES
+#include "inventory_facility.h"
+#endif
+
+// Nuklear's context, taken by the GUI functions. Only the sources of
+// those functions import Nuklear itself.
+struct nk_context;
+
+/* How items work.
+An item is something the enterprise sells, with a retail price, an internal
+cost, and the facilities it is stocked at (see inventory_facility.c). The item
+list is laid out like every other list of the enterprise (see
+record_store.c), and its table can be sorted by any of its columns.
+
+The item list also keeps the value of all stock at each facility (see
+stock_valuation.c), built the first time it is shown.
+
+Data structures:
+item_node: An item.
+item_list: The items of the enterprise.
+*/
+
+struct item_node {
+    enterprise_id id;
+    const char* name;
+    enterprise_cents retail_price;
+    enterprise_cents internal_cost;
+
+    struct item_facility_list* item_facility_list;
+};
+
+// The columns of the item table.
+enum item_column {item_column_id, item_column_name, item_column_retail_price, \
+item_column_internal_cost, item_column_count};
+
+// Item list metadata structure.
+struct item_list {
+    struct record_store store;
+    struct id_index id_index;
+    struct string_pool* string_pool;
+
+    // Where changes to the list are recorded, or NULL if they are not.
+    struct journal* journal;
+
+    // Bumped whenever a node is appended, edited or deleted, so that the
+    // labels cached for the list's table know when they are stale.
+    uint64_t version;
+    struct row_labels row_labels;
+
+    // The column the list's table is sorted by, and an index of the list
+    // sorted by each column. Indexes are built when first sorted by.
+    enum item_column sort_column;
+    bool sort_descending;
+    struct sort_index sort_indexes[item_column_count];
+
+    // The value of all stock at each facility, built when first shown.
+    struct stock_valuation valuation;
+    struct row_labels valuation_labels;
+
+    // The facility references that the facilities of the list's items are
+    // counted in, or NULL if they are not.
+    struct facility_references* facility_references;
+
+    // Editable copies of the text of the node open in the editor.
+    enterprise_id edit_id;
+    char edit_name[ENTERPRISE_STRING_LENGTH];
+    char edit_retail_price[ENTERPRISE_CENTS_TEXT_LENGTH];
+    char edit_internal_cost[ENTERPRISE_CENTS_TEXT_LENGTH];
+
+    enterprise_id id_last_assigned;
+    enterprise_id id_currently_selected;
+    uint32_t handle_currently_selected;
+    bool deletion_requested;
+};
+
+struct item_node *item_node_new(struct record_store* store);
+uint64_t item_key_id(const void* item);
+uint64_t item_key_name(const void* item);
+uint64_t item_key_retail_price(const void* item);
+uint64_t item_key_internal_cost(const void* item);
+int item_compare_id(const void* a, const void* b);
+int item_compare_name(const void* a, const void* b);
+int item_compare_retail_price(const void* a, const void* b);
+int item_compare_internal_cost(const void* a, const void* b);
+bool item_list_prices(void* list, enterprise_id item_id, \
+enterprise_cents* retail_price, enterprise_cents* internal_cost);
+struct item_list* item_list_new(struct string_pool* string_pool);
+void item_node_free(struct string_pool* string_pool,\
+struct record_store* store, struct item_node* item);
+void item_list_free(struct item_list* item_list);
+void item_list_sort_node(struct item_list* item_list, struct item_node* item);
+void item_list_value_stock(struct item_list* item_list, \
+struct item_node* item, int sign);
+bool item_list_value(struct item_list* item_list);
+void item_list_append(struct item_list* item_list);
+int item_list_get_num_item_nodes(struct item_list* item_list);
+bool item_list_reserve(struct item_list* item_list, uint32_t count);
+struct item_node *item_list_get_node\
+(struct item_list *item_list, enterprise_id id);
+struct item_node *item_list_get_selected_node\
+(struct item_list *item_list);
+void item_list_delete_node\
+(struct item_list *item_list, enterprise_id id);
+void item_list_select_previous_node(struct item_list *item_list);
+void item_list_select_next_node(struct item_list *item_list);
+void item_list_set_selected_id\
+(struct item_list *item_list, enterprise_id id);
+bool item_list_sort(struct item_list* item_list, enum item_column column, \
+bool descending);
+struct item_node* item_list_get_row_node(struct item_list* item_list, \
+uint32_t row);
+void item_list_label_rows(struct item_list* item_list, \
+uint32_t first_row, uint32_t row_count);
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+enum program_status item_table(struct nk_context* ctx,\
+struct item_list* item_list);
+enum program_status item_editor(struct nk_context* ctx,\
+struct item_list* item_list);
+enum program_status item_valuation_table(struct nk_context* ctx, \
+struct item_list* item_list, struct facility_list* facility_list);
+#endif
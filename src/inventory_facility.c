@@ -9,329 +9,262 @@
 #include <limits.h>
 #include <time.h>
 
-#include "constants.c"
-
-#ifndef PROGRAM_STATES
-#define PROGRAM_STATES
-#include "program_states.c"
-#endif
-
-
-// Import Nuklear.
-#ifndef ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
+// Import Nuklear, unless building without the GUI.
+#if !defined(ENTERPRISE_NUKLEAR_LIBRARY_IMPORT) \
+&& !defined(ENTERPRISE_HEADLESS)
 #define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-    #define NK_INCLUDE_FIXED_TYPES
-    #define NK_INCLUDE_STANDARD_IO
-    #define NK_INCLUDE_STANDARD_VARARGS
-    #define NK_INCLUDE_DEFAULT_ALLOCATOR
-    #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    #define NK_INCLUDE_FONT_BAKING
-    #define NK_INCLUDE_DEFAULT_FONT
-    #define NK_IMPLEMENTATION
-    #define NK_SDL_GLES2_IMPLEMENTATION
-    #include "../third_party/Nuklear/nuklear.h"
-    #include "../third_party/Nuklear/demo/sdl_opengles2/nuklear_sdl_gles2.h"
-    #include "../third_party/Nuklear/demo/common/style.c"
+#include "nuklear_import.h"
 #endif
 
-#ifndef ENTERPRISE_LIBRARIES
-#define ENTERPRISE_LIBRARIES
-#include "constants.c"
-#include "facilities.c"
-#include "inventory.c"
-#include "customers.c"
-#include "suppliers.c"
-#include "expenses.c"
-#include "orders.c"
+#ifndef ENTERPRISE_ITEM_FACILITIES
+#define ENTERPRISE_ITEM_FACILITIES
+#include "inventory_facility.h"
 #endif
 
-/* How item_facilitys work.
-item_facilitys are stored in a struct that contains a pointer to the head of a
-linked list containing all the item_facilitys. The struct that stores the linked
-list is directly added to the enterprise struct and stores metadata about the
-list. All item_facilitys are assigned a unique ID, no two item_facilitys can have the
-same ID, the item_facility_list structure keeps track of that.
-
-Data structures:
-item_facility_node: An individual item_facility.
-item_facility_list: A structure holding important metadata about the item_facility
-linked list.
-
-item_facility list metadata:
-item_facility_list->id_last_assigned: This is incremented by 1 every time a new
-item_facility is added in order to ensure no two item_facilitys ever have the same ID.
-
-item_facility_list->id_currently_selected: This is the ID that is selected in the
-item_facility editor dialogue.
-*/
-
-struct item_facility_node {
-    char id[ENTERPRISE_STRING_LENGTH];
-    char facility_id[ENTERPRISE_STRING_LENGTH];
-    char quantity[ENTERPRISE_STRING_LENGTH];
-
-    struct item_facility_node* prev;
-    struct item_facility_node* next;
-};
-
-// item_facility node constructor and initialiser.
-// Returns item_facility node on success, or NULL on failure.
-struct item_facility_node *item_facility_node_new() {
-    struct item_facility_node* item_facility = malloc(sizeof(struct item_facility_node));
+// Item facility node constructor and initialiser.
+// The node is added to the end of the passed in record store.
+// Returns item facility node on success, or NULL on failure.
+struct item_facility_node *item_facility_node_new(struct record_store* store) {
+    struct item_facility_node* item_facility = record_store_append(store);
     if (item_facility == NULL) return NULL;
-    strcpy(item_facility->id, "");
-    strcpy(item_facility->facility_id, "");
-    strcpy(item_facility->quantity, "");
-
-    item_facility->prev = NULL;
-    item_facility->next = NULL;
+    item_facility->id = ENTERPRISE_ID_NONE;
+    item_facility->facility_id = ENTERPRISE_ID_NONE;
+    item_facility->quantity = 0;
 
     return item_facility;
 }
 
-// item_facility list metadata structure.
-struct item_facility_list {
-    struct item_facility_node *head;
-    char id_last_assigned[ENTERPRISE_STRING_LENGTH];
-    char id_currently_selected[ENTERPRISE_STRING_LENGTH];
-    bool deletion_requested;
-    bool addition_requested;
-};
-
-// item_facility list constructor.
-// Returns item_facility list on success, or NULL on failure.
-struct item_facility_list* item_facility_list_new() {
+// Item facility list constructor. Changes to the list are recorded in
+// journal as changes to the facilities of the item with ID owner_id, changes
+// to its stock are counted in valuation, and the facilities it is stocked at
+// are counted in references.
+// Returns item facility list on success, or NULL on failure.
+struct item_facility_list* item_facility_list_new(struct journal* journal, \
+struct stock_valuation* valuation, struct facility_references* references, \
+enterprise_id owner_id) {
     struct item_facility_list* item_facility_list = malloc(sizeof(struct item_facility_list));
     if (item_facility_list == NULL) return NULL;
-    item_facility_list->head = NULL;
-    strcpy(item_facility_list->id_last_assigned, "0");
-    strcpy(item_facility_list->id_currently_selected, "0");
+    record_store_init(&item_facility_list->store, sizeof(struct item_facility_node));
+    id_index_init(&item_facility_list->id_index);
+    item_facility_list->journal = journal;
+    item_facility_list->owner_id = owner_id;
+    item_facility_list->valuation = valuation;
+    item_facility_list->references = references;
+    item_facility_list->version = 0;
+    row_labels_init(&item_facility_list->row_labels);
+    row_labels_init(&item_facility_list->addition_labels);
+    item_facility_list->id_last_assigned = ENTERPRISE_ID_NONE;
+    item_facility_list->id_currently_selected = ENTERPRISE_ID_NONE;
+    item_facility_list->handle_currently_selected = RECORD_STORE_NONE;
     item_facility_list->deletion_requested = false;
     item_facility_list->addition_requested = false;
     return item_facility_list;
 }
 
-// Free an entire item_facility linked list
-void item_facility_node_linked_list_free(struct item_facility_node* item_facility) {
-    if (item_facility == NULL) return;
-    struct item_facility_node* next = NULL;
-    while (item_facility != NULL) {
-        next = item_facility->next;
-        free(item_facility);
-        item_facility = next;
-    }
-}
-
-// Free all memory associated with a item_facility list.
+// Free all memory associated with an item facility list.
 void item_facility_list_free(struct item_facility_list* item_facility_list) {
     if (item_facility_list == NULL) return;
-
-    if (item_facility_list->head != NULL) {
-        item_facility_node_linked_list_free(item_facility_list->head);
-    }
-
+    row_labels_free(&item_facility_list->row_labels);
+    row_labels_free(&item_facility_list->addition_labels);
+    id_index_free(&item_facility_list->id_index);
+    record_store_free(&item_facility_list->store);
     free(item_facility_list);
     return;
 }
 
-// Append a new item_facility to a item_facility list.
+// Append a new item facility to an item facility list.
 void item_facility_list_append(struct item_facility_list* item_facility_list) {
     if (item_facility_list == NULL) return;
 
     // Increment unique ID by 1.
-    char buffer[ENTERPRISE_STRING_LENGTH];
-    sprintf(buffer, "%lld", atoll(item_facility_list->id_last_assigned) + 1);
-    strcpy(item_facility_list->id_last_assigned, buffer);
-
-    // Add new node to start of item_facility list if item_facility linked list does
-    // not exist.
-    if (item_facility_list->head == NULL) {
-        item_facility_list->head = item_facility_node_new();
-        strcpy(item_facility_list->head->id, item_facility_list->id_last_assigned);
-        strcpy(item_facility_list->id_currently_selected,
-        item_facility_list->id_last_assigned);
+    item_facility_list->id_last_assigned++;
+
+    // Add the new node to the end of the list.
+    struct item_facility_node* item_facility = item_facility_node_new(&item_facility_list->store);
+    if (item_facility == NULL) return;
+
+    item_facility->id = item_facility_list->id_last_assigned;
+
+    // Index the new node by its ID so it can be found without a search.
+    if (id_index_insert(&item_facility_list->id_index, item_facility->id, \
+    record_store_handle(item_facility)) == false) {
+        record_store_remove(&item_facility_list->store, item_facility);
         return;
     }
 
-    // Else add the new node to the end of the list.
-    struct item_facility_node* item_facility = item_facility_list->head;
-    while (item_facility->next != NULL) {
-        item_facility = item_facility->next;
-    }
-    
-    item_facility->next = item_facility_node_new();
-    item_facility->next->prev = item_facility;
+    item_facility_list->id_currently_selected = \
+    item_facility_list->id_last_assigned;
 
-    strcpy(item_facility->next->id, item_facility_list->id_last_assigned);
-    strcpy(item_facility_list->id_currently_selected,
-    item_facility_list->id_last_assigned);
+    item_facility_list->version++;
+    journal_put(item_facility_list->journal, journal_list_item_facilities, \
+    item_facility_list->owner_id, item_facility->id);
 
     return;
 }
 
-// Get the number of item_facility nodes in the item_facility list
+// Get the number of item facility nodes in the item facility list
 int item_facility_list_get_num_item_facility_nodes(struct item_facility_list* item_facility_list) {
     if (item_facility_list == NULL) return 0;
-    if (item_facility_list->head == NULL) return 0;
-
-    struct item_facility_node* item_facility = item_facility_list->head;
-    int item_facility_count = 0;
-    while (item_facility != NULL) {
-        item_facility_count++;
-        item_facility = item_facility->next;
-    }
-    return item_facility_count;
+    return (int)item_facility_list->store.count;
 }
 
-// Return a pointer to a item_facility node according to ID.
+// Return a pointer to an item facility node according to ID.
 // Returns NULL on failure.
 struct item_facility_node *item_facility_list_get_node\
-(struct item_facility_list *item_facility_list, char *id) {
-    if (item_facility_list == NULL || id == NULL) return NULL;
-    if (item_facility_list->head == NULL) return NULL;
+(struct item_facility_list *item_facility_list, enterprise_id id) {
+    if (item_facility_list == NULL) return NULL;
+    return record_store_get\
+    (&item_facility_list->store, id_index_find(&item_facility_list->id_index, id));
+}
 
-    struct item_facility_node* item_facility = item_facility_list->head;
-    while (item_facility != NULL) {
-        if (strcmp(item_facility->id, id) == 0) return item_facility;
-        item_facility = item_facility->next;
+// Return a pointer to the currently selected item facility node.
+// The selected item facility's handle is checked before its ID is looked up,
+// so this only searches the ID index after the selection was changed by ID.
+// Returns NULL if no item facility is selected.
+struct item_facility_node *item_facility_list_get_selected_node\
+(struct item_facility_list *item_facility_list) {
+    if (item_facility_list == NULL) return NULL;
+
+    struct item_facility_node* item_facility = record_store_get\
+    (&item_facility_list->store, item_facility_list->handle_currently_selected);
+    if (item_facility == NULL || item_facility->id != item_facility_list->id_currently_selected) {
+        item_facility = item_facility_list_get_node(item_facility_list, item_facility_list->id_currently_selected);
+        item_facility_list->handle_currently_selected = record_store_handle(item_facility);
     }
-    return NULL;
+    return item_facility;
 }
 
-// Return a pointer to a item_facility node according to facility ID.
+// Return a pointer to an item facility node according to facility ID.
 // Returns NULL on failure.
 struct item_facility_node *item_facility_list_get_node_by_facility_id\
-(struct item_facility_list *item_facility_list, char *id) {
-    if (item_facility_list == NULL || id == NULL) return NULL;
-    if (item_facility_list->head == NULL) return NULL;
+(struct item_facility_list *item_facility_list, enterprise_id id) {
+    if (item_facility_list == NULL) return NULL;
 
-    struct item_facility_node* item_facility = item_facility_list->head;
+    struct item_facility_node* item_facility = record_store_first(&item_facility_list->store);
     while (item_facility != NULL) {
-        if (strcmp(item_facility->facility_id, id) == 0) return item_facility;
-        item_facility = item_facility->next;
+        if (item_facility->facility_id == id) return item_facility;
+        item_facility = record_store_next(&item_facility_list->store, item_facility);
     }
     return NULL;
 }
 
-// Searches for a item_facility by ID and deletes it
-void item_facility_list_delete_node(struct item_facility_list *item_facility_list, char *id) {
-    if (item_facility_list == NULL || id == NULL) return;
-    if (item_facility_list->head == NULL) return;
-
-    // Delete the head if it is the ID that is requested to be deleted.
-    if (strcmp(id, item_facility_list->head->id) == 0) {
-        if (item_facility_list->head->next == NULL) {
-            free(item_facility_list->head);
-            item_facility_list->head = NULL;
-            return;
-        }
-
-        struct item_facility_node *next = item_facility_list->head->next;
-        free(item_facility_list->head);
-        item_facility_list->head = next;
-        return;
-    }
+// Set the facility that an item facility refers to, moving its stock there,
+// counting it in the facility references and noting the change in the
+// journal.
+void item_facility_list_set_facility\
+(struct item_facility_list* item_facility_list, \
+struct item_facility_node* item_facility, enterprise_id facility_id) {
+    if (item_facility_list == NULL || item_facility == NULL) return;
+    if (item_facility->facility_id == facility_id) return;
+
+    stock_valuation_change_item(item_facility_list->valuation, \
+    item_facility_list->owner_id, item_facility->facility_id, \
+    -item_facility->quantity);
+    facility_references_move(item_facility_list->references, \
+    facility_reference_item, item_facility_list->owner_id, \
+    item_facility->facility_id, facility_id);
+    item_facility->facility_id = facility_id;
+    stock_valuation_change_item(item_facility_list->valuation, \
+    item_facility_list->owner_id, item_facility->facility_id, \
+    item_facility->quantity);
+
+    item_facility_list->version++;
+    journal_put(item_facility_list->journal, journal_list_item_facilities, \
+    item_facility_list->owner_id, item_facility->id);
+}
 
-    // Else search for the item_facility to delete.
-    struct item_facility_node* item_facility = item_facility_list->head;
+// Remove every facility of a list from the facility references, before the
+// list is freed along with its item.
+void item_facility_list_unlink(struct item_facility_list* item_facility_list) {
+    if (item_facility_list == NULL) return;
+    struct item_facility_node* item_facility = \
+    record_store_first(&item_facility_list->store);
     while (item_facility != NULL) {
-        if (strcmp(item_facility->id, id) == 0) break;
-        item_facility = item_facility->next;
+        facility_references_remove(item_facility_list->references, \
+        item_facility->facility_id, facility_reference_item, \
+        item_facility_list->owner_id);
+        item_facility = \
+        record_store_next(&item_facility_list->store, item_facility);
     }
-    if (item_facility == NULL) return;
+}
 
-    // Fix the pointers of the next and previous nodes to the item_facility to be
-    // deleted in order to ensure that traversal still works.
+// Searches for an item facility by ID and deletes it
+void item_facility_list_delete_node\
+(struct item_facility_list *item_facility_list, enterprise_id id) {
+    if (item_facility_list == NULL) return;
 
-    struct item_facility_node* prev = item_facility->prev;
-    struct item_facility_node* next = item_facility->next;
+    struct item_facility_node* item_facility = item_facility_list_get_node(item_facility_list, id);
+    if (item_facility == NULL) return;
 
-    if (prev != NULL) {
-        if (next == NULL) {
-            prev->next = NULL;
-            strcpy(item_facility_list->id_currently_selected, prev->id);
-        }
-        if (next != NULL) {
-            prev->next = next;
-            next->prev = prev;
-            strcpy(item_facility_list->id_currently_selected, next->id);
-        }
+    // Select the node after the deleted item facility, or the node before it if
+    // the deleted item facility is the last one.
+    struct item_facility_node* prev = record_store_prev(&item_facility_list->store, item_facility);
+    struct item_facility_node* next = record_store_next(&item_facility_list->store, item_facility);
+    if (next != NULL) {
+        item_facility_list->id_currently_selected = next->id;
     }
-
-    if (prev == NULL) {
-        if (next != NULL) {
-            next->prev = NULL;
-            strcpy(item_facility_list->id_currently_selected, next->id);
-        }
+    else if (prev != NULL) {
+        item_facility_list->id_currently_selected = prev->id;
     }
 
-    // Delete the item_facility
-    free(item_facility);
+    item_facility_list->version++;
+    journal_delete(item_facility_list->journal, journal_list_item_facilities, \
+    item_facility_list->owner_id, item_facility->id);
+    stock_valuation_change_item(item_facility_list->valuation, \
+    item_facility_list->owner_id, item_facility->facility_id, \
+    -item_facility->quantity);
+    facility_references_remove(item_facility_list->references, \
+    item_facility->facility_id, facility_reference_item, \
+    item_facility_list->owner_id);
+
+    // Delete the item facility
+    id_index_remove(&item_facility_list->id_index, item_facility->id);
+    record_store_remove(&item_facility_list->store, item_facility);
     return;
 }
 
 // Select the previous node as the currently selected item.
 void item_facility_list_select_previous_node(struct item_facility_list *item_facility_list) {
     if (item_facility_list == NULL) return;
-    if (item_facility_list->head == NULL) return;
 
-    struct item_facility_node* item_facility = item_facility_list->head;
-    while (item_facility != NULL) {
-        if (strcmp(item_facility->id, item_facility_list->id_currently_selected) == 0) {
-            if (item_facility->prev != NULL) {
-                strcpy(item_facility_list->id_currently_selected, item_facility->prev->id);
-                return;
-            }
-            if (item_facility->prev == NULL) {
-                struct item_facility_node* temp = item_facility;
-                while (temp->next != NULL) {
-                    temp = temp->next;
-                }
-                strcpy(item_facility_list->id_currently_selected, temp->id);
-                return;
-            }
-        }
-        item_facility = item_facility->next;
-    }
+    struct item_facility_node* item_facility = item_facility_list_get_selected_node(item_facility_list);
+    if (item_facility == NULL) return;
+
+    // Wrap around to the last item facility if the first one is selected.
+    struct item_facility_node* prev = record_store_prev(&item_facility_list->store, item_facility);
+    if (prev == NULL) prev = record_store_last(&item_facility_list->store);
+    item_facility_list->id_currently_selected = prev->id;
+    item_facility_list->handle_currently_selected = record_store_handle(prev);
 }
 
 // Select the next node as the currently selected item.
 void item_facility_list_select_next_node(struct item_facility_list *item_facility_list) {
     if (item_facility_list == NULL) return;
-    if (item_facility_list->head == NULL) return;
 
-    struct item_facility_node* item_facility = item_facility_list->head;
-    while (item_facility != NULL) {
-        if (strcmp(item_facility->id, item_facility_list->id_currently_selected) == 0) {
-            if (item_facility->next != NULL) {
-                strcpy(item_facility_list->id_currently_selected, item_facility->next->id);
-                return;
-            }
-            if (item_facility->next == NULL) {
-                strcpy(item_facility_list->id_currently_selected,\
-                item_facility_list->head->id);
-                return;
-            }
-        }
-        item_facility = item_facility->next;
-    }
+    struct item_facility_node* item_facility = item_facility_list_get_selected_node(item_facility_list);
+    if (item_facility == NULL) return;
+
+    // Wrap around to the first item facility if the last one is selected.
+    struct item_facility_node* next = record_store_next(&item_facility_list->store, item_facility);
+    if (next == NULL) next = record_store_first(&item_facility_list->store);
+    item_facility_list->id_currently_selected = next->id;
+    item_facility_list->handle_currently_selected = record_store_handle(next);
 }
 
-// Change the currently selected ID to the passed in ID in the item_facility list.
+// Change the currently selected ID to the passed in ID in the item facility
+// list.
 void item_facility_list_set_selected_id\
-(struct item_facility_list *item_facility_list, char* id) {
-    if (item_facility_list == NULL || id == NULL) return;
-    if (item_facility_list->head == NULL) return;
+(struct item_facility_list *item_facility_list, enterprise_id id) {
+    if (item_facility_list == NULL) return;
 
-    struct item_facility_node* item_facility = item_facility_list->head;
-    while (item_facility != NULL) {
-        if (strcmp(item_facility->id, id) == 0) {
-            strcpy(item_facility_list->id_currently_selected, id);
-        }
-        item_facility = item_facility->next;
+    if (item_facility_list_get_node(item_facility_list, id) != NULL) {
+        item_facility_list->id_currently_selected = id;
     }
 }
 
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+
 // Render the item facilities table GUI.
 // This is an overview of the facilities that an item works at.
 enum program_status item_facility_table(struct nk_context* ctx,\
@@ -347,7 +280,7 @@ struct facility_list* facility_list) {
     }
 
     // Handle case where there are no facilities.
-    if (facility_list->head == NULL) {
+    if (record_store_first(&facility_list->store) == NULL) {
         nk_label(ctx, "There are no facilities available to add item stock to.",\
         NK_TEXT_CENTERED);
         if (nk_button_label(ctx, "Go to Facility Table.")) {
@@ -361,29 +294,52 @@ struct facility_list* facility_list) {
         nk_label(ctx, "Item is in stock at the following facilities: ",\
          NK_TEXT_CENTERED);
 
-        // Present all facilities that the item works for.
-        struct item_facility_node* item_facility\
-        = item_facility_list->head;
-        char* print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-        while (item_facility != NULL) {
-
-            struct facility_node* facility = facility_list_get_node(\
-            facility_list, item_facility->id);
-
-            if (facility == NULL) break;
- 
-            sprintf(print_buffer, "Facility ID: %s Name: %s", \
-            item_facility->id, facility->name);
-
-            if (nk_button_label(ctx, print_buffer)) {
-                strcpy(item_facility_list->id_currently_selected,\
-                item_facility->id);
-                free(print_buffer);
-                return program_status_item_facility_editor;
+        /* Present all facilities that the item is in stock at.
+        Only the rows scrolled into view are drawn, and their labels are only
+        formatted again when different rows come into view or either list
+        changes. Both versions only ever grow, so their sum changes whenever
+        either of them does.*/
+        enum program_status status = program_status_item_facility_table;
+        struct nk_list_view view;
+        uint64_t version = \
+        item_facility_list->version + facility_list->version;
+        int rows = item_facility_list->store.count > INT_MAX \
+        ? INT_MAX : (int)item_facility_list->store.count;
+        nk_layout_row_dynamic(ctx, ENTERPRISE_TABLE_HEIGHT / 2, 1);
+        if (nk_list_view_begin(ctx, &view, "item_facility_table", \
+        NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+            nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+            struct row_labels* labels = &item_facility_list->row_labels;
+            if (row_labels_current(labels, version, \
+            (uint32_t)view.begin, (uint32_t)view.count) == false) {
+                row_labels_begin(labels, version, \
+                (uint32_t)view.begin, (uint32_t)view.count);
+                struct item_facility_node* item_facility = \
+                record_store_seek(&item_facility_list->store, \
+                (uint32_t)view.begin);
+                for (int row = 0; row < view.count \
+                && item_facility != NULL; row++) {
+                    struct facility_node* facility = facility_list_get_node(\
+                    facility_list, item_facility->facility_id);
+                    if (row_labels_add(labels, item_facility->id, \
+                    "Facility ID: %lld Name: %s", \
+                    item_facility->facility_id, \
+                    facility == NULL ? "" : facility->name) == false) break;
+                    item_facility = record_store_next\
+                    (&item_facility_list->store, item_facility);
+                }
             }
-            item_facility = item_facility->next;
+
+            for (uint32_t row = 0; row < labels->count; row++) {
+                if (nk_button_label(ctx, row_labels_text(labels, row))) {
+                    item_facility_list->id_currently_selected = \
+                    row_labels_id(labels, row);
+                    status = program_status_item_facility_editor;
+                }
+            }
+            nk_list_view_end(&view);
         }
-        free(print_buffer);
+        if (status != program_status_item_facility_table) return status;
 
         // Create button to add new item facilities to the table.
         nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
@@ -396,70 +352,93 @@ struct facility_list* facility_list) {
         }
 
         /* If we want to add a new facility.
-        Search through all the facilities in the facility table, display the 
-        facilities that aren't currently worked for by the item, and 
-        if clicked on, add it to the list of facilities the current item 
-        works for. */
+        Go through the facilities in view in the facility table. Facilities
+        the item is already stocked at are shown as labels, so that every
+        facility keeps its row. Facilities it isn't stocked at yet are shown as
+        buttons, and if clicked on, added to the item's list of facilities. */
         if (item_facility_list->addition_requested == true) {
-            print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-            struct facility_node* facility = facility_list->head;
-
-            while (facility != NULL) {
-                bool show = false;
-                sprintf(print_buffer, "ID : %s Facility Name: %s",\
-                facility->id, facility->name);
-                if (item_facility_list_get_node_by_facility_id(\
-                item_facility_list,facility->id) == NULL) show = true;
-                    if (show == true) {
-                        if (nk_button_label(ctx, print_buffer)) {
-                            item_facility_list_append(item_facility_list);
-
-                            strcpy(item_facility_list_get_node\
-                            (item_facility_list,\
-                            item_facility_list->id_currently_selected)\
-                            ->facility_id, facility->id);
-                            item_facility_list->addition_requested = false;
+            rows = facility_list->store.count > INT_MAX \
+            ? INT_MAX : (int)facility_list->store.count;
+            nk_layout_row_dynamic(ctx, ENTERPRISE_TABLE_HEIGHT / 2, 1);
+            if (nk_list_view_begin(ctx, &view, "item_facility_addition", \
+            NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+                nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+                struct row_labels* labels = \
+                &item_facility_list->addition_labels;
+                if (row_labels_current(labels, version, \
+                (uint32_t)view.begin, (uint32_t)view.count) == false) {
+                    row_labels_begin(labels, version, \
+                    (uint32_t)view.begin, (uint32_t)view.count);
+                    struct facility_node* facility = record_store_seek\
+                    (&facility_list->store, (uint32_t)view.begin);
+                    for (int row = 0; row < view.count && facility != NULL; \
+                    row++) {
+                        // Facilities that are already added have no ID.
+                        enterprise_id id = facility->id;
+                        if (item_facility_list_get_node_by_facility_id(\
+                        item_facility_list, facility->id) != NULL) {
+                            id = ENTERPRISE_ID_NONE;
                         }
+                        if (row_labels_add(labels, id, \
+                        "ID : %lld Facility Name: %s", facility->id, \
+                        facility->name) == false) break;
+                        facility = record_store_next(&facility_list->store, \
+                        facility);
+                    }
+                }
+
+                for (uint32_t row = 0; row < labels->count; row++) {
+                    enterprise_id id = row_labels_id(labels, row);
+                    if (id == ENTERPRISE_ID_NONE) {
+                        nk_label(ctx, row_labels_text(labels, row), \
+                        NK_TEXT_LEFT);
+                    }
+                    else if (nk_button_label(ctx, \
+                    row_labels_text(labels, row))) {
+                        item_facility_list_append(item_facility_list);
+                        item_facility_list_set_facility(item_facility_list, \
+                        item_facility_list_get_selected_node\
+                        (item_facility_list), id);
+                        item_facility_list->addition_requested = false;
                     }
-                facility = facility->next;
+                }
+                nk_list_view_end(&view);
             }
-            free(print_buffer);
         }
     }
     return program_status_item_facility_table;
 }
 
-// Render the item_facility editor GUI.
-// It gives the user an opportunity to edit a currently selected item_facility.
+// Render the item facility editor GUI.
+// It gives the user an opportunity to edit a currently selected item facility.
 enum program_status item_facility_editor(struct nk_context* ctx,\
 struct item_facility_list* item_facility_list, \
 struct facility_list* facility_list) {
     if (ctx == NULL || item_facility_list == NULL)
         return program_status_enterprise_menu;
 
-    // Display title and return to item_facility table button.
+    // Display title and return to item facility table button.
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
     if (nk_button_label(ctx, "Return to Item Facility Stock Table")) {
         return program_status_item_facility_table;
     }
     nk_label(ctx, "Item Facility Stock Editor", NK_TEXT_CENTERED);
     
-    // Select currently selected item_facility.
+    // Select currently selected item facility.
     struct item_facility_node* item_facility = \
-    item_facility_list_get_node(item_facility_list,\
-    item_facility_list->id_currently_selected);
+    item_facility_list_get_selected_node(item_facility_list);
 
-    // If the currently selected item_facility does not exist:
+    // If the currently selected item facility does not exist:
     if (item_facility == NULL) {
-        // Select the first item_facility instead.
-        if (item_facility_list->head != NULL) {
-            strcpy(item_facility_list->id_currently_selected, \
-            item_facility_list->head->id);
+        // Select the first item facility instead.
+        item_facility = record_store_first(&item_facility_list->store);
+        if (item_facility != NULL) {
+            item_facility_list->id_currently_selected = item_facility->id;
             return program_status_item_facility_editor;
         }
 
-        // Else tell the user to create a new item_facility 
-        // if the first item_facility doesn't exist.
+        // Else tell the user to create a new item facility 
+        // if the first item facility doesn't exist.
         else {
             nk_label(ctx, "No facilities found.", NK_TEXT_CENTERED);
             if (nk_button_label(ctx, "New Facility")) {
@@ -470,21 +449,48 @@ struct facility_list* facility_list) {
         }
     }
 
-    // Display edit fields to edit item_facility entries.
+    // Display edit fields to edit item facility entries.
     nk_layout_row_template_begin(ctx, ENTERPRISE_WIDGET_HEIGHT);
     nk_layout_row_template_push_static(ctx, 150);
     nk_layout_row_template_push_dynamic(ctx);
     nk_layout_row_template_end(ctx);
 
+    // Fields are edited in place, so keep copies to tell if they change.
+    enterprise_id facility_id = item_facility->facility_id;
+    enterprise_quantity quantity = item_facility->quantity;
+
+    char id_text[ENTERPRISE_ID_TEXT_LENGTH];
+    enterprise_id_format(item_facility->facility_id, id_text);
     nk_label(ctx, "Facility ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    item_facility->facility_id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_decimal);
+    item_facility->facility_id = enterprise_id_parse(id_text);
 
+    // A quantity too large to store is left as it was.
+    char quantity_text[ENTERPRISE_QUANTITY_TEXT_LENGTH];
+    enterprise_quantity_format(item_facility->quantity, quantity_text);
     nk_label(ctx, "Quantity: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    item_facility->quantity, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    quantity_text, ENTERPRISE_QUANTITY_TEXT_LENGTH, nk_filter_decimal);
+    enterprise_quantity_parse(quantity_text, &item_facility->quantity);
+
+    // Note any edits in the journal.
+    if (item_facility->facility_id != facility_id || \
+    item_facility->quantity != quantity) {
+        stock_valuation_change_item(item_facility_list->valuation, \
+        item_facility_list->owner_id, facility_id, -quantity);
+        stock_valuation_change_item(item_facility_list->valuation, \
+        item_facility_list->owner_id, item_facility->facility_id, \
+        item_facility->quantity);
+        facility_references_move(item_facility_list->references, \
+        facility_reference_item, item_facility_list->owner_id, \
+        facility_id, item_facility->facility_id);
+        item_facility_list->version++;
+        journal_put(item_facility_list->journal, journal_list_item_facilities, \
+        item_facility_list->owner_id, item_facility->id);
+    }
 
-    // Move between next and previous item_facilitys.
+    // Move between next and previous item facilities.
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 2);
     if (nk_button_symbol_label\
     (ctx, NK_SYMBOL_TRIANGLE_LEFT, "prev", NK_TEXT_RIGHT)) {
@@ -528,30 +534,31 @@ struct facility_list* facility_list) {
 
     if (item_facility_list->addition_requested == true) {
             char* print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-            struct facility_node* facility = facility_list->head;
+            struct facility_node* facility = record_store_first(&facility_list->store);
 
             while (facility != NULL) {
                 bool show = false;
-                sprintf(print_buffer, "ID : %s Facility Name: %s",\
+                sprintf(print_buffer, "ID : %lld Facility Name: %s",\
                 facility->id, facility->name);
                 if (item_facility_list_get_node_by_facility_id(\
                 item_facility_list,facility->id) == NULL) show = true;
                     if (show == true) {
                         if (nk_button_label(ctx, print_buffer)) {
                             item_facility_list_append(item_facility_list);
-
-                            strcpy(item_facility_list_get_node\
-                            (item_facility_list,\
-                            item_facility_list->id_currently_selected)\
-                            ->facility_id, facility->id);
+                            item_facility_list_set_facility\
+                            (item_facility_list, \
+                            item_facility_list_get_selected_node\
+                            (item_facility_list), facility->id);
                             item_facility_list->addition_requested = false;
                         }
                     }
-                facility = facility->next;
+                facility = record_store_next(&facility_list->store, facility);
             }
             free(print_buffer);
             
         }
     
     return program_status_item_facility_editor;
-}
\ No newline at end of file
+}
+
+#endif
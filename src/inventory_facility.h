@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+#ifndef ENTERPRISE_AMOUNTS
+#define ENTERPRISE_AMOUNTS
+#include "enterprise_amount.h"
+#endif
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+#ifndef ENTERPRISE_FACILITY_REFERENCES
+#define ENTERPRISE_FACILITY_REFERENCES
+#include "facility_references.h"
+#endif
+
+#ifndef ENTERPRISE_STOCK_VALUATION
+#define ENTERPRISE_STOCK_VALUATION
+#include "stock_valuation.h"
+#endif
+
+#ifndef ENTERPRISE_JOURNAL
+#define ENTERPRISE_JOURNAL
+#include "journal.h"
+#endif
+
+#ifndef ENTERPRISE_ROW_LABELS
+#define ENTERPRISE_ROW_LABELS
+#include "row_labels.h"
+#endif
+
+#ifndef PROGRAM_STATES
+#define PROGRAM_STATES
+#include "program_states.h"
+#endif
+
+#ifndef ENTERPRISE_FACILITIES
+#define ENTERPRISE_FACILITIES
+#include "facilities.h"
+#endif
+
+// Nuklear's context, taken by the GUI functions. Only the sources of
+// those functions import Nuklear itself.
+struct nk_context;
+
+/* How item facility links work.
+An item can be stocked at any number of facilities. Each item owns a list of
+item facility links, and each link holds the ID of one facility and the
+quantity of the item in stock there. The list is laid out like every other
+list of the enterprise (see record_store.c), but it belongs to its item rather
+than to the enterprise, and link IDs only have to be unique within it.
+
+Adding, changing or removing a link updates the item's reference to the
+facility (see facility_references.c) and the value of the stock held at it
+(see stock_valuation.c), and is recorded in the journal as a change to the
+item's facilities.
+
+Data structures:
+item_facility_node: A link to one facility, and the stock held there.
+item_facility_list: The facility links of one item.
+*/
+
+struct item_facility_node {
+    enterprise_id id;
+    enterprise_id facility_id;
+    enterprise_quantity quantity;
+};
+
+// Item facility list metadata structure.
+struct item_facility_list {
+    struct record_store store;
+    struct id_index id_index;
+
+    // Where changes to the list are recorded, or NULL if they are not, and the
+    // ID of the node that owns the list.
+    struct journal* journal;
+    enterprise_id owner_id;
+
+    // The stock valuation that changes to the list's stock are counted in, and
+    // the facility references that its facilities are counted in, or NULL if
+    // they are not.
+    struct stock_valuation* valuation;
+    struct facility_references* references;
+
+    // Bumped whenever a node is appended, edited or deleted, so that the
+    // labels cached for the list's table and for the facilities that can be
+    // added to it know when they are stale.
+    uint64_t version;
+    struct row_labels row_labels;
+    struct row_labels addition_labels;
+
+    enterprise_id id_last_assigned;
+    enterprise_id id_currently_selected;
+    uint32_t handle_currently_selected;
+    bool deletion_requested;
+    bool addition_requested;
+};
+
+struct item_facility_node *item_facility_node_new(struct record_store* store);
+struct item_facility_list* item_facility_list_new(struct journal* journal, \
+struct stock_valuation* valuation, struct facility_references* references, \
+enterprise_id owner_id);
+void item_facility_list_free(struct item_facility_list* item_facility_list);
+void item_facility_list_append(struct item_facility_list* item_facility_list);
+int item_facility_list_get_num_item_facility_nodes(struct item_facility_list* item_facility_list);
+struct item_facility_node *item_facility_list_get_node\
+(struct item_facility_list *item_facility_list, enterprise_id id);
+struct item_facility_node *item_facility_list_get_selected_node\
+(struct item_facility_list *item_facility_list);
+struct item_facility_node *item_facility_list_get_node_by_facility_id\
+(struct item_facility_list *item_facility_list, enterprise_id id);
+void item_facility_list_set_facility\
+(struct item_facility_list* item_facility_list, \
+struct item_facility_node* item_facility, enterprise_id facility_id);
+void item_facility_list_unlink(struct item_facility_list* item_facility_list);
+void item_facility_list_delete_node\
+(struct item_facility_list *item_facility_list, enterprise_id id);
+void item_facility_list_select_previous_node(struct item_facility_list *item_facility_list);
+void item_facility_list_select_next_node(struct item_facility_list *item_facility_list);
+void item_facility_list_set_selected_id\
+(struct item_facility_list *item_facility_list, enterprise_id id);
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+enum program_status item_facility_table(struct nk_context* ctx,\
+struct item_facility_list* item_facility_list, \
+struct facility_list* facility_list);
+enum program_status item_facility_editor(struct nk_context* ctx,\
+struct item_facility_list* item_facility_list, \
+struct facility_list* facility_list);
+#endif
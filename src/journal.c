@@ -0,0 +1,376 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_JOURNAL
+#define ENTERPRISE_JOURNAL
+#include "journal.h"
+#endif
+
+// Returns the checksum of size bytes of data.
+static uint32_t journal_checksum(const unsigned char* data, size_t size) {
+    uint32_t checksum = 2166136261u;
+    for (size_t byte = 0; byte < size; byte++) {
+        checksum ^= data[byte];
+        checksum *= 16777619u;
+    }
+    return checksum;
+}
+
+// Write out a file's buffers and wait for them to reach the disk.
+// Returns true on success, or false on failure.
+static bool journal_sync(FILE* file) {
+    if (fflush(file) != 0) return false;
+    #if !defined(_WIN32)
+        if (fsync(fileno(file)) != 0) return false;
+    #endif
+    return true;
+}
+
+// Check the header at the start of a journal file of size bytes.
+// Returns true if it is a journal this program can read, or false if not.
+static bool journal_header_valid\
+(const struct journal_header* header, size_t size) {
+    return size >= sizeof(struct journal_header) && \
+    memcmp(header->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) == 0 && \
+    header->version == JOURNAL_VERSION && \
+    header->byte_order == JOURNAL_BYTE_ORDER;
+}
+
+// Check whether the journal at path belongs to the snapshot of generation,
+// or does not exist yet.
+// Returns true if it can be appended to, or false if it must start again.
+static bool journal_belongs(const char* path, uint64_t generation) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return true;
+    struct journal_header header;
+    size_t size = fread(&header, 1, sizeof(struct journal_header), file);
+    fclose(file);
+    return journal_header_valid(&header, size) && \
+    header.generation == generation;
+}
+
+// Journal constructor. Opens the journal at path belonging to the snapshot of
+// generation to append to it, or starts a new empty journal there if truncate
+// is true, there is none yet or the one there belongs to another snapshot.
+// Returns journal on success, or NULL on failure.
+struct journal* journal_open\
+(const char* path, bool truncate, uint64_t generation) {
+    if (path == NULL) return NULL;
+    if (truncate == false && journal_belongs(path, generation) == false) {
+        truncate = true;
+    }
+    struct journal* journal = malloc(sizeof(struct journal));
+    if (journal == NULL) return NULL;
+    journal->file = fopen(path, truncate ? "wb" : "ab");
+    if (journal->file == NULL) {free(journal); return NULL;}
+
+    journal->changes = NULL;
+    journal->change_count = 0;
+    journal->change_capacity = 0;
+    journal->waiting = false;
+    journal->waiting_since = 0;
+    journal->buffer = NULL;
+    journal->buffer_used = 0;
+    journal->buffer_capacity = 0;
+    journal->text_count = 0;
+    journal->failed = false;
+
+    long size = -1;
+    if (fseek(journal->file, 0, SEEK_END) == 0) size = ftell(journal->file);
+    journal->size = size < 0 ? 0 : (uint64_t)size;
+    bool opened = size >= 0;
+
+    // A new journal starts with its header.
+    if (opened && journal->size == 0) {
+        struct journal_header header;
+        memset(&header, 0, sizeof(struct journal_header));
+        memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        header.version = JOURNAL_VERSION;
+        header.byte_order = JOURNAL_BYTE_ORDER;
+        header.generation = generation;
+        opened = fwrite(&header, sizeof(struct journal_header), 1, \
+        journal->file) == 1 && journal_sync(journal->file);
+        journal->size = sizeof(struct journal_header);
+    }
+    if (opened == false) {
+        fclose(journal->file);
+        free(journal);
+        return NULL;
+    }
+    return journal;
+}
+
+// Close a journal and free all memory associated with it. Changes that have
+// not been committed are lost.
+void journal_close(struct journal* journal) {
+    if (journal == NULL) return;
+    fclose(journal->file);
+    free(journal->changes);
+    free(journal->buffer);
+    free(journal);
+}
+
+// Note a change to a record, unless it is the same as the last one noted.
+static void journal_note(struct journal* journal, uint32_t list, \
+uint32_t operation, enterprise_id owner_id, enterprise_id id) {
+    if (journal == NULL || journal->failed) return;
+    if (journal->change_count > 0) {
+        struct journal_change* last = \
+        &journal->changes[journal->change_count - 1];
+        if (last->list == list && last->operation == operation && \
+        last->owner_id == owner_id && last->id == id) return;
+    }
+
+    if (journal->change_count == journal->change_capacity) {
+        uint32_t change_capacity = journal->change_capacity == 0 ? \
+        64 : journal->change_capacity * 2;
+        struct journal_change* changes = realloc(journal->changes, \
+        sizeof(struct journal_change) * change_capacity);
+        if (changes == NULL) {
+            journal->failed = true;
+            return;
+        }
+        journal->changes = changes;
+        journal->change_capacity = change_capacity;
+    }
+    struct journal_change* change = &journal->changes[journal->change_count++];
+    change->list = list;
+    change->operation = operation;
+    change->owner_id = owner_id;
+    change->id = id;
+}
+
+// Note that a record was added or changed. Does nothing if journal is NULL.
+void journal_put(struct journal* journal, enum journal_list list, \
+enterprise_id owner_id, enterprise_id id) {
+    journal_note(journal, list, journal_operation_put, owner_id, id);
+}
+
+// Note that a record was deleted. Does nothing if journal is NULL.
+void journal_delete(struct journal* journal, enum journal_list list, \
+enterprise_id owner_id, enterprise_id id) {
+    journal_note(journal, list, journal_operation_delete, owner_id, id);
+}
+
+// Forget every change waiting to be committed, for when a snapshot holding
+// them has just been saved.
+void journal_discard(struct journal* journal) {
+    if (journal == NULL) return;
+    journal->change_count = 0;
+    journal->buffer_used = 0;
+    journal->text_count = 0;
+    journal->waiting = false;
+}
+
+// Check whether the changes waiting in a journal should be committed, given
+// the current time in milliseconds.
+// Returns true if they should, or false if they can wait.
+bool journal_due(struct journal* journal, uint64_t milliseconds) {
+    if (journal == NULL || journal->failed || journal->change_count == 0) {
+        return false;
+    }
+    if (journal->waiting == false) {
+        journal->waiting = true;
+        journal->waiting_since = milliseconds;
+    }
+    return milliseconds - journal->waiting_since >= JOURNAL_COMMIT_INTERVAL \
+    || journal->change_count >= JOURNAL_MAX_CHANGES;
+}
+
+// Add a text to the entry being written.
+// Returns the text's position in the entry, or 0 if the text is empty.
+uint32_t journal_text(struct journal* journal, const char* text) {
+    if (text == NULL || text[0] == '\0') return 0;
+    if (journal->text_count == JOURNAL_MAX_TEXTS) {
+        journal->failed = true;
+        return 0;
+    }
+    journal->texts[journal->text_count++] = text;
+    return journal->text_count;
+}
+
+// Write an entry for a change, holding record and the texts added since the
+// last entry. Deletions have no record.
+void journal_write_entry(struct journal* journal, \
+const struct journal_change* change, const void* record, uint32_t record_size) {
+    uint32_t text_count = journal->text_count;
+    journal->text_count = 0;
+    if (journal->failed) return;
+
+    size_t size = record_size;
+    for (uint32_t text = 0; text < text_count; text++) {
+        size += strlen(journal->texts[text]) + 1;
+    }
+    if (size > UINT32_MAX - sizeof(struct journal_entry)) {
+        journal->failed = true;
+        return;
+    }
+
+    size_t needed = journal->buffer_used + sizeof(struct journal_entry) + size;
+    if (needed > journal->buffer_capacity) {
+        size_t buffer_capacity = journal->buffer_capacity == 0 ? \
+        4096 : journal->buffer_capacity;
+        while (buffer_capacity < needed) buffer_capacity *= 2;
+        unsigned char* buffer = realloc(journal->buffer, buffer_capacity);
+        if (buffer == NULL) {
+            journal->failed = true;
+            return;
+        }
+        journal->buffer = buffer;
+        journal->buffer_capacity = buffer_capacity;
+    }
+
+    struct journal_entry entry;
+    memset(&entry, 0, sizeof(struct journal_entry));
+    entry.size = (uint32_t)size;
+    entry.list = change->list;
+    entry.operation = change->operation;
+    entry.record_size = record_size;
+    entry.text_count = text_count;
+    entry.owner_id = change->owner_id;
+    entry.id = change->id;
+
+    unsigned char* start = journal->buffer + journal->buffer_used;
+    unsigned char* end = start + sizeof(struct journal_entry);
+    if (record_size > 0) {
+        memcpy(end, record, record_size);
+        end += record_size;
+    }
+    for (uint32_t text = 0; text < text_count; text++) {
+        size_t length = strlen(journal->texts[text]) + 1;
+        memcpy(end, journal->texts[text], length);
+        end += length;
+    }
+    memcpy(start, &entry, sizeof(struct journal_entry));
+    entry.checksum = journal_checksum(start + sizeof(uint32_t), \
+    (size_t)(end - start) - sizeof(uint32_t));
+    memcpy(start, &entry.checksum, sizeof(uint32_t));
+    journal->buffer_used = (size_t)(end - journal->buffer);
+}
+
+// Write the entries of a commit to the journal file and wait for them to
+// reach the disk, then forget the committed changes.
+// Returns true on success, or false on failure.
+bool journal_commit(struct journal* journal) {
+    if (journal == NULL) return false;
+    if (journal->failed == false && journal->buffer_used > 0) {
+        if (fwrite(journal->buffer, 1, journal->buffer_used, journal->file) \
+        != journal->buffer_used || journal_sync(journal->file) == false) {
+            journal->failed = true;
+        }
+        else journal->size += journal->buffer_used;
+    }
+    journal_discard(journal);
+    return journal->failed == false;
+}
+
+// Read a journal file into a reader, which is stale if the journal does not
+// belong to the snapshot of generation.
+// Returns true on success, or false if there is no journal at path.
+bool journal_reader_open(struct journal_reader* reader, const char* path, \
+uint64_t generation) {
+    if (reader == NULL || path == NULL) return false;
+    reader->data = NULL;
+    reader->size = 0;
+    reader->offset = sizeof(struct journal_header);
+    reader->damaged = false;
+    reader->stale = false;
+
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return false;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        reader->damaged = true;
+        fclose(file);
+        return true;
+    }
+    reader->size = (size_t)size;
+    reader->data = malloc(reader->size + 1);
+    if (reader->data == NULL || \
+    fread(reader->data, 1, reader->size, file) != reader->size) {
+        reader->damaged = true;
+        reader->size = 0;
+    }
+    fclose(file);
+
+    struct journal_header header;
+    if (reader->size < sizeof(struct journal_header)) {
+        reader->damaged = true;
+        return true;
+    }
+    memcpy(&header, reader->data, sizeof(struct journal_header));
+    if (journal_header_valid(&header, reader->size) == false) {
+        reader->damaged = true;
+    }
+    else if (header.generation != generation) reader->stale = true;
+    return true;
+}
+
+// Free all memory associated with a reader.
+void journal_reader_free(struct journal_reader* reader) {
+    if (reader == NULL) return;
+    free(reader->data);
+    reader->data = NULL;
+}
+
+// Read the next entry of a journal. Reaching an entry that is torn or does
+// not match its checksum marks the reader as damaged.
+// Returns true on success, or false if there are no more entries.
+bool journal_read_entry\
+(struct journal_reader* reader, struct journal_replay_entry* entry) {
+    if (reader->damaged || reader->stale || reader->offset >= reader->size) {
+        return false;
+    }
+    size_t left = reader->size - reader->offset;
+    unsigned char* start = reader->data + reader->offset;
+
+    reader->damaged = true;
+    if (left < sizeof(struct journal_entry)) return false;
+    memcpy(&entry->header, start, sizeof(struct journal_entry));
+    struct journal_entry* header = &entry->header;
+    if (header->size > left - sizeof(struct journal_entry) || \
+    header->record_size > header->size || \
+    header->text_count > JOURNAL_MAX_TEXTS || \
+    header->checksum != journal_checksum(start + sizeof(uint32_t), \
+    sizeof(struct journal_entry) - sizeof(uint32_t) + header->size)) {
+        return false;
+    }
+
+    // Split the texts after the record, which must fill the rest of the
+    // entry exactly.
+    entry->record = start + sizeof(struct journal_entry);
+    const char* text = (const char*)(entry->record + header->record_size);
+    const char* end = (const char*)(entry->record + header->size);
+    entry->texts[0] = "";
+    for (uint32_t position = 1; position <= header->text_count; position++) {
+        const char* terminator = memchr(text, '\0', (size_t)(end - text));
+        if (terminator == NULL) return false;
+        entry->texts[position] = text;
+        text = terminator + 1;
+    }
+    if (text != end) return false;
+
+    reader->damaged = false;
+    reader->offset += sizeof(struct journal_entry) + header->size;
+    return true;
+}
+
+// Copy the record of an entry, checking that it has the expected size.
+// Returns true on success, or false on failure.
+bool journal_entry_record(const struct journal_replay_entry* entry, \
+void* record, uint32_t record_size) {
+    if (entry->header.record_size != record_size) return false;
+    memcpy(record, entry->record, record_size);
+    return true;
+}
+
+// Returns the text at a position in an entry, or NULL if there is none.
+const char* journal_entry_text\
+(const struct journal_replay_entry* entry, uint32_t position) {
+    if (position > entry->header.text_count) return NULL;
+    return entry->texts[position];
+}
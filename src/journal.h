@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#if !defined(_WIN32)
+    #include <unistd.h>
+#endif
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+/* How the journal works.
+Saving a snapshot (see snapshot.c) writes out the whole database, which is far
+too slow to do after every edit. The journal is a file next to the snapshot
+that changes are appended to as they happen, so keeping an edit safe costs
+time in proportion to the edit rather than to the database.
+
+Lists tell the journal that one of their records was added or changed with
+journal_put, and that one was deleted with journal_delete. Only the list and
+IDs of each change are noted. Changes are committed in groups: a commit writes
+one entry per changed record holding the record as it is at that moment, then
+calls fsync once. A burst of keystrokes in an editor changes the same record
+over and over, but costs a single entry and a single fsync per commit.
+Commits happen once changes have waited JOURNAL_COMMIT_INTERVAL milliseconds.
+
+Each entry is a header with the list, operation and IDs of the record and a
+checksum, followed by the record in the same layout as in a snapshot, followed
+by the text of the record. Text fields of the record hold the position of
+their text among the texts of the entry, with 0 meaning an empty string.
+
+On startup the snapshot is loaded and the journal is replayed on top of it.
+Entries hold whole records rather than edits to them, so replaying an entry
+that the snapshot already holds changes nothing. A crash in the middle of a
+commit leaves a torn entry at the end of the journal, and replay stops there.
+
+Saving a snapshot compacts the journal: everything in the journal is then in
+the snapshot too, so the journal is started again empty.
+
+A journal belongs to one snapshot. Its header holds the generation of that
+snapshot, which every save changes. A crash after a save has replaced the
+snapshot but before it has started the journal again leaves behind a journal
+of changes the new snapshot already holds, and perhaps changes it has undone
+since. Replay ignores a journal whose generation is not the snapshot's, and
+opening one to append to starts it again empty. The enterprise also
+saves on its own when the journal grows past JOURNAL_COMPACT_SIZE bytes, so
+that replay stays quick.
+
+Data structures:
+journal: The journal file and the changes waiting to be committed.
+journal_change: A record that changed since the last commit.
+journal_header and journal_entry: The on disk layout.
+journal_reader: A journal file being replayed.
+journal_replay_entry: An entry read back from a journal file.
+*/
+
+#define JOURNAL_MAGIC "ENTJRNL"
+#define JOURNAL_VERSION 3
+#define JOURNAL_BYTE_ORDER 0x01020304u
+#define JOURNAL_MAX_TEXTS 8
+#define JOURNAL_MAX_CHANGES 65536
+#define JOURNAL_COMMIT_INTERVAL 250
+#define JOURNAL_COMPACT_SIZE (16 * 1024 * 1024)
+
+// The lists that changes can be made to.
+enum journal_list {journal_list_enterprise = 1, journal_list_facilities,
+journal_list_employees, journal_list_employee_facilities, journal_list_items,
+journal_list_item_facilities, journal_list_customers, journal_list_suppliers,
+journal_list_expenses, journal_list_orders};
+
+// What happened to a record.
+enum journal_operation {journal_operation_put = 1, journal_operation_delete};
+
+// The first bytes of every journal, ending with the generation of the
+// snapshot it belongs to.
+struct journal_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t generation;
+};
+
+// The header in front of every entry. The checksum covers everything after
+// it, up to the end of the entry's texts. Nested lists of facilities give
+// the ID of the employee or item that owns them as owner_id.
+struct journal_entry {
+    uint32_t checksum;
+    uint32_t size;
+    uint32_t list;
+    uint32_t operation;
+    uint32_t record_size;
+    uint32_t text_count;
+    int64_t owner_id;
+    int64_t id;
+};
+
+// A record that changed since the last commit.
+struct journal_change {
+    uint32_t list;
+    uint32_t operation;
+    enterprise_id owner_id;
+    enterprise_id id;
+};
+
+// Journal structure.
+struct journal {
+    FILE* file;
+    uint64_t size;
+
+    // Changes waiting to be committed, and when the first of them was seen
+    // by journal_due.
+    struct journal_change* changes;
+    uint32_t change_count;
+    uint32_t change_capacity;
+    bool waiting;
+    uint64_t waiting_since;
+
+    // Entries written by the commit in progress, and the texts of the entry
+    // being written.
+    unsigned char* buffer;
+    size_t buffer_used;
+    size_t buffer_capacity;
+    const char* texts[JOURNAL_MAX_TEXTS];
+    uint32_t text_count;
+
+    bool failed;
+};
+
+// A journal file being replayed, read into memory in one go. A stale journal
+// belongs to another snapshot, and none of its entries are read.
+struct journal_reader {
+    unsigned char* data;
+    size_t size;
+    size_t offset;
+    bool damaged;
+    bool stale;
+};
+
+// An entry read back from a journal. Text position 0 is the empty string.
+struct journal_replay_entry {
+    struct journal_entry header;
+    const unsigned char* record;
+    const char* texts[JOURNAL_MAX_TEXTS + 1];
+};
+
+struct journal* journal_open\
+(const char* path, bool truncate, uint64_t generation);
+void journal_close(struct journal* journal);
+void journal_put(struct journal* journal, enum journal_list list, \
+enterprise_id owner_id, enterprise_id id);
+void journal_delete(struct journal* journal, enum journal_list list, \
+enterprise_id owner_id, enterprise_id id);
+void journal_discard(struct journal* journal);
+bool journal_due(struct journal* journal, uint64_t milliseconds);
+uint32_t journal_text(struct journal* journal, const char* text);
+void journal_write_entry(struct journal* journal, \
+const struct journal_change* change, const void* record, uint32_t record_size);
+bool journal_commit(struct journal* journal);
+bool journal_reader_open(struct journal_reader* reader, const char* path, \
+uint64_t generation);
+void journal_reader_free(struct journal_reader* reader);
+bool journal_read_entry\
+(struct journal_reader* reader, struct journal_replay_entry* entry);
+bool journal_entry_record(const struct journal_replay_entry* entry, \
+void* record, uint32_t record_size);
+const char* journal_entry_text\
+(const struct journal_replay_entry* entry, uint32_t position);
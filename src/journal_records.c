@@ -0,0 +1,639 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_JOURNAL_RECORDS
+#define ENTERPRISE_JOURNAL_RECORDS
+#include "journal_records.h"
+#endif
+
+// Write a journal entry holding a facility.
+void journal_write_facility(struct journal* journal, \
+const struct journal_change* change, struct facility_list* facility_list) {
+    struct facility_node* facility = \
+    facility_list_get_node(facility_list, change->id);
+    if (facility == NULL) return;
+
+    struct snapshot_facility record;
+    memset(&record, 0, sizeof(struct snapshot_facility));
+    record.id = facility->id;
+    record.name = journal_text(journal, facility->name);
+    record.email = journal_text(journal, facility->email);
+    record.phone = journal_text(journal, facility->phone);
+    record.address = journal_text(journal, facility->address);
+    record.type = facility->type;
+    journal_write_entry(journal, change, &record, \
+    sizeof(struct snapshot_facility));
+}
+
+// Write a journal entry holding an employee.
+void journal_write_employee(struct journal* journal, \
+const struct journal_change* change, struct employee_list* employee_list) {
+    struct employee_node* employee = \
+    employee_list_get_node(employee_list, change->id);
+    if (employee == NULL) return;
+
+    struct snapshot_employee record;
+    memset(&record, 0, sizeof(struct snapshot_employee));
+    record.id = employee->id;
+    record.name = journal_text(journal, employee->name);
+    record.email = journal_text(journal, employee->email);
+    record.phone = journal_text(journal, employee->phone);
+    record.address = journal_text(journal, employee->address);
+    if (employee->employee_facility_list != NULL) {
+        record.has_facilities = 1;
+        record.facilities_last_assigned = \
+        employee->employee_facility_list->id_last_assigned;
+    }
+    journal_write_entry(journal, change, &record, \
+    sizeof(struct snapshot_employee));
+}
+
+// Write a journal entry holding a facility that an employee works at.
+void journal_write_employee_facility(struct journal* journal, \
+const struct journal_change* change, struct employee_list* employee_list) {
+    struct employee_node* employee = \
+    employee_list_get_node(employee_list, change->owner_id);
+    if (employee == NULL) return;
+    struct employee_facility_node* employee_facility = \
+    employee_facility_list_get_node(employee->employee_facility_list, \
+    change->id);
+    if (employee_facility == NULL) return;
+
+    struct snapshot_employee_facility record;
+    memset(&record, 0, sizeof(struct snapshot_employee_facility));
+    record.employee_id = employee->id;
+    record.id = employee_facility->id;
+    record.facility_id = employee_facility->facility_id;
+    journal_write_entry(journal, change, &record, \
+    sizeof(struct snapshot_employee_facility));
+}
+
+// Write a journal entry holding an item.
+void journal_write_item(struct journal* journal, \
+const struct journal_change* change, struct item_list* item_list) {
+    struct item_node* item = item_list_get_node(item_list, change->id);
+    if (item == NULL) return;
+
+    struct snapshot_item record;
+    memset(&record, 0, sizeof(struct snapshot_item));
+    record.id = item->id;
+    record.name = journal_text(journal, item->name);
+    record.retail_price = item->retail_price;
+    record.internal_cost = item->internal_cost;
+    if (item->item_facility_list != NULL) {
+        record.has_facilities = 1;
+        record.facilities_last_assigned = \
+        item->item_facility_list->id_last_assigned;
+    }
+    journal_write_entry(journal, change, &record, sizeof(struct snapshot_item));
+}
+
+// Write a journal entry holding a facility that an item is stocked at.
+void journal_write_item_facility(struct journal* journal, \
+const struct journal_change* change, struct item_list* item_list) {
+    struct item_node* item = item_list_get_node(item_list, change->owner_id);
+    if (item == NULL) return;
+    struct item_facility_node* item_facility = \
+    item_facility_list_get_node(item->item_facility_list, change->id);
+    if (item_facility == NULL) return;
+
+    struct snapshot_item_facility record;
+    memset(&record, 0, sizeof(struct snapshot_item_facility));
+    record.item_id = item->id;
+    record.id = item_facility->id;
+    record.facility_id = item_facility->facility_id;
+    record.quantity = item_facility->quantity;
+    journal_write_entry(journal, change, &record, \
+    sizeof(struct snapshot_item_facility));
+}
+
+// Write a journal entry holding a customer.
+void journal_write_customer(struct journal* journal, \
+const struct journal_change* change, struct customer_list* customer_list) {
+    struct customer_node* customer = \
+    customer_list_get_node(customer_list, change->id);
+    if (customer == NULL) return;
+
+    struct snapshot_customer record;
+    memset(&record, 0, sizeof(struct snapshot_customer));
+    record.id = customer->id;
+    record.name = journal_text(journal, customer->name);
+    record.email = journal_text(journal, customer->email);
+    record.phone = journal_text(journal, customer->phone);
+    record.address = journal_text(journal, customer->address);
+    journal_write_entry(journal, change, &record, \
+    sizeof(struct snapshot_customer));
+}
+
+// Write a journal entry holding a supplier.
+void journal_write_supplier(struct journal* journal, \
+const struct journal_change* change, struct supplier_list* supplier_list) {
+    struct supplier_node* supplier = \
+    supplier_list_get_node(supplier_list, change->id);
+    if (supplier == NULL) return;
+
+    struct snapshot_supplier record;
+    memset(&record, 0, sizeof(struct snapshot_supplier));
+    record.id = supplier->id;
+    record.name = journal_text(journal, supplier->name);
+    record.email = journal_text(journal, supplier->email);
+    record.phone = journal_text(journal, supplier->phone);
+    record.address = journal_text(journal, supplier->address);
+    journal_write_entry(journal, change, &record, \
+    sizeof(struct snapshot_supplier));
+}
+
+// Write a journal entry holding an expense.
+void journal_write_expense(struct journal* journal, \
+const struct journal_change* change, struct expense_list* expense_list) {
+    struct expense_node* expense = \
+    expense_list_get_node(expense_list, change->id);
+    if (expense == NULL) return;
+
+    struct snapshot_expense record;
+    memset(&record, 0, sizeof(struct snapshot_expense));
+    record.id = expense->id;
+    record.facility_id = expense->facility_id;
+    record.supplier_id = expense->supplier_id;
+    record.type = expense->type;
+    journal_write_entry(journal, change, &record, \
+    sizeof(struct snapshot_expense));
+}
+
+// Write a journal entry holding an order.
+void journal_write_order(struct journal* journal, \
+const struct journal_change* change, struct order_list* order_list) {
+    struct order_node* order = order_list_get_node(order_list, change->id);
+    if (order == NULL) return;
+
+    struct snapshot_order record;
+    memset(&record, 0, sizeof(struct snapshot_order));
+    record.id = order->id;
+    record.supplier_id = order->supplier_id;
+    record.recipient_id = order->recipient_id;
+    record.time_order_placed = (int64_t)order->time_order_placed;
+    record.supplier_type = order->supplier_type;
+    record.recipient_type = order->recipient_type;
+    record.delivered = order->delivered;
+    journal_write_entry(journal, change, &record, \
+    sizeof(struct snapshot_order));
+}
+
+// Apply a journal entry to a facility list.
+// Returns true on success, or false if the entry is damaged.
+bool journal_apply_facility(struct facility_list* facility_list, \
+const struct journal_replay_entry* entry) {
+    if (entry->header.operation == journal_operation_delete) {
+        facility_list->id_last_assigned = \
+        MAX(facility_list->id_last_assigned, entry->header.id);
+        facility_list_delete_node(facility_list, entry->header.id);
+        return true;
+    }
+
+    struct snapshot_facility record;
+    if (journal_entry_record(entry, &record, \
+    sizeof(struct snapshot_facility)) == false || \
+    record.id != entry->header.id || record.id <= ENTERPRISE_ID_NONE) {
+        return false;
+    }
+    const char* name = journal_entry_text(entry, record.name);
+    const char* email = journal_entry_text(entry, record.email);
+    const char* phone = journal_entry_text(entry, record.phone);
+    const char* address = journal_entry_text(entry, record.address);
+    if (name == NULL || email == NULL || phone == NULL || address == NULL || \
+    record.type < facility_type_office || \
+    record.type > facility_type_warehouse) return false;
+
+    struct facility_node* facility = \
+    facility_list_get_node(facility_list, record.id);
+    if (facility == NULL) {
+        facility = facility_node_new(&facility_list->store);
+        if (facility == NULL) return false;
+        facility->id = record.id;
+        if (id_index_insert(&facility_list->id_index, facility->id, \
+        record_store_handle(facility)) == false) {
+            record_store_remove(&facility_list->store, facility);
+            return false;
+        }
+        facility_list->id_last_assigned = \
+        MAX(facility_list->id_last_assigned, record.id);
+    }
+    string_pool_assign(facility_list->string_pool, &facility->name, name);
+    string_pool_assign(facility_list->string_pool, &facility->email, email);
+    string_pool_assign(facility_list->string_pool, &facility->phone, phone);
+    string_pool_assign(facility_list->string_pool, &facility->address, \
+    address);
+    facility->type = (enum facility_type)record.type;
+    facility_list->version++;
+    return true;
+}
+
+// Apply a journal entry to an employee list.
+// Returns true on success, or false if the entry is damaged.
+bool journal_apply_employee(struct employee_list* employee_list, \
+const struct journal_replay_entry* entry) {
+    if (entry->header.operation == journal_operation_delete) {
+        employee_list->id_last_assigned = \
+        MAX(employee_list->id_last_assigned, entry->header.id);
+        employee_list_delete_node(employee_list, entry->header.id);
+        return true;
+    }
+
+    struct snapshot_employee record;
+    if (journal_entry_record(entry, &record, \
+    sizeof(struct snapshot_employee)) == false || \
+    record.id != entry->header.id || record.id <= ENTERPRISE_ID_NONE || \
+    record.facilities_last_assigned < ENTERPRISE_ID_NONE) return false;
+    const char* name = journal_entry_text(entry, record.name);
+    const char* email = journal_entry_text(entry, record.email);
+    const char* phone = journal_entry_text(entry, record.phone);
+    const char* address = journal_entry_text(entry, record.address);
+    if (name == NULL || email == NULL || phone == NULL || address == NULL) {
+        return false;
+    }
+
+    struct employee_node* employee = \
+    employee_list_get_node(employee_list, record.id);
+    if (employee == NULL) {
+        employee = employee_node_new(&employee_list->store);
+        if (employee == NULL) return false;
+        employee->id = record.id;
+        if (id_index_insert(&employee_list->id_index, employee->id, \
+        record_store_handle(employee)) == false) {
+            record_store_remove(&employee_list->store, employee);
+            return false;
+        }
+        employee_list->id_last_assigned = \
+        MAX(employee_list->id_last_assigned, record.id);
+    }
+    string_pool_assign(employee_list->string_pool, &employee->name, name);
+    string_pool_assign(employee_list->string_pool, &employee->email, email);
+    string_pool_assign(employee_list->string_pool, &employee->phone, phone);
+    string_pool_assign(employee_list->string_pool, &employee->address, \
+    address);
+
+    if (record.has_facilities && employee->employee_facility_list == NULL) {
+        employee->employee_facility_list = employee_facility_list_new\
+        (NULL, employee_list->facility_references, employee->id);
+        if (employee->employee_facility_list == NULL) return false;
+    }
+    if (employee->employee_facility_list != NULL) {
+        employee->employee_facility_list->id_last_assigned = \
+        MAX(employee->employee_facility_list->id_last_assigned, \
+        record.facilities_last_assigned);
+    }
+    employee_list->version++;
+    employee_list_index_node(employee_list, employee);
+    return true;
+}
+
+// Apply a journal entry to the facilities of an employee.
+// Returns true on success, or false if the entry is damaged.
+bool journal_apply_employee_facility(struct employee_list* employee_list, \
+const struct journal_replay_entry* entry) {
+    struct employee_node* employee = \
+    employee_list_get_node(employee_list, entry->header.owner_id);
+    if (employee == NULL) return true;
+    if (employee->employee_facility_list == NULL) {
+        employee->employee_facility_list = employee_facility_list_new\
+        (NULL, employee_list->facility_references, employee->id);
+        if (employee->employee_facility_list == NULL) return false;
+    }
+    struct employee_facility_list* employee_facility_list = \
+    employee->employee_facility_list;
+    if (entry->header.operation == journal_operation_delete) {
+        employee_facility_list->id_last_assigned = \
+        MAX(employee_facility_list->id_last_assigned, entry->header.id);
+        employee_facility_list_delete_node(employee_facility_list, \
+        entry->header.id);
+        return true;
+    }
+
+    struct snapshot_employee_facility record;
+    if (journal_entry_record(entry, &record, \
+    sizeof(struct snapshot_employee_facility)) == false || \
+    record.id != entry->header.id || record.id <= ENTERPRISE_ID_NONE || \
+    record.employee_id != employee->id) return false;
+
+    struct employee_facility_node* employee_facility = \
+    employee_facility_list_get_node(employee_facility_list, record.id);
+    if (employee_facility == NULL) {
+        employee_facility = \
+        employee_facility_node_new(&employee_facility_list->store);
+        if (employee_facility == NULL) return false;
+        employee_facility->id = record.id;
+        if (id_index_insert(&employee_facility_list->id_index, \
+        employee_facility->id, record_store_handle(employee_facility)) \
+        == false) {
+            record_store_remove(&employee_facility_list->store, \
+            employee_facility);
+            return false;
+        }
+        employee_facility_list->id_last_assigned = \
+        MAX(employee_facility_list->id_last_assigned, record.id);
+    }
+    facility_references_move(employee_facility_list->references, \
+    facility_reference_employee, employee->id, \
+    employee_facility->facility_id, record.facility_id);
+    employee_facility->facility_id = record.facility_id;
+    employee_facility_list->version++;
+    return true;
+}
+
+// Apply a journal entry to an item list.
+// Returns true on success, or false if the entry is damaged.
+bool journal_apply_item(struct item_list* item_list, \
+const struct journal_replay_entry* entry) {
+    if (entry->header.operation == journal_operation_delete) {
+        item_list->id_last_assigned = \
+        MAX(item_list->id_last_assigned, entry->header.id);
+        item_list_delete_node(item_list, entry->header.id);
+        return true;
+    }
+
+    struct snapshot_item record;
+    if (journal_entry_record(entry, &record, sizeof(struct snapshot_item)) \
+    == false || record.id != entry->header.id || \
+    record.id <= ENTERPRISE_ID_NONE || \
+    record.facilities_last_assigned < ENTERPRISE_ID_NONE) return false;
+    const char* name = journal_entry_text(entry, record.name);
+    if (name == NULL) return false;
+
+    struct item_node* item = item_list_get_node(item_list, record.id);
+    if (item == NULL) {
+        item = item_node_new(&item_list->store);
+        if (item == NULL) return false;
+        item->id = record.id;
+        if (id_index_insert(&item_list->id_index, item->id, \
+        record_store_handle(item)) == false) {
+            record_store_remove(&item_list->store, item);
+            return false;
+        }
+        item_list->id_last_assigned = \
+        MAX(item_list->id_last_assigned, record.id);
+    }
+    string_pool_assign(item_list->string_pool, &item->name, name);
+    if (item->retail_price != record.retail_price || \
+    item->internal_cost != record.internal_cost) {
+        item_list_value_stock(item_list, item, -1);
+        item->retail_price = record.retail_price;
+        item->internal_cost = record.internal_cost;
+        item_list_value_stock(item_list, item, 1);
+    }
+
+    if (record.has_facilities && item->item_facility_list == NULL) {
+        item->item_facility_list = item_facility_list_new(NULL, \
+        &item_list->valuation, item_list->facility_references, item->id);
+        if (item->item_facility_list == NULL) return false;
+    }
+    if (item->item_facility_list != NULL) {
+        item->item_facility_list->id_last_assigned = \
+        MAX(item->item_facility_list->id_last_assigned, \
+        record.facilities_last_assigned);
+    }
+    item_list->version++;
+    item_list_sort_node(item_list, item);
+    return true;
+}
+
+// Apply a journal entry to the facilities of an item.
+// Returns true on success, or false if the entry is damaged.
+bool journal_apply_item_facility(struct item_list* item_list, \
+const struct journal_replay_entry* entry) {
+    struct item_node* item = \
+    item_list_get_node(item_list, entry->header.owner_id);
+    if (item == NULL) return true;
+    if (item->item_facility_list == NULL) {
+        item->item_facility_list = item_facility_list_new(NULL, \
+        &item_list->valuation, item_list->facility_references, item->id);
+        if (item->item_facility_list == NULL) return false;
+    }
+    struct item_facility_list* item_facility_list = item->item_facility_list;
+    if (entry->header.operation == journal_operation_delete) {
+        item_facility_list->id_last_assigned = \
+        MAX(item_facility_list->id_last_assigned, entry->header.id);
+        item_facility_list_delete_node(item_facility_list, entry->header.id);
+        return true;
+    }
+
+    struct snapshot_item_facility record;
+    if (journal_entry_record(entry, &record, \
+    sizeof(struct snapshot_item_facility)) == false || \
+    record.id != entry->header.id || record.id <= ENTERPRISE_ID_NONE || \
+    record.item_id != item->id || record.quantity < 0) return false;
+
+    struct item_facility_node* item_facility = \
+    item_facility_list_get_node(item_facility_list, record.id);
+    if (item_facility == NULL) {
+        item_facility = item_facility_node_new(&item_facility_list->store);
+        if (item_facility == NULL) return false;
+        item_facility->id = record.id;
+        if (id_index_insert(&item_facility_list->id_index, \
+        item_facility->id, record_store_handle(item_facility)) == false) {
+            record_store_remove(&item_facility_list->store, item_facility);
+            return false;
+        }
+        item_facility_list->id_last_assigned = \
+        MAX(item_facility_list->id_last_assigned, record.id);
+    }
+    stock_valuation_change_item(&item_list->valuation, item->id, \
+    item_facility->facility_id, -item_facility->quantity);
+    facility_references_move(item_facility_list->references, \
+    facility_reference_item, item->id, item_facility->facility_id, \
+    record.facility_id);
+    item_facility->facility_id = record.facility_id;
+    item_facility->quantity = record.quantity;
+    stock_valuation_change_item(&item_list->valuation, item->id, \
+    item_facility->facility_id, item_facility->quantity);
+    item_facility_list->version++;
+    return true;
+}
+
+// Apply a journal entry to a customer list.
+// Returns true on success, or false if the entry is damaged.
+bool journal_apply_customer(struct customer_list* customer_list, \
+const struct journal_replay_entry* entry) {
+    if (entry->header.operation == journal_operation_delete) {
+        customer_list->id_last_assigned = \
+        MAX(customer_list->id_last_assigned, entry->header.id);
+        customer_list_delete_node(customer_list, entry->header.id);
+        return true;
+    }
+
+    struct snapshot_customer record;
+    if (journal_entry_record(entry, &record, \
+    sizeof(struct snapshot_customer)) == false || \
+    record.id != entry->header.id || record.id <= ENTERPRISE_ID_NONE) {
+        return false;
+    }
+    const char* name = journal_entry_text(entry, record.name);
+    const char* email = journal_entry_text(entry, record.email);
+    const char* phone = journal_entry_text(entry, record.phone);
+    const char* address = journal_entry_text(entry, record.address);
+    if (name == NULL || email == NULL || phone == NULL || address == NULL) {
+        return false;
+    }
+
+    struct customer_node* customer = \
+    customer_list_get_node(customer_list, record.id);
+    if (customer == NULL) {
+        customer = customer_node_new(&customer_list->store);
+        if (customer == NULL) return false;
+        customer->id = record.id;
+        if (id_index_insert(&customer_list->id_index, customer->id, \
+        record_store_handle(customer)) == false) {
+            record_store_remove(&customer_list->store, customer);
+            return false;
+        }
+        customer_list->id_last_assigned = \
+        MAX(customer_list->id_last_assigned, record.id);
+    }
+    string_pool_assign(customer_list->string_pool, &customer->name, name);
+    string_pool_assign(customer_list->string_pool, &customer->email, email);
+    string_pool_assign(customer_list->string_pool, &customer->phone, phone);
+    string_pool_assign(customer_list->string_pool, &customer->address, \
+    address);
+    customer_list->version++;
+    customer_list_index_node(customer_list, customer);
+    customer_list_sort_node(customer_list, customer);
+    return true;
+}
+
+// Apply a journal entry to a supplier list.
+// Returns true on success, or false if the entry is damaged.
+bool journal_apply_supplier(struct supplier_list* supplier_list, \
+const struct journal_replay_entry* entry) {
+    if (entry->header.operation == journal_operation_delete) {
+        supplier_list->id_last_assigned = \
+        MAX(supplier_list->id_last_assigned, entry->header.id);
+        supplier_list_delete_node(supplier_list, entry->header.id);
+        return true;
+    }
+
+    struct snapshot_supplier record;
+    if (journal_entry_record(entry, &record, \
+    sizeof(struct snapshot_supplier)) == false || \
+    record.id != entry->header.id || record.id <= ENTERPRISE_ID_NONE) {
+        return false;
+    }
+    const char* name = journal_entry_text(entry, record.name);
+    const char* email = journal_entry_text(entry, record.email);
+    const char* phone = journal_entry_text(entry, record.phone);
+    const char* address = journal_entry_text(entry, record.address);
+    if (name == NULL || email == NULL || phone == NULL || address == NULL) {
+        return false;
+    }
+
+    struct supplier_node* supplier = \
+    supplier_list_get_node(supplier_list, record.id);
+    if (supplier == NULL) {
+        supplier = supplier_node_new(&supplier_list->store);
+        if (supplier == NULL) return false;
+        supplier->id = record.id;
+        if (id_index_insert(&supplier_list->id_index, supplier->id, \
+        record_store_handle(supplier)) == false) {
+            record_store_remove(&supplier_list->store, supplier);
+            return false;
+        }
+        supplier_list->id_last_assigned = \
+        MAX(supplier_list->id_last_assigned, record.id);
+    }
+    string_pool_assign(supplier_list->string_pool, &supplier->name, name);
+    string_pool_assign(supplier_list->string_pool, &supplier->email, email);
+    string_pool_assign(supplier_list->string_pool, &supplier->phone, phone);
+    string_pool_assign(supplier_list->string_pool, &supplier->address, \
+    address);
+    supplier_list->version++;
+    supplier_list_index_node(supplier_list, supplier);
+    return true;
+}
+
+// Apply a journal entry to an expense list.
+// Returns true on success, or false if the entry is damaged.
+bool journal_apply_expense(struct expense_list* expense_list, \
+const struct journal_replay_entry* entry) {
+    if (entry->header.operation == journal_operation_delete) {
+        expense_list->id_last_assigned = \
+        MAX(expense_list->id_last_assigned, entry->header.id);
+        expense_list_delete_node(expense_list, entry->header.id);
+        return true;
+    }
+
+    struct snapshot_expense record;
+    if (journal_entry_record(entry, &record, \
+    sizeof(struct snapshot_expense)) == false || \
+    record.id != entry->header.id || record.id <= ENTERPRISE_ID_NONE || \
+    record.type < expense_type_rent || record.type > expense_type_misc) {
+        return false;
+    }
+
+    struct expense_node* expense = \
+    expense_list_get_node(expense_list, record.id);
+    if (expense == NULL) {
+        expense = expense_node_new(&expense_list->store);
+        if (expense == NULL) return false;
+        expense->id = record.id;
+        if (id_index_insert(&expense_list->id_index, expense->id, \
+        record_store_handle(expense)) == false) {
+            record_store_remove(&expense_list->store, expense);
+            return false;
+        }
+        expense_list->id_last_assigned = \
+        MAX(expense_list->id_last_assigned, record.id);
+    }
+    facility_references_move(expense_list->facility_references, \
+    facility_reference_expense, expense->id, expense->facility_id, \
+    record.facility_id);
+    expense->facility_id = record.facility_id;
+    expense->supplier_id = record.supplier_id;
+    expense->type = (enum expense_type)record.type;
+    expense_list->version++;
+    return true;
+}
+
+// Apply a journal entry to an order list.
+// Returns true on success, or false if the entry is damaged.
+bool journal_apply_order(struct order_list* order_list, \
+const struct journal_replay_entry* entry) {
+    if (entry->header.operation == journal_operation_delete) {
+        order_list->id_last_assigned = \
+        MAX(order_list->id_last_assigned, entry->header.id);
+        order_list_delete_node(order_list, entry->header.id);
+        return true;
+    }
+
+    struct snapshot_order record;
+    if (journal_entry_record(entry, &record, sizeof(struct snapshot_order)) \
+    == false || record.id != entry->header.id || \
+    record.id <= ENTERPRISE_ID_NONE || \
+    record.supplier_type < order_supplier_supplier || \
+    record.supplier_type > order_supplier_facility || \
+    record.recipient_type < order_recipient_facility || \
+    record.recipient_type > order_recipient_customer) return false;
+
+    struct order_node* order = order_list_get_node(order_list, record.id);
+    if (order == NULL) {
+        order = order_node_new(&order_list->store);
+        if (order == NULL) return false;
+        order->id = record.id;
+        if (id_index_insert(&order_list->id_index, order->id, \
+        record_store_handle(order)) == false) {
+            record_store_remove(&order_list->store, order);
+            return false;
+        }
+        order_list->id_last_assigned = \
+        MAX(order_list->id_last_assigned, record.id);
+    }
+    order->supplier_id = record.supplier_id;
+    order->recipient_id = record.recipient_id;
+    order->time_order_placed = (time_t)record.time_order_placed;
+    order->supplier_type = (enum order_supplier_type)record.supplier_type;
+    order->recipient_type = (enum order_recipient_type)record.recipient_type;
+    order->delivered = record.delivered != 0;
+    order_list->version++;
+    order_list_sort_node(order_list, order);
+    return true;
+}
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_FACILITIES
+#define ENTERPRISE_FACILITIES
+#include "facilities.h"
+#endif
+
+#ifndef ENTERPRISE_EMPLOYEES
+#define ENTERPRISE_EMPLOYEES
+#include "employees.h"
+#endif
+
+#ifndef ENTERPRISE_ITEMS
+#define ENTERPRISE_ITEMS
+#include "inventory.h"
+#endif
+
+#ifndef ENTERPRISE_CUSTOMERS
+#define ENTERPRISE_CUSTOMERS
+#include "customers.h"
+#endif
+
+#ifndef ENTERPRISE_SUPPLIERS
+#define ENTERPRISE_SUPPLIERS
+#include "suppliers.h"
+#endif
+
+#ifndef ENTERPRISE_EXPENSES
+#define ENTERPRISE_EXPENSES
+#include "expenses.h"
+#endif
+
+#ifndef ENTERPRISE_ORDERS
+#define ENTERPRISE_ORDERS
+#include "orders.h"
+#endif
+
+#ifndef ENTERPRISE_SNAPSHOTS
+#define ENTERPRISE_SNAPSHOTS
+#include "snapshot.h"
+#endif
+
+/* What does this file do?
+It turns the records of every list into journal entries and back (see
+journal.c). Entries hold records in the same layout as snapshots do, so the
+snapshot_* record structures are reused here, with text fields holding the
+position of their text within the entry.
+
+journal_write_* functions write an entry holding a record as it is now. They
+write nothing if the record has since been deleted, as its deletion follows in
+the same commit.
+
+journal_apply_* functions replay an entry onto a list. A put adds the record
+if the list does not hold it yet and then overwrites every field, so replaying
+an entry the list already reflects changes nothing. They return false if the
+entry is damaged, and ignore entries for nested facilities whose owner is gone.
+
+A record added and deleted within one commit leaves only its deletion in the
+journal, so a delete raises the list's last assigned ID to the deleted ID just
+as a put does. Otherwise the ID would be handed out again after a replay.
+*/
+
+void journal_write_facility(struct journal* journal, \
+const struct journal_change* change, struct facility_list* facility_list);
+void journal_write_employee(struct journal* journal, \
+const struct journal_change* change, struct employee_list* employee_list);
+void journal_write_employee_facility(struct journal* journal, \
+const struct journal_change* change, struct employee_list* employee_list);
+void journal_write_item(struct journal* journal, \
+const struct journal_change* change, struct item_list* item_list);
+void journal_write_item_facility(struct journal* journal, \
+const struct journal_change* change, struct item_list* item_list);
+void journal_write_customer(struct journal* journal, \
+const struct journal_change* change, struct customer_list* customer_list);
+void journal_write_supplier(struct journal* journal, \
+const struct journal_change* change, struct supplier_list* supplier_list);
+void journal_write_expense(struct journal* journal, \
+const struct journal_change* change, struct expense_list* expense_list);
+void journal_write_order(struct journal* journal, \
+const struct journal_change* change, struct order_list* order_list);
+bool journal_apply_facility(struct facility_list* facility_list, \
+const struct journal_replay_entry* entry);
+bool journal_apply_employee(struct employee_list* employee_list, \
+const struct journal_replay_entry* entry);
+bool journal_apply_employee_facility(struct employee_list* employee_list, \
+const struct journal_replay_entry* entry);
+bool journal_apply_item(struct item_list* item_list, \
+const struct journal_replay_entry* entry);
+bool journal_apply_item_facility(struct item_list* item_list, \
+const struct journal_replay_entry* entry);
+bool journal_apply_customer(struct customer_list* customer_list, \
+const struct journal_replay_entry* entry);
+bool journal_apply_supplier(struct supplier_list* supplier_list, \
+const struct journal_replay_entry* entry);
+bool journal_apply_expense(struct expense_list* expense_list, \
+const struct journal_replay_entry* entry);
+bool journal_apply_order(struct order_list* order_list, \
+const struct journal_replay_entry* entry);
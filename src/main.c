@@ -9,9 +9,18 @@
 File description: main.c contains a program status struct and manages the 
 execution of the enterprise software.
 
+Long running operations on the enterprise, such as saving, loading and
+exporting, run as a job on a worker thread (see worker_pool.c) while frames
+keep being drawn, showing the job's progress. The enterprise belongs to the
+job until it is finished: no menu that reads or edits the enterprise is shown
+and the journal is not ticked in the meantime, so editors can never change the
+enterprise under the job. Finished jobs are drained once a frame, on the
+program's thread.
+
 Data structures:
 - The program struct stores information about rendering, program status, and the
 enterprise database itself. 
+- The program job struct stores a long running operation and its progress.
 */
 
 // Import C standard libraries.
@@ -19,38 +28,58 @@ enterprise database itself.
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include <string.h>
 #include <math.h>
 #include <assert.h>
 #include <limits.h>
 #include <time.h>
 
-// Import Nuklear.
+// Import Nuklear, compiling it into this file.
 #ifndef ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
 #define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-    #define NK_INCLUDE_FIXED_TYPES
-    #define NK_INCLUDE_STANDARD_IO
-    #define NK_INCLUDE_STANDARD_VARARGS
-    #define NK_INCLUDE_DEFAULT_ALLOCATOR
-    #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    #define NK_INCLUDE_FONT_BAKING
-    #define NK_INCLUDE_DEFAULT_FONT
     #define NK_IMPLEMENTATION
     #define NK_SDL_GLES2_IMPLEMENTATION
-    #include "../third_party/Nuklear/nuklear.h"
+    #include "nuklear_import.h"
     #include "../third_party/Nuklear/demo/sdl_opengles2/nuklear_sdl_gles2.h"
     #include "../third_party/Nuklear/demo/common/style.c"
 #endif
 
 // Import enterprise.
-#include "constants.c"
-#include "enterprise.c"
+#include "constants.h"
+
+#ifndef ENTERPRISE_DATABASE
+#define ENTERPRISE_DATABASE
+#include "enterprise.h"
+#endif
 
 #ifndef PROGRAM_STATES
 #define PROGRAM_STATES
-#include "program_states.c"
+#include "program_states.h"
 #endif
 
+// The long running operations that run as jobs.
+enum program_job_type {program_job_load, program_job_save, \
+program_job_compact, program_job_export};
+
+// A long running operation on the enterprise, run on a worker thread.
+struct program_job {
+    struct program* program;
+    enum program_job_type type;
+    char title[ENTERPRISE_STRING_LENGTH + 32];
+    char path[ENTERPRISE_STRING_LENGTH];
+    enum export_table table;
+    enum export_format format;
+
+    // The menu to go back to once the job is finished.
+    enum program_status status_after;
+
+    // The enterprise opened by a load job, or NULL.
+    struct enterprise* loaded;
+    struct worker_pool_progress progress;
+    bool succeeded;
+};
+
 // Define the program state structure used to hold everything.
 
 struct program {
@@ -64,8 +93,129 @@ struct program {
     
     // Enterprise data structure.
     struct enterprise* enterprise;
+
+    // Snapshot opened read only, if any.
+    struct snapshot_map* snapshot_map;
+
+    // The worker thread that jobs run on, one at a time, and the job running,
+    // if job_running is set.
+    struct worker_pool workers;
+    struct program_job job;
+    bool job_running;
+
+    // Time spent building frames since the frame time was last reported, in
+    // performance counter ticks, and the number of frames built.
+    uint64_t frame_time;
+    uint32_t frame_count;
+    uint32_t frame_time_reported;
+
+    // Frames still to be drawn even if no input arrives, and when the last
+    // frame was started, in milliseconds.
+    uint32_t frames_pending;
+    uint32_t frame_started;
 };
 
+// Run a job on a worker thread. Runs as a worker pool job.
+void program_run_job(void* data) {
+    struct program_job* job = data;
+    struct enterprise* enterprise = job->program->enterprise;
+    switch (job->type) {
+        case program_job_load:
+            job->loaded = enterprise_open(job->path, false, &job->progress);
+            job->succeeded = job->loaded != NULL;
+            break;
+        case program_job_save:
+            job->succeeded = \
+            enterprise_save(enterprise, job->path, &job->progress);
+            break;
+        case program_job_compact:
+            job->succeeded = enterprise_compact(enterprise, &job->progress);
+            break;
+        case program_job_export:
+            job->succeeded = enterprise_export_file(enterprise, job->table, \
+            job->format, job->path, &job->progress);
+            break;
+    }
+}
+
+// Hand the enterprise back to the menus once a job is done. Runs on the
+// program's thread when the worker pool is drained.
+void program_finish_job(void* data) {
+    struct program_job* job = data;
+    struct program* program = job->program;
+    if (job->type == program_job_load && job->loaded != NULL) {
+        enterprise_quit(program->enterprise);
+        program->enterprise = job->loaded;
+        enterprise_print_load_times(program->enterprise);
+    }
+    if (job->succeeded == false) {
+        if (job->type == program_job_load) {
+            printf("Failed to load enterprise from '%s'.\n", job->path);
+        }
+        else if (job->type == program_job_save) {
+            printf("Failed to save enterprise to '%s'.\n", job->path);
+        }
+        else if (job->type == program_job_export) {
+            printf("Failed to export to '%s'.\n", job->path);
+        }
+    }
+    program->job_running = false;
+    if (program->status == program_status_job_progress) {
+        program->status = job->status_after;
+    }
+    program->frames_pending = ENTERPRISE_SETTLE_FRAMES;
+}
+
+// Start a job on the file at path, showing its progress until it finishes.
+// Only one job runs at a time.
+void program_start_job(struct program* program, enum program_job_type type, \
+const char* path) {
+    if (program->job_running) return;
+    const char* titles[] = {"Loading", "Saving", "Compacting", "Exporting"};
+    struct program_job* job = &program->job;
+    job->program = program;
+    job->type = type;
+    snprintf(job->title, sizeof(job->title), "%s '%s'...", titles[type], path);
+    snprintf(job->path, sizeof(job->path), "%s", path);
+    job->table = program->enterprise->export_table;
+    job->format = program->enterprise->export_format;
+    job->status_after = type == program_job_compact \
+    ? program->status : program_status_enterprise_menu;
+    job->loaded = NULL;
+    job->succeeded = false;
+    worker_pool_progress_begin(&job->progress, 0);
+
+    program->job_running = true;
+    program->status = program_status_job_progress;
+    program->frames_pending = ENTERPRISE_SETTLE_FRAMES;
+    worker_pool_submit_finish(&program->workers, program_run_job, \
+    program_finish_job, job);
+}
+
+// Render the progress of the running job.
+enum program_status program_job_progress\
+(struct nk_context* ctx, struct program_job* job) {
+    nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+    nk_label(ctx, job->title, NK_TEXT_CENTERED);
+    nk_size done = (nk_size)(worker_pool_progress_fraction(&job->progress) \
+    * ENTERPRISE_PROGRESS_STEPS);
+    nk_progress(ctx, &done, ENTERPRISE_PROGRESS_STEPS, NK_FIXED);
+    return program_status_job_progress;
+}
+
+// Commit the journal once its changes have waited long enough, and compact it
+// into the snapshot as a job once it grows large. Nothing is done while a job
+// has the enterprise.
+void program_tick(struct program* program) {
+    if (program->job_running) return;
+    if (enterprise_compaction_due(program->enterprise)) {
+        program_start_job(program, program_job_compact, \
+        program->enterprise->snapshot_path);
+        return;
+    }
+    enterprise_tick(program->enterprise, SDL_GetTicks());
+}
+
 // Initialise a new program state and initialise associated libraries.
 // Returns program state pointer on success, or NULL on failure.
 struct program* program_init() {
@@ -131,24 +281,113 @@ struct program* program_init() {
     // Set program status:
     program->status = program_status_enterprise_menu;
 
-    // Initialise Enterprise database.
+    // Initialise Enterprise database, opening the last saved snapshot and
+    // its journal if there are any. The snapshot is opened as a job, so the
+    // window shows its progress, and an empty enterprise is used until then,
+    // or if it can not be opened.
     program->enterprise = enterprise_new();
+    if (program->enterprise == NULL) {printf("Failed to initialise "
+    "enterprise.\n"); nk_sdl_shutdown();SDL_GL_DeleteContext(program->glctx);
+    SDL_DestroyWindow(program->window);SDL_Quit();free(program);return NULL;}
+    program->snapshot_map = NULL;
+
+    program->frame_time = 0;
+    program->frame_count = 0;
+    program->frame_time_reported = SDL_GetTicks();
+    program->frames_pending = ENTERPRISE_SETTLE_FRAMES;
+    program->frame_started = 0;
+
+    // Jobs run one at a time, so one worker thread is enough.
+    worker_pool_init(&program->workers, 1);
+    program->job_running = false;
+    program_start_job(program, program_job_load, ENTERPRISE_DATABASE_FILE);
 
     // Return program pointer.
     return program;
 }
 
+// Add the time taken to build a frame to the program's frame time.
+// When built with ENTERPRISE_FRAME_TIME defined, the average time taken to
+// build a frame is printed every ENTERPRISE_FRAME_TIME_INTERVAL milliseconds.
+// Rendering and swapping buffers are left out, as they wait for the display.
+void program_frame_time(struct program* program, uint64_t ticks) {
+    program->frame_time += ticks;
+    program->frame_count++;
+
+    uint32_t now = SDL_GetTicks();
+    if (now - program->frame_time_reported < ENTERPRISE_FRAME_TIME_INTERVAL)
+        return;
+    #if defined(ENTERPRISE_FRAME_TIME)
+        double milliseconds = (double)program->frame_time * 1000.0 \
+        / (double)SDL_GetPerformanceFrequency() / program->frame_count;
+        printf("Frame time: %.3f ms over %u frames.\n", milliseconds, \
+        program->frame_count);
+    #endif
+    program->frame_time = 0;
+    program->frame_count = 0;
+    program->frame_time_reported = now;
+}
+
+// Pass an SDL event on to Nuklear, noting if the user asked to quit.
+void program_handle_event(struct program* program, SDL_Event* evt) {
+    if (evt->type == SDL_QUIT) program->status = program_status_quit;
+    nk_sdl_handle_event(evt);
+}
+
+// Wait for an event for at most timeout milliseconds.
+// Returns true if an event arrived, or false if the wait timed out.
+// The browser cannot be blocked, so on the web this only checks for an event
+// and the browser calls the loop ENTERPRISE_MAX_FPS times a second instead.
+bool program_wait_event(SDL_Event* evt, int timeout) {
+    #if defined(__EMSCRIPTEN__)
+        UNUSED(timeout);
+        return SDL_PollEvent(evt) == 1;
+    #else
+        return SDL_WaitEventTimeout(evt, timeout) == 1;
+    #endif
+}
+
 // Runs the main loop of the program
+// A frame is only built and drawn when input arrives, and for
+// ENTERPRISE_SETTLE_FRAMES frames after it so that whatever the input changed
+// is shown. Otherwise the loop sleeps until input arrives, waking up every
+// ENTERPRISE_IDLE_TIMEOUT milliseconds to commit the journal.
 void program_loop(void* loop_argument) {
     // Load in the program state.
     struct program* program = (struct program*)loop_argument;
 
-    // Handle SDL Input
+    // Hand the enterprise back from jobs finished since the last frame.
+    worker_pool_drain(&program->workers);
+
+    // Wait for input unless frames are still to be drawn.
     SDL_Event evt;
+    bool input = false;
+    if (program->frames_pending == 0) {
+        input = program_wait_event(&evt, ENTERPRISE_IDLE_TIMEOUT);
+        if (input == false) {
+            program_tick(program);
+            return;
+        }
+    }
+
+    // Keep to at most ENTERPRISE_MAX_FPS frames a second. Events that arrive
+    // while waiting are handled in this frame.
+    #if !defined(__EMSCRIPTEN__)
+        uint32_t since = SDL_GetTicks() - program->frame_started;
+        if (since < 1000 / ENTERPRISE_MAX_FPS) {
+            SDL_Delay(1000 / ENTERPRISE_MAX_FPS - since);
+        }
+    #endif
+    program->frame_started = SDL_GetTicks();
+    uint64_t frame_start = SDL_GetPerformanceCounter();
+    enum program_status status = program->status;
+
+    // Handle SDL Input
     nk_input_begin(program->nk_context);
+    if (input) program_handle_event(program, &evt);
     while (SDL_PollEvent(&evt)) {
-        if (evt.type == SDL_QUIT) program->status = program_status_quit;
-        nk_sdl_handle_event(&evt);
+        program_handle_event(program, &evt);
+        input = true;
     }
     nk_input_end(program->nk_context);
 
@@ -162,6 +401,66 @@ void program_loop(void* loop_argument) {
             ,program->enterprise);
         }
 
+        // Replace the enterprise with the snapshot named in the menu, keeping
+        // the current one if the snapshot cannot be loaded, or if neither it
+        // nor its journal exist, so that a mistyped name loads nothing. The
+        // current journal is committed first, as it may be the one opened.
+        if (program->status == program_status_enterprise_load) {
+            enterprise_commit(program->enterprise);
+            program_start_job(program, program_job_load, \
+            program->enterprise->file_path);
+        }
+
+        if (program->status == program_status_enterprise_save) {
+            program_start_job(program, program_job_save, \
+            program->enterprise->file_path);
+        }
+
+        // Exports are written to the working directory, named after the
+        // table and format picked in the menu.
+        if (program->status == program_status_enterprise_export) {
+            char path[ENTERPRISE_STRING_LENGTH];
+            snprintf(path, sizeof(path), "%s.%s", \
+            export_table_names[program->enterprise->export_table], \
+            export_format_names[program->enterprise->export_format]);
+            program_start_job(program, program_job_export, path);
+        }
+
+        if (program->status == program_status_job_progress) {
+            program->status = program_job_progress(program->nk_context, \
+            &program->job);
+        }
+
+        // View the snapshot named in the menu without loading it.
+        if (program->status == program_status_snapshot_map_open) {
+            program->snapshot_map = \
+            snapshot_map_open(program->enterprise->file_path);
+            if (program->snapshot_map != NULL) {
+                program->status = program_status_snapshot_map_menu;
+            }
+            else {
+                printf("Failed to open '%s' read only.\n", 
+                program->enterprise->file_path);
+                program->status = program_status_enterprise_menu;
+            }
+        }
+
+        if (program->status == program_status_snapshot_map_menu) {
+            program->status = snapshot_map_menu(program->nk_context\
+            ,program->snapshot_map);
+        }
+
+        if (program->status == program_status_snapshot_map_table) {
+            program->status = snapshot_map_table(program->nk_context\
+            ,program->snapshot_map);
+        }
+
+        if (program->status == program_status_snapshot_map_close) {
+            snapshot_map_close(program->snapshot_map);
+            program->snapshot_map = NULL;
+            program->status = program_status_enterprise_menu;
+        }
+
         if (program->status == program_status_facility_table) {
             program->status = facility_table(program->nk_context\
             ,program->enterprise->facility_list);
@@ -171,6 +470,15 @@ void program_loop(void* loop_argument) {
             program->status = facility_editor(program->nk_context\
             ,program->enterprise->facility_list);
         }
+
+        // Delete the facility open in the editor along with everything that
+        // refers to it, which needs the other lists.
+        if (program->status == program_status_facility_delete) {
+            if (enterprise_delete_facility(program->enterprise, \
+            program->enterprise->facility_list->id_currently_selected) \
+            == false) printf("Failed to delete facility.\n");
+            program->status = program_status_facility_editor;
+        }
         
         if (program->status == program_status_employee_table) {
             program->status = employee_table(program->nk_context\
@@ -186,16 +494,16 @@ void program_loop(void* loop_argument) {
         // facilities said employee works at.
         if (program->status == program_status_employee_facility_editor) {
             program->status = employee_facility_editor(program->nk_context\
-            ,employee_list_get_node(program->enterprise->employee_list,\
-            program->enterprise->employee_list->id_currently_selected)\
+            ,employee_list_get_selected_node\
+            (program->enterprise->employee_list)\
             ->employee_facility_list, program->enterprise->facility_list);
         }
         
         // Show what facilities the currently selected employee works at.
         if (program->status == program_status_employee_facility_table) {
             program->status = employee_facility_table(program->nk_context\
-            ,employee_list_get_node(program->enterprise->employee_list,\
-            program->enterprise->employee_list->id_currently_selected)\
+            ,employee_list_get_selected_node\
+            (program->enterprise->employee_list)\
             ->employee_facility_list, program->enterprise->facility_list);
         }
 
@@ -211,19 +519,25 @@ void program_loop(void* loop_argument) {
 
         if (program->status == program_status_item_facility_editor) {
             program->status = item_facility_editor(program->nk_context\
-            ,item_list_get_node(program->enterprise->item_list,\
-            program->enterprise->item_list->id_currently_selected)\
+            ,item_list_get_selected_node\
+            (program->enterprise->item_list)\
             ->item_facility_list, program->enterprise->facility_list);
         }
         
         // Show what facilities the currently selected item works at.
         if (program->status == program_status_item_facility_table) {
             program->status = item_facility_table(program->nk_context\
-            ,item_list_get_node(program->enterprise->item_list,\
-            program->enterprise->item_list->id_currently_selected)\
+            ,item_list_get_selected_node\
+            (program->enterprise->item_list)\
             ->item_facility_list, program->enterprise->facility_list);
         }
 
+        if (program->status == program_status_stock_valuation) {
+            program->status = item_valuation_table(program->nk_context\
+            ,program->enterprise->item_list\
+            ,program->enterprise->facility_list);
+        }
+
         if (program->status == program_status_customer_table) {
             program->status = customer_table(program->nk_context\
             ,program->enterprise->customer_list);
@@ -255,7 +569,7 @@ void program_loop(void* loop_argument) {
         }
 
         if (program->status == program_status_order_table) {
-            program->status = order_editor(program->nk_context\
+            program->status = order_table(program->nk_context\
             ,program->enterprise->order_list);
         }
 
@@ -268,6 +582,21 @@ void program_loop(void* loop_argument) {
     }
     nk_end(program->nk_context);
 
+    // Commit the edits made in this frame and the ones before it to the
+    // journal once they have waited long enough.
+    program_tick(program);
+    program_frame_time(program, SDL_GetPerformanceCounter() - frame_start);
+
+    // Draw a few more frames after input or a change of menu, so that the
+    // frame drawn last shows what they changed. Frames are drawn all the time
+    // while a job runs, to show its progress.
+    if (input || program->status != status || program->job_running) {
+        program->frames_pending = ENTERPRISE_SETTLE_FRAMES;
+    }
+    else if (program->frames_pending > 0) {
+        program->frames_pending--;
+    }
+
     // Render the GUI.
     float bg[4];
     int win_width, win_height;
@@ -284,6 +613,10 @@ void program_loop(void* loop_argument) {
 void program_quit(struct program* program) {
     if (program == NULL) return;
 
+    // Wait for the running job, if any, so that it is finished with the
+    // enterprise before the enterprise is freed.
+    worker_pool_free(&program->workers);
+
     // Shutdown Nuklear
     nk_sdl_shutdown();
 
@@ -294,6 +627,7 @@ void program_quit(struct program* program) {
 
     // Free enterprise database memory.
     if (program->enterprise != NULL) enterprise_quit(program->enterprise);
+    snapshot_map_close(program->snapshot_map);
 
     // Free program heap memory.
     free(program);
@@ -309,7 +643,8 @@ int main(void) {
     // differently based on whether program is native or on web.
     #if defined(__EMSCRIPTEN__)
         #include <emscripten.h>
-        emscripten_set_main_loop_arg(program_loop, (void*)program, 0, 1);
+        emscripten_set_main_loop_arg(program_loop, (void*)program, \
+        ENTERPRISE_MAX_FPS, 1);
     #else
         while (program->status != program_status_quit) {
             program_loop((void*)program);
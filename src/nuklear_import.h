@@ -0,0 +1,11 @@
+// Nuklear's declarations, with the options every source of the GUI is built
+// with. Nuklear itself is compiled once, by main.c defining NK_IMPLEMENTATION
+// and NK_SDL_GLES2_IMPLEMENTATION before including this.
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_STANDARD_IO
+#define NK_INCLUDE_STANDARD_VARARGS
+#define NK_INCLUDE_DEFAULT_ALLOCATOR
+#define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+#include "../third_party/Nuklear/nuklear.h"
@@ -9,162 +9,167 @@
 #include <limits.h>
 #include <time.h>
 
-#include "constants.c"
-
-#ifndef PROGRAM_STATES
-#define PROGRAM_STATES
-#include "program_states.c"
-#endif
-
-
-// Import Nuklear.
-#ifndef ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
+// Import Nuklear, unless building without the GUI.
+#if !defined(ENTERPRISE_NUKLEAR_LIBRARY_IMPORT) \
+&& !defined(ENTERPRISE_HEADLESS)
 #define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-    #define NK_INCLUDE_FIXED_TYPES
-    #define NK_INCLUDE_STANDARD_IO
-    #define NK_INCLUDE_STANDARD_VARARGS
-    #define NK_INCLUDE_DEFAULT_ALLOCATOR
-    #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    #define NK_INCLUDE_FONT_BAKING
-    #define NK_INCLUDE_DEFAULT_FONT
-    #define NK_IMPLEMENTATION
-    #define NK_SDL_GLES2_IMPLEMENTATION
-    #include "../third_party/Nuklear/nuklear.h"
-    #include "../third_party/Nuklear/demo/sdl_opengles2/nuklear_sdl_gles2.h"
-    #include "../third_party/Nuklear/demo/common/style.c"
+#include "nuklear_import.h"
 #endif
 
-/* How orders work.
-orders are stored in a struct that contains a pointer to the head of a
-linked list containing all the orders. The struct that stores the linked
-list is directly added to the enterprise struct and stores metadata about the
-list. All orders are assigned a unique ID, no two orders can have the
-same ID, the order_list structure keeps track of that.
-
-Data structures:
-order_node: An individual order.
-order_list: A structure holding important metadata about the order
-linked list.
+#ifndef ENTERPRISE_ORDERS
+#define ENTERPRISE_ORDERS
+#include "orders.h"
+#endif
 
-order list metadata:
-order_list->id_last_assigned: This is incremented by 1 every time a new
-order is added in order to ensure no two orders ever have the same ID.
+// Order node constructor and initialiser.
+// The node is added to the end of the passed in record store.
+// Returns order node on success, or NULL on failure.
+struct order_node *order_node_new(struct record_store* store) {
+    struct order_node* order = record_store_append(store);
+    if (order == NULL) return NULL;
+    order->id = ENTERPRISE_ID_NONE;
+    order->supplier_id = ENTERPRISE_ID_NONE;
+    order->recipient_id = ENTERPRISE_ID_NONE;
 
-order_list->id_currently_selected: This is the ID that is selected in the
-order editor dialogue.
-*/
+    order->delivered = false;
 
-enum order_supplier_type {order_supplier_supplier, order_supplier_facility};
-enum order_recipient_type {order_recipient_facility, order_recipient_customer};
-struct order_node {
-    char id[ENTERPRISE_STRING_LENGTH];
-    char supplier_id[ENTERPRISE_STRING_LENGTH];
-    char recipient_id[ENTERPRISE_STRING_LENGTH];
+    order->supplier_type = order_supplier_facility;
+    order->recipient_type = order_recipient_customer;
 
-    enum order_supplier_type supplier_type;
-    enum order_recipient_type recipient_type;
+    return order;
+}
 
-    time_t time_order_placed;
-    bool delivered;
+// Returns the sort key of an order's ID.
+uint64_t order_key_id(const void* order) {
+    return sort_index_integer_key(((const struct order_node*)order)->id);
+}
 
-    struct order_node* prev;
-    struct order_node* next;
-};
+// Returns the sort key of the time an order was placed.
+uint64_t order_key_time_placed(const void* order) {
+    return sort_index_integer_key\
+    ((int64_t)((const struct order_node*)order)->time_order_placed);
+}
 
-// order node constructor and initialiser.
-// Returns order node on success, or NULL on failure.
-struct order_node *order_node_new() {
-    struct order_node* order = malloc(sizeof(struct order_node));
-    if (order == NULL) return NULL;
-    strcpy(order->id, "");
-    strcpy(order->supplier_id, "");
-    strcpy(order->recipient_id, "");
+// Returns the sort key of an order's supplier ID.
+uint64_t order_key_supplier_id(const void* order) {
+    return sort_index_integer_key\
+    (((const struct order_node*)order)->supplier_id);
+}
 
-    order->delivered = false;
+// Returns the sort key of an order's recipient ID.
+uint64_t order_key_recipient_id(const void* order) {
+    return sort_index_integer_key\
+    (((const struct order_node*)order)->recipient_id);
+}
 
-    order->supplier_type = order_supplier_facility;
-    order->recipient_type = order_recipient_customer;
+// Compare two orders by ID for sorting.
+int order_compare_id(const void* a, const void* b) {
+    enterprise_id id_a = ((const struct order_node*)a)->id;
+    enterprise_id id_b = ((const struct order_node*)b)->id;
+    return (id_a > id_b) - (id_a < id_b);
+}
 
-    order->prev = NULL;
-    order->next = NULL;
+// Compare two orders by the time they were placed for sorting, then by ID.
+int order_compare_time_placed(const void* a, const void* b) {
+    time_t time_a = ((const struct order_node*)a)->time_order_placed;
+    time_t time_b = ((const struct order_node*)b)->time_order_placed;
+    int order = (time_a > time_b) - (time_a < time_b);
+    return order != 0 ? order : order_compare_id(a, b);
+}
 
-    return order;
+// Compare two orders by supplier ID for sorting, then by ID.
+int order_compare_supplier_id(const void* a, const void* b) {
+    enterprise_id id_a = ((const struct order_node*)a)->supplier_id;
+    enterprise_id id_b = ((const struct order_node*)b)->supplier_id;
+    int order = (id_a > id_b) - (id_a < id_b);
+    return order != 0 ? order : order_compare_id(a, b);
 }
 
-// order list metadata structure.
-struct order_list {
-    struct order_node *head;
-    char id_last_assigned[ENTERPRISE_STRING_LENGTH];
-    char id_currently_selected[ENTERPRISE_STRING_LENGTH];
-    bool deletion_requested;
-};
+// Compare two orders by recipient ID for sorting, then by ID.
+int order_compare_recipient_id(const void* a, const void* b) {
+    enterprise_id id_a = ((const struct order_node*)a)->recipient_id;
+    enterprise_id id_b = ((const struct order_node*)b)->recipient_id;
+    int order = (id_a > id_b) - (id_a < id_b);
+    return order != 0 ? order : order_compare_id(a, b);
+}
 
-// order list constructor.
+// Order list constructor.
 // Returns order list on success, or NULL on failure.
 struct order_list* order_list_new() {
     struct order_list* order_list = malloc(sizeof(struct order_list));
     if (order_list == NULL) return NULL;
-    order_list->head = NULL;
-    strcpy(order_list->id_last_assigned, "0");
-    strcpy(order_list->id_currently_selected, "0");
+    record_store_init(&order_list->store, sizeof(struct order_node));
+    id_index_init(&order_list->id_index);
+    order_list->journal = NULL;
+    order_list->version = 0;
+    row_labels_init(&order_list->row_labels);
+    order_list->sort_column = order_column_id;
+    order_list->sort_descending = false;
+    sort_index_init(&order_list->sort_indexes[order_column_id], \
+    order_key_id, order_compare_id);
+    sort_index_init(&order_list->sort_indexes[order_column_time_placed], \
+    order_key_time_placed, order_compare_time_placed);
+    sort_index_init(&order_list->sort_indexes[order_column_supplier_id], \
+    order_key_supplier_id, order_compare_supplier_id);
+    sort_index_init(&order_list->sort_indexes[order_column_recipient_id], \
+    order_key_recipient_id, order_compare_recipient_id);
+    order_list->id_last_assigned = ENTERPRISE_ID_NONE;
+    order_list->id_currently_selected = ENTERPRISE_ID_NONE;
+    order_list->handle_currently_selected = RECORD_STORE_NONE;
     order_list->deletion_requested = false;
     return order_list;
 }
 
-// Free an entire order linked list
-void order_node_linked_list_free(struct order_node* order) {
-    if (order == NULL) return;
-    struct order_node* next = NULL;
-    while (order != NULL) {
-        next = order->next;
-        free(order);
-        order = next;
-    }
-}
-
-// Free all memory associated with a order list.
+// Free all memory associated with an order list.
 void order_list_free(struct order_list* order_list) {
     if (order_list == NULL) return;
-
-    if (order_list->head != NULL) {
-        order_node_linked_list_free(order_list->head);
+    row_labels_free(&order_list->row_labels);
+    for (int column = 0; column < order_column_count; column++) {
+        sort_index_free(&order_list->sort_indexes[column]);
     }
-
+    id_index_free(&order_list->id_index);
+    record_store_free(&order_list->store);
     free(order_list);
     return;
 }
 
-// Append a new order to a order list.
+// Move an order to its place in every sort index of the list, after it was
+// added or edited.
+void order_list_sort_node(struct order_list* order_list, \
+struct order_node* order) {
+    if (order_list == NULL || order == NULL) return;
+    for (int column = 0; column < order_column_count; column++) {
+        sort_index_update(&order_list->sort_indexes[column], order);
+    }
+}
+
+// Append a new order to an order list.
 void order_list_append(struct order_list* order_list) {
     if (order_list == NULL) return;
 
     // Increment unique ID by 1.
-    char buffer[ENTERPRISE_STRING_LENGTH];
-    sprintf(buffer, "%lld", atoll(order_list->id_last_assigned) + 1);
-    strcpy(order_list->id_last_assigned, buffer);
-
-    // Add new node to start of order list if order linked list does
-    // not exist.
-    if (order_list->head == NULL) {
-        order_list->head = order_node_new();
-        strcpy(order_list->head->id, order_list->id_last_assigned);
-        strcpy(order_list->id_currently_selected,
-        order_list->id_last_assigned);
+    order_list->id_last_assigned++;
+
+    // Add the new node to the end of the list.
+    struct order_node* order = order_node_new(&order_list->store);
+    if (order == NULL) return;
+
+    order->id = order_list->id_last_assigned;
+    order->time_order_placed = time(NULL);
+
+    // Index the new node by its ID so it can be found without a search.
+    if (id_index_insert(&order_list->id_index, order->id, \
+    record_store_handle(order)) == false) {
+        record_store_remove(&order_list->store, order);
         return;
     }
 
-    // Else add the new node to the end of the list.
-    struct order_node* order = order_list->head;
-    while (order->next != NULL) {
-        order = order->next;
-    }
-    
-    order->next = order_node_new();
-    order->next->prev = order;
+    order_list->id_currently_selected = order_list->id_last_assigned;
 
-    strcpy(order->next->id, order_list->id_last_assigned);
-    strcpy(order_list->id_currently_selected,
-    order_list->id_last_assigned);
+    order_list->version++;
+    order_list_sort_node(order_list, order);
+    journal_put(order_list->journal, journal_list_orders, \
+    ENTERPRISE_ID_NONE, order->id);
 
     return;
 }
@@ -172,151 +177,198 @@ void order_list_append(struct order_list* order_list) {
 // Get the number of order nodes in the order list
 int order_list_get_num_order_nodes(struct order_list* order_list) {
     if (order_list == NULL) return 0;
-    if (order_list->head == NULL) return 0;
+    return (int)order_list->store.count;
+}
 
-    struct order_node* order = order_list->head;
-    int order_count = 0;
-    while (order != NULL) {
-        order_count++;
-        order = order->next;
-    }
-    return order_count;
+// Make room in an order list and its ID index for count more orders.
+// Returns true on success, or false on failure.
+bool order_list_reserve(struct order_list* order_list, uint32_t count) {
+    if (order_list == NULL) return false;
+    return record_store_reserve(&order_list->store, count) \
+    && id_index_reserve(&order_list->id_index, count);
 }
 
-// Return a pointer to a order node according to ID.
+// Return a pointer to an order node according to ID.
 // Returns NULL on failure.
 struct order_node *order_list_get_node\
-(struct order_list *order_list, char *id) {
-    if (order_list == NULL || id == NULL) return NULL;
-    if (order_list->head == NULL) return NULL;
-
-    struct order_node* order = order_list->head;
-    while (order != NULL) {
-        if (strcmp(order->id, id) == 0) return order;
-        order = order->next;
-    }
-    return NULL;
+(struct order_list *order_list, enterprise_id id) {
+    if (order_list == NULL) return NULL;
+    return record_store_get\
+    (&order_list->store, id_index_find(&order_list->id_index, id));
 }
 
-// Searches for a order by ID and deletes it
-void order_list_delete_node(struct order_list *order_list, char *id) {
-    if (order_list == NULL || id == NULL) return;
-    if (order_list->head == NULL) return;
-
-    // Delete the head if it is the ID that is requested to be deleted.
-    if (strcmp(id, order_list->head->id) == 0) {
-        if (order_list->head->next == NULL) {
-            free(order_list->head);
-            order_list->head = NULL;
-            return;
-        }
-
-        struct order_node *next = order_list->head->next;
-        free(order_list->head);
-        order_list->head = next;
-        return;
-    }
+// Return a pointer to the currently selected order node.
+// The selected order's handle is checked before its ID is looked up, so this
+// only searches the ID index after the selection was changed by ID.
+// Returns NULL if no order is selected.
+struct order_node *order_list_get_selected_node\
+(struct order_list *order_list) {
+    if (order_list == NULL) return NULL;
 
-    // Else search for the order to delete.
-    struct order_node* order = order_list->head;
-    while (order != NULL) {
-        if (strcmp(order->id, id) == 0) break;
-        order = order->next;
+    struct order_node* order = record_store_get\
+    (&order_list->store, order_list->handle_currently_selected);
+    if (order == NULL || order->id != order_list->id_currently_selected) {
+        order = order_list_get_node\
+        (order_list, order_list->id_currently_selected);
+        order_list->handle_currently_selected = \
+        record_store_handle(order);
     }
-    if (order == NULL) return;
+    return order;
+}
 
-    // Fix the pointers of the next and previous nodes to the order to be
-    // deleted in order to ensure that traversal still works.
+// Searches for an order by ID and deletes it
+void order_list_delete_node\
+(struct order_list *order_list, enterprise_id id) {
+    if (order_list == NULL) return;
 
-    struct order_node* prev = order->prev;
-    struct order_node* next = order->next;
+    struct order_node* order = order_list_get_node(order_list, id);
+    if (order == NULL) return;
 
-    if (prev != NULL) {
-        if (next == NULL) {
-            prev->next = NULL;
-            strcpy(order_list->id_currently_selected, prev->id);
-        }
-        if (next != NULL) {
-            prev->next = next;
-            next->prev = prev;
-            strcpy(order_list->id_currently_selected, next->id);
-        }
+    // Select the node after the deleted order, or the node before it if the
+    // deleted order is the last one.
+    struct order_node* prev = record_store_prev(&order_list->store, order);
+    struct order_node* next = record_store_next(&order_list->store, order);
+    if (next != NULL) {
+        order_list->id_currently_selected = next->id;
     }
-
-    if (prev == NULL) {
-        if (next != NULL) {
-            next->prev = NULL;
-            strcpy(order_list->id_currently_selected, next->id);
-        }
+    else if (prev != NULL) {
+        order_list->id_currently_selected = prev->id;
     }
 
+    order_list->version++;
+    journal_delete(order_list->journal, journal_list_orders, \
+    ENTERPRISE_ID_NONE, order->id);
+
     // Delete the order
-    free(order);
+    for (int column = 0; column < order_column_count; column++) {
+        sort_index_remove(&order_list->sort_indexes[column], order);
+    }
+    id_index_remove(&order_list->id_index, order->id);
+    record_store_remove(&order_list->store, order);
     return;
 }
 
-// Select the previous node as the currently selected item.
+// Return the order after the passed in one in the order the order table is
+// sorted in, or the one before it if backwards is set, wrapping around at
+// either end.
+static struct order_node* order_list_step(struct order_list* order_list, \
+struct order_node* order, bool backwards) {
+    struct record_store* store = &order_list->store;
+    struct sort_index* index = \
+    &order_list->sort_indexes[order_list->sort_column];
+    if (order_list->sort_descending) backwards = backwards == false;
+
+    // Sorting by ID lists orders in the order they were added.
+    uint32_t row = order_list->sort_column == order_column_id \
+    ? SORT_INDEX_NONE : sort_index_row(index, order);
+    if (row == SORT_INDEX_NONE) {
+        struct order_node* step = backwards \
+        ? record_store_prev(store, order) : record_store_next(store, order);
+        if (step != NULL) return step;
+        return backwards ? record_store_last(store) : record_store_first(store);
+    }
+    if (backwards) row = row == 0 ? index->count - 1 : row - 1;
+    else row = row + 1 == index->count ? 0 : row + 1;
+    return (void*)sort_index_record(index, row);
+}
+
+// Select the order before the selected one in the order table.
 void order_list_select_previous_node(struct order_list *order_list) {
     if (order_list == NULL) return;
-    if (order_list->head == NULL) return;
-
-    struct order_node* order = order_list->head;
-    while (order != NULL) {
-        if (strcmp(order->id, order_list->id_currently_selected) == 0) {
-            if (order->prev != NULL) {
-                strcpy(order_list->id_currently_selected, order->prev->id);
-                return;
-            }
-            if (order->prev == NULL) {
-                struct order_node* temp = order;
-                while (temp->next != NULL) {
-                    temp = temp->next;
-                }
-                strcpy(order_list->id_currently_selected, temp->id);
-                return;
-            }
-        }
-        order = order->next;
-    }
+
+    struct order_node* order = \
+    order_list_get_selected_node(order_list);
+    if (order == NULL) return;
+
+    struct order_node* prev = order_list_step(order_list, order, true);
+    order_list->id_currently_selected = prev->id;
+    order_list->handle_currently_selected = record_store_handle(prev);
 }
 
-// Select the next node as the currently selected item.
+// Select the order after the selected one in the order table.
 void order_list_select_next_node(struct order_list *order_list) {
     if (order_list == NULL) return;
-    if (order_list->head == NULL) return;
-
-    struct order_node* order = order_list->head;
-    while (order != NULL) {
-        if (strcmp(order->id, order_list->id_currently_selected) == 0) {
-            if (order->next != NULL) {
-                strcpy(order_list->id_currently_selected, order->next->id);
-                return;
-            }
-            if (order->next == NULL) {
-                strcpy(order_list->id_currently_selected,\
-                order_list->head->id);
-                return;
-            }
-        }
-        order = order->next;
-    }
+
+    struct order_node* order = \
+    order_list_get_selected_node(order_list);
+    if (order == NULL) return;
+
+    struct order_node* next = order_list_step(order_list, order, false);
+    order_list->id_currently_selected = next->id;
+    order_list->handle_currently_selected = record_store_handle(next);
 }
 
 // Change the currently selected ID to the passed in ID in the order list.
 void order_list_set_selected_id\
-(struct order_list *order_list, char* id) {
-    if (order_list == NULL || id == NULL) return;
-    if (order_list->head == NULL) return;
-
-    struct order_node* order = order_list->head;
-    while (order != NULL) {
-        if (strcmp(order->id, id) == 0) {
-            strcpy(order_list->id_currently_selected, id);
+(struct order_list *order_list, enterprise_id id) {
+    if (order_list == NULL) return;
+
+    if (order_list_get_node(order_list, id) != NULL) {
+        order_list->id_currently_selected = id;
+    }
+}
+
+// Sort the order table by a column, in descending order if descending is true.
+// The column's sort index is built the first time it is sorted by.
+// Returns true on success, or false on failure, in which case the table is
+// left in the order it was.
+bool order_list_sort(struct order_list* order_list, enum order_column column, \
+bool descending) {
+    if (order_list == NULL || column >= order_column_count) return false;
+    struct sort_index* index = &order_list->sort_indexes[column];
+    if (column != order_column_id && index->built == false && \
+    sort_index_build(index, &order_list->store) == false) return false;
+
+    order_list->sort_column = column;
+    order_list->sort_descending = descending;
+    row_labels_invalidate(&order_list->row_labels);
+    return true;
+}
+
+// Return the order shown at a row of the order table, which depends on the
+// column the table is sorted by.
+// Returns NULL if there is no such row.
+struct order_node* order_list_get_row_node(struct order_list* order_list, \
+uint32_t row) {
+    if (order_list == NULL || row >= order_list->store.count) return NULL;
+    if (order_list->sort_descending) row = order_list->store.count - 1 - row;
+    if (order_list->sort_column == order_column_id) {
+        return record_store_seek(&order_list->store, row);
+    }
+    return (void*)sort_index_record\
+    (&order_list->sort_indexes[order_list->sort_column], row);
+}
+
+// Make the labels of row_count rows of the order table, starting at
+// first_row, unless they are cached already.
+void order_list_label_rows(struct order_list* order_list, \
+uint32_t first_row, uint32_t row_count) {
+    if (order_list == NULL) return;
+    struct row_labels* labels = &order_list->row_labels;
+    if (row_labels_current(labels, order_list->version, first_row, \
+    row_count)) return;
+
+    row_labels_begin(labels, order_list->version, first_row, row_count);
+    for (uint32_t row = 0; row < row_count; row++) {
+        struct order_node* order = \
+        order_list_get_row_node(order_list, first_row + row);
+        if (order == NULL) break;
+
+        char placed[32] = "";
+        struct tm* time_placed = localtime(&order->time_order_placed);
+        if (time_placed != NULL) {
+            strftime(placed, sizeof(placed), "%Y-%m-%d %H:%M", time_placed);
         }
-        order = order->next;
+        if (row_labels_add(labels, order->id, \
+        "ID: %lld Placed: %s Supplier ID: %lld Recipient ID: %lld", \
+        order->id, placed, order->supplier_id, order->recipient_id) \
+        == false) break;
     }
 }
 
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+
 // Render the order table GUI.
 // This function displays a list of orders as a table that can be selected.
 // It is an overview.
@@ -339,31 +391,55 @@ struct order_list* order_list) {
     }
 
     // If there are no orders, warn the user.
-    if (order_list->head == NULL) {
+    if (record_store_first(&order_list->store) == NULL) {
         nk_label(ctx, "No Orders found.", NK_TEXT_CENTERED);
         return program_status_order_table;
     }
 
-    /* If there are orders, go through the linked list of orders.
-    Copy the data from each order and make it a button label.
-    When the button is pressed, set the currently selected order to that
+    // Sort controls, picking the column to sort by and the direction.
+    const char* columns[] = {"Sort by ID", "Sort by Time Placed", \
+    "Sort by Supplier ID", "Sort by Recipient ID"};
+    nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 2);
+    int column = nk_combo(ctx, columns, NK_LEN(columns), \
+    (int)order_list->sort_column, ENTERPRISE_WIDGET_HEIGHT, \
+    nk_vec2(WINDOW_WIDTH / 2, 200));
+    bool descending = order_list->sort_descending;
+    if (nk_button_label(ctx, descending ? "Descending" : "Ascending")) {
+        descending = !descending;
+    }
+    if (column != (int)order_list->sort_column || \
+    descending != order_list->sort_descending) {
+        order_list_sort(order_list, (enum order_column)column, descending);
+    }
+
+    /* If there are orders, make a button for each order in view.
+    Only the rows scrolled into view are drawn, and their labels are only
+    formatted again when different rows come into view or the list changes.
+    When a button is pressed, set the currently selected order to that
     order and switch to order editor.*/
-    struct order_node* order = order_list->head;
-    char* print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-    while (order != NULL) {
-        sprintf(print_buffer, \
-        "ID: %s Supplier ID: %s Recipient ID: %s",order->id,\
-        order->supplier_id, order->recipient_id);
-
-        if (nk_button_label(ctx, print_buffer)) {
-            strcpy(order_list->id_currently_selected, order->id);
-            free(print_buffer);
-            return program_status_order_editor;
+    enum program_status status = program_status_order_table;
+    struct nk_list_view view;
+    int rows = order_list->store.count > INT_MAX \
+    ? INT_MAX : (int)order_list->store.count;
+    nk_layout_row_dynamic(ctx, \
+    ENTERPRISE_TABLE_HEIGHT - ENTERPRISE_WIDGET_HEIGHT, 1);
+    if (nk_list_view_begin(ctx, &view, "order_table", \
+    NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+        nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+        struct row_labels* labels = &order_list->row_labels;
+        order_list_label_rows(order_list, \
+        (uint32_t)view.begin, (uint32_t)view.count);
+
+        for (uint32_t row = 0; row < labels->count; row++) {
+            if (nk_button_label(ctx, row_labels_text(labels, row))) {
+                order_list->id_currently_selected = \
+                row_labels_id(labels, row);
+                status = program_status_order_editor;
+            }
         }
-        order = order->next;
+        nk_list_view_end(&view);
     }
-    free(print_buffer);
-    return program_status_order_table;
+    return status;
 }
 
 // Render the order editor GUI.
@@ -381,14 +457,15 @@ struct order_list* order_list) {
     nk_label(ctx, "Order Editor", NK_TEXT_CENTERED);
     
     // Select currently selected order.
-    struct order_node* order = order_list_get_node\
-    (order_list, order_list->id_currently_selected);
+    struct order_node* order = \
+    order_list_get_selected_node(order_list);
 
     // If the currently selected order does not exist:
     if (order == NULL) {
         // Select the first order instead.
-        if (order_list->head != NULL) {
-            strcpy(order_list->id_currently_selected, order_list->head->id);
+        order = record_store_first(&order_list->store);
+        if (order != NULL) {
+            order_list->id_currently_selected = order->id;
             return program_status_order_editor;
         }
 
@@ -409,17 +486,36 @@ struct order_list* order_list) {
     nk_layout_row_template_push_dynamic(ctx);
     nk_layout_row_template_end(ctx);
 
+    // Fields are edited in place, so keep copies to tell if they change.
+    enterprise_id supplier_id = order->supplier_id;
+    enterprise_id recipient_id = order->recipient_id;
+
+    char id_text[ENTERPRISE_ID_TEXT_LENGTH];
+    enterprise_id_format(order->id, id_text);
     nk_label(ctx, "ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_READ_ONLY, \
-    order->id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_default);
 
+    enterprise_id_format(order->supplier_id, id_text);
     nk_label(ctx, "Supplier ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    order->supplier_id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_decimal);
+    order->supplier_id = enterprise_id_parse(id_text);
 
+    enterprise_id_format(order->recipient_id, id_text);
     nk_label(ctx, "Recipient ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    order->recipient_id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_decimal);
+    order->recipient_id = enterprise_id_parse(id_text);
+
+    // Note any edits in the journal.
+    if (order->supplier_id != supplier_id || \
+    order->recipient_id != recipient_id) {
+        order_list->version++;
+        order_list_sort_node(order_list, order);
+        journal_put(order_list->journal, journal_list_orders, \
+        ENTERPRISE_ID_NONE, order->id);
+    }
 
     // Move between next and previous orders.
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 2);
@@ -459,4 +555,6 @@ struct order_list* order_list) {
     }
     
     return program_status_order_editor;
-}
\ No newline at end of file
+}
+
+#endif
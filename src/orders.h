@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+#ifndef ENTERPRISE_JOURNAL
+#define ENTERPRISE_JOURNAL
+#include "journal.h"
+#endif
+
+#ifndef ENTERPRISE_ROW_LABELS
+#define ENTERPRISE_ROW_LABELS
+#include "row_labels.h"
+#endif
+
+#ifndef ENTERPRISE_SORT_INDEX
+#define ENTERPRISE_SORT_INDEX
+#include "sort_index.h"
+#endif
+
+#ifndef PROGRAM_STATES
+#define PROGRAM_STATES
+#include "program_states.h"
+#endif
+
+// Nuklear's context, taken by the GUI functions. Only the sources of
+// those functions import Nuklear itself.
+struct nk_context;
+
+/* How orders work.
+An order sends goods from a supplier or a facility to a facility or a
+customer, each referred to by its ID, and records when it was placed and
+whether it has been delivered. The order list is laid out like every other
+list of the enterprise (see record_store.c), and its table can be sorted by
+any of its columns.
+
+Data structures:
+order_node: An order.
+order_list: The orders of the enterprise.
+*/
+
+enum order_supplier_type {order_supplier_supplier, order_supplier_facility};
+enum order_recipient_type {order_recipient_facility, order_recipient_customer};
+struct order_node {
+    enterprise_id id;
+    enterprise_id supplier_id;
+    enterprise_id recipient_id;
+
+    enum order_supplier_type supplier_type;
+    enum order_recipient_type recipient_type;
+
+    time_t time_order_placed;
+    bool delivered;
+};
+
+// The columns of the order table.
+enum order_column {order_column_id, order_column_time_placed, \
+order_column_supplier_id, order_column_recipient_id, order_column_count};
+
+// Order list metadata structure.
+struct order_list {
+    struct record_store store;
+    struct id_index id_index;
+
+    // Where changes to the list are recorded, or NULL if they are not.
+    struct journal* journal;
+
+    // Bumped whenever a node is appended, edited or deleted, so that the
+    // labels cached for the list's table know when they are stale.
+    uint64_t version;
+    struct row_labels row_labels;
+
+    // The column the list's table is sorted by, and an index of the list
+    // sorted by each column. Indexes are built when first sorted by.
+    enum order_column sort_column;
+    bool sort_descending;
+    struct sort_index sort_indexes[order_column_count];
+
+    enterprise_id id_last_assigned;
+    enterprise_id id_currently_selected;
+    uint32_t handle_currently_selected;
+    bool deletion_requested;
+};
+
+struct order_node *order_node_new(struct record_store* store);
+uint64_t order_key_id(const void* order);
+uint64_t order_key_time_placed(const void* order);
+uint64_t order_key_supplier_id(const void* order);
+uint64_t order_key_recipient_id(const void* order);
+int order_compare_id(const void* a, const void* b);
+int order_compare_time_placed(const void* a, const void* b);
+int order_compare_supplier_id(const void* a, const void* b);
+int order_compare_recipient_id(const void* a, const void* b);
+struct order_list* order_list_new();
+void order_list_free(struct order_list* order_list);
+void order_list_sort_node(struct order_list* order_list, \
+struct order_node* order);
+void order_list_append(struct order_list* order_list);
+int order_list_get_num_order_nodes(struct order_list* order_list);
+bool order_list_reserve(struct order_list* order_list, uint32_t count);
+struct order_node *order_list_get_node\
+(struct order_list *order_list, enterprise_id id);
+struct order_node *order_list_get_selected_node\
+(struct order_list *order_list);
+void order_list_delete_node\
+(struct order_list *order_list, enterprise_id id);
+void order_list_select_previous_node(struct order_list *order_list);
+void order_list_select_next_node(struct order_list *order_list);
+void order_list_set_selected_id\
+(struct order_list *order_list, enterprise_id id);
+bool order_list_sort(struct order_list* order_list, enum order_column column, \
+bool descending);
+struct order_node* order_list_get_row_node(struct order_list* order_list, \
+uint32_t row);
+void order_list_label_rows(struct order_list* order_list, \
+uint32_t first_row, uint32_t row_count);
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+enum program_status order_table(struct nk_context* ctx,\
+struct order_list* order_list);
+enum program_status order_editor(struct nk_context* ctx,\
+struct order_list* order_list);
+#endif
@@ -1,10 +1,16 @@
 enum program_status {program_status_quit, program_status_running, 
-program_status_enterprise_menu,
+program_status_enterprise_menu, program_status_enterprise_load,
+program_status_enterprise_save, program_status_enterprise_export,
+program_status_job_progress,
+program_status_snapshot_map_open, program_status_snapshot_map_close,
+program_status_snapshot_map_menu, program_status_snapshot_map_table,
 program_status_facility_table, program_status_facility_editor,
+program_status_facility_delete,
 program_status_employee_table, program_status_employee_editor,
 program_status_employee_facility_table, program_status_employee_facility_editor,
 program_status_item_table, program_status_item_editor,
 program_status_item_facility_table, program_status_item_facility_editor,
+program_status_stock_valuation,
 program_status_customer_table, program_status_customer_editor,
 program_status_supplier_table, program_status_supplier_editor,
 program_status_expense_table, program_status_expense_editor,
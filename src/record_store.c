@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+// Initialise an empty record store that holds records of record_size bytes.
+void record_store_init(struct record_store* store, size_t record_size) {
+    if (store == NULL) return;
+    memset(store, 0, sizeof(struct record_store));
+    store->record_size = record_size;
+
+    // Round the slot up so that every record stays suitably aligned.
+    size_t slot_size = sizeof(struct record_header) + record_size;
+    store->slot_size = (slot_size + RECORD_STORE_ALIGNMENT - 1) \
+    & ~(size_t)(RECORD_STORE_ALIGNMENT - 1);
+
+    store->head = RECORD_STORE_NONE;
+    store->tail = RECORD_STORE_NONE;
+    store->free_head = RECORD_STORE_NONE;
+}
+
+// Free all memory associated with a record store.
+// The store is left empty and can be reused.
+void record_store_free(struct record_store* store) {
+    if (store == NULL) return;
+    for (uint32_t chunk = 0; chunk < store->chunk_count; chunk++) {
+        free(store->chunks[chunk]);
+    }
+    free(store->rows);
+    record_store_init(store, store->record_size);
+}
+
+// Add another chunk to the store and put its slots on the free list.
+// Returns true on success, or false on failure.
+static bool record_store_grow(struct record_store* store) {
+    if (store->chunk_count == RECORD_STORE_MAX_CHUNKS) return false;
+
+    uint32_t chunk = store->chunk_count;
+    uint32_t chunk_size = RECORD_STORE_FIRST_CHUNK_SIZE << chunk;
+
+    // Grow the rows along with the slots once the store is large enough.
+    if (store->capacity + chunk_size >= RECORD_STORE_ROWS_MIN) {
+        uint32_t* rows = realloc(store->rows, \
+        sizeof(uint32_t) * (store->capacity + chunk_size));
+        if (rows == NULL) return false;
+        store->rows = rows;
+    }
+
+    store->chunks[chunk] = malloc(store->slot_size * chunk_size);
+    if (store->chunks[chunk] == NULL) return false;
+    store->chunk_count++;
+
+    // Thread the new slots onto the free list in ascending order so that
+    // appended records are laid out one after another in memory.
+    uint32_t first = store->capacity;
+    store->capacity += chunk_size;
+    for (uint32_t handle = store->capacity; handle > first; handle--) {
+        struct record_header* header = record_store_header(store, handle - 1);
+        header->handle = handle - 1;
+        header->live = 0;
+        header->prev = RECORD_STORE_NONE;
+        header->next = store->free_head;
+        store->free_head = handle - 1;
+    }
+    return true;
+}
+
+// Make room in the store for count more records, so that appending them
+// does not allocate.
+// Returns true on success, or false on failure.
+bool record_store_reserve(struct record_store* store, uint32_t count) {
+    if (store == NULL) return false;
+    uint64_t needed = (uint64_t)store->count + count;
+    while (store->capacity < needed) {
+        if (record_store_grow(store) == false) return false;
+    }
+    return true;
+}
+
+// Append a zeroed record to the end of the store.
+// Returns pointer to the record on success, or NULL on failure.
+void* record_store_append(struct record_store* store) {
+    if (store == NULL) return NULL;
+    if (store->free_head == RECORD_STORE_NONE) {
+        if (record_store_grow(store) == false) return NULL;
+    }
+
+    // Take a slot off the free list.
+    struct record_header* header = record_store_header(store, store->free_head);
+    store->free_head = header->next;
+
+    // Link it in after the current tail.
+    header->live = 1;
+    header->prev = store->tail;
+    header->next = RECORD_STORE_NONE;
+    if (store->tail != RECORD_STORE_NONE) {
+        record_store_header(store, store->tail)->next = header->handle;
+    }
+    else {
+        store->head = header->handle;
+    }
+    store->tail = header->handle;
+    if (store->rows != NULL && store->row_count == store->count) {
+        store->rows[store->row_count++] = header->handle;
+    }
+    store->count++;
+    store->appends++;
+
+    void* record = record_store_record_of(header);
+    memset(record, 0, store->record_size);
+    return record;
+}
+
+// Remove a record from the store and put its slot on the free list.
+void record_store_remove(struct record_store* store, void* record) {
+    if (store == NULL || record == NULL) return;
+    struct record_header* header = record_store_header_of(record);
+    if (header->live == 0) return;
+    bool last = header->next == RECORD_STORE_NONE;
+
+    // Fix the handles of the neighbouring records so traversal still works.
+    if (header->prev != RECORD_STORE_NONE) {
+        record_store_header(store, header->prev)->next = header->next;
+    }
+    else {
+        store->head = header->next;
+    }
+    if (header->next != RECORD_STORE_NONE) {
+        record_store_header(store, header->next)->prev = header->prev;
+    }
+    else {
+        store->tail = header->prev;
+    }
+
+    header->live = 0;
+    header->prev = RECORD_STORE_NONE;
+    header->next = store->free_head;
+    store->free_head = header->handle;
+    store->count--;
+    store->removes++;
+
+    // Removing the last row leaves the others where they were, but removing
+    // any other row moves the rows after it up by one.
+    if (last == false) store->row_count = 0;
+    else if (store->row_count > store->count) store->row_count = store->count;
+}
+
+// Add the counts and memory use of a store to stats.
+void record_store_add_stats\
+(struct record_store* store, struct record_store_stats* stats) {
+    if (store == NULL || stats == NULL) return;
+    stats->stores++;
+    stats->records += store->count;
+    stats->capacity += store->capacity;
+    stats->chunks += store->chunk_count;
+    stats->bytes += (uint64_t)store->slot_size * store->capacity;
+    if (store->rows != NULL) {
+        stats->bytes += (uint64_t)sizeof(uint32_t) * store->capacity;
+    }
+    stats->appends += store->appends;
+    stats->removes += store->removes;
+}
+
+// Return the record at the given row of the store's order, or NULL if there is
+// no such row.
+void* record_store_seek(struct record_store* store, uint32_t row) {
+    if (store == NULL || row >= store->count) return NULL;
+
+    // Walk small stores from the head or the tail, whichever is closer.
+    if (store->rows == NULL) {
+        uint32_t handle = store->head;
+        uint32_t from = 0;
+        if (store->count - 1 - row < row) {
+            handle = store->tail;
+            from = store->count - 1;
+        }
+        for (; from < row; from++) {
+            handle = record_store_header(store, handle)->next;
+        }
+        for (; from > row; from--) {
+            handle = record_store_header(store, handle)->prev;
+        }
+        return record_store_record_of(record_store_header(store, handle));
+    }
+
+    // Fill in the rows that are not known yet, from the last known row on.
+    if (row >= store->row_count) {
+        uint32_t handle = store->row_count == 0 ? store->head \
+        : record_store_header(store, store->rows[store->row_count - 1])->next;
+        while (store->row_count < store->count) {
+            store->rows[store->row_count++] = handle;
+            handle = record_store_header(store, handle)->next;
+        }
+    }
+    return record_store_record_of(record_store_header(store, store->rows[row]));
+}
@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* How the record store works.
+Every list in the enterprise (facilities, employees, items and so on) keeps its
+nodes in a record store instead of allocating each node on its own. A record
+store is a dense array of fixed size slots, split into chunks so that growing
+the store never moves a record that has already been handed out. Pointers to
+records therefore stay valid until the record is removed.
+
+Each slot has a small header in front of the record. The header stores the
+slot's handle (its index in the store), whether the slot is in use, and the
+handles of the previous and next records. The previous and next handles keep
+records in the order they were appended, so the lists still read from head to
+tail like the old linked lists did.
+
+Removed slots are put on a free list and reused by the next append, so a store
+never grows while it has free slots. The store keeps its tail and a count of
+its records, so appending and counting never walk the records. Callers about
+to append many records at once can reserve room for them first, so that all
+the chunks they need are allocated up front.
+
+Tables only draw the rows in view, so they need the record at a given row of
+the order. Once a store has room for RECORD_STORE_ROWS_MIN records it keeps an
+array of the handle at each row, grown along with its chunks, so that jumping
+anywhere in a table finds its first row straight away. Appending never moves a
+row, so appended records are added to the end of the array. Removing a record
+from the middle moves every row after it, so the array is filled in again from
+the head by the next seek. Smaller stores keep no array and seeking walks from
+whichever of the head and the tail is closer.
+
+Chunk sizes double as the store grows: chunk 0 holds
+RECORD_STORE_FIRST_CHUNK_SIZE records, chunk 1 holds twice that and so on.
+The first chunk holds a single record, because every employee and item has a
+store of its own for its facilities and most of them only hold one or two. A
+store never holds more than twice the records it needs, and large lists still
+only need a few allocations.
+
+Every store counts the records appended to and removed from it over its life,
+and record_store_add_stats adds those counts and the store's memory use to a
+record_store_stats. The enterprise sums them per type of node to report where
+its memory goes.
+
+How lists use record stores.
+Every list of the enterprise is a list struct, held by the enterprise struct
+or, for the facilities of an employee or item, by that employee or item. It
+keeps its nodes in a record store, along with an ID index (see id_index.c)
+that finds a node by its ID. Each list struct also holds:
+
+id_last_assigned: The last ID given to a node. Each new node gets the next ID,
+so no two nodes of a list ever have the same ID, even after some are deleted.
+
+id_currently_selected: The ID of the node selected in the list's editor.
+
+handle_currently_selected: The handle of the selected node, remembered so
+that moving the selection does not have to find the node by its ID again.
+
+Lists whose tables can be sorted also hold sort_column, the column the table
+is sorted by (see sort_index.c). Sorting by ID lists the nodes in the order
+they were added.
+
+Data structures:
+record_header: The header stored in front of every record.
+record_store: The store itself.
+record_store_stats: Counts of records and memory summed over stores.
+*/
+
+#define RECORD_STORE_NONE UINT32_MAX
+#define RECORD_STORE_FIRST_CHUNK_SHIFT 0
+#define RECORD_STORE_FIRST_CHUNK_SIZE (1u << RECORD_STORE_FIRST_CHUNK_SHIFT)
+#define RECORD_STORE_MAX_CHUNKS 31
+#define RECORD_STORE_ALIGNMENT 16
+#define RECORD_STORE_ROWS_MIN 64
+
+// Header stored in front of every record in a record store.
+struct record_header {
+    uint32_t handle;
+    uint32_t prev;
+    uint32_t next;
+    uint32_t live;
+};
+
+// Record store structure.
+struct record_store {
+    unsigned char* chunks[RECORD_STORE_MAX_CHUNKS];
+    uint32_t chunk_count;
+    size_t record_size;
+    size_t slot_size;
+
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t free_head;
+
+    // The handle of the record at each row, or NULL while the store is
+    // smaller than RECORD_STORE_ROWS_MIN. Only the first row_count rows are
+    // known, and the rest are filled in by the next seek.
+    uint32_t* rows;
+    uint32_t row_count;
+
+    // Records appended and removed over the life of the store.
+    uint64_t appends;
+    uint64_t removes;
+};
+
+// Counts of records and memory summed over one or more record stores.
+struct record_store_stats {
+    uint64_t stores;
+    uint64_t records;
+    uint64_t capacity;
+    uint64_t chunks;
+    uint64_t bytes;
+    uint64_t appends;
+    uint64_t removes;
+};
+
+void record_store_init(struct record_store* store, size_t record_size);
+void record_store_free(struct record_store* store);
+
+// Returns which chunk a handle lives in.
+static inline uint32_t record_store_chunk_of(uint32_t handle) {
+    uint32_t scaled = (handle >> RECORD_STORE_FIRST_CHUNK_SHIFT) + 1;
+    #if defined(__GNUC__)
+        return 31 - (uint32_t)__builtin_clz(scaled);
+    #else
+        uint32_t chunk = 0;
+        while (scaled >>= 1) chunk++;
+        return chunk;
+    #endif
+}
+
+// Returns the header of the slot with the given handle.
+// The handle must be below the store's capacity.
+static inline struct record_header* record_store_header\
+(struct record_store* store, uint32_t handle) {
+    uint32_t chunk = record_store_chunk_of(handle);
+    uint32_t first = RECORD_STORE_FIRST_CHUNK_SIZE * ((1u << chunk) - 1);
+    return (struct record_header*)\
+    (store->chunks[chunk] + (size_t)(handle - first) * store->slot_size);
+}
+
+// Returns the header in front of a record handed out by the store.
+static inline struct record_header* record_store_header_of(void* record) {
+    return (struct record_header*)record - 1;
+}
+
+// Returns the record stored behind a header.
+static inline void* record_store_record_of(struct record_header* header) {
+    return header + 1;
+}
+
+bool record_store_reserve(struct record_store* store, uint32_t count);
+void* record_store_append(struct record_store* store);
+void record_store_remove(struct record_store* store, void* record);
+void record_store_add_stats\
+(struct record_store* store, struct record_store_stats* stats);
+
+// Return a pointer to the record with the given handle.
+// Returns NULL if the handle does not refer to a record in the store.
+static inline void* record_store_get\
+(struct record_store* store, uint32_t handle) {
+    if (store == NULL || handle >= store->capacity) return NULL;
+    struct record_header* header = record_store_header(store, handle);
+    if (header->live == 0) return NULL;
+    return record_store_record_of(header);
+}
+
+// Return the handle of a record handed out by the store.
+static inline uint32_t record_store_handle(void* record) {
+    if (record == NULL) return RECORD_STORE_NONE;
+    return record_store_header_of(record)->handle;
+}
+
+// Return the first record in the store, or NULL if the store is empty.
+static inline void* record_store_first(struct record_store* store) {
+    if (store == NULL || store->head == RECORD_STORE_NONE) return NULL;
+    return record_store_record_of(record_store_header(store, store->head));
+}
+
+// Return the last record in the store, or NULL if the store is empty.
+static inline void* record_store_last(struct record_store* store) {
+    if (store == NULL || store->tail == RECORD_STORE_NONE) return NULL;
+    return record_store_record_of(record_store_header(store, store->tail));
+}
+
+// Return the record after the passed in record, or NULL if it is the last.
+static inline void* record_store_next\
+(struct record_store* store, void* record) {
+    if (store == NULL || record == NULL) return NULL;
+    uint32_t next = record_store_header_of(record)->next;
+    if (next == RECORD_STORE_NONE) return NULL;
+    return record_store_record_of(record_store_header(store, next));
+}
+
+// Return the record before the passed in record, or NULL if it is the first.
+static inline void* record_store_prev\
+(struct record_store* store, void* record) {
+    if (store == NULL || record == NULL) return NULL;
+    uint32_t prev = record_store_header_of(record)->prev;
+    if (prev == RECORD_STORE_NONE) return NULL;
+    return record_store_record_of(record_store_header(store, prev));
+}
+
+void* record_store_seek(struct record_store* store, uint32_t row);
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_ROW_LABELS
+#define ENTERPRISE_ROW_LABELS
+#include "row_labels.h"
+#endif
+
+// Initialise an empty row label cache.
+void row_labels_init(struct row_labels* labels) {
+    if (labels == NULL) return;
+    memset(labels, 0, sizeof(struct row_labels));
+}
+
+// Free all memory associated with a row label cache.
+// The cache is left empty and can be reused.
+void row_labels_free(struct row_labels* labels) {
+    if (labels == NULL) return;
+    free(labels->ids);
+    free(labels->offsets);
+    free(labels->text);
+    row_labels_init(labels);
+}
+
+// Returns true if the cache holds the labels of row_count rows starting at
+// first_row, made while the list was at the given version.
+bool row_labels_current(struct row_labels* labels, uint64_t version, \
+uint32_t first_row, uint32_t row_count) {
+    if (labels == NULL || labels->valid == false) return false;
+    return labels->version == version && labels->first_row == first_row \
+    && labels->row_count == row_count;
+}
+
+// Empty the cache to make new labels for row_count rows starting at
+// first_row, for the given version of the list.
+void row_labels_begin(struct row_labels* labels, uint64_t version, \
+uint32_t first_row, uint32_t row_count) {
+    if (labels == NULL) return;
+    labels->valid = true;
+    labels->version = version;
+    labels->first_row = first_row;
+    labels->row_count = row_count;
+    labels->count = 0;
+    labels->text_used = 0;
+}
+
+// Mark the cache as stale, so that the labels are made again next frame even
+// if the list has not changed.
+void row_labels_invalidate(struct row_labels* labels) {
+    if (labels == NULL) return;
+    labels->valid = false;
+}
+
+// Make room for another label with text_size bytes of text.
+// Returns true on success, or false on failure.
+static bool row_labels_reserve(struct row_labels* labels, size_t text_size) {
+    if (labels->count == labels->capacity) {
+        uint32_t capacity = labels->capacity == 0 \
+        ? ROW_LABELS_FIRST_CAPACITY : labels->capacity * 2;
+        enterprise_id* ids = \
+        realloc(labels->ids, sizeof(enterprise_id) * capacity);
+        if (ids == NULL) return false;
+        labels->ids = ids;
+        size_t* offsets = realloc(labels->offsets, sizeof(size_t) * capacity);
+        if (offsets == NULL) return false;
+        labels->offsets = offsets;
+        labels->capacity = capacity;
+    }
+
+    if (labels->text_capacity - labels->text_used < text_size) {
+        size_t text_capacity = labels->text_capacity == 0 \
+        ? ROW_LABELS_FIRST_TEXT_CAPACITY : labels->text_capacity;
+        while (text_capacity - labels->text_used < text_size) {
+            text_capacity *= 2;
+        }
+        char* text = realloc(labels->text, text_capacity);
+        if (text == NULL) return false;
+        labels->text = text;
+        labels->text_capacity = text_capacity;
+    }
+    return true;
+}
+
+// Format the label of the next row, which shows the node with the given ID.
+// Returns true on success, or false on failure. On failure the cache is
+// marked stale so that the labels are made again next frame.
+bool row_labels_add(struct row_labels* labels, enterprise_id id, \
+const char* format, ...) {
+    if (labels == NULL || format == NULL) return false;
+
+    // Format straight into the free space if the label fits.
+    va_list args;
+    va_start(args, format);
+    size_t space = labels->text_capacity - labels->text_used;
+    char* free_text = space == 0 ? NULL : labels->text + labels->text_used;
+    int length = vsnprintf(free_text, space, format, args);
+    va_end(args);
+    if (length < 0) {
+        labels->valid = false;
+        return false;
+    }
+
+    // Otherwise grow the cache and format it again.
+    size_t size = (size_t)length + 1;
+    if (size > space || labels->count == labels->capacity) {
+        if (row_labels_reserve(labels, size) == false) {
+            labels->valid = false;
+            return false;
+        }
+        va_start(args, format);
+        vsnprintf(labels->text + labels->text_used, size, format, args);
+        va_end(args);
+    }
+
+    labels->ids[labels->count] = id;
+    labels->offsets[labels->count] = labels->text_used;
+    labels->text_used += size;
+    labels->count++;
+    return true;
+}
+
+// Returns the text of the label at the given row of the cache, counting from
+// its first row, or NULL if there is no such label.
+const char* row_labels_text(struct row_labels* labels, uint32_t row) {
+    if (labels == NULL || row >= labels->count) return NULL;
+    return labels->text + labels->offsets[row];
+}
+
+// Returns the ID of the node shown at the given row of the cache, counting
+// from its first row, or ENTERPRISE_ID_NONE if there is no such label.
+enterprise_id row_labels_id(struct row_labels* labels, uint32_t row) {
+    if (labels == NULL || row >= labels->count) return ENTERPRISE_ID_NONE;
+    return labels->ids[row];
+}
@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+/* How row labels work.
+Tables draw a button for each row in view, labelled with text formatted from
+the row's node. Formatting every row again every frame is wasted work when
+nothing has changed, so each table keeps the labels of the rows in view in a
+row label cache.
+
+Every list has a version that is bumped whenever one of its nodes is appended,
+edited or deleted. The cache remembers the version and the rows its labels
+were made for. A frame that shows the same rows of an unchanged list reuses
+the labels without formatting or allocating anything. The cache also keeps the
+ID of each row's node so that a pressed button can be acted on without
+finding the node again.
+
+Label text is packed into one buffer that only grows, so the cache stops
+allocating once it has seen the longest labels of a table.
+
+Data structures:
+row_labels: The labels of the rows in view of one table.
+*/
+
+#define ROW_LABELS_FIRST_CAPACITY 32
+#define ROW_LABELS_FIRST_TEXT_CAPACITY 4096
+
+// The labels of the rows in view of one table.
+struct row_labels {
+    bool valid;
+    uint64_t version;
+    uint32_t first_row;
+    uint32_t row_count;
+
+    // Labels made so far, the IDs of their nodes and where their text starts.
+    uint32_t count;
+    uint32_t capacity;
+    enterprise_id* ids;
+    size_t* offsets;
+
+    char* text;
+    size_t text_used;
+    size_t text_capacity;
+};
+
+void row_labels_init(struct row_labels* labels);
+void row_labels_free(struct row_labels* labels);
+bool row_labels_current(struct row_labels* labels, uint64_t version, \
+uint32_t first_row, uint32_t row_count);
+void row_labels_begin(struct row_labels* labels, uint64_t version, \
+uint32_t first_row, uint32_t row_count);
+void row_labels_invalidate(struct row_labels* labels);
+bool row_labels_add(struct row_labels* labels, enterprise_id id, \
+const char* format, ...);
+const char* row_labels_text(struct row_labels* labels, uint32_t row);
+enterprise_id row_labels_id(struct row_labels* labels, uint32_t row);
@@ -0,0 +1,1097 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef ENTERPRISE_SNAPSHOTS
+#define ENTERPRISE_SNAPSHOTS
+#include "snapshot.h"
+#endif
+
+// Returns the generation of a snapshot saved after the one of generation
+// previous: the time of the save in nanoseconds, so that snapshots of
+// different databases hardly ever share one, but always above previous.
+uint64_t snapshot_next_generation(uint64_t previous) {
+    uint64_t generation = 0;
+    struct timespec now;
+    if (timespec_get(&now, TIME_UTC) != 0) {
+        generation = (uint64_t)now.tv_sec * 1000000000u + \
+        (uint64_t)now.tv_nsec;
+    }
+    return generation > previous ? generation : previous + 1;
+}
+
+// Initialise a writer for a file opened for writing.
+// Returns true on success, or false on failure.
+bool snapshot_writer_init(struct snapshot_writer* writer, FILE* file) {
+    if (writer == NULL || file == NULL) return false;
+    writer->file = file;
+    writer->buffer_used = 0;
+    writer->strings = NULL;
+    writer->string_count = 0;
+    writer->string_capacity = 0;
+    writer->positions = NULL;
+    writer->collecting = true;
+    writer->failed = false;
+    writer->generation = 0;
+    writer->buffer = malloc(SNAPSHOT_BUFFER_SIZE);
+    writer->string_pool = string_pool_new();
+    if (writer->buffer == NULL || writer->string_pool == NULL) {
+        free(writer->buffer);
+        string_pool_free(writer->string_pool);
+        return false;
+    }
+    return true;
+}
+
+// Write out anything left in the writer's buffer.
+void snapshot_flush(struct snapshot_writer* writer) {
+    if (writer->buffer_used > 0 && writer->failed == false) {
+        if (fwrite(writer->buffer, 1, writer->buffer_used, writer->file) \
+        != writer->buffer_used) writer->failed = true;
+    }
+    writer->buffer_used = 0;
+}
+
+// Free all memory associated with a writer. Does not close the file.
+void snapshot_writer_free(struct snapshot_writer* writer) {
+    if (writer == NULL) return;
+    free(writer->buffer);
+    free(writer->strings);
+    free(writer->positions);
+    string_pool_free(writer->string_pool);
+}
+
+// Write size bytes to the snapshot. Does nothing while collecting.
+void snapshot_write\
+(struct snapshot_writer* writer, const void* data, size_t size) {
+    if (writer->collecting || writer->failed) return;
+    if (writer->buffer_used + size > SNAPSHOT_BUFFER_SIZE) {
+        snapshot_flush(writer);
+    }
+    if (size > SNAPSHOT_BUFFER_SIZE) {
+        if (fwrite(data, 1, size, writer->file) != size) writer->failed = true;
+        return;
+    }
+    memcpy(writer->buffer + writer->buffer_used, data, size);
+    writer->buffer_used += size;
+}
+
+// Returns the string table position of a piece of text. While collecting, the
+// text is added to the string table instead and 0 is returned.
+uint32_t snapshot_text(struct snapshot_writer* writer, const char* text) {
+    if (writer->failed || text == NULL || text[0] == '\0') return 0;
+    if (writer->collecting == false) {
+        uint32_t slot = string_pool_get_slot(writer->string_pool, text);
+        return slot == 0 ? 0 : writer->positions[slot - 1];
+    }
+
+    const char* string = string_pool_intern(writer->string_pool, text);
+    if (string == NULL) {
+        writer->failed = true;
+        return 0;
+    }
+
+    // Text seen for the first time goes on the end of the string table, so
+    // that text is stored in the order the records use it.
+    if (string_pool_header(string)->references == 1) {
+        if (writer->string_count == writer->string_capacity) {
+            uint32_t string_capacity = writer->string_capacity == 0 ? \
+            1024 : writer->string_capacity * 2;
+            const char** strings = realloc(writer->strings, \
+            sizeof(const char*) * string_capacity);
+            if (strings == NULL) {
+                writer->failed = true;
+                return 0;
+            }
+            writer->strings = strings;
+            writer->string_capacity = string_capacity;
+        }
+        writer->strings[writer->string_count++] = string;
+    }
+    return 0;
+}
+
+// Write a section header.
+void snapshot_write_section(struct snapshot_writer* writer, uint32_t tag, \
+uint32_t record_size, uint64_t count, enterprise_id id_last_assigned) {
+    struct snapshot_section section;
+    memset(&section, 0, sizeof(struct snapshot_section));
+    section.tag = tag;
+    section.record_size = record_size;
+    section.count = count;
+    section.id_last_assigned = id_last_assigned;
+    snapshot_write(writer, &section, sizeof(struct snapshot_section));
+}
+
+// Write the snapshot header and the string table collected so far, and stop
+// collecting so that the following writes go to the file.
+void snapshot_write_header(struct snapshot_writer* writer) {
+    writer->collecting = false;
+
+    struct snapshot_header header;
+    memset(&header, 0, sizeof(struct snapshot_header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.generation = writer->generation;
+    snapshot_write(writer, &header, sizeof(struct snapshot_header));
+
+    // Find the position of every string from its slot in the string pool.
+    struct string_pool* string_pool = writer->string_pool;
+    if (string_pool->capacity > 0) {
+        writer->positions = malloc(sizeof(uint32_t) * string_pool->capacity);
+        if (writer->positions == NULL) {
+            writer->failed = true;
+            return;
+        }
+    }
+    for (uint32_t string = 0; string < writer->string_count; string++) {
+        uint32_t slot = string_pool_get_slot(string_pool, \
+        writer->strings[string]);
+        writer->positions[slot - 1] = string + 1;
+    }
+
+    // Write the offset of every string into the text, then the text.
+    snapshot_write_section(writer, snapshot_tag_strings, sizeof(uint64_t), \
+    writer->string_count, ENTERPRISE_ID_NONE);
+    uint64_t offset = 0;
+    for (uint32_t string = 0; string < writer->string_count; string++) {
+        snapshot_write(writer, &offset, sizeof(uint64_t));
+        offset += string_pool_header(writer->strings[string])->length + 1;
+    }
+
+    // Pad the text with zeros so that the next section stays aligned.
+    uint64_t size = (offset + SNAPSHOT_ALIGNMENT - 1) & \
+    ~(uint64_t)(SNAPSHOT_ALIGNMENT - 1);
+    snapshot_write_section(writer, snapshot_tag_text, 1, size, \
+    ENTERPRISE_ID_NONE);
+    for (uint32_t string = 0; string < writer->string_count; string++) {
+        snapshot_write(writer, writer->strings[string], \
+        string_pool_header(writer->strings[string])->length + 1);
+    }
+    const char padding[SNAPSHOT_ALIGNMENT] = {0};
+    snapshot_write(writer, padding, size - offset);
+}
+
+// Write a facility list.
+void snapshot_write_facility_list\
+(struct snapshot_writer* writer, struct facility_list* facility_list) {
+    snapshot_write_section(writer, snapshot_tag_facilities, \
+    sizeof(struct snapshot_facility), facility_list->store.count, \
+    facility_list->id_last_assigned);
+
+    struct facility_node* facility = record_store_first(&facility_list->store);
+    while (facility != NULL) {
+        struct snapshot_facility record;
+        memset(&record, 0, sizeof(struct snapshot_facility));
+        record.id = facility->id;
+        record.name = snapshot_text(writer, facility->name);
+        record.email = snapshot_text(writer, facility->email);
+        record.phone = snapshot_text(writer, facility->phone);
+        record.address = snapshot_text(writer, facility->address);
+        record.type = facility->type;
+        snapshot_write(writer, &record, sizeof(struct snapshot_facility));
+        facility = record_store_next(&facility_list->store, facility);
+    }
+}
+
+// Write an employee list, followed by the facilities of every employee.
+void snapshot_write_employee_list\
+(struct snapshot_writer* writer, struct employee_list* employee_list) {
+    snapshot_write_section(writer, snapshot_tag_employees, \
+    sizeof(struct snapshot_employee), employee_list->store.count, \
+    employee_list->id_last_assigned);
+
+    uint64_t facility_count = 0;
+    struct employee_node* employee = record_store_first(&employee_list->store);
+    while (employee != NULL) {
+        struct employee_facility_list* employee_facility_list = \
+        employee->employee_facility_list;
+
+        struct snapshot_employee record;
+        memset(&record, 0, sizeof(struct snapshot_employee));
+        record.id = employee->id;
+        record.name = snapshot_text(writer, employee->name);
+        record.email = snapshot_text(writer, employee->email);
+        record.phone = snapshot_text(writer, employee->phone);
+        record.address = snapshot_text(writer, employee->address);
+        if (employee_facility_list != NULL) {
+            record.has_facilities = 1;
+            record.facilities_last_assigned = \
+            employee_facility_list->id_last_assigned;
+            facility_count += employee_facility_list->store.count;
+        }
+        snapshot_write(writer, &record, sizeof(struct snapshot_employee));
+        employee = record_store_next(&employee_list->store, employee);
+    }
+
+    snapshot_write_section(writer, snapshot_tag_employee_facilities, \
+    sizeof(struct snapshot_employee_facility), facility_count, \
+    ENTERPRISE_ID_NONE);
+
+    employee = record_store_first(&employee_list->store);
+    while (employee != NULL && writer->collecting == false) {
+        struct employee_facility_list* employee_facility_list = \
+        employee->employee_facility_list;
+        struct employee_facility_node* employee_facility = \
+        employee_facility_list == NULL ? NULL : \
+        record_store_first(&employee_facility_list->store);
+
+        while (employee_facility != NULL) {
+            struct snapshot_employee_facility record;
+            memset(&record, 0, sizeof(struct snapshot_employee_facility));
+            record.employee_id = employee->id;
+            record.id = employee_facility->id;
+            record.facility_id = employee_facility->facility_id;
+            snapshot_write(writer, &record, \
+            sizeof(struct snapshot_employee_facility));
+            employee_facility = record_store_next\
+            (&employee_facility_list->store, employee_facility);
+        }
+        employee = record_store_next(&employee_list->store, employee);
+    }
+}
+
+// Write an item list, followed by the facilities of every item.
+void snapshot_write_item_list\
+(struct snapshot_writer* writer, struct item_list* item_list) {
+    snapshot_write_section(writer, snapshot_tag_items, \
+    sizeof(struct snapshot_item), item_list->store.count, \
+    item_list->id_last_assigned);
+
+    uint64_t facility_count = 0;
+    struct item_node* item = record_store_first(&item_list->store);
+    while (item != NULL) {
+        struct item_facility_list* item_facility_list = \
+        item->item_facility_list;
+
+        struct snapshot_item record;
+        memset(&record, 0, sizeof(struct snapshot_item));
+        record.id = item->id;
+        record.name = snapshot_text(writer, item->name);
+        record.retail_price = item->retail_price;
+        record.internal_cost = item->internal_cost;
+        if (item_facility_list != NULL) {
+            record.has_facilities = 1;
+            record.facilities_last_assigned = \
+            item_facility_list->id_last_assigned;
+            facility_count += item_facility_list->store.count;
+        }
+        snapshot_write(writer, &record, sizeof(struct snapshot_item));
+        item = record_store_next(&item_list->store, item);
+    }
+
+    snapshot_write_section(writer, snapshot_tag_item_facilities, \
+    sizeof(struct snapshot_item_facility), facility_count, \
+    ENTERPRISE_ID_NONE);
+
+    // Item facilities hold no text, so they are skipped while collecting.
+    item = record_store_first(&item_list->store);
+    while (item != NULL && writer->collecting == false) {
+        struct item_facility_list* item_facility_list = \
+        item->item_facility_list;
+        struct item_facility_node* item_facility = \
+        item_facility_list == NULL ? NULL : \
+        record_store_first(&item_facility_list->store);
+
+        while (item_facility != NULL) {
+            struct snapshot_item_facility record;
+            memset(&record, 0, sizeof(struct snapshot_item_facility));
+            record.item_id = item->id;
+            record.id = item_facility->id;
+            record.facility_id = item_facility->facility_id;
+            record.quantity = item_facility->quantity;
+            snapshot_write(writer, &record, \
+            sizeof(struct snapshot_item_facility));
+            item_facility = record_store_next\
+            (&item_facility_list->store, item_facility);
+        }
+        item = record_store_next(&item_list->store, item);
+    }
+}
+
+// Write a customer list.
+void snapshot_write_customer_list\
+(struct snapshot_writer* writer, struct customer_list* customer_list) {
+    snapshot_write_section(writer, snapshot_tag_customers, \
+    sizeof(struct snapshot_customer), customer_list->store.count, \
+    customer_list->id_last_assigned);
+
+    struct customer_node* customer = record_store_first(&customer_list->store);
+    while (customer != NULL) {
+        struct snapshot_customer record;
+        memset(&record, 0, sizeof(struct snapshot_customer));
+        record.id = customer->id;
+        record.name = snapshot_text(writer, customer->name);
+        record.email = snapshot_text(writer, customer->email);
+        record.phone = snapshot_text(writer, customer->phone);
+        record.address = snapshot_text(writer, customer->address);
+        snapshot_write(writer, &record, sizeof(struct snapshot_customer));
+        customer = record_store_next(&customer_list->store, customer);
+    }
+}
+
+// Write a supplier list.
+void snapshot_write_supplier_list\
+(struct snapshot_writer* writer, struct supplier_list* supplier_list) {
+    snapshot_write_section(writer, snapshot_tag_suppliers, \
+    sizeof(struct snapshot_supplier), supplier_list->store.count, \
+    supplier_list->id_last_assigned);
+
+    struct supplier_node* supplier = record_store_first(&supplier_list->store);
+    while (supplier != NULL) {
+        struct snapshot_supplier record;
+        memset(&record, 0, sizeof(struct snapshot_supplier));
+        record.id = supplier->id;
+        record.name = snapshot_text(writer, supplier->name);
+        record.email = snapshot_text(writer, supplier->email);
+        record.phone = snapshot_text(writer, supplier->phone);
+        record.address = snapshot_text(writer, supplier->address);
+        snapshot_write(writer, &record, sizeof(struct snapshot_supplier));
+        supplier = record_store_next(&supplier_list->store, supplier);
+    }
+}
+
+// Write an expense list.
+void snapshot_write_expense_list\
+(struct snapshot_writer* writer, struct expense_list* expense_list) {
+    if (writer->collecting) return;
+    snapshot_write_section(writer, snapshot_tag_expenses, \
+    sizeof(struct snapshot_expense), expense_list->store.count, \
+    expense_list->id_last_assigned);
+
+    struct expense_node* expense = record_store_first(&expense_list->store);
+    while (expense != NULL) {
+        struct snapshot_expense record;
+        memset(&record, 0, sizeof(struct snapshot_expense));
+        record.id = expense->id;
+        record.facility_id = expense->facility_id;
+        record.supplier_id = expense->supplier_id;
+        record.type = expense->type;
+        snapshot_write(writer, &record, sizeof(struct snapshot_expense));
+        expense = record_store_next(&expense_list->store, expense);
+    }
+}
+
+// Write an order list.
+void snapshot_write_order_list\
+(struct snapshot_writer* writer, struct order_list* order_list) {
+    if (writer->collecting) return;
+    snapshot_write_section(writer, snapshot_tag_orders, \
+    sizeof(struct snapshot_order), order_list->store.count, \
+    order_list->id_last_assigned);
+
+    struct order_node* order = record_store_first(&order_list->store);
+    while (order != NULL) {
+        struct snapshot_order record;
+        memset(&record, 0, sizeof(struct snapshot_order));
+        record.id = order->id;
+        record.supplier_id = order->supplier_id;
+        record.recipient_id = order->recipient_id;
+        record.time_order_placed = (int64_t)order->time_order_placed;
+        record.supplier_type = order->supplier_type;
+        record.recipient_type = order->recipient_type;
+        record.delivered = order->delivered;
+        snapshot_write(writer, &record, sizeof(struct snapshot_order));
+        order = record_store_next(&order_list->store, order);
+    }
+}
+
+// Initialise a reader for a file opened for reading. Strings read from the
+// snapshot are interned into string_pool.
+// Returns true on success, or false on failure.
+bool snapshot_reader_init(struct snapshot_reader* reader, FILE* file, \
+struct string_pool* string_pool) {
+    if (reader == NULL || file == NULL) return false;
+    reader->file = file;
+    reader->string_pool = string_pool;
+    reader->strings = NULL;
+    reader->string_count = 0;
+    reader->shared_strings = false;
+    reader->failed = false;
+    reader->generation = 0;
+
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) return false;
+    reader->size = (uint64_t)size;
+    reader->bytes_left = (uint64_t)size;
+
+    reader->buffer = malloc(SNAPSHOT_BUFFER_SIZE);
+    return reader->buffer != NULL;
+}
+
+// Free all memory associated with a reader, giving back the reader's
+// references to the string table. Does not close the file.
+void snapshot_reader_free(struct snapshot_reader* reader) {
+    if (reader == NULL) return;
+    if (reader->shared_strings) {
+        free(reader->buffer);
+        return;
+    }
+    for (uint32_t string = 0; string < reader->string_count; string++) {
+        string_pool_release(reader->string_pool, reader->strings[string]);
+    }
+    free(reader->strings);
+    free(reader->buffer);
+}
+
+// Read exactly size bytes from the snapshot.
+// Returns true on success, or false on failure.
+bool snapshot_read(struct snapshot_reader* reader, void* data, size_t size) {
+    if (reader->failed) return false;
+    if (size > reader->bytes_left || \
+    fread(data, 1, size, reader->file) != size) reader->failed = true;
+    else reader->bytes_left -= size;
+    return reader->failed == false;
+}
+
+// Skip over size bytes of the snapshot.
+// Returns true on success, or false on failure.
+bool snapshot_skip(struct snapshot_reader* reader, uint64_t size) {
+    if (reader->failed) return false;
+    if (size > reader->bytes_left || size > LONG_MAX || \
+    fseek(reader->file, (long)size, SEEK_CUR) != 0) reader->failed = true;
+    else reader->bytes_left -= size;
+    return reader->failed == false;
+}
+
+// Move to offset bytes from the start of the snapshot.
+// Returns true on success, or false on failure.
+bool snapshot_reader_seek(struct snapshot_reader* reader, uint64_t offset) {
+    if (offset > reader->size || offset > LONG_MAX || \
+    fseek(reader->file, (long)offset, SEEK_SET) != 0) reader->failed = true;
+    else reader->bytes_left = reader->size - offset;
+    return reader->failed == false;
+}
+
+// Use the string table of another reader of the same snapshot, which must
+// have read it already and must outlive this reader. Lists can then be read
+// by several readers at the same time, each on its own thread.
+void snapshot_reader_share_strings(struct snapshot_reader* reader, \
+const struct snapshot_reader* from) {
+    reader->strings = from->strings;
+    reader->string_count = from->string_count;
+    reader->shared_strings = true;
+}
+
+// Read a section header, checking that it is the expected section.
+// Returns true on success, or false on failure.
+bool snapshot_read_section(struct snapshot_reader* reader, \
+struct snapshot_section* section, uint32_t tag, uint32_t record_size) {
+    if (snapshot_read(reader, section, sizeof(struct snapshot_section)) \
+    == false) return false;
+    if (section->tag != tag || section->record_size != record_size || \
+    section->id_last_assigned < ENTERPRISE_ID_NONE || \
+    section->count > reader->bytes_left / record_size) reader->failed = true;
+    return reader->failed == false;
+}
+
+// Read the next batch of up to remaining records into the reader's buffer.
+// Returns the number of records read, or 0 on failure.
+size_t snapshot_read_batch\
+(struct snapshot_reader* reader, size_t record_size, uint64_t remaining) {
+    size_t batch = SNAPSHOT_BUFFER_SIZE / record_size;
+    if (remaining < batch) batch = (size_t)remaining;
+    if (snapshot_read(reader, reader->buffer, record_size * batch) == false) {
+        return 0;
+    }
+    return batch;
+}
+
+// Returns the text at a position in the string table with a new reference
+// taken to it. Marks the reader as failed if there is no such position.
+const char* snapshot_read_text(struct snapshot_reader* reader, uint32_t text) {
+    if (text >= reader->string_count) {
+        reader->failed = true;
+        return "";
+    }
+    if (reader->shared_strings) {
+        string_pool_retain_shared(reader->string_pool, reader->strings[text]);
+    }
+    else string_pool_retain(reader->string_pool, reader->strings[text]);
+    return reader->strings[text];
+}
+
+// Copy the text at a position in the string table into a fixed size field.
+void snapshot_read_text_into\
+(struct snapshot_reader* reader, uint32_t text, char* field) {
+    if (text >= reader->string_count) {
+        reader->failed = true;
+        return;
+    }
+    snprintf(field, ENTERPRISE_STRING_LENGTH, "%s", reader->strings[text]);
+}
+
+// Check that an ID read from a snapshot is one its list could have handed out.
+// Lists are saved in the order their nodes were added, so IDs must count up
+// from the ID of the node before, which also rules out duplicate IDs.
+// Returns true if the ID is valid, or false if it is not.
+bool snapshot_check_id(struct snapshot_reader* reader, enterprise_id id, \
+enterprise_id id_previous, enterprise_id id_last_assigned) {
+    if (id <= id_previous || id > id_last_assigned) reader->failed = true;
+    return reader->failed == false;
+}
+
+// Find where every section of the snapshot starts by walking the section
+// headers from the start of the file, skipping their records, then go back to
+// the start. offsets holds SNAPSHOT_TAG_COUNT offsets, one for each tag.
+// Returns true on success, or false on failure.
+bool snapshot_find_sections(struct snapshot_reader* reader, uint64_t* offsets) {
+    const uint32_t record_sizes[SNAPSHOT_TAG_COUNT] = {0, sizeof(uint64_t), \
+    1, sizeof(struct snapshot_enterprise), sizeof(struct snapshot_facility), \
+    sizeof(struct snapshot_employee), \
+    sizeof(struct snapshot_employee_facility), sizeof(struct snapshot_item), \
+    sizeof(struct snapshot_item_facility), sizeof(struct snapshot_customer), \
+    sizeof(struct snapshot_supplier), sizeof(struct snapshot_expense), \
+    sizeof(struct snapshot_order)};
+
+    struct snapshot_section section;
+    if (snapshot_skip(reader, sizeof(struct snapshot_header)) == false) {
+        return false;
+    }
+    offsets[0] = 0;
+    for (uint32_t tag = snapshot_tag_strings; tag < SNAPSHOT_TAG_COUNT; \
+    tag++) {
+        offsets[tag] = reader->size - reader->bytes_left;
+        if (snapshot_read_section(reader, &section, tag, record_sizes[tag]) \
+        == false || snapshot_skip(reader, section.count * record_sizes[tag]) \
+        == false) return false;
+    }
+    return snapshot_reader_seek(reader, 0);
+}
+
+// Read the snapshot header and string table.
+// Returns true on success, or false on failure.
+bool snapshot_read_header(struct snapshot_reader* reader) {
+    struct snapshot_header header;
+    if (snapshot_read(reader, &header, sizeof(struct snapshot_header)) \
+    == false) return false;
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || \
+    header.version != SNAPSHOT_VERSION || \
+    header.byte_order != SNAPSHOT_BYTE_ORDER) return false;
+    reader->generation = header.generation;
+
+    // The string offsets are only needed when a snapshot is mapped, as
+    // loading walks the text from start to end.
+    struct snapshot_section section;
+    if (snapshot_read_section(reader, &section, snapshot_tag_strings, \
+    sizeof(uint64_t)) == false || section.count >= UINT32_MAX || \
+    snapshot_skip(reader, section.count * sizeof(uint64_t)) == false) {
+        return false;
+    }
+    uint32_t string_count = (uint32_t)section.count;
+
+    // Every string in the text takes at least its terminating zero, so the
+    // number of strings can never exceed the size of the text.
+    if (snapshot_read_section(reader, &section, snapshot_tag_text, 1) \
+    == false || string_count > section.count) return false;
+
+    char* table = malloc(section.count + 1);
+    reader->strings = malloc(sizeof(const char*) * ((size_t)string_count + 1));
+    if (table == NULL || reader->strings == NULL || \
+    string_pool_reserve(reader->string_pool, string_count) == false || \
+    snapshot_read(reader, table, section.count) == false) {
+        free(table);
+        return false;
+    }
+    table[section.count] = '\0';
+
+    // Position 0 is the empty string.
+    reader->strings[0] = "";
+    reader->string_count = 1;
+
+    // Strings are hashed SNAPSHOT_PREFETCH_DISTANCE strings before they are
+    // interned, so the string pool can fetch their slots from memory in the
+    // meantime.
+    struct {const char* text; size_t length; uint32_t hash;} \
+    ahead[SNAPSHOT_PREFETCH_DISTANCE];
+    const char* text = table;
+    const char* end = table + section.count;
+    for (uint32_t string = 0; string < string_count + \
+    SNAPSHOT_PREFETCH_DISTANCE; string++) {
+        uint32_t next = string % SNAPSHOT_PREFETCH_DISTANCE;
+        if (string >= SNAPSHOT_PREFETCH_DISTANCE) {
+            const char* pooled = string_pool_intern_hashed\
+            (reader->string_pool, ahead[next].text, ahead[next].length, \
+            ahead[next].hash);
+            if (pooled == NULL) break;
+            reader->strings[reader->string_count++] = pooled;
+        }
+        if (string < string_count) {
+            if (text >= end) break;
+            size_t length = strlen(text);
+            ahead[next].text = text;
+            ahead[next].length = string_pool_length(text);
+            ahead[next].hash = string_pool_hash(text, ahead[next].length);
+            string_pool_prefetch(reader->string_pool, ahead[next].hash);
+            text += length + 1;
+        }
+    }
+    // Only zeros may follow the last string, to pad the text.
+    bool padded = reader->string_count == string_count + 1 && \
+    end - text < SNAPSHOT_ALIGNMENT;
+    while (padded && text < end) padded = *text++ == '\0';
+    free(table);
+    return padded;
+}
+
+// Read a facility list into an empty facility list.
+// Returns true on success, or false on failure.
+bool snapshot_read_facility_list\
+(struct snapshot_reader* reader, struct facility_list* facility_list) {
+    struct snapshot_section section;
+    if (snapshot_read_section(reader, &section, snapshot_tag_facilities, \
+    sizeof(struct snapshot_facility)) == false) return false;
+    facility_list->id_last_assigned = section.id_last_assigned;
+    if (section.count > UINT32_MAX || \
+    facility_list_reserve(facility_list, (uint32_t)section.count) \
+    == false) return false;
+
+    enterprise_id id_previous = ENTERPRISE_ID_NONE;
+
+    uint64_t remaining = section.count;
+    while (remaining > 0) {
+        size_t batch = snapshot_read_batch(reader, section.record_size, \
+        remaining);
+        if (batch == 0) return false;
+        remaining -= batch;
+
+        struct snapshot_facility* records = \
+        (struct snapshot_facility*)reader->buffer;
+        for (size_t record = 0; record < batch; record++) {
+            if (record + SNAPSHOT_PREFETCH_DISTANCE < batch) {
+                id_index_prefetch(&facility_list->id_index, \
+                records[record + SNAPSHOT_PREFETCH_DISTANCE].id);
+            }
+            if (snapshot_check_id(reader, records[record].id, id_previous, \
+            section.id_last_assigned) == false) return false;
+            id_previous = records[record].id;
+            if (records[record].type < facility_type_office || \
+            records[record].type > facility_type_warehouse) return false;
+
+            struct facility_node* facility = \
+            facility_node_new(&facility_list->store);
+            if (facility == NULL) return false;
+            facility->id = records[record].id;
+            facility->name = snapshot_read_text(reader, records[record].name);
+            facility->email = snapshot_read_text(reader, records[record].email);
+            facility->phone = snapshot_read_text(reader, records[record].phone);
+            facility->address = \
+            snapshot_read_text(reader, records[record].address);
+            facility->type = (enum facility_type)records[record].type;
+            if (id_index_insert(&facility_list->id_index, facility->id, \
+            record_store_handle(facility)) == false) return false;
+        }
+        if (reader->failed) return false;
+    }
+    return true;
+}
+
+// Read an employee list and the facilities of every employee into an empty
+// employee list.
+// Returns true on success, or false on failure.
+bool snapshot_read_employee_list\
+(struct snapshot_reader* reader, struct employee_list* employee_list) {
+    struct snapshot_section section;
+    if (snapshot_read_section(reader, &section, snapshot_tag_employees, \
+    sizeof(struct snapshot_employee)) == false) return false;
+    employee_list->id_last_assigned = section.id_last_assigned;
+    if (section.count > UINT32_MAX || \
+    employee_list_reserve(employee_list, (uint32_t)section.count) \
+    == false) return false;
+
+    enterprise_id id_previous = ENTERPRISE_ID_NONE;
+
+    uint64_t remaining = section.count;
+    while (remaining > 0) {
+        size_t batch = snapshot_read_batch(reader, section.record_size, \
+        remaining);
+        if (batch == 0) return false;
+        remaining -= batch;
+
+        struct snapshot_employee* records = \
+        (struct snapshot_employee*)reader->buffer;
+        for (size_t record = 0; record < batch; record++) {
+            if (record + SNAPSHOT_PREFETCH_DISTANCE < batch) {
+                id_index_prefetch(&employee_list->id_index, \
+                records[record + SNAPSHOT_PREFETCH_DISTANCE].id);
+            }
+            if (snapshot_check_id(reader, records[record].id, id_previous, \
+            section.id_last_assigned) == false) return false;
+            id_previous = records[record].id;
+
+            struct employee_node* employee = \
+            employee_node_new(&employee_list->store);
+            if (employee == NULL) return false;
+            employee->id = records[record].id;
+            employee->name = snapshot_read_text(reader, records[record].name);
+            employee->email = snapshot_read_text(reader, records[record].email);
+            employee->phone = snapshot_read_text(reader, records[record].phone);
+            employee->address = \
+            snapshot_read_text(reader, records[record].address);
+            if (id_index_insert(&employee_list->id_index, employee->id, \
+            record_store_handle(employee)) == false) return false;
+
+            if (records[record].has_facilities) {
+                if (records[record].facilities_last_assigned < \
+                ENTERPRISE_ID_NONE) return false;
+                employee->employee_facility_list = \
+                employee_facility_list_new(NULL, \
+                employee_list->facility_references, employee->id);
+                if (employee->employee_facility_list == NULL) return false;
+                employee->employee_facility_list->id_last_assigned = \
+                records[record].facilities_last_assigned;
+            }
+        }
+        if (reader->failed) return false;
+    }
+
+    // Facilities are grouped by employee, so the owner rarely changes.
+    if (snapshot_read_section(reader, &section, \
+    snapshot_tag_employee_facilities, \
+    sizeof(struct snapshot_employee_facility)) == false) return false;
+
+    struct employee_node* employee = NULL;
+    remaining = section.count;
+    while (remaining > 0) {
+        size_t batch = snapshot_read_batch(reader, section.record_size, \
+        remaining);
+        if (batch == 0) return false;
+        remaining -= batch;
+
+        struct snapshot_employee_facility* records = \
+        (struct snapshot_employee_facility*)reader->buffer;
+        for (size_t record = 0; record < batch; record++) {
+            if (employee == NULL || \
+            employee->id != records[record].employee_id) {
+                employee = employee_list_get_node(employee_list, \
+                records[record].employee_id);
+                if (employee == NULL || \
+                employee->employee_facility_list == NULL) return false;
+            }
+            struct employee_facility_list* employee_facility_list = \
+            employee->employee_facility_list;
+            struct employee_facility_node* last = \
+            record_store_last(&employee_facility_list->store);
+            if (snapshot_check_id(reader, records[record].id, \
+            last == NULL ? ENTERPRISE_ID_NONE : last->id, \
+            employee_facility_list->id_last_assigned) == false) return false;
+
+            struct employee_facility_node* employee_facility = \
+            employee_facility_node_new(&employee_facility_list->store);
+            if (employee_facility == NULL) return false;
+            employee_facility->id = records[record].id;
+            employee_facility->facility_id = records[record].facility_id;
+            if (id_index_insert(&employee_facility_list->id_index, \
+            employee_facility->id, record_store_handle(employee_facility)) \
+            == false) return false;
+        }
+    }
+    return true;
+}
+
+// Read an item list and the facilities of every item into an empty item list.
+// Returns true on success, or false on failure.
+bool snapshot_read_item_list\
+(struct snapshot_reader* reader, struct item_list* item_list) {
+    struct snapshot_section section;
+    if (snapshot_read_section(reader, &section, snapshot_tag_items, \
+    sizeof(struct snapshot_item)) == false) return false;
+    item_list->id_last_assigned = section.id_last_assigned;
+    if (section.count > UINT32_MAX || \
+    item_list_reserve(item_list, (uint32_t)section.count) \
+    == false) return false;
+
+    enterprise_id id_previous = ENTERPRISE_ID_NONE;
+
+    uint64_t remaining = section.count;
+    while (remaining > 0) {
+        size_t batch = snapshot_read_batch(reader, section.record_size, \
+        remaining);
+        if (batch == 0) return false;
+        remaining -= batch;
+
+        struct snapshot_item* records = (struct snapshot_item*)reader->buffer;
+        for (size_t record = 0; record < batch; record++) {
+            if (record + SNAPSHOT_PREFETCH_DISTANCE < batch) {
+                id_index_prefetch(&item_list->id_index, \
+                records[record + SNAPSHOT_PREFETCH_DISTANCE].id);
+            }
+            if (snapshot_check_id(reader, records[record].id, id_previous, \
+            section.id_last_assigned) == false) return false;
+            id_previous = records[record].id;
+
+            struct item_node* item = item_node_new(&item_list->store);
+            if (item == NULL) return false;
+            item->id = records[record].id;
+            item->name = snapshot_read_text(reader, records[record].name);
+            item->retail_price = records[record].retail_price;
+            item->internal_cost = records[record].internal_cost;
+            if (id_index_insert(&item_list->id_index, item->id, \
+            record_store_handle(item)) == false) return false;
+
+            if (records[record].has_facilities) {
+                if (records[record].facilities_last_assigned < \
+                ENTERPRISE_ID_NONE) return false;
+                item->item_facility_list = item_facility_list_new\
+                (NULL, &item_list->valuation, \
+                item_list->facility_references, item->id);
+                if (item->item_facility_list == NULL) return false;
+                item->item_facility_list->id_last_assigned = \
+                records[record].facilities_last_assigned;
+            }
+        }
+        if (reader->failed) return false;
+    }
+
+    // Facilities are grouped by item, so the owner rarely changes.
+    if (snapshot_read_section(reader, &section, snapshot_tag_item_facilities, \
+    sizeof(struct snapshot_item_facility)) == false) return false;
+
+    struct item_node* item = NULL;
+    remaining = section.count;
+    while (remaining > 0) {
+        size_t batch = snapshot_read_batch(reader, section.record_size, \
+        remaining);
+        if (batch == 0) return false;
+        remaining -= batch;
+
+        struct snapshot_item_facility* records = \
+        (struct snapshot_item_facility*)reader->buffer;
+        for (size_t record = 0; record < batch; record++) {
+            if (item == NULL || item->id != records[record].item_id) {
+                item = item_list_get_node(item_list, records[record].item_id);
+                if (item == NULL || item->item_facility_list == NULL) {
+                    return false;
+                }
+            }
+            struct item_facility_list* item_facility_list = \
+            item->item_facility_list;
+            struct item_facility_node* last = \
+            record_store_last(&item_facility_list->store);
+            if (snapshot_check_id(reader, records[record].id, \
+            last == NULL ? ENTERPRISE_ID_NONE : last->id, \
+            item_facility_list->id_last_assigned) == false) return false;
+
+            struct item_facility_node* item_facility = \
+            item_facility_node_new(&item_facility_list->store);
+            if (item_facility == NULL) return false;
+            item_facility->id = records[record].id;
+            item_facility->facility_id = records[record].facility_id;
+            item_facility->quantity = records[record].quantity;
+            if (id_index_insert(&item_facility_list->id_index, \
+            item_facility->id, record_store_handle(item_facility)) == false) {
+                return false;
+            }
+        }
+        if (reader->failed) return false;
+    }
+    return true;
+}
+
+// Read a customer list into an empty customer list.
+// Returns true on success, or false on failure.
+bool snapshot_read_customer_list\
+(struct snapshot_reader* reader, struct customer_list* customer_list) {
+    struct snapshot_section section;
+    if (snapshot_read_section(reader, &section, snapshot_tag_customers, \
+    sizeof(struct snapshot_customer)) == false) return false;
+    customer_list->id_last_assigned = section.id_last_assigned;
+    if (section.count > UINT32_MAX || \
+    customer_list_reserve(customer_list, (uint32_t)section.count) \
+    == false) return false;
+
+    enterprise_id id_previous = ENTERPRISE_ID_NONE;
+
+    uint64_t remaining = section.count;
+    while (remaining > 0) {
+        size_t batch = snapshot_read_batch(reader, section.record_size, \
+        remaining);
+        if (batch == 0) return false;
+        remaining -= batch;
+
+        struct snapshot_customer* records = \
+        (struct snapshot_customer*)reader->buffer;
+        for (size_t record = 0; record < batch; record++) {
+            if (record + SNAPSHOT_PREFETCH_DISTANCE < batch) {
+                id_index_prefetch(&customer_list->id_index, \
+                records[record + SNAPSHOT_PREFETCH_DISTANCE].id);
+            }
+            if (snapshot_check_id(reader, records[record].id, id_previous, \
+            section.id_last_assigned) == false) return false;
+            id_previous = records[record].id;
+
+            struct customer_node* customer = \
+            customer_node_new(&customer_list->store);
+            if (customer == NULL) return false;
+            customer->id = records[record].id;
+            customer->name = snapshot_read_text(reader, records[record].name);
+            customer->email = snapshot_read_text(reader, records[record].email);
+            customer->phone = snapshot_read_text(reader, records[record].phone);
+            customer->address = \
+            snapshot_read_text(reader, records[record].address);
+            if (id_index_insert(&customer_list->id_index, customer->id, \
+            record_store_handle(customer)) == false) return false;
+        }
+        if (reader->failed) return false;
+    }
+    return true;
+}
+
+// Read a supplier list into an empty supplier list.
+// Returns true on success, or false on failure.
+bool snapshot_read_supplier_list\
+(struct snapshot_reader* reader, struct supplier_list* supplier_list) {
+    struct snapshot_section section;
+    if (snapshot_read_section(reader, &section, snapshot_tag_suppliers, \
+    sizeof(struct snapshot_supplier)) == false) return false;
+    supplier_list->id_last_assigned = section.id_last_assigned;
+    if (section.count > UINT32_MAX || \
+    supplier_list_reserve(supplier_list, (uint32_t)section.count) \
+    == false) return false;
+
+    enterprise_id id_previous = ENTERPRISE_ID_NONE;
+
+    uint64_t remaining = section.count;
+    while (remaining > 0) {
+        size_t batch = snapshot_read_batch(reader, section.record_size, \
+        remaining);
+        if (batch == 0) return false;
+        remaining -= batch;
+
+        struct snapshot_supplier* records = \
+        (struct snapshot_supplier*)reader->buffer;
+        for (size_t record = 0; record < batch; record++) {
+            if (record + SNAPSHOT_PREFETCH_DISTANCE < batch) {
+                id_index_prefetch(&supplier_list->id_index, \
+                records[record + SNAPSHOT_PREFETCH_DISTANCE].id);
+            }
+            if (snapshot_check_id(reader, records[record].id, id_previous, \
+            section.id_last_assigned) == false) return false;
+            id_previous = records[record].id;
+
+            struct supplier_node* supplier = \
+            supplier_node_new(&supplier_list->store);
+            if (supplier == NULL) return false;
+            supplier->id = records[record].id;
+            supplier->name = snapshot_read_text(reader, records[record].name);
+            supplier->email = snapshot_read_text(reader, records[record].email);
+            supplier->phone = snapshot_read_text(reader, records[record].phone);
+            supplier->address = \
+            snapshot_read_text(reader, records[record].address);
+            if (id_index_insert(&supplier_list->id_index, supplier->id, \
+            record_store_handle(supplier)) == false) return false;
+        }
+        if (reader->failed) return false;
+    }
+    return true;
+}
+
+// Read an expense list into an empty expense list.
+// Returns true on success, or false on failure.
+bool snapshot_read_expense_list\
+(struct snapshot_reader* reader, struct expense_list* expense_list) {
+    struct snapshot_section section;
+    if (snapshot_read_section(reader, &section, snapshot_tag_expenses, \
+    sizeof(struct snapshot_expense)) == false) return false;
+    expense_list->id_last_assigned = section.id_last_assigned;
+    if (section.count > UINT32_MAX || \
+    expense_list_reserve(expense_list, (uint32_t)section.count) \
+    == false) return false;
+
+    enterprise_id id_previous = ENTERPRISE_ID_NONE;
+
+    uint64_t remaining = section.count;
+    while (remaining > 0) {
+        size_t batch = snapshot_read_batch(reader, section.record_size, \
+        remaining);
+        if (batch == 0) return false;
+        remaining -= batch;
+
+        struct snapshot_expense* records = \
+        (struct snapshot_expense*)reader->buffer;
+        for (size_t record = 0; record < batch; record++) {
+            if (record + SNAPSHOT_PREFETCH_DISTANCE < batch) {
+                id_index_prefetch(&expense_list->id_index, \
+                records[record + SNAPSHOT_PREFETCH_DISTANCE].id);
+            }
+            if (snapshot_check_id(reader, records[record].id, id_previous, \
+            section.id_last_assigned) == false) return false;
+            id_previous = records[record].id;
+            if (records[record].type < expense_type_rent || \
+            records[record].type > expense_type_misc) return false;
+
+            struct expense_node* expense = \
+            expense_node_new(&expense_list->store);
+            if (expense == NULL) return false;
+            expense->id = records[record].id;
+            expense->facility_id = records[record].facility_id;
+            expense->supplier_id = records[record].supplier_id;
+            expense->type = (enum expense_type)records[record].type;
+            if (id_index_insert(&expense_list->id_index, expense->id, \
+            record_store_handle(expense)) == false) return false;
+        }
+    }
+    return true;
+}
+
+// Read an order list into an empty order list.
+// Returns true on success, or false on failure.
+bool snapshot_read_order_list\
+(struct snapshot_reader* reader, struct order_list* order_list) {
+    struct snapshot_section section;
+    if (snapshot_read_section(reader, &section, snapshot_tag_orders, \
+    sizeof(struct snapshot_order)) == false) return false;
+    order_list->id_last_assigned = section.id_last_assigned;
+    if (section.count > UINT32_MAX || \
+    order_list_reserve(order_list, (uint32_t)section.count) \
+    == false) return false;
+
+    enterprise_id id_previous = ENTERPRISE_ID_NONE;
+
+    uint64_t remaining = section.count;
+    while (remaining > 0) {
+        size_t batch = snapshot_read_batch(reader, section.record_size, \
+        remaining);
+        if (batch == 0) return false;
+        remaining -= batch;
+
+        struct snapshot_order* records = \
+        (struct snapshot_order*)reader->buffer;
+        for (size_t record = 0; record < batch; record++) {
+            if (record + SNAPSHOT_PREFETCH_DISTANCE < batch) {
+                id_index_prefetch(&order_list->id_index, \
+                records[record + SNAPSHOT_PREFETCH_DISTANCE].id);
+            }
+            if (snapshot_check_id(reader, records[record].id, id_previous, \
+            section.id_last_assigned) == false) return false;
+            id_previous = records[record].id;
+            if (records[record].supplier_type < order_supplier_supplier || \
+            records[record].supplier_type > order_supplier_facility || \
+            records[record].recipient_type < order_recipient_facility || \
+            records[record].recipient_type > order_recipient_customer) {
+                return false;
+            }
+
+            struct order_node* order = order_node_new(&order_list->store);
+            if (order == NULL) return false;
+            order->id = records[record].id;
+            order->supplier_id = records[record].supplier_id;
+            order->recipient_id = records[record].recipient_id;
+            order->time_order_placed = \
+            (time_t)records[record].time_order_placed;
+            order->supplier_type = \
+            (enum order_supplier_type)records[record].supplier_type;
+            order->recipient_type = \
+            (enum order_recipient_type)records[record].recipient_type;
+            order->delivered = records[record].delivered != 0;
+            if (id_index_insert(&order_list->id_index, order->id, \
+            record_store_handle(order)) == false) return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,318 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_FACILITIES
+#define ENTERPRISE_FACILITIES
+#include "facilities.h"
+#endif
+
+#ifndef ENTERPRISE_EMPLOYEES
+#define ENTERPRISE_EMPLOYEES
+#include "employees.h"
+#endif
+
+#ifndef ENTERPRISE_ITEMS
+#define ENTERPRISE_ITEMS
+#include "inventory.h"
+#endif
+
+#ifndef ENTERPRISE_CUSTOMERS
+#define ENTERPRISE_CUSTOMERS
+#include "customers.h"
+#endif
+
+#ifndef ENTERPRISE_SUPPLIERS
+#define ENTERPRISE_SUPPLIERS
+#include "suppliers.h"
+#endif
+
+#ifndef ENTERPRISE_EXPENSES
+#define ENTERPRISE_EXPENSES
+#include "expenses.h"
+#endif
+
+#ifndef ENTERPRISE_ORDERS
+#define ENTERPRISE_ORDERS
+#include "orders.h"
+#endif
+
+/* How snapshots work.
+A snapshot is a binary file holding the whole enterprise database. It is laid
+out so that loading it is a handful of large reads instead of parsing fields
+one by one:
+
+1. A header with a magic number, the format version, a byte order marker and
+the generation of the snapshot. Every save gives the snapshot a new
+generation, and the journal of changes made since holds the same one (see
+journal.c).
+2. A string table holding every piece of text in the database exactly once:
+the offset of each string, then the text of every string.
+3. The enterprise's own fields.
+4. One section per list, each a section header followed by an array of fixed
+size records. Employees and items are followed by a section holding the
+records of every nested facility list, in the same order as their owners.
+
+Records refer to text by its position in the string table, with 0 meaning an
+empty string. The string table is built by interning every piece of text into a
+string pool used only for the save, so text shared by many nodes is written
+once. On load the table is interned into the enterprise's string pool and each
+node takes another reference to its strings, so no text is copied per node.
+
+Every section starts on a multiple of SNAPSHOT_ALIGNMENT bytes, so a snapshot
+mapped into memory can be used in place (see snapshot_map.c).
+
+Snapshots are written in the byte order of the machine that saved them, and a
+machine with a different byte order refuses to load them. Any change to the
+layout of a record must bump SNAPSHOT_VERSION.
+
+Sections are found without reading their records, by walking the section
+headers, so each list can be loaded by its own reader of the file on its own
+thread. Those readers share the string table read by the first.
+
+Writing happens in two passes over the same functions. The first pass only
+collects text into the save's string pool, the second writes the records.
+
+Data structures:
+snapshot_writer: The file being saved, its output buffer and string pool.
+snapshot_reader: The file being loaded, its input buffer and string table.
+snapshot_header, snapshot_section and snapshot_*: The on disk layout.
+*/
+
+#define SNAPSHOT_MAGIC "ENTSNAP"
+#define SNAPSHOT_VERSION 4
+#define SNAPSHOT_ALIGNMENT 8
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+#define SNAPSHOT_BUFFER_SIZE (1024 * 1024)
+#define SNAPSHOT_PREFETCH_DISTANCE 16
+
+// Tags marking the start of each section of a snapshot.
+enum snapshot_tag {snapshot_tag_strings = 1, snapshot_tag_text,
+snapshot_tag_enterprise,
+snapshot_tag_facilities, snapshot_tag_employees,
+snapshot_tag_employee_facilities, snapshot_tag_items,
+snapshot_tag_item_facilities, snapshot_tag_customers, snapshot_tag_suppliers,
+snapshot_tag_expenses, snapshot_tag_orders};
+
+#define SNAPSHOT_TAG_COUNT (snapshot_tag_orders + 1)
+
+// The first bytes of every snapshot.
+struct snapshot_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t generation;
+};
+
+// The header in front of every section. Sections of records hold count
+// records of record_size bytes each.
+struct snapshot_section {
+    uint32_t tag;
+    uint32_t record_size;
+    uint64_t count;
+    int64_t id_last_assigned;
+};
+
+// The enterprise's own fields.
+struct snapshot_enterprise {
+    uint32_t name;
+    uint32_t unused;
+    int64_t balance;
+};
+
+// On disk facility.
+struct snapshot_facility {
+    int64_t id;
+    uint32_t name;
+    uint32_t email;
+    uint32_t phone;
+    uint32_t address;
+    int32_t type;
+    uint32_t unused;
+};
+
+// On disk employee. The employee's facilities follow in their own section.
+struct snapshot_employee {
+    int64_t id;
+    int64_t facilities_last_assigned;
+    uint32_t name;
+    uint32_t email;
+    uint32_t phone;
+    uint32_t address;
+    uint32_t has_facilities;
+    uint32_t unused;
+};
+
+// On disk facility that an employee works at.
+struct snapshot_employee_facility {
+    int64_t employee_id;
+    int64_t id;
+    int64_t facility_id;
+};
+
+// On disk item. The item's facilities follow in their own section.
+struct snapshot_item {
+    int64_t id;
+    int64_t facilities_last_assigned;
+    int64_t retail_price;
+    int64_t internal_cost;
+    uint32_t name;
+    uint32_t has_facilities;
+};
+
+// On disk facility that an item is stocked at.
+struct snapshot_item_facility {
+    int64_t item_id;
+    int64_t id;
+    int64_t facility_id;
+    int64_t quantity;
+};
+
+// On disk customer.
+struct snapshot_customer {
+    int64_t id;
+    uint32_t name;
+    uint32_t email;
+    uint32_t phone;
+    uint32_t address;
+};
+
+// On disk supplier.
+struct snapshot_supplier {
+    int64_t id;
+    uint32_t name;
+    uint32_t email;
+    uint32_t phone;
+    uint32_t address;
+};
+
+// On disk expense.
+struct snapshot_expense {
+    int64_t id;
+    int64_t facility_id;
+    int64_t supplier_id;
+    int32_t type;
+    uint32_t unused;
+};
+
+// On disk order.
+struct snapshot_order {
+    int64_t id;
+    int64_t supplier_id;
+    int64_t recipient_id;
+    int64_t time_order_placed;
+    int32_t supplier_type;
+    int32_t recipient_type;
+    uint32_t delivered;
+    uint32_t unused;
+};
+
+// Snapshot writer structure.
+struct snapshot_writer {
+    FILE* file;
+    unsigned char* buffer;
+    size_t buffer_used;
+
+    // Every piece of text being saved, interned once, in the order the text
+    // is first used, and the position of each in the string table by its
+    // slot in the string pool.
+    struct string_pool* string_pool;
+    const char** strings;
+    uint32_t string_count;
+    uint32_t string_capacity;
+    uint32_t* positions;
+
+    // The generation written into the header.
+    uint64_t generation;
+
+    // While collecting, text is added to the string pool and nothing is
+    // written to the file.
+    bool collecting;
+    bool failed;
+};
+
+// Snapshot reader structure.
+struct snapshot_reader {
+    FILE* file;
+    unsigned char* buffer;
+
+    // The enterprise's string pool, and the string table interned into it.
+    // A reader sharing another reader's string table does not own it, and
+    // may be one of several threads taking references to its strings.
+    struct string_pool* string_pool;
+    const char** strings;
+    uint32_t string_count;
+    bool shared_strings;
+
+    // The size of the file, and the bytes left in it, so that a damaged
+    // section header can not ask for more records than the file holds.
+    uint64_t size;
+    uint64_t bytes_left;
+    bool failed;
+
+    // The generation read from the header.
+    uint64_t generation;
+};
+
+uint64_t snapshot_next_generation(uint64_t previous);
+bool snapshot_writer_init(struct snapshot_writer* writer, FILE* file);
+void snapshot_flush(struct snapshot_writer* writer);
+void snapshot_writer_free(struct snapshot_writer* writer);
+void snapshot_write\
+(struct snapshot_writer* writer, const void* data, size_t size);
+uint32_t snapshot_text(struct snapshot_writer* writer, const char* text);
+void snapshot_write_section(struct snapshot_writer* writer, uint32_t tag, \
+uint32_t record_size, uint64_t count, enterprise_id id_last_assigned);
+void snapshot_write_header(struct snapshot_writer* writer);
+void snapshot_write_facility_list\
+(struct snapshot_writer* writer, struct facility_list* facility_list);
+void snapshot_write_employee_list\
+(struct snapshot_writer* writer, struct employee_list* employee_list);
+void snapshot_write_item_list\
+(struct snapshot_writer* writer, struct item_list* item_list);
+void snapshot_write_customer_list\
+(struct snapshot_writer* writer, struct customer_list* customer_list);
+void snapshot_write_supplier_list\
+(struct snapshot_writer* writer, struct supplier_list* supplier_list);
+void snapshot_write_expense_list\
+(struct snapshot_writer* writer, struct expense_list* expense_list);
+void snapshot_write_order_list\
+(struct snapshot_writer* writer, struct order_list* order_list);
+bool snapshot_reader_init(struct snapshot_reader* reader, FILE* file, \
+struct string_pool* string_pool);
+void snapshot_reader_free(struct snapshot_reader* reader);
+bool snapshot_read(struct snapshot_reader* reader, void* data, size_t size);
+bool snapshot_skip(struct snapshot_reader* reader, uint64_t size);
+bool snapshot_reader_seek(struct snapshot_reader* reader, uint64_t offset);
+void snapshot_reader_share_strings(struct snapshot_reader* reader, \
+const struct snapshot_reader* from);
+bool snapshot_read_section(struct snapshot_reader* reader, \
+struct snapshot_section* section, uint32_t tag, uint32_t record_size);
+size_t snapshot_read_batch\
+(struct snapshot_reader* reader, size_t record_size, uint64_t remaining);
+const char* snapshot_read_text(struct snapshot_reader* reader, uint32_t text);
+void snapshot_read_text_into\
+(struct snapshot_reader* reader, uint32_t text, char* field);
+bool snapshot_check_id(struct snapshot_reader* reader, enterprise_id id, \
+enterprise_id id_previous, enterprise_id id_last_assigned);
+bool snapshot_find_sections(struct snapshot_reader* reader, uint64_t* offsets);
+bool snapshot_read_header(struct snapshot_reader* reader);
+bool snapshot_read_facility_list\
+(struct snapshot_reader* reader, struct facility_list* facility_list);
+bool snapshot_read_employee_list\
+(struct snapshot_reader* reader, struct employee_list* employee_list);
+bool snapshot_read_item_list\
+(struct snapshot_reader* reader, struct item_list* item_list);
+bool snapshot_read_customer_list\
+(struct snapshot_reader* reader, struct customer_list* customer_list);
+bool snapshot_read_supplier_list\
+(struct snapshot_reader* reader, struct supplier_list* supplier_list);
+bool snapshot_read_expense_list\
+(struct snapshot_reader* reader, struct expense_list* expense_list);
+bool snapshot_read_order_list\
+(struct snapshot_reader* reader, struct order_list* order_list);
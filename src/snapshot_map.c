@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+// Import Nuklear, unless building without the GUI.
+#if !defined(ENTERPRISE_NUKLEAR_LIBRARY_IMPORT) \
+&& !defined(ENTERPRISE_HEADLESS)
+#define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
+#include "nuklear_import.h"
+#endif
+
+#ifndef ENTERPRISE_SNAPSHOT_MAP
+#define ENTERPRISE_SNAPSHOT_MAP
+#include "snapshot_map.h"
+#endif
+
+// Find the section starting at *offset in a mapped snapshot, check that it is
+// the expected section and fits in the file, and move *offset past it.
+// Returns true on success, or false on failure.
+static bool snapshot_map_section(struct snapshot_map* map, uint64_t* offset, \
+uint32_t tag, uint32_t record_size, struct snapshot_map_list* list) {
+    const unsigned char* data = map->data;
+    if (map->size - *offset < sizeof(struct snapshot_section)) return false;
+    const struct snapshot_section* section = \
+    (const struct snapshot_section*)(data + *offset);
+    *offset += sizeof(struct snapshot_section);
+
+    if (section->tag != tag || section->record_size != record_size || \
+    section->count > (map->size - *offset) / record_size) return false;
+    list->records = data + *offset;
+    list->count = section->count;
+    list->record_size = record_size;
+    *offset += section->count * record_size;
+
+    // Sections start on aligned offsets so records can be used in place.
+    return *offset % SNAPSHOT_ALIGNMENT == 0;
+}
+
+// Free all resources associated with a mapped snapshot.
+void snapshot_map_close(struct snapshot_map* map) {
+    if (map == NULL) return;
+    #if !defined(_WIN32)
+        if (map->data != NULL) munmap(map->data, map->size);
+    #endif
+    free(map);
+}
+
+// Map the snapshot file at path into memory for viewing.
+// Returns pointer to the mapped snapshot on success, or NULL on failure.
+struct snapshot_map* snapshot_map_open(const char* path) {
+    #if defined(_WIN32)
+        UNUSED(path);
+        return NULL;
+    #else
+        if (path == NULL) return NULL;
+        struct snapshot_map* map = malloc(sizeof(struct snapshot_map));
+        if (map == NULL) return NULL;
+        memset(map, 0, sizeof(struct snapshot_map));
+        map->table = snapshot_tag_facilities;
+
+        int file = open(path, O_RDONLY);
+        if (file < 0) {free(map); return NULL;}
+        struct stat status;
+        if (fstat(file, &status) != 0 || status.st_size < \
+        (off_t)sizeof(struct snapshot_header)) {
+            close(file);
+            free(map);
+            return NULL;
+        }
+        map->size = (size_t)status.st_size;
+        map->data = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (map->data == MAP_FAILED) {free(map); return NULL;}
+
+        const struct snapshot_header* header = map->data;
+        if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) \
+        != 0 || header->version != SNAPSHOT_VERSION || \
+        header->byte_order != SNAPSHOT_BYTE_ORDER) {
+            snapshot_map_close(map);
+            return NULL;
+        }
+
+        // Find every section, in the order they are saved.
+        uint64_t offset = sizeof(struct snapshot_header);
+        struct snapshot_map_list strings, text, enterprise;
+        bool mapped = \
+        snapshot_map_section(map, &offset, snapshot_tag_strings, \
+        sizeof(uint64_t), &strings) && \
+        snapshot_map_section(map, &offset, snapshot_tag_text, 1, &text) && \
+        snapshot_map_section(map, &offset, snapshot_tag_enterprise, \
+        sizeof(struct snapshot_enterprise), &enterprise) && \
+        enterprise.count == 1 && \
+        snapshot_map_section(map, &offset, snapshot_tag_facilities, \
+        sizeof(struct snapshot_facility), &map->facilities) && \
+        snapshot_map_section(map, &offset, snapshot_tag_employees, \
+        sizeof(struct snapshot_employee), &map->employees) && \
+        snapshot_map_section(map, &offset, snapshot_tag_employee_facilities, \
+        sizeof(struct snapshot_employee_facility), \
+        &map->employee_facilities) && \
+        snapshot_map_section(map, &offset, snapshot_tag_items, \
+        sizeof(struct snapshot_item), &map->items) && \
+        snapshot_map_section(map, &offset, snapshot_tag_item_facilities, \
+        sizeof(struct snapshot_item_facility), &map->item_facilities) && \
+        snapshot_map_section(map, &offset, snapshot_tag_customers, \
+        sizeof(struct snapshot_customer), &map->customers) && \
+        snapshot_map_section(map, &offset, snapshot_tag_suppliers, \
+        sizeof(struct snapshot_supplier), &map->suppliers) && \
+        snapshot_map_section(map, &offset, snapshot_tag_expenses, \
+        sizeof(struct snapshot_expense), &map->expenses) && \
+        snapshot_map_section(map, &offset, snapshot_tag_orders, \
+        sizeof(struct snapshot_order), &map->orders);
+
+        // The text must end in a zero so that no string runs off its end.
+        if (mapped == false || \
+        (text.count > 0 && text.records[text.count - 1] != '\0') || \
+        (text.count == 0 && strings.count > 0)) {
+            snapshot_map_close(map);
+            return NULL;
+        }
+        map->string_offsets = (const uint64_t*)strings.records;
+        map->string_count = strings.count;
+        map->text = (const char*)text.records;
+        map->text_size = text.count;
+        map->enterprise = (const struct snapshot_enterprise*)enterprise.records;
+        return map;
+    #endif
+}
+
+// Returns the text at a position in a mapped snapshot's string table, or an
+// empty string if there is no such position.
+const char* snapshot_map_text(struct snapshot_map* map, uint32_t position) {
+    if (map == NULL || position == 0 || position > map->string_count) {
+        return "";
+    }
+    uint64_t offset = map->string_offsets[position - 1];
+    if (offset >= map->text_size) return "";
+    return map->text + offset;
+}
+
+// Returns the list of a mapped snapshot shown for a table, or NULL if the
+// table is not one that can be viewed.
+struct snapshot_map_list* snapshot_map_get_list\
+(struct snapshot_map* map, enum snapshot_tag table) {
+    if (map == NULL) return NULL;
+    if (table == snapshot_tag_facilities) return &map->facilities;
+    if (table == snapshot_tag_employees) return &map->employees;
+    if (table == snapshot_tag_items) return &map->items;
+    if (table == snapshot_tag_customers) return &map->customers;
+    if (table == snapshot_tag_suppliers) return &map->suppliers;
+    if (table == snapshot_tag_expenses) return &map->expenses;
+    if (table == snapshot_tag_orders) return &map->orders;
+    return NULL;
+}
+
+// Write the text of a row of the table being viewed into map->row.
+// Returns map->row.
+const char* snapshot_map_format_row(struct snapshot_map* map, uint64_t row) {
+    const char* facility_types[] = {"Office", "Store", "Warehouse"};
+    const char* expense_types[] = \
+    {"Rent", "Wage", "Insurance", "Energy", "Misc"};
+    struct snapshot_map_list* list = snapshot_map_get_list(map, map->table);
+    const void* record = list->records + row * list->record_size;
+    size_t size = sizeof(map->row);
+
+    if (map->table == snapshot_tag_facilities) {
+        const struct snapshot_facility* facility = record;
+        snprintf(map->row, size, \
+        "ID: %lld Type: %s Name: %s Email: %s Phone: %s Address: %s", \
+        (long long)facility->id, (uint32_t)facility->type < \
+        LEN(facility_types) ? facility_types[facility->type] : "", \
+        snapshot_map_text(map, facility->name), \
+        snapshot_map_text(map, facility->email), \
+        snapshot_map_text(map, facility->phone), \
+        snapshot_map_text(map, facility->address));
+    }
+    else if (map->table == snapshot_tag_employees) {
+        const struct snapshot_employee* employee = record;
+        snprintf(map->row, size, \
+        "ID: %lld Name: %s Email: %s Phone: %s Address: %s", \
+        (long long)employee->id, snapshot_map_text(map, employee->name), \
+        snapshot_map_text(map, employee->email), \
+        snapshot_map_text(map, employee->phone), \
+        snapshot_map_text(map, employee->address));
+    }
+    else if (map->table == snapshot_tag_items) {
+        const struct snapshot_item* item = record;
+        char retail_price[ENTERPRISE_CENTS_TEXT_LENGTH];
+        char internal_cost[ENTERPRISE_CENTS_TEXT_LENGTH];
+        enterprise_cents_format(item->retail_price, retail_price);
+        enterprise_cents_format(item->internal_cost, internal_cost);
+        snprintf(map->row, size, \
+        "ID: %lld Name: %s Retail Price: %s Internal Cost: %s", \
+        (long long)item->id, snapshot_map_text(map, item->name), \
+        retail_price, internal_cost);
+    }
+    else if (map->table == snapshot_tag_customers) {
+        const struct snapshot_customer* customer = record;
+        snprintf(map->row, size, \
+        "ID: %lld Name: %s Email: %s Phone: %s Address: %s", \
+        (long long)customer->id, snapshot_map_text(map, customer->name), \
+        snapshot_map_text(map, customer->email), \
+        snapshot_map_text(map, customer->phone), \
+        snapshot_map_text(map, customer->address));
+    }
+    else if (map->table == snapshot_tag_suppliers) {
+        const struct snapshot_supplier* supplier = record;
+        snprintf(map->row, size, \
+        "ID: %lld Name: %s Email: %s Phone: %s Address: %s", \
+        (long long)supplier->id, snapshot_map_text(map, supplier->name), \
+        snapshot_map_text(map, supplier->email), \
+        snapshot_map_text(map, supplier->phone), \
+        snapshot_map_text(map, supplier->address));
+    }
+    else if (map->table == snapshot_tag_expenses) {
+        const struct snapshot_expense* expense = record;
+        snprintf(map->row, size, \
+        "ID: %lld Type: %s Facility ID: %lld Supplier ID: %lld", \
+        (long long)expense->id, (uint32_t)expense->type < \
+        LEN(expense_types) ? expense_types[expense->type] : "", \
+        (long long)expense->facility_id, (long long)expense->supplier_id);
+    }
+    else if (map->table == snapshot_tag_orders) {
+        const struct snapshot_order* order = record;
+        snprintf(map->row, size, \
+        "ID: %lld Supplier ID: %lld Recipient ID: %lld", \
+        (long long)order->id, (long long)order->supplier_id, \
+        (long long)order->recipient_id);
+    }
+    else {
+        map->row[0] = '\0';
+    }
+    return map->row;
+}
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+
+// Render the menu of a mapped snapshot.
+enum program_status snapshot_map_menu\
+(struct nk_context* ctx, struct snapshot_map* map) {
+    if (ctx == NULL || map == NULL) return program_status_enterprise_menu;
+    nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+    if (nk_button_label(ctx, "Close and Return to Enterprise Menu")) {
+        return program_status_snapshot_map_close;
+    }
+
+    // Show the enterprise's own fields.
+    char balance[ENTERPRISE_CENTS_TEXT_LENGTH];
+    enterprise_cents_format(map->enterprise->balance, balance);
+    snprintf(map->row, sizeof(map->row), "Read Only: %s Balance: %s", \
+    snapshot_map_text(map, map->enterprise->name), balance);
+    nk_label(ctx, map->row, NK_TEXT_CENTERED);
+
+    const char* labels[] = {"Facilities", "Employees", "Inventory", \
+    "Customers", "Suppliers", "Expenses", "Orders"};
+    const enum snapshot_tag tables[] = {snapshot_tag_facilities, \
+    snapshot_tag_employees, snapshot_tag_items, snapshot_tag_customers, \
+    snapshot_tag_suppliers, snapshot_tag_expenses, snapshot_tag_orders};
+    for (size_t table = 0; table < LEN(tables); table++) {
+        if (nk_button_label(ctx, labels[table])) {
+            map->table = tables[table];
+            return program_status_snapshot_map_table;
+        }
+    }
+    return program_status_snapshot_map_menu;
+}
+
+// Render the table of a mapped snapshot's list being viewed.
+// Only the rows in view are drawn, so only their pages of the file are read.
+enum program_status snapshot_map_table\
+(struct nk_context* ctx, struct snapshot_map* map) {
+    if (ctx == NULL || map == NULL) return program_status_enterprise_menu;
+    nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+    if (nk_button_label(ctx, "Return to Read Only Menu")) {
+        return program_status_snapshot_map_menu;
+    }
+
+    struct snapshot_map_list* list = snapshot_map_get_list(map, map->table);
+    if (list == NULL || list->count == 0) {
+        nk_label(ctx, "Nothing found.", NK_TEXT_CENTERED);
+        return program_status_snapshot_map_table;
+    }
+
+    struct nk_list_view view;
+    int rows = list->count > INT_MAX ? INT_MAX : (int)list->count;
+    nk_layout_row_dynamic(ctx, ENTERPRISE_TABLE_HEIGHT, 1);
+    if (nk_list_view_begin(ctx, &view, "snapshot_map_table", \
+    NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+        nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+        for (int row = view.begin; row < view.begin + view.count; row++) {
+            nk_label(ctx, snapshot_map_format_row(map, (uint64_t)row), \
+            NK_TEXT_LEFT);
+        }
+        nk_list_view_end(&view);
+    }
+    return program_status_snapshot_map_table;
+}
+
+#endif
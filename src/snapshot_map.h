@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+#include "constants.h"
+
+#ifndef PROGRAM_STATES
+#define PROGRAM_STATES
+#include "program_states.h"
+#endif
+
+#ifndef ENTERPRISE_SNAPSHOTS
+#define ENTERPRISE_SNAPSHOTS
+#include "snapshot.h"
+#endif
+
+// Nuklear's context, taken by the GUI functions. Only the sources of
+// those functions import Nuklear itself.
+struct nk_context;
+
+/* How mapped snapshots work.
+A snapshot can be opened read only by mapping the file into memory instead of
+loading it. Nothing is copied onto the heap: the tables read records and text
+straight out of the mapped file, and the operating system only reads the parts
+of the file that are actually shown. Opening even a very large snapshot is
+therefore close to instant, which suits workstations that only view reports.
+
+Opening a snapshot checks that every section is where the header says it is
+and fits in the file. Individual records are not checked, so text positions
+are checked as the text is looked up.
+
+Mapped snapshots can not be edited. To edit a snapshot, load it instead.
+
+Data structures:
+snapshot_map_list: The records of one list in the mapped file.
+snapshot_map: The mapped file, and the list currently being viewed.
+*/
+
+// The records of one list in a mapped snapshot.
+struct snapshot_map_list {
+    const unsigned char* records;
+    uint64_t count;
+    uint32_t record_size;
+};
+
+// Mapped snapshot structure.
+struct snapshot_map {
+    void* data;
+    size_t size;
+
+    // The string table.
+    const uint64_t* string_offsets;
+    uint64_t string_count;
+    const char* text;
+    uint64_t text_size;
+
+    const struct snapshot_enterprise* enterprise;
+    struct snapshot_map_list facilities;
+    struct snapshot_map_list employees;
+    struct snapshot_map_list employee_facilities;
+    struct snapshot_map_list items;
+    struct snapshot_map_list item_facilities;
+    struct snapshot_map_list customers;
+    struct snapshot_map_list suppliers;
+    struct snapshot_map_list expenses;
+    struct snapshot_map_list orders;
+
+    // The list shown in the table view, and the text of the row being drawn.
+    enum snapshot_tag table;
+    char row[ENTERPRISE_STRING_LENGTH * 5];
+};
+
+void snapshot_map_close(struct snapshot_map* map);
+struct snapshot_map* snapshot_map_open(const char* path);
+const char* snapshot_map_text(struct snapshot_map* map, uint32_t position);
+struct snapshot_map_list* snapshot_map_get_list\
+(struct snapshot_map* map, enum snapshot_tag table);
+const char* snapshot_map_format_row(struct snapshot_map* map, uint64_t row);
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+enum program_status snapshot_map_menu\
+(struct nk_context* ctx, struct snapshot_map* map);
+enum program_status snapshot_map_table\
+(struct nk_context* ctx, struct snapshot_map* map);
+#endif
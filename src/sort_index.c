@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_SORT_INDEX
+#define ENTERPRISE_SORT_INDEX
+#include "sort_index.h"
+#endif
+
+// Initialise an empty sort index that sorts records by key, and then by
+// compare.
+void sort_index_init(struct sort_index* index, sort_index_key key, \
+sort_index_compare compare) {
+    if (index == NULL) return;
+    memset(index, 0, sizeof(struct sort_index));
+    index->key = key;
+    index->compare = compare;
+}
+
+// Free all memory associated with a sort index.
+// The index is left empty and unbuilt, and can be reused.
+void sort_index_free(struct sort_index* index) {
+    if (index == NULL) return;
+    free(index->entries);
+    sort_index_init(index, index->key, index->compare);
+}
+
+// Returns a negative number if entry a comes before entry b in an index, a
+// positive number if it comes after, and 0 if they hold the same record.
+static inline int sort_index_order(struct sort_index* index, \
+const struct sort_index_entry* a, const struct sort_index_entry* b) {
+    if (a->key != b->key) return a->key < b->key ? -1 : 1;
+    return index->compare(a->record, b->record);
+}
+
+// Make room in the index for count records.
+// Returns true on success, or false on failure.
+static bool sort_index_reserve(struct sort_index* index, uint32_t count) {
+    if (count <= index->capacity) return true;
+    uint32_t capacity = index->capacity == 0 \
+    ? SORT_INDEX_FIRST_CAPACITY : index->capacity;
+    while (capacity < count) capacity *= 2;
+    struct sort_index_entry* entries = \
+    realloc(index->entries, sizeof(struct sort_index_entry) * capacity);
+    if (entries == NULL) return false;
+    index->entries = entries;
+    index->capacity = capacity;
+    return true;
+}
+
+// Returns the first position of the index whose entry does not come before
+// entry.
+static uint32_t sort_index_lower_bound(struct sort_index* index, \
+const struct sort_index_entry* entry) {
+    uint32_t low = 0;
+    uint32_t high = index->count;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (sort_index_order(index, &index->entries[middle], entry) < 0) {
+            low = middle + 1;
+        }
+        else high = middle;
+    }
+    return low;
+}
+
+// Sort count entries into the order of an index. Their keys must be made by
+// the index's key function.
+// Merge sort is used because qsort can not pass the index to its callback.
+// Returns true on success, or false on failure.
+bool sort_index_sort(struct sort_index* index, \
+struct sort_index_entry* entries, uint32_t count) {
+    if (index == NULL) return false;
+
+    // Sort short runs by insertion first, which is quicker than merging them.
+    for (uint32_t start = 0; start < count; start += SORT_INDEX_RUN) {
+        uint32_t end = count - start > SORT_INDEX_RUN \
+        ? start + SORT_INDEX_RUN : count;
+        for (uint32_t next = start + 1; next < end; next++) {
+            struct sort_index_entry entry = entries[next];
+            uint32_t position = next;
+            while (position > start && \
+            sort_index_order(index, &entries[position - 1], &entry) > 0) {
+                entries[position] = entries[position - 1];
+                position--;
+            }
+            entries[position] = entry;
+        }
+    }
+    if (count <= SORT_INDEX_RUN) return true;
+
+    // Then merge runs of doubling width, back and forth between the entries
+    // and a scratch array.
+    struct sort_index_entry* scratch = \
+    malloc(sizeof(struct sort_index_entry) * count);
+    if (scratch == NULL) return false;
+    struct sort_index_entry* from = entries;
+    struct sort_index_entry* to = scratch;
+    for (uint64_t width = SORT_INDEX_RUN; width < count; width *= 2) {
+        for (uint64_t start = 0; start < count; start += width * 2) {
+            uint64_t middle = start + width < count ? start + width : count;
+            uint64_t end = middle + width < count ? middle + width : count;
+            uint64_t left = start;
+            uint64_t right = middle;
+            for (uint64_t out = start; out < end; out++) {
+                if (right >= end || (left < middle && sort_index_order\
+                (index, &from[left], &from[right]) <= 0)) {
+                    to[out] = from[left++];
+                }
+                else to[out] = from[right++];
+            }
+        }
+        struct sort_index_entry* swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != entries) {
+        memcpy(entries, from, sizeof(struct sort_index_entry) * count);
+    }
+    free(scratch);
+    return true;
+}
+
+// Build the index from every record in a store.
+// Returns true on success, or false on failure.
+bool sort_index_build(struct sort_index* index, struct record_store* store) {
+    if (index == NULL || store == NULL) return false;
+    index->built = false;
+    index->count = 0;
+    if (sort_index_reserve(index, store->count) == false) return false;
+
+    for (void* record = record_store_first(store); record != NULL; \
+    record = record_store_next(store, record)) {
+        index->entries[index->count].key = index->key(record);
+        index->entries[index->count].record = record;
+        index->count++;
+    }
+    if (sort_index_sort(index, index->entries, index->count) == false) {
+        return false;
+    }
+
+    index->built = true;
+    return true;
+}
+
+// Take a record out of the index before it is deleted.
+void sort_index_remove(struct sort_index* index, const void* record) {
+    if (index == NULL || record == NULL || index->built == false) return;
+
+    uint32_t position = sort_index_row(index, record);
+    if (position == SORT_INDEX_NONE) return;
+    memmove(&index->entries[position], &index->entries[position + 1], \
+    sizeof(struct sort_index_entry) * (index->count - position - 1));
+    index->count--;
+}
+
+// Move a record to its place in the index after it was added or edited.
+// Does nothing until the index is built. On failure the index is marked
+// unbuilt so that it is built again the next time it is used.
+// Returns true on success, or false on failure.
+bool sort_index_update(struct sort_index* index, const void* record) {
+    if (index == NULL || record == NULL) return false;
+    if (index->built == false) return true;
+
+    // A record whose column did not change is already in its place, which is
+    // the case if it is found between records that come before and after it.
+    struct sort_index_entry entry = {index->key(record), record};
+    uint32_t position = sort_index_lower_bound(index, &entry);
+    if (position < index->count && index->entries[position].record == record \
+    && (position == 0 || \
+    sort_index_order(index, &index->entries[position - 1], &entry) < 0) \
+    && (position + 1 == index->count || \
+    sort_index_order(index, &entry, &index->entries[position + 1]) < 0)) {
+        index->entries[position].key = entry.key;
+        return true;
+    }
+
+    // Otherwise take it out from wherever it was, and put it in its place.
+    sort_index_remove(index, record);
+    if (sort_index_reserve(index, index->count + 1) == false) {
+        index->built = false;
+        return false;
+    }
+    position = sort_index_lower_bound(index, &entry);
+    memmove(&index->entries[position + 1], &index->entries[position], \
+    sizeof(struct sort_index_entry) * (index->count - position));
+    index->entries[position] = entry;
+    index->count++;
+    return true;
+}
+
+// Return the row of a record in the index, or SORT_INDEX_NONE if it is not in
+// the index. A record whose column is unchanged since it was last put in its
+// place is found with a binary search, and any other by checking every record.
+uint32_t sort_index_row(struct sort_index* index, const void* record) {
+    if (index == NULL || record == NULL || index->built == false) {
+        return SORT_INDEX_NONE;
+    }
+    struct sort_index_entry entry = {index->key(record), record};
+    uint32_t position = sort_index_lower_bound(index, &entry);
+    if (position < index->count && index->entries[position].record == record) {
+        return position;
+    }
+    for (position = 0; position < index->count; position++) {
+        if (index->entries[position].record == record) return position;
+    }
+    return SORT_INDEX_NONE;
+}
+
+// Return the record at the given row of the index, or NULL if there is no such
+// row.
+const void* sort_index_record(struct sort_index* index, uint32_t row) {
+    if (index == NULL || row >= index->count) return NULL;
+    return index->entries[row].record;
+}
+
+// Compare two strings for sorting, ignoring the case of ASCII letters.
+int sort_index_compare_text(const char* a, const char* b) {
+    for (;; a++, b++) {
+        unsigned char character_a = (unsigned char)*a;
+        unsigned char character_b = (unsigned char)*b;
+        if (character_a >= 'A' && character_a <= 'Z') character_a += 'a' - 'A';
+        if (character_b >= 'A' && character_b <= 'Z') character_b += 'a' - 'A';
+        if (character_a != character_b || character_a == '\0') {
+            return (int)character_a - (int)character_b;
+        }
+    }
+}
+
+// Returns the key of a string compared with sort_index_compare_text, made from
+// its first eight bytes.
+uint64_t sort_index_text_key(const char* text) {
+    uint64_t key = 0;
+    for (int byte = 0; byte < 8; byte++) {
+        unsigned char character = (unsigned char)*text;
+        if (character >= 'A' && character <= 'Z') character += 'a' - 'A';
+        key = key << 8 | character;
+        if (*text != '\0') text++;
+    }
+    return key;
+}
+
+// Returns the key of a signed integer.
+uint64_t sort_index_integer_key(int64_t value) {
+    return (uint64_t)value ^ ((uint64_t)1 << 63);
+}
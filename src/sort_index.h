@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+/* How sorted tables work.
+Some tables can be sorted by one of their columns instead of listing records
+in the order they were added. Sorting a large list every time the user picks a
+column, or every time a record changes, is too slow, so a list keeps a sort
+index for each column it has been sorted by.
+
+A sort index is an array of pointers to the list's records, kept in order by
+the column's compare function. Records never move in a record store (see
+record_store.c), so the pointers stay valid until a record is deleted. Any row
+of a sorted table is found straight from the array, and reading the array
+backwards sorts the table in descending order.
+
+Following a pointer to compare two records is slow when the records are spread
+over a large store, so each pointer is kept next to a 64 bit key made from the
+record's column, such as the first letters of a name. Records with different
+keys are ordered by their keys alone, and only records with the same key are
+compared in full.
+
+An index is built the first time its column is picked, and then kept in order
+as records are added, edited and deleted. A record whose column did not change
+is found in place with a binary search, so only records whose column did
+change are moved. Compare functions must break ties, usually by ID, so that
+no two records compare equal.
+
+Data structures:
+sort_index_entry: A record in a sort index, and its key.
+sort_index: The records of one list, sorted by one column.
+*/
+
+#define SORT_INDEX_NONE UINT32_MAX
+#define SORT_INDEX_FIRST_CAPACITY 64
+#define SORT_INDEX_RUN 16
+
+// Compares two records of a list. Returns a negative number if a comes before
+// b, a positive number if a comes after b, and 0 only if they are the same.
+typedef int (*sort_index_compare)(const void* a, const void* b);
+
+// Returns the key of a record. A record with a lower key than another must
+// come before it.
+typedef uint64_t (*sort_index_key)(const void* record);
+
+// A record in a sort index, and its key.
+struct sort_index_entry {
+    uint64_t key;
+    const void* record;
+};
+
+// Sort index structure.
+struct sort_index {
+    sort_index_compare compare;
+    sort_index_key key;
+    bool built;
+
+    // The records of the list in order.
+    struct sort_index_entry* entries;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+void sort_index_init(struct sort_index* index, sort_index_key key, \
+sort_index_compare compare);
+void sort_index_free(struct sort_index* index);
+bool sort_index_sort(struct sort_index* index, \
+struct sort_index_entry* entries, uint32_t count);
+bool sort_index_build(struct sort_index* index, struct record_store* store);
+void sort_index_remove(struct sort_index* index, const void* record);
+bool sort_index_update(struct sort_index* index, const void* record);
+const void* sort_index_record(struct sort_index* index, uint32_t row);
+uint32_t sort_index_row(struct sort_index* index, const void* record);
+int sort_index_compare_text(const char* a, const char* b);
+uint64_t sort_index_text_key(const char* text);
+uint64_t sort_index_integer_key(int64_t value);
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_STOCK_VALUATION
+#define ENTERPRISE_STOCK_VALUATION
+#include "stock_valuation.h"
+#endif
+
+// Initialise an empty stock valuation that finds the prices of items with
+// prices, passing it list.
+void stock_valuation_init(struct stock_valuation* valuation, \
+stock_valuation_prices prices, void* list) {
+    if (valuation == NULL) return;
+    memset(valuation, 0, sizeof(struct stock_valuation));
+    valuation->prices = prices;
+    valuation->list = list;
+    id_index_init(&valuation->facility_index);
+}
+
+// Free the rows gathered to build a stock valuation.
+static void stock_valuation_free_rows(struct stock_valuation* valuation) {
+    free(valuation->row_facility_ids);
+    free(valuation->row_quantities);
+    free(valuation->row_retail_prices);
+    free(valuation->row_internal_costs);
+    valuation->row_facility_ids = NULL;
+    valuation->row_quantities = NULL;
+    valuation->row_retail_prices = NULL;
+    valuation->row_internal_costs = NULL;
+    valuation->row_count = 0;
+    valuation->row_capacity = 0;
+}
+
+// Free all memory associated with a stock valuation.
+// The valuation is left empty and unbuilt, and can be reused.
+void stock_valuation_free(struct stock_valuation* valuation) {
+    if (valuation == NULL) return;
+    stock_valuation_free_rows(valuation);
+    id_index_free(&valuation->facility_index);
+    free(valuation->facility_ids);
+    free(valuation->quantities);
+    free(valuation->retail_values);
+    free(valuation->internal_values);
+    uint64_t version = valuation->version;
+    stock_valuation_init(valuation, valuation->prices, valuation->list);
+    valuation->version = version + 1;
+}
+
+// Returns the position of a facility's totals, adding empty totals for it if
+// it has none yet, or UINT32_MAX on failure.
+static uint32_t stock_valuation_facility\
+(struct stock_valuation* valuation, enterprise_id facility_id) {
+    uint32_t position = \
+    id_index_find(&valuation->facility_index, facility_id);
+    if (position != RECORD_STORE_NONE) return position;
+
+    if (valuation->facility_count == valuation->facility_capacity) {
+        uint32_t capacity = valuation->facility_capacity == 0 \
+        ? STOCK_VALUATION_FIRST_CAPACITY : valuation->facility_capacity * 2;
+        enterprise_id* facility_ids = realloc(valuation->facility_ids, \
+        sizeof(enterprise_id) * capacity);
+        if (facility_ids != NULL) valuation->facility_ids = facility_ids;
+        enterprise_quantity* quantities = realloc(valuation->quantities, \
+        sizeof(enterprise_quantity) * capacity);
+        if (quantities != NULL) valuation->quantities = quantities;
+        enterprise_cents* retail_values = realloc(valuation->retail_values, \
+        sizeof(enterprise_cents) * capacity);
+        if (retail_values != NULL) valuation->retail_values = retail_values;
+        enterprise_cents* internal_values = realloc\
+        (valuation->internal_values, sizeof(enterprise_cents) * capacity);
+        if (internal_values != NULL) {
+            valuation->internal_values = internal_values;
+        }
+        if (facility_ids == NULL || quantities == NULL || \
+        retail_values == NULL || internal_values == NULL) return UINT32_MAX;
+        valuation->facility_capacity = capacity;
+    }
+
+    position = valuation->facility_count;
+    if (id_index_insert(&valuation->facility_index, facility_id, position) \
+    == false) return UINT32_MAX;
+    valuation->facility_ids[position] = facility_id;
+    valuation->quantities[position] = 0;
+    valuation->retail_values[position] = 0;
+    valuation->internal_values[position] = 0;
+    valuation->facility_count++;
+    return position;
+}
+
+// Start building a stock valuation from scratch, with room for count rows.
+// Returns true on success, or false on failure.
+bool stock_valuation_begin(struct stock_valuation* valuation, uint32_t count) {
+    if (valuation == NULL) return false;
+    stock_valuation_free(valuation);
+    if (count < STOCK_VALUATION_FIRST_CAPACITY) {
+        count = STOCK_VALUATION_FIRST_CAPACITY;
+    }
+    valuation->row_facility_ids = malloc(sizeof(enterprise_id) * count);
+    valuation->row_quantities = malloc(sizeof(enterprise_quantity) * count);
+    valuation->row_retail_prices = malloc(sizeof(enterprise_cents) * count);
+    valuation->row_internal_costs = malloc(sizeof(enterprise_cents) * count);
+    valuation->row_capacity = count;
+    if (valuation->row_facility_ids == NULL || \
+    valuation->row_quantities == NULL || \
+    valuation->row_retail_prices == NULL || \
+    valuation->row_internal_costs == NULL) {
+        stock_valuation_free_rows(valuation);
+        return false;
+    }
+    return true;
+}
+
+// Add a row to a stock valuation being built: quantity units of an item
+// priced at retail_price and internal_cost, stocked at a facility.
+// Returns true on success, or false if there is no room for the row.
+bool stock_valuation_gather(struct stock_valuation* valuation, \
+enterprise_id facility_id, enterprise_quantity quantity, \
+enterprise_cents retail_price, enterprise_cents internal_cost) {
+    if (valuation == NULL || valuation->row_count == valuation->row_capacity) {
+        return false;
+    }
+    uint32_t row = valuation->row_count++;
+    valuation->row_facility_ids[row] = facility_id;
+    valuation->row_quantities[row] = quantity;
+    valuation->row_retail_prices[row] = retail_price;
+    valuation->row_internal_costs[row] = internal_cost;
+    return true;
+}
+
+// Work out the totals of the rows gathered since stock_valuation_begin, and
+// free the rows.
+// Returns true on success, or false on failure.
+bool stock_valuation_end(struct stock_valuation* valuation) {
+    if (valuation == NULL || valuation->row_quantities == NULL) return false;
+    uint32_t count = valuation->row_count;
+
+    // Value every row. Sums are kept unsigned so that they wrap around
+    // instead of overflowing, and so that these loops can be vectorised.
+    const uint64_t* quantities = (const uint64_t*)valuation->row_quantities;
+    uint64_t* retail_values = (uint64_t*)valuation->row_retail_prices;
+    uint64_t* internal_values = (uint64_t*)valuation->row_internal_costs;
+    for (uint32_t row = 0; row < count; row++) {
+        retail_values[row] *= quantities[row];
+    }
+    for (uint32_t row = 0; row < count; row++) {
+        internal_values[row] *= quantities[row];
+    }
+
+    // Total the whole enterprise.
+    uint64_t quantity = 0;
+    uint64_t retail_value = 0;
+    uint64_t internal_value = 0;
+    for (uint32_t row = 0; row < count; row++) quantity += quantities[row];
+    for (uint32_t row = 0; row < count; row++) {
+        retail_value += retail_values[row];
+    }
+    for (uint32_t row = 0; row < count; row++) {
+        internal_value += internal_values[row];
+    }
+    valuation->quantity = (enterprise_quantity)quantity;
+    valuation->retail_value = (enterprise_cents)retail_value;
+    valuation->internal_value = (enterprise_cents)internal_value;
+
+    // Then total each facility. The rows of an item's facilities are
+    // gathered together, so the facility of a row is often the last one.
+    enterprise_id facility_id = ENTERPRISE_ID_NONE;
+    uint32_t position = UINT32_MAX;
+    bool built = true;
+    for (uint32_t row = 0; row < count; row++) {
+        if (position == UINT32_MAX || \
+        valuation->row_facility_ids[row] != facility_id) {
+            facility_id = valuation->row_facility_ids[row];
+            position = stock_valuation_facility(valuation, facility_id);
+            if (position == UINT32_MAX) {
+                built = false;
+                break;
+            }
+        }
+        valuation->quantities[position] = (enterprise_quantity)\
+        ((uint64_t)valuation->quantities[position] + quantities[row]);
+        valuation->retail_values[position] = (enterprise_cents)\
+        ((uint64_t)valuation->retail_values[position] + retail_values[row]);
+        valuation->internal_values[position] = (enterprise_cents)\
+        ((uint64_t)valuation->internal_values[position] + \
+        internal_values[row]);
+    }
+
+    stock_valuation_free_rows(valuation);
+    if (built == false) {
+        stock_valuation_free(valuation);
+        return false;
+    }
+    valuation->built = true;
+    valuation->version++;
+    return true;
+}
+
+// Count quantity more units of an item at a facility, priced at retail_price
+// and internal_cost. A negative quantity takes stock away.
+// Does nothing until the valuation is built. On failure the valuation is
+// freed so that it is built again the next time it is used.
+void stock_valuation_change(struct stock_valuation* valuation, \
+enterprise_id facility_id, enterprise_quantity quantity, \
+enterprise_cents retail_price, enterprise_cents internal_cost) {
+    if (valuation == NULL || valuation->built == false || quantity == 0) {
+        return;
+    }
+    uint32_t position = stock_valuation_facility(valuation, facility_id);
+    if (position == UINT32_MAX) {
+        stock_valuation_free(valuation);
+        return;
+    }
+
+    uint64_t retail_value = (uint64_t)retail_price * (uint64_t)quantity;
+    uint64_t internal_value = (uint64_t)internal_cost * (uint64_t)quantity;
+    valuation->quantities[position] = (enterprise_quantity)\
+    ((uint64_t)valuation->quantities[position] + (uint64_t)quantity);
+    valuation->retail_values[position] = (enterprise_cents)\
+    ((uint64_t)valuation->retail_values[position] + retail_value);
+    valuation->internal_values[position] = (enterprise_cents)\
+    ((uint64_t)valuation->internal_values[position] + internal_value);
+    valuation->quantity = (enterprise_quantity)\
+    ((uint64_t)valuation->quantity + (uint64_t)quantity);
+    valuation->retail_value = (enterprise_cents)\
+    ((uint64_t)valuation->retail_value + retail_value);
+    valuation->internal_value = (enterprise_cents)\
+    ((uint64_t)valuation->internal_value + internal_value);
+    valuation->version++;
+}
+
+// Count quantity more units of the item with ID item_id at a facility, at the
+// item's current prices. A negative quantity takes stock away.
+void stock_valuation_change_item(struct stock_valuation* valuation, \
+enterprise_id item_id, enterprise_id facility_id, \
+enterprise_quantity quantity) {
+    if (valuation == NULL || valuation->built == false || quantity == 0) {
+        return;
+    }
+    enterprise_cents retail_price;
+    enterprise_cents internal_cost;
+    if (valuation->prices(valuation->list, item_id, &retail_price, \
+    &internal_cost) == false) return;
+    stock_valuation_change(valuation, facility_id, quantity, retail_price, \
+    internal_cost);
+}
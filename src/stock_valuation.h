@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+#ifndef ENTERPRISE_AMOUNTS
+#define ENTERPRISE_AMOUNTS
+#include "enterprise_amount.h"
+#endif
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+/* How the stock valuation works.
+The stock valuation report shows how much stock every facility holds, and what
+it is worth at retail price and at internal cost, along with the totals for the
+whole enterprise. Walking every item and every facility it is stocked at each
+time the report is drawn is too slow for a large inventory, so the item list
+keeps a stock valuation: the totals of every facility, kept up to date as stock
+and prices change.
+
+The valuation is built the first time the report is opened. Every facility
+that an item is stocked at is gathered into a row of plain arrays, one array
+per column, and the values and totals are then worked out by short loops over
+those arrays that the compiler turns into vector instructions.
+
+After that every change is counted on its own: a quantity that changes only
+adds the difference to its facility's totals, and an item whose prices change
+takes its stock away at the old prices and adds it back at the new ones.
+
+Amounts are summed as 64 bit integers. Totals beyond about 92 quadrillion
+dollars wrap around instead of being exact.
+
+Data structures:
+stock_valuation: The totals of every facility and of the whole enterprise.
+*/
+
+#define STOCK_VALUATION_FIRST_CAPACITY 16
+
+// Returns the prices of the item with ID item_id in a list, on success true,
+// or false if there is no such item.
+typedef bool (*stock_valuation_prices)(void* list, enterprise_id item_id, \
+enterprise_cents* retail_price, enterprise_cents* internal_cost);
+
+// Stock valuation structure.
+struct stock_valuation {
+    bool built;
+
+    // Bumped whenever a total changes, so that the labels cached for the
+    // report know when they are stale.
+    uint64_t version;
+
+    // Finds the prices of the items that stock is counted for.
+    stock_valuation_prices prices;
+    void* list;
+
+    // The totals of each facility, one array per column. A facility's
+    // position in the arrays is found with the facility index.
+    struct id_index facility_index;
+    enterprise_id* facility_ids;
+    enterprise_quantity* quantities;
+    enterprise_cents* retail_values;
+    enterprise_cents* internal_values;
+    uint32_t facility_count;
+    uint32_t facility_capacity;
+
+    // The totals of the whole enterprise.
+    enterprise_quantity quantity;
+    enterprise_cents retail_value;
+    enterprise_cents internal_value;
+
+    // Rows gathered while the valuation is built, one array per column.
+    enterprise_id* row_facility_ids;
+    enterprise_quantity* row_quantities;
+    enterprise_cents* row_retail_prices;
+    enterprise_cents* row_internal_costs;
+    uint32_t row_count;
+    uint32_t row_capacity;
+};
+
+void stock_valuation_init(struct stock_valuation* valuation, \
+stock_valuation_prices prices, void* list);
+void stock_valuation_free(struct stock_valuation* valuation);
+bool stock_valuation_begin(struct stock_valuation* valuation, uint32_t count);
+bool stock_valuation_gather(struct stock_valuation* valuation, \
+enterprise_id facility_id, enterprise_quantity quantity, \
+enterprise_cents retail_price, enterprise_cents internal_cost);
+bool stock_valuation_end(struct stock_valuation* valuation);
+void stock_valuation_change(struct stock_valuation* valuation, \
+enterprise_id facility_id, enterprise_quantity quantity, \
+enterprise_cents retail_price, enterprise_cents internal_cost);
+void stock_valuation_change_item(struct stock_valuation* valuation, \
+enterprise_id item_id, enterprise_id facility_id, \
+enterprise_quantity quantity);
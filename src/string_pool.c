@@ -0,0 +1,303 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_STRING_POOL
+#define ENTERPRISE_STRING_POOL
+#include "string_pool.h"
+#endif
+
+// String pool constructor.
+// Returns string pool on success, or NULL on failure.
+struct string_pool* string_pool_new() {
+    struct string_pool* string_pool = malloc(sizeof(struct string_pool));
+    if (string_pool == NULL) return NULL;
+    memset(string_pool, 0, sizeof(struct string_pool));
+
+    // Start with a full block so the first string opens a new one.
+    string_pool->block_used = STRING_POOL_BLOCK_SIZE;
+    return string_pool;
+}
+
+// Free all memory associated with a string pool.
+// All strings handed out by the pool become invalid.
+void string_pool_free(struct string_pool* string_pool) {
+    if (string_pool == NULL) return;
+    for (size_t block = 0; block < string_pool->block_count; block++) {
+        free(string_pool->blocks[block]);
+    }
+    free(string_pool->blocks);
+    free(string_pool->table);
+    free(string_pool);
+}
+
+// Mark a string pool as about to be freed. Releasing strings does nothing
+// from then on, so only string_pool_free may be called on it afterwards.
+void string_pool_drop(struct string_pool* string_pool) {
+    if (string_pool == NULL) return;
+    string_pool->dropping = true;
+}
+
+// Returns true if the pool is about to be freed as a whole.
+bool string_pool_is_dropping(struct string_pool* string_pool) {
+    return string_pool != NULL && string_pool->dropping;
+}
+
+// Hash text with 32 bit FNV-1a.
+uint32_t string_pool_hash(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t character = 0; character < length; character++) {
+        hash ^= (unsigned char)text[character];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Place a string in the first free slot of its probe sequence.
+static void string_pool_place\
+(struct string_pool* string_pool, struct string_pool_entry entry) {
+    uint32_t mask = string_pool->capacity - 1;
+    uint32_t slot = entry.hash & mask;
+    while (string_pool->table[slot].string != NULL) slot = (slot + 1) & mask;
+    string_pool->table[slot] = entry;
+}
+
+// Double the size of the hash table.
+// Returns true on success, or false on failure.
+static bool string_pool_grow_table(struct string_pool* string_pool) {
+    struct string_pool_entry* old_table = string_pool->table;
+    uint32_t old_capacity = string_pool->capacity;
+    uint32_t capacity = old_capacity == 0 ? \
+    STRING_POOL_MIN_CAPACITY : old_capacity * 2;
+
+    string_pool->table = calloc(capacity, sizeof(struct string_pool_entry));
+    if (string_pool->table == NULL) {
+        string_pool->table = old_table;
+        return false;
+    }
+    string_pool->capacity = capacity;
+    for (uint32_t slot = 0; slot < old_capacity; slot++) {
+        if (old_table[slot].string != NULL) {
+            string_pool_place(string_pool, old_table[slot]);
+        }
+    }
+    free(old_table);
+    return true;
+}
+
+// Make room in the hash table for count more strings, so that interning many
+// strings at once does not grow the table over and over.
+// Returns true on success, or false on failure.
+bool string_pool_reserve(struct string_pool* string_pool, uint32_t count) {
+    if (string_pool == NULL) return false;
+    while (((uint64_t)string_pool->count + count) * 2 > string_pool->capacity) {
+        if (string_pool_grow_table(string_pool) == false) return false;
+    }
+    return true;
+}
+
+// Carve size bytes for a new string out of the pool's blocks, reusing a
+// freed string of the same size class if there is one.
+// Returns pointer to the memory on success, or NULL on failure.
+static struct pooled_string* string_pool_allocate\
+(struct string_pool* string_pool, uint32_t size) {
+    uint32_t size_class = size / STRING_POOL_ALIGNMENT - 1;
+    struct pooled_string* string = string_pool->free_lists[size_class];
+    if (string != NULL) {
+        memcpy(&string_pool->free_lists[size_class], string->text, \
+        sizeof(struct pooled_string*));
+        return string;
+    }
+
+    // Open a new block if the current one is full.
+    if (string_pool->block_used + size > STRING_POOL_BLOCK_SIZE) {
+        if (string_pool->block_count == string_pool->block_capacity) {
+            size_t block_capacity = string_pool->block_capacity == 0 ? \
+            16 : string_pool->block_capacity * 2;
+            unsigned char** blocks = realloc(string_pool->blocks, \
+            sizeof(unsigned char*) * block_capacity);
+            if (blocks == NULL) return NULL;
+            string_pool->blocks = blocks;
+            string_pool->block_capacity = block_capacity;
+        }
+        unsigned char* block = malloc(STRING_POOL_BLOCK_SIZE);
+        if (block == NULL) return NULL;
+        string_pool->blocks[string_pool->block_count++] = block;
+        string_pool->block_used = 0;
+    }
+
+    string = (struct pooled_string*)\
+    (string_pool->blocks[string_pool->block_count - 1] \
+    + string_pool->block_used);
+    string_pool->block_used += size;
+    return string;
+}
+
+// Get a pooled copy of the first length characters of text, whose hash from
+// string_pool_hash is already known. See string_pool_intern.
+// Returns the pooled text on success, or NULL on failure.
+const char* string_pool_intern_hashed(struct string_pool* string_pool, \
+const char* text, size_t length, uint32_t hash) {
+    if (string_pool == NULL || text == NULL) return NULL;
+    if (length == 0) return "";
+
+    // Return the existing copy if the pool already holds this text.
+    if (string_pool->count > 0) {
+        uint32_t mask = string_pool->capacity - 1;
+        uint32_t slot = hash & mask;
+        while (string_pool->table[slot].string != NULL) {
+            struct pooled_string* string = string_pool->table[slot].string;
+            if (string_pool->table[slot].hash == hash && \
+            string->length == length && \
+            memcmp(string->text, text, length) == 0) {
+                string->references++;
+                return string->text;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    // Keep the hash table at most half full.
+    if ((string_pool->count + 1) * 2 > string_pool->capacity) {
+        if (string_pool_grow_table(string_pool) == false) return NULL;
+    }
+
+    uint32_t size = (uint32_t)(sizeof(struct pooled_string) + length + 1);
+    size = (size + STRING_POOL_ALIGNMENT - 1) & ~(STRING_POOL_ALIGNMENT - 1);
+    struct pooled_string* string = string_pool_allocate(string_pool, size);
+    if (string == NULL) return NULL;
+
+    string->references = 1;
+    string->hash = hash;
+    string->length = (uint32_t)length;
+    string->size = size;
+    memcpy(string->text, text, length);
+    string->text[length] = '\0';
+
+    struct string_pool_entry entry;
+    entry.string = string;
+    entry.hash = hash;
+    string_pool_place(string_pool, entry);
+    string_pool->count++;
+    string_pool->bytes_used += size;
+    return string->text;
+}
+
+// Get a pooled copy of the passed in text, adding it to the pool if needed.
+// Text longer than ENTERPRISE_STRING_LENGTH - 1 characters is cut short.
+// Every string returned must be given back with string_pool_release.
+// Returns the pooled text on success, or NULL on failure.
+const char* string_pool_intern\
+(struct string_pool* string_pool, const char* text) {
+    if (string_pool == NULL || text == NULL) return NULL;
+    size_t length = string_pool_length(text);
+    return string_pool_intern_hashed(string_pool, text, length, \
+    string_pool_hash(text, length));
+}
+
+// Give back a string handed out by string_pool_intern.
+// The string is freed once nothing refers to it any more.
+void string_pool_release(struct string_pool* string_pool, const char* text) {
+    if (string_pool == NULL || text == NULL || text[0] == '\0') return;
+    if (string_pool->dropping) return;
+
+    struct pooled_string* string = string_pool_header(text);
+    if (--string->references > 0) return;
+
+    // Find the string in the hash table.
+    uint32_t mask = string_pool->capacity - 1;
+    uint32_t slot = string->hash & mask;
+    while (string_pool->table[slot].string != string) {
+        slot = (slot + 1) & mask;
+    }
+
+    // Shift later strings of the same probe run back into the gap.
+    uint32_t gap = slot;
+    uint32_t next = (gap + 1) & mask;
+    while (string_pool->table[next].string != NULL) {
+        uint32_t home = string_pool->table[next].hash & mask;
+        bool movable = (next > gap) ? \
+        (home <= gap || home > next) : (home <= gap && home > next);
+        if (movable) {
+            string_pool->table[gap] = string_pool->table[next];
+            gap = next;
+        }
+        next = (next + 1) & mask;
+    }
+    string_pool->table[gap].string = NULL;
+    string_pool->count--;
+    string_pool->bytes_used -= string->size;
+
+    // Put the memory on the free list for its size class.
+    uint32_t size_class = string->size / STRING_POOL_ALIGNMENT - 1;
+    memcpy(string->text, &string_pool->free_lists[size_class], \
+    sizeof(struct pooled_string*));
+    string_pool->free_lists[size_class] = string;
+}
+
+// Replace the pooled string in a field with a pooled copy of text.
+// Does nothing if the field already holds the same text.
+// Returns true if the field was changed, or false if it was not.
+bool string_pool_assign\
+(struct string_pool* string_pool, const char** field, const char* text) {
+    if (string_pool == NULL || field == NULL || text == NULL) return false;
+    if (*field != NULL && strcmp(*field, text) == 0) return false;
+
+    const char* string = string_pool_intern(string_pool, text);
+    if (string == NULL) return false;
+    string_pool_release(string_pool, *field);
+    *field = string;
+    return true;
+}
+
+// Take another reference to a string handed out by string_pool_intern.
+// Cheaper than interning the same text again when the pooled copy is known.
+void string_pool_retain(struct string_pool* string_pool, const char* text) {
+    if (string_pool == NULL || text == NULL || text[0] == '\0') return;
+    string_pool_header(text)->references++;
+}
+
+// Take another reference to a string like string_pool_retain, from a thread
+// that shares the pool with others. Nothing else about the pool may change
+// while other threads are using it.
+void string_pool_retain_shared\
+(struct string_pool* string_pool, const char* text) {
+    if (string_pool == NULL || text == NULL || text[0] == '\0') return;
+    #if defined(__GNUC__)
+        __atomic_fetch_add(&string_pool_header(text)->references, 1, \
+        __ATOMIC_RELAXED);
+    #else
+        string_pool_header(text)->references++;
+    #endif
+}
+
+// Returns one more than the slot holding the passed in text in the pool's hash
+// table, or 0 if the text is empty or not in the pool. Slots only change when
+// strings are added to or removed from the pool.
+uint32_t string_pool_get_slot\
+(struct string_pool* string_pool, const char* text) {
+    if (string_pool == NULL || text == NULL || text[0] == '\0') return 0;
+    if (string_pool->count == 0) return 0;
+
+    size_t length = string_pool_length(text);
+    uint32_t hash = string_pool_hash(text, length);
+    uint32_t mask = string_pool->capacity - 1;
+    uint32_t slot = hash & mask;
+    while (string_pool->table[slot].string != NULL) {
+        struct pooled_string* string = string_pool->table[slot].string;
+        if (string_pool->table[slot].hash == hash && \
+        string->length == length && \
+        memcmp(string->text, text, length) == 0) return slot + 1;
+        slot = (slot + 1) & mask;
+    }
+    return 0;
+}
+
+// Returns the number of bytes taken up by strings in the pool.
+size_t string_pool_get_bytes_used(struct string_pool* string_pool) {
+    if (string_pool == NULL) return 0;
+    return string_pool->bytes_used;
+}
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "constants.h"
+
+/* How the string pool works.
+Text fields such as names, emails, phone numbers and addresses are not stored
+inside nodes. Nodes hold a pointer to a string kept in the enterprise's string
+pool instead, so each string only takes up as much memory as its text.
+
+The pool interns strings: asking it for a string that it already holds returns
+the existing copy and bumps its reference count. Identical text, like a city in
+many addresses, is therefore only stored once. Releasing a string drops a
+reference, and the memory is reused once nobody refers to the string.
+
+Strings are carved out of large blocks rather than allocated one at a time.
+Freed strings go onto a free list for their size class, rounded up to
+STRING_POOL_ALIGNMENT bytes, and are reused by later strings of the same
+class.
+
+Empty strings are never stored in the pool. Fields can point at any empty
+string, such as "", and releasing an empty string does nothing.
+
+A pool that is about to be freed along with everything that refers to it can
+be dropped with string_pool_drop. Releases are ignored from then on, so the
+lists freed just before the pool do not give back their strings one by one
+only for the whole pool to be freed straight after.
+
+Strings handed out by the pool must not be written to. Editors copy the
+selected node's text into a fixed size buffer, let the user edit the buffer,
+and store the result back with string_pool_assign.
+
+Data structures:
+pooled_string: The header stored in front of the text of each string.
+string_pool_entry: A slot in the hash table used to find strings.
+string_pool: The blocks, free lists and hash table used to find strings.
+*/
+
+#define STRING_POOL_ALIGNMENT 16
+#define STRING_POOL_BLOCK_SIZE (64 * 1024)
+#define STRING_POOL_MIN_CAPACITY 64
+
+// A string in the pool. The text follows the header.
+struct pooled_string {
+    uint32_t references;
+    uint32_t hash;
+    uint32_t length;
+    uint32_t size;
+    char text[];
+};
+
+// A slot in the string pool's hash table. The hash is kept next to the string
+// so that probing past other strings does not have to read them. Empty slots
+// have a NULL string.
+struct string_pool_entry {
+    struct pooled_string* string;
+    uint32_t hash;
+};
+
+// Number of size classes needed for the longest string the pool stores.
+#define STRING_POOL_SIZE_CLASSES \
+((sizeof(struct pooled_string) + ENTERPRISE_STRING_LENGTH \
++ STRING_POOL_ALIGNMENT - 1) / STRING_POOL_ALIGNMENT)
+
+// String pool structure.
+struct string_pool {
+    // Blocks that strings are carved out of.
+    unsigned char** blocks;
+    size_t block_count;
+    size_t block_capacity;
+    size_t block_used;
+
+    // Freed strings, by size class.
+    struct pooled_string* free_lists[STRING_POOL_SIZE_CLASSES];
+
+    // Open addressing hash table of every string in the pool.
+    struct string_pool_entry* table;
+    uint32_t capacity;
+    uint32_t count;
+
+    // Bytes of text currently stored, for reporting memory use.
+    size_t bytes_used;
+
+    // Set once the pool is about to be freed as a whole.
+    bool dropping;
+};
+
+struct string_pool* string_pool_new();
+void string_pool_free(struct string_pool* string_pool);
+void string_pool_drop(struct string_pool* string_pool);
+bool string_pool_is_dropping(struct string_pool* string_pool);
+uint32_t string_pool_hash(const char* text, size_t length);
+
+// Returns the pooled string that owns the passed in text.
+static inline struct pooled_string* string_pool_header(const char* text) {
+    return (struct pooled_string*)(text - offsetof(struct pooled_string, text));
+}
+
+bool string_pool_reserve(struct string_pool* string_pool, uint32_t count);
+
+// Returns the number of characters of text the pool would store.
+static inline size_t string_pool_length(const char* text) {
+    size_t length = strlen(text);
+    return length > ENTERPRISE_STRING_LENGTH - 1 ? \
+    ENTERPRISE_STRING_LENGTH - 1 : length;
+}
+
+// Hint that text with the passed in hash is about to be interned, so that its
+// part of the hash table can be fetched from memory while other work is done.
+// Used when interning many strings at once, where waiting on memory for each
+// string in turn would dominate.
+static inline void string_pool_prefetch\
+(struct string_pool* string_pool, uint32_t hash) {
+    #if defined(__GNUC__)
+        if (string_pool->capacity == 0) return;
+        __builtin_prefetch\
+        (&string_pool->table[hash & (string_pool->capacity - 1)]);
+    #else
+        UNUSED(string_pool);
+        UNUSED(hash);
+    #endif
+}
+
+const char* string_pool_intern_hashed(struct string_pool* string_pool, \
+const char* text, size_t length, uint32_t hash);
+const char* string_pool_intern\
+(struct string_pool* string_pool, const char* text);
+void string_pool_release(struct string_pool* string_pool, const char* text);
+bool string_pool_assign\
+(struct string_pool* string_pool, const char** field, const char* text);
+void string_pool_retain(struct string_pool* string_pool, const char* text);
+void string_pool_retain_shared\
+(struct string_pool* string_pool, const char* text);
+uint32_t string_pool_get_slot\
+(struct string_pool* string_pool, const char* text);
+size_t string_pool_get_bytes_used(struct string_pool* string_pool);
@@ -9,118 +9,93 @@
 #include <limits.h>
 #include <time.h>
 
-#include "constants.c"
-
-#ifndef PROGRAM_STATES
-#define PROGRAM_STATES
-#include "program_states.c"
+// Import Nuklear, unless building without the GUI.
+#if !defined(ENTERPRISE_NUKLEAR_LIBRARY_IMPORT) \
+&& !defined(ENTERPRISE_HEADLESS)
+#define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
+#include "nuklear_import.h"
 #endif
 
-
-// Import Nuklear.
-#ifndef ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-#define ENTERPRISE_NUKLEAR_LIBRARY_IMPORT
-    #define NK_INCLUDE_FIXED_TYPES
-    #define NK_INCLUDE_STANDARD_IO
-    #define NK_INCLUDE_STANDARD_VARARGS
-    #define NK_INCLUDE_DEFAULT_ALLOCATOR
-    #define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
-    #define NK_INCLUDE_FONT_BAKING
-    #define NK_INCLUDE_DEFAULT_FONT
-    #define NK_IMPLEMENTATION
-    #define NK_SDL_GLES2_IMPLEMENTATION
-    #include "../third_party/Nuklear/nuklear.h"
-    #include "../third_party/Nuklear/demo/sdl_opengles2/nuklear_sdl_gles2.h"
-    #include "../third_party/Nuklear/demo/common/style.c"
+#ifndef ENTERPRISE_SUPPLIERS
+#define ENTERPRISE_SUPPLIERS
+#include "suppliers.h"
 #endif
 
-/* How suppliers work.
-suppliers are stored in a struct that contains a pointer to the head of a
-linked list containing all the suppliers. The struct that stores the linked
-list is directly added to the enterprise struct and stores metadata about the
-list. All suppliers are assigned a unique ID, no two suppliers can have the
-same ID, the supplier_list structure keeps track of that.
-
-Data structures:
-supplier_node: An individual supplier.
-supplier_list: A structure holding important metadata about the supplier
-linked list.
-
-supplier list metadata:
-supplier_list->id_last_assigned: This is incremented by 1 every time a new
-supplier is added in order to ensure no two suppliers ever have the same ID.
-
-supplier_list->id_currently_selected: This is the ID that is selected in the
-supplier editor dialogue.
-*/
-
-struct supplier_node {
-    char id[ENTERPRISE_STRING_LENGTH];
-    char name[ENTERPRISE_STRING_LENGTH];
-    char email[ENTERPRISE_STRING_LENGTH];
-    char phone[ENTERPRISE_STRING_LENGTH];
-    char address[ENTERPRISE_STRING_LENGTH];
-
-    struct supplier_node* prev;
-    struct supplier_node* next;
-};
-
-// supplier node constructor and initialiser.
+// Supplier node constructor and initialiser.
+// The node is added to the end of the passed in record store.
 // Returns supplier node on success, or NULL on failure.
-struct supplier_node *supplier_node_new() {
-    struct supplier_node* supplier = malloc(sizeof(struct supplier_node));
+struct supplier_node *supplier_node_new(struct record_store* store) {
+    struct supplier_node* supplier = record_store_append(store);
     if (supplier == NULL) return NULL;
-    strcpy(supplier->id, "");
-    strcpy(supplier->name, "");
-    strcpy(supplier->email, "");
-    strcpy(supplier->phone, "");
-    strcpy(supplier->address, "");
-
-    supplier->prev = NULL;
-    supplier->next = NULL;
+    supplier->id = ENTERPRISE_ID_NONE;
+    supplier->name = "";
+    supplier->email = "";
+    supplier->phone = "";
+    supplier->address = "";
 
     return supplier;
 }
 
-// supplier list metadata structure.
-struct supplier_list {
-    struct supplier_node *head;
-    char id_last_assigned[ENTERPRISE_STRING_LENGTH];
-    char id_currently_selected[ENTERPRISE_STRING_LENGTH];
-    bool deletion_requested;
-};
+// Free everything associated with a supplier and remove it from its store.
+void supplier_node_free(struct string_pool* string_pool,\
+struct record_store* store, struct supplier_node* supplier) {
+    if (supplier == NULL) return;
+    string_pool_release(string_pool, supplier->name);
+    string_pool_release(string_pool, supplier->email);
+    string_pool_release(string_pool, supplier->phone);
+    string_pool_release(string_pool, supplier->address);
+    record_store_remove(store, supplier);
+}
 
-// supplier list constructor.
+// Supplier list constructor.
 // Returns supplier list on success, or NULL on failure.
-struct supplier_list* supplier_list_new() {
+struct supplier_list* supplier_list_new(struct string_pool* string_pool) {
     struct supplier_list* supplier_list = malloc(sizeof(struct supplier_list));
     if (supplier_list == NULL) return NULL;
-    supplier_list->head = NULL;
-    strcpy(supplier_list->id_last_assigned, "0");
-    strcpy(supplier_list->id_currently_selected, "0");
+    record_store_init(&supplier_list->store, sizeof(struct supplier_node));
+    id_index_init(&supplier_list->id_index);
+    supplier_list->journal = NULL;
+    supplier_list->version = 0;
+    row_labels_init(&supplier_list->row_labels);
+    text_search_init(&supplier_list->search);
+    text_index_init(&supplier_list->text_index);
+    supplier_list->string_pool = string_pool;
+    supplier_list->edit_id = ENTERPRISE_ID_NONE;
+    strcpy(supplier_list->edit_name, "");
+    strcpy(supplier_list->edit_email, "");
+    strcpy(supplier_list->edit_phone, "");
+    strcpy(supplier_list->edit_address, "");
+    supplier_list->id_last_assigned = ENTERPRISE_ID_NONE;
+    supplier_list->id_currently_selected = ENTERPRISE_ID_NONE;
+    supplier_list->handle_currently_selected = RECORD_STORE_NONE;
     supplier_list->deletion_requested = false;
     return supplier_list;
 }
 
-// Free an entire supplier linked list
-void supplier_node_linked_list_free(struct supplier_node* supplier) {
-    if (supplier == NULL) return;
-    struct supplier_node* next = NULL;
-    while (supplier != NULL) {
-        next = supplier->next;
-        free(supplier);
-        supplier = next;
-    }
-}
-
 // Free all memory associated with a supplier list.
 void supplier_list_free(struct supplier_list* supplier_list) {
     if (supplier_list == NULL) return;
 
-    if (supplier_list->head != NULL) {
-        supplier_node_linked_list_free(supplier_list->head);
+    // Free every supplier, giving their text back to the string pool. There is
+    // nothing to give back if the pool is being dropped, and the record store
+    // frees every supplier at once.
+    if (string_pool_is_dropping(supplier_list->string_pool) == false) {
+        struct supplier_node* supplier = \
+        record_store_first(&supplier_list->store);
+        while (supplier != NULL) {
+            struct supplier_node* next = \
+            record_store_next(&supplier_list->store, supplier);
+            supplier_node_free(supplier_list->string_pool, \
+            &supplier_list->store, supplier);
+            supplier = next;
+        }
     }
 
+    row_labels_free(&supplier_list->row_labels);
+    text_search_free(&supplier_list->search);
+    text_index_free(&supplier_list->text_index);
+    id_index_free(&supplier_list->id_index);
+    record_store_free(&supplier_list->store);
     free(supplier_list);
     return;
 }
@@ -130,32 +105,26 @@ void supplier_list_append(struct supplier_list* supplier_list) {
     if (supplier_list == NULL) return;
 
     // Increment unique ID by 1.
-    char buffer[ENTERPRISE_STRING_LENGTH];
-    sprintf(buffer, "%lld", atoll(supplier_list->id_last_assigned) + 1);
-    strcpy(supplier_list->id_last_assigned, buffer);
-
-    // Add new node to start of supplier list if supplier linked list does
-    // not exist.
-    if (supplier_list->head == NULL) {
-        supplier_list->head = supplier_node_new();
-        strcpy(supplier_list->head->id, supplier_list->id_last_assigned);
-        strcpy(supplier_list->id_currently_selected,
-        supplier_list->id_last_assigned);
+    supplier_list->id_last_assigned++;
+
+    // Add the new node to the end of the list.
+    struct supplier_node* supplier = supplier_node_new(&supplier_list->store);
+    if (supplier == NULL) return;
+
+    supplier->id = supplier_list->id_last_assigned;
+
+    // Index the new node by its ID so it can be found without a search.
+    if (id_index_insert(&supplier_list->id_index, supplier->id, \
+    record_store_handle(supplier)) == false) {
+        record_store_remove(&supplier_list->store, supplier);
         return;
     }
 
-    // Else add the new node to the end of the list.
-    struct supplier_node* supplier = supplier_list->head;
-    while (supplier->next != NULL) {
-        supplier = supplier->next;
-    }
-    
-    supplier->next = supplier_node_new();
-    supplier->next->prev = supplier;
+    supplier_list->id_currently_selected = supplier_list->id_last_assigned;
 
-    strcpy(supplier->next->id, supplier_list->id_last_assigned);
-    strcpy(supplier_list->id_currently_selected,
-    supplier_list->id_last_assigned);
+    supplier_list->version++;
+    journal_put(supplier_list->journal, journal_list_suppliers, \
+    ENTERPRISE_ID_NONE, supplier->id);
 
     return;
 }
@@ -163,151 +132,226 @@ void supplier_list_append(struct supplier_list* supplier_list) {
 // Get the number of supplier nodes in the supplier list
 int supplier_list_get_num_supplier_nodes(struct supplier_list* supplier_list) {
     if (supplier_list == NULL) return 0;
-    if (supplier_list->head == NULL) return 0;
+    return (int)supplier_list->store.count;
+}
 
-    struct supplier_node* supplier = supplier_list->head;
-    int supplier_count = 0;
-    while (supplier != NULL) {
-        supplier_count++;
-        supplier = supplier->next;
-    }
-    return supplier_count;
+// Make room in a supplier list and its ID index for count more suppliers.
+// Returns true on success, or false on failure.
+bool supplier_list_reserve(struct supplier_list* supplier_list, \
+uint32_t count) {
+    if (supplier_list == NULL) return false;
+    return record_store_reserve(&supplier_list->store, count) \
+    && id_index_reserve(&supplier_list->id_index, count);
 }
 
 // Return a pointer to a supplier node according to ID.
 // Returns NULL on failure.
 struct supplier_node *supplier_list_get_node\
-(struct supplier_list *supplier_list, char *id) {
-    if (supplier_list == NULL || id == NULL) return NULL;
-    if (supplier_list->head == NULL) return NULL;
+(struct supplier_list *supplier_list, enterprise_id id) {
+    if (supplier_list == NULL) return NULL;
+    return record_store_get\
+    (&supplier_list->store, id_index_find(&supplier_list->id_index, id));
+}
 
-    struct supplier_node* supplier = supplier_list->head;
-    while (supplier != NULL) {
-        if (strcmp(supplier->id, id) == 0) return supplier;
-        supplier = supplier->next;
+// Return a pointer to the currently selected supplier node.
+// The selected supplier's handle is checked before its ID is looked up, so this
+// only searches the ID index after the selection was changed by ID.
+// Returns NULL if no supplier is selected.
+struct supplier_node *supplier_list_get_selected_node\
+(struct supplier_list *supplier_list) {
+    if (supplier_list == NULL) return NULL;
+
+    struct supplier_node* supplier = record_store_get\
+    (&supplier_list->store, supplier_list->handle_currently_selected);
+    if (supplier == NULL \
+    || supplier->id != supplier_list->id_currently_selected) {
+        supplier = supplier_list_get_node\
+        (supplier_list, supplier_list->id_currently_selected);
+        supplier_list->handle_currently_selected = \
+        record_store_handle(supplier);
     }
-    return NULL;
+    return supplier;
 }
 
 // Searches for a supplier by ID and deletes it
-void supplier_list_delete_node(struct supplier_list *supplier_list, char *id) {
-    if (supplier_list == NULL || id == NULL) return;
-    if (supplier_list->head == NULL) return;
-
-    // Delete the head if it is the ID that is requested to be deleted.
-    if (strcmp(id, supplier_list->head->id) == 0) {
-        if (supplier_list->head->next == NULL) {
-            free(supplier_list->head);
-            supplier_list->head = NULL;
-            return;
-        }
-
-        struct supplier_node *next = supplier_list->head->next;
-        free(supplier_list->head);
-        supplier_list->head = next;
-        return;
-    }
+void supplier_list_delete_node\
+(struct supplier_list *supplier_list, enterprise_id id) {
+    if (supplier_list == NULL) return;
 
-    // Else search for the supplier to delete.
-    struct supplier_node* supplier = supplier_list->head;
-    while (supplier != NULL) {
-        if (strcmp(supplier->id, id) == 0) break;
-        supplier = supplier->next;
-    }
+    struct supplier_node* supplier = supplier_list_get_node(supplier_list, id);
     if (supplier == NULL) return;
 
-    // Fix the pointers of the next and previous nodes to the supplier to be
-    // deleted in order to ensure that traversal still works.
-
-    struct supplier_node* prev = supplier->prev;
-    struct supplier_node* next = supplier->next;
-
-    if (prev != NULL) {
-        if (next == NULL) {
-            prev->next = NULL;
-            strcpy(supplier_list->id_currently_selected, prev->id);
-        }
-        if (next != NULL) {
-            prev->next = next;
-            next->prev = prev;
-            strcpy(supplier_list->id_currently_selected, next->id);
-        }
+    // Select the node after the deleted supplier, or the node before it if the
+    // deleted supplier is the last one.
+    struct supplier_node* prev = record_store_prev(&supplier_list->store, supplier);
+    struct supplier_node* next = record_store_next(&supplier_list->store, supplier);
+    if (next != NULL) {
+        supplier_list->id_currently_selected = next->id;
     }
-
-    if (prev == NULL) {
-        if (next != NULL) {
-            next->prev = NULL;
-            strcpy(supplier_list->id_currently_selected, next->id);
-        }
+    else if (prev != NULL) {
+        supplier_list->id_currently_selected = prev->id;
     }
 
+    supplier_list->version++;
+    journal_delete(supplier_list->journal, journal_list_suppliers, \
+    ENTERPRISE_ID_NONE, supplier->id);
+
     // Delete the supplier
-    free(supplier);
+    id_index_remove(&supplier_list->id_index, supplier->id);
+    supplier_node_free(supplier_list->string_pool, \
+    &supplier_list->store, supplier);
     return;
 }
 
 // Select the previous node as the currently selected item.
 void supplier_list_select_previous_node(struct supplier_list *supplier_list) {
     if (supplier_list == NULL) return;
-    if (supplier_list->head == NULL) return;
 
-    struct supplier_node* supplier = supplier_list->head;
-    while (supplier != NULL) {
-        if (strcmp(supplier->id, supplier_list->id_currently_selected) == 0) {
-            if (supplier->prev != NULL) {
-                strcpy(supplier_list->id_currently_selected, supplier->prev->id);
-                return;
-            }
-            if (supplier->prev == NULL) {
-                struct supplier_node* temp = supplier;
-                while (temp->next != NULL) {
-                    temp = temp->next;
-                }
-                strcpy(supplier_list->id_currently_selected, temp->id);
-                return;
-            }
-        }
-        supplier = supplier->next;
-    }
+    struct supplier_node* supplier = \
+    supplier_list_get_selected_node(supplier_list);
+    if (supplier == NULL) return;
+
+    // Wrap around to the last supplier if the first one is selected.
+    struct supplier_node* prev = record_store_prev(&supplier_list->store, supplier);
+    if (prev == NULL) prev = record_store_last(&supplier_list->store);
+    supplier_list->id_currently_selected = prev->id;
+    supplier_list->handle_currently_selected = record_store_handle(prev);
 }
 
 // Select the next node as the currently selected item.
 void supplier_list_select_next_node(struct supplier_list *supplier_list) {
     if (supplier_list == NULL) return;
-    if (supplier_list->head == NULL) return;
 
-    struct supplier_node* supplier = supplier_list->head;
-    while (supplier != NULL) {
-        if (strcmp(supplier->id, supplier_list->id_currently_selected) == 0) {
-            if (supplier->next != NULL) {
-                strcpy(supplier_list->id_currently_selected, supplier->next->id);
-                return;
-            }
-            if (supplier->next == NULL) {
-                strcpy(supplier_list->id_currently_selected,\
-                supplier_list->head->id);
-                return;
-            }
-        }
-        supplier = supplier->next;
-    }
+    struct supplier_node* supplier = \
+    supplier_list_get_selected_node(supplier_list);
+    if (supplier == NULL) return;
+
+    // Wrap around to the first supplier if the last one is selected.
+    struct supplier_node* next = record_store_next(&supplier_list->store, supplier);
+    if (next == NULL) next = record_store_first(&supplier_list->store);
+    supplier_list->id_currently_selected = next->id;
+    supplier_list->handle_currently_selected = record_store_handle(next);
 }
 
 // Change the currently selected ID to the passed in ID in the supplier list.
 void supplier_list_set_selected_id\
-(struct supplier_list *supplier_list, char* id) {
-    if (supplier_list == NULL || id == NULL) return;
-    if (supplier_list->head == NULL) return;
+(struct supplier_list *supplier_list, enterprise_id id) {
+    if (supplier_list == NULL) return;
 
-    struct supplier_node* supplier = supplier_list->head;
+    if (supplier_list_get_node(supplier_list, id) != NULL) {
+        supplier_list->id_currently_selected = id;
+    }
+}
+
+// Add the text of a supplier to the list's search index, after it was added
+// or edited. Does nothing until the list is first searched.
+void supplier_list_index_node(struct supplier_list* supplier_list, \
+struct supplier_node* supplier) {
+    if (supplier_list == NULL || supplier == NULL) return;
+    struct text_index* index = &supplier_list->text_index;
+    if (index->built == false) return;
+
+    uint32_t handle = record_store_handle(supplier);
+    if (text_index_add(index, handle, supplier->name) == false || \
+    text_index_add(index, handle, supplier->email) == false || \
+    text_index_add(index, handle, supplier->phone) == false || \
+    text_index_add(index, handle, supplier->address) == false) {
+        // Build the index again on the next search rather than miss matches.
+        index->built = false;
+    }
+}
+
+// Returns true if a supplier's name, email, phone or address contain query,
+// ignoring case.
+bool supplier_node_matches(struct supplier_node* supplier, const char* query) {
+    return text_index_contains(supplier->name, query) || \
+    text_index_contains(supplier->email, query) || \
+    text_index_contains(supplier->phone, query) || \
+    text_index_contains(supplier->address, query);
+}
+
+// Search the suppliers for the text in the list's search box, and keep the IDs
+// of the suppliers whose name, email, phone or address contain it.
+// Returns true on success, or false on failure.
+bool supplier_list_search(struct supplier_list* supplier_list) {
+    if (supplier_list == NULL) return false;
+    struct text_search* search = &supplier_list->search;
+    text_search_begin(search, supplier_list->version);
+    row_labels_invalidate(&supplier_list->row_labels);
+    if (search->active == false) return true;
+
+    // Build the index from every supplier the first time the list is searched.
+    struct text_index* index = &supplier_list->text_index;
+    if (text_index_due(index)) {
+        text_index_clear(index);
+        index->built = true;
+        struct supplier_node* supplier = \
+        record_store_first(&supplier_list->store);
+        while (supplier != NULL && index->built) {
+            supplier_list_index_node(supplier_list, supplier);
+            supplier = record_store_next(&supplier_list->store, supplier);
+        }
+        if (index->built) text_index_finish(index);
+    }
+
+    // Only check the suppliers that hold the rarest trigram of the search.
+    const uint32_t* candidates = NULL;
+    uint32_t candidate_count = 0;
+    if (index->built && text_index_candidates(index, search->query, \
+    &candidates, &candidate_count)) {
+        for (uint32_t candidate = 0; candidate < candidate_count; \
+        candidate++) {
+            struct supplier_node* supplier = \
+            record_store_get(&supplier_list->store, candidates[candidate]);
+            if (supplier == NULL || \
+            supplier_node_matches(supplier, search->query) == false) continue;
+            if (text_search_add(search, supplier->id) == false) return false;
+        }
+        text_search_finish(search);
+        return true;
+    }
+
+    // Short searches, or searches without an index, check every supplier.
+    struct supplier_node* supplier = record_store_first(&supplier_list->store);
     while (supplier != NULL) {
-        if (strcmp(supplier->id, id) == 0) {
-            strcpy(supplier_list->id_currently_selected, id);
+        if (supplier_node_matches(supplier, search->query) && \
+        text_search_add(search, supplier->id) == false) return false;
+        supplier = record_store_next(&supplier_list->store, supplier);
+    }
+    return true;
+}
+
+// Make the labels of row_count rows of the supplier table, starting at
+// first_row, unless they are cached already.
+void supplier_list_label_rows(struct supplier_list* supplier_list, \
+uint32_t first_row, uint32_t row_count) {
+    if (supplier_list == NULL) return;
+    struct row_labels* labels = &supplier_list->row_labels;
+    if (row_labels_current(labels, supplier_list->version, first_row, \
+    row_count)) return;
+
+    // While searching, the rows are the matches of the search.
+    row_labels_begin(labels, supplier_list->version, first_row, row_count);
+    struct text_search* search = &supplier_list->search;
+    struct supplier_node* supplier = search->active \
+    ? supplier_list_get_node(supplier_list, text_search_id(search, first_row)) \
+    : record_store_seek(&supplier_list->store, first_row);
+    for (uint32_t row = 0; row < row_count && supplier != NULL; row++) {
+        if (row_labels_add(labels, supplier->id, \
+        "ID: %lld Name: %s Email: %s Phone: %s Address: %s",\
+        supplier->id, supplier->name, supplier->email, \
+        supplier->phone, supplier->address) == false) break;
+        if (search->active) {
+            supplier = supplier_list_get_node\
+            (supplier_list, text_search_id(search, first_row + row + 1));
         }
-        supplier = supplier->next;
+        else supplier = record_store_next(&supplier_list->store, supplier);
     }
 }
 
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+
 // Render the supplier table GUI.
 // This function displays a list of suppliers as a table that can be selected.
 // It is an overview.
@@ -330,31 +374,51 @@ struct supplier_list* supplier_list) {
     }
 
     // If there are no suppliers, warn the user.
-    if (supplier_list->head == NULL) {
+    if (record_store_first(&supplier_list->store) == NULL) {
         nk_label(ctx, "No Suppliers found.", NK_TEXT_CENTERED);
         return program_status_supplier_table;
     }
 
-    /* If there are suppliers, go through the linked list of suppliers.
-    Copy the data from each supplier and make it a button label.
-    When the button is pressed, set the currently selected supplier to that
-    supplier and switch to supplier editor.*/
-    struct supplier_node* supplier = supplier_list->head;
-    char* print_buffer = malloc(sizeof(char) * ENTERPRISE_STRING_LENGTH * 10);
-    while (supplier != NULL) {
-        sprintf(print_buffer, \
-        "ID: %s Name: %s Email: %s Phone: %s Address: %s",supplier->id,\
-        supplier->name, supplier->email, supplier->phone, supplier->address);
+    // Search box. While it holds text, only the matching suppliers are listed.
+    nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
+    supplier_list->search.query, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    if (text_search_due(&supplier_list->search, supplier_list->version)) {
+        supplier_list_search(supplier_list);
+    }
+    if (supplier_list->search.active && supplier_list->search.count == 0) {
+        nk_label(ctx, "No suppliers match the search.", NK_TEXT_CENTERED);
+        return program_status_supplier_table;
+    }
 
-        if (nk_button_label(ctx, print_buffer)) {
-            strcpy(supplier_list->id_currently_selected, supplier->id);
-            free(print_buffer);
-            return program_status_supplier_editor;
+    /* If there are suppliers, make a button for each supplier in view.
+    Only the rows scrolled into view are drawn, and their labels are only
+    formatted again when different rows come into view or the list changes.
+    When a button is pressed, set the currently selected supplier to that
+    supplier and switch to supplier editor.*/
+    enum program_status status = program_status_supplier_table;
+    struct nk_list_view view;
+    uint32_t row_total = supplier_list->search.active \
+    ? supplier_list->search.count : supplier_list->store.count;
+    int rows = row_total > INT_MAX ? INT_MAX : (int)row_total;
+    nk_layout_row_dynamic(ctx, \
+    ENTERPRISE_TABLE_HEIGHT - ENTERPRISE_WIDGET_HEIGHT, 1);
+    if (nk_list_view_begin(ctx, &view, "supplier_table", \
+    NK_WINDOW_BORDER, ENTERPRISE_WIDGET_HEIGHT, rows)) {
+        nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 1);
+        struct row_labels* labels = &supplier_list->row_labels;
+        supplier_list_label_rows(supplier_list, \
+        (uint32_t)view.begin, (uint32_t)view.count);
+
+        for (uint32_t row = 0; row < labels->count; row++) {
+            if (nk_button_label(ctx, row_labels_text(labels, row))) {
+                supplier_list_set_selected_id\
+                (supplier_list, row_labels_id(labels, row));
+                status = program_status_supplier_editor;
+            }
         }
-        supplier = supplier->next;
+        nk_list_view_end(&view);
     }
-    free(print_buffer);
-    return program_status_supplier_table;
+    return status;
 }
 
 // Render the supplier editor GUI.
@@ -372,14 +436,15 @@ struct supplier_list* supplier_list) {
     nk_label(ctx, "Supplier Editor", NK_TEXT_CENTERED);
     
     // Select currently selected supplier.
-    struct supplier_node* supplier = supplier_list_get_node\
-    (supplier_list, supplier_list->id_currently_selected);
+    struct supplier_node* supplier = \
+    supplier_list_get_selected_node(supplier_list);
 
     // If the currently selected supplier does not exist:
     if (supplier == NULL) {
         // Select the first supplier instead.
-        if (supplier_list->head != NULL) {
-            strcpy(supplier_list->id_currently_selected, supplier_list->head->id);
+        supplier = record_store_first(&supplier_list->store);
+        if (supplier != NULL) {
+            supplier_list->id_currently_selected = supplier->id;
             return program_status_supplier_editor;
         }
 
@@ -394,31 +459,59 @@ struct supplier_list* supplier_list) {
         }
     }
 
+    // Copy the selected supplier's text into the edit buffers whenever a
+    // different supplier is selected.
+    if (supplier_list->edit_id != supplier->id) {
+        supplier_list->edit_id = supplier->id;
+        strcpy(supplier_list->edit_name, supplier->name);
+        strcpy(supplier_list->edit_email, supplier->email);
+        strcpy(supplier_list->edit_phone, supplier->phone);
+        strcpy(supplier_list->edit_address, supplier->address);
+    }
+
     // Display edit fields to edit supplier entries.
     nk_layout_row_template_begin(ctx, ENTERPRISE_WIDGET_HEIGHT);
     nk_layout_row_template_push_static(ctx, 150);
     nk_layout_row_template_push_dynamic(ctx);
     nk_layout_row_template_end(ctx);
 
+    char id_text[ENTERPRISE_ID_TEXT_LENGTH];
+    enterprise_id_format(supplier->id, id_text);
     nk_label(ctx, "ID: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_READ_ONLY, \
-    supplier->id, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    id_text, ENTERPRISE_ID_TEXT_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Name: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    supplier->name, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    supplier_list->edit_name, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Phone: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    supplier->phone, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    supplier_list->edit_phone, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Email: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    supplier->email, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    supplier_list->edit_email, ENTERPRISE_STRING_LENGTH, nk_filter_default);
 
     nk_label(ctx, "Address: ", NK_TEXT_LEFT);
     nk_edit_string_zero_terminated(ctx, NK_EDIT_FIELD, \
-    supplier->address, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+    supplier_list->edit_address, ENTERPRISE_STRING_LENGTH, nk_filter_default);
+
+    // Store any edits back into the supplier, and note them in the journal.
+    bool edited = string_pool_assign(supplier_list->string_pool, \
+    &supplier->name, supplier_list->edit_name);
+    edited |= string_pool_assign(supplier_list->string_pool, \
+    &supplier->email, supplier_list->edit_email);
+    edited |= string_pool_assign(supplier_list->string_pool, \
+    &supplier->phone, supplier_list->edit_phone);
+    edited |= string_pool_assign(supplier_list->string_pool, \
+    &supplier->address, supplier_list->edit_address);
+    if (edited) {
+        supplier_list->version++;
+        supplier_list_index_node(supplier_list, supplier);
+        journal_put(supplier_list->journal, journal_list_suppliers, \
+        ENTERPRISE_ID_NONE, supplier->id);
+    }
 
     // Move between next and previous suppliers.
     nk_layout_row_dynamic(ctx, ENTERPRISE_WIDGET_HEIGHT, 2);
@@ -458,4 +551,6 @@ struct supplier_list* supplier_list) {
     }
     
     return program_status_supplier_editor;
-}
\ No newline at end of file
+}
+
+#endif
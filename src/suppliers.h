@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_RECORD_STORE
+#define ENTERPRISE_RECORD_STORE
+#include "record_store.h"
+#endif
+
+#ifndef ENTERPRISE_STRING_POOL
+#define ENTERPRISE_STRING_POOL
+#include "string_pool.h"
+#endif
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+#ifndef ENTERPRISE_ID_INDEX
+#define ENTERPRISE_ID_INDEX
+#include "id_index.h"
+#endif
+
+#ifndef ENTERPRISE_JOURNAL
+#define ENTERPRISE_JOURNAL
+#include "journal.h"
+#endif
+
+#ifndef ENTERPRISE_ROW_LABELS
+#define ENTERPRISE_ROW_LABELS
+#include "row_labels.h"
+#endif
+
+#ifndef ENTERPRISE_TEXT_INDEX
+#define ENTERPRISE_TEXT_INDEX
+#include "text_index.h"
+#endif
+
+#ifndef PROGRAM_STATES
+#define PROGRAM_STATES
+#include "program_states.h"
+#endif
+
+// Nuklear's context, taken by the GUI functions. Only the sources of
+// those functions import Nuklear itself.
+struct nk_context;
+
+/* How suppliers work.
+A supplier has a name and contact details. Orders can come from suppliers, and
+expenses can be paid to them. The supplier list is laid out like every other
+list of the enterprise (see record_store.c). Its table can be searched by
+name, email, phone and address through a trigram index (see text_index.c).
+
+Data structures:
+supplier_node: A supplier.
+supplier_list: The suppliers of the enterprise.
+*/
+
+struct supplier_node {
+    enterprise_id id;
+    const char* name;
+    const char* email;
+    const char* phone;
+    const char* address;
+};
+
+// Supplier list metadata structure.
+struct supplier_list {
+    struct record_store store;
+    struct id_index id_index;
+    struct string_pool* string_pool;
+
+    // Where changes to the list are recorded, or NULL if they are not.
+    struct journal* journal;
+
+    // Bumped whenever a node is appended, edited or deleted, so that the
+    // labels cached for the list's table know when they are stale.
+    uint64_t version;
+    struct row_labels row_labels;
+
+    // The search box of the list's table, and the index used to search it.
+    struct text_search search;
+    struct text_index text_index;
+
+    // Editable copies of the text of the node open in the editor.
+    enterprise_id edit_id;
+    char edit_name[ENTERPRISE_STRING_LENGTH];
+    char edit_email[ENTERPRISE_STRING_LENGTH];
+    char edit_phone[ENTERPRISE_STRING_LENGTH];
+    char edit_address[ENTERPRISE_STRING_LENGTH];
+
+    enterprise_id id_last_assigned;
+    enterprise_id id_currently_selected;
+    uint32_t handle_currently_selected;
+    bool deletion_requested;
+};
+
+struct supplier_node *supplier_node_new(struct record_store* store);
+void supplier_node_free(struct string_pool* string_pool,\
+struct record_store* store, struct supplier_node* supplier);
+struct supplier_list* supplier_list_new(struct string_pool* string_pool);
+void supplier_list_free(struct supplier_list* supplier_list);
+void supplier_list_append(struct supplier_list* supplier_list);
+int supplier_list_get_num_supplier_nodes(struct supplier_list* supplier_list);
+bool supplier_list_reserve(struct supplier_list* supplier_list, \
+uint32_t count);
+struct supplier_node *supplier_list_get_node\
+(struct supplier_list *supplier_list, enterprise_id id);
+struct supplier_node *supplier_list_get_selected_node\
+(struct supplier_list *supplier_list);
+void supplier_list_delete_node\
+(struct supplier_list *supplier_list, enterprise_id id);
+void supplier_list_select_previous_node(struct supplier_list *supplier_list);
+void supplier_list_select_next_node(struct supplier_list *supplier_list);
+void supplier_list_set_selected_id\
+(struct supplier_list *supplier_list, enterprise_id id);
+void supplier_list_index_node(struct supplier_list* supplier_list, \
+struct supplier_node* supplier);
+bool supplier_node_matches(struct supplier_node* supplier, const char* query);
+bool supplier_list_search(struct supplier_list* supplier_list);
+void supplier_list_label_rows(struct supplier_list* supplier_list, \
+uint32_t first_row, uint32_t row_count);
+
+// The GUI is left out of headless builds.
+#ifndef ENTERPRISE_HEADLESS
+enum program_status supplier_table(struct nk_context* ctx,\
+struct supplier_list* supplier_list);
+enum program_status supplier_editor(struct nk_context* ctx,\
+struct supplier_list* supplier_list);
+#endif
@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ENTERPRISE_TEXT_INDEX
+#define ENTERPRISE_TEXT_INDEX
+#include "text_index.h"
+#endif
+
+// Initialise an empty trigram index.
+void text_index_init(struct text_index* index) {
+    if (index == NULL) return;
+    memset(index, 0, sizeof(struct text_index));
+}
+
+// Free all memory associated with a trigram index.
+// The index is left empty and unbuilt, and can be reused.
+void text_index_free(struct text_index* index) {
+    if (index == NULL) return;
+    for (uint32_t slot = 0; slot < index->capacity; slot++) {
+        free(index->entries[slot].handles);
+    }
+    free(index->entries);
+    text_index_init(index);
+}
+
+// Returns an ASCII letter in lower case, and any other byte as it is.
+static inline unsigned char text_index_fold(unsigned char character) {
+    if (character >= 'A' && character <= 'Z') return character - 'A' + 'a';
+    return character;
+}
+
+// Returns the trigram starting at text, which must hold at least three bytes.
+static inline uint32_t text_index_trigram(const char* text) {
+    return (uint32_t)text_index_fold((unsigned char)text[0]) << 16 \
+    | (uint32_t)text_index_fold((unsigned char)text[1]) << 8 \
+    | (uint32_t)text_index_fold((unsigned char)text[2]);
+}
+
+// Returns the slot of the index holding a trigram, or the empty slot where it
+// would go. The index must have a capacity.
+static inline uint32_t text_index_slot(struct text_index* index, \
+uint32_t trigram) {
+    uint32_t mask = index->capacity - 1;
+    uint32_t slot = (trigram * 2654435761u) & mask;
+    while (index->entries[slot].trigram != 0 && \
+    index->entries[slot].trigram != trigram) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// Double the size of the index's hash table.
+// Returns true on success, or false on failure.
+static bool text_index_grow(struct text_index* index) {
+    struct text_index_entry* old_entries = index->entries;
+    uint32_t old_capacity = index->capacity;
+    uint32_t capacity = old_capacity == 0 ? \
+    TEXT_INDEX_MIN_CAPACITY : old_capacity * 2;
+
+    index->entries = calloc(capacity, sizeof(struct text_index_entry));
+    if (index->entries == NULL) {
+        index->entries = old_entries;
+        return false;
+    }
+    index->capacity = capacity;
+    for (uint32_t slot = 0; slot < old_capacity; slot++) {
+        if (old_entries[slot].trigram == 0) continue;
+        index->entries[text_index_slot(index, old_entries[slot].trigram)] = \
+        old_entries[slot];
+    }
+    free(old_entries);
+    return true;
+}
+
+// Note that the record with the given handle has a field containing text.
+// Returns true on success, or false on failure.
+bool text_index_add(struct text_index* index, uint32_t handle, \
+const char* text) {
+    if (index == NULL || text == NULL) return false;
+    size_t length = strlen(text);
+    for (size_t start = 0; start + TEXT_INDEX_TRIGRAM_LENGTH <= length; \
+    start++) {
+        uint32_t trigram = text_index_trigram(text + start);
+        if ((index->count + 1) * 2 > index->capacity) {
+            if (text_index_grow(index) == false) return false;
+        }
+        struct text_index_entry* entry = \
+        &index->entries[text_index_slot(index, trigram)];
+        if (entry->trigram == 0) {
+            entry->trigram = trigram;
+            index->count++;
+        }
+
+        // Fields are added one record at a time, so a record that already
+        // holds this trigram is the last one under it.
+        if (entry->count > 0 && entry->handles[entry->count - 1] == handle) {
+            continue;
+        }
+        if (entry->count == entry->capacity) {
+            uint32_t capacity = entry->capacity == 0 ? \
+            TEXT_INDEX_FIRST_HANDLES : entry->capacity * 2;
+            uint32_t* handles = \
+            realloc(entry->handles, sizeof(uint32_t) * capacity);
+            if (handles == NULL) return false;
+            entry->handles = handles;
+            entry->capacity = capacity;
+        }
+        entry->handles[entry->count++] = handle;
+        index->handles++;
+    }
+    return true;
+}
+
+// Empty the index so that it can be built again.
+void text_index_clear(struct text_index* index) {
+    if (index == NULL) return;
+    for (uint32_t slot = 0; slot < index->capacity; slot++) {
+        index->entries[slot].count = 0;
+    }
+    index->handles = 0;
+    index->built = false;
+}
+
+// Mark the index as holding every record of its list.
+void text_index_finish(struct text_index* index) {
+    if (index == NULL) return;
+    index->built = true;
+    index->built_handles = index->handles;
+}
+
+// Returns true if the index must be built before it can be searched, because
+// it has never been built or is mostly made up of stale handles.
+bool text_index_due(struct text_index* index) {
+    if (index == NULL) return false;
+    return index->built == false || index->handles > index->built_handles * 2;
+}
+
+// Find the records that may contain query. On success candidates points at
+// the handles of those records and candidate_count holds how many there are,
+// which may include stale and repeated handles.
+// Returns false if the query is too short to look up, in which case every
+// record must be checked instead.
+bool text_index_candidates(struct text_index* index, const char* query, \
+const uint32_t** candidates, uint32_t* candidate_count) {
+    *candidates = NULL;
+    *candidate_count = 0;
+    if (index == NULL || query == NULL) return false;
+    size_t length = strlen(query);
+    if (length < TEXT_INDEX_TRIGRAM_LENGTH) return false;
+    if (index->capacity == 0) return true;
+
+    // Every match holds every trigram of the query, so checking the records
+    // holding its rarest trigram is enough.
+    struct text_index_entry* rarest = NULL;
+    for (size_t start = 0; start + TEXT_INDEX_TRIGRAM_LENGTH <= length; \
+    start++) {
+        struct text_index_entry* entry = &index->entries\
+        [text_index_slot(index, text_index_trigram(query + start))];
+        if (entry->trigram == 0 || entry->count == 0) return true;
+        if (rarest == NULL || entry->count < rarest->count) rarest = entry;
+    }
+    *candidates = rarest->handles;
+    *candidate_count = rarest->count;
+    return true;
+}
+
+// Returns true if text contains query, ignoring the case of ASCII letters.
+bool text_index_contains(const char* text, const char* query) {
+    if (text == NULL || query == NULL) return false;
+    if (query[0] == '\0') return true;
+    unsigned char first = text_index_fold((unsigned char)query[0]);
+    for (; *text != '\0'; text++) {
+        if (text_index_fold((unsigned char)*text) != first) continue;
+        size_t character = 1;
+        while (query[character] != '\0' && \
+        text_index_fold((unsigned char)text[character]) == \
+        text_index_fold((unsigned char)query[character])) {
+            character++;
+        }
+        if (query[character] == '\0') return true;
+    }
+    return false;
+}
+
+// Initialise a text search with an empty search box.
+void text_search_init(struct text_search* search) {
+    if (search == NULL) return;
+    memset(search, 0, sizeof(struct text_search));
+}
+
+// Free all memory associated with a text search.
+void text_search_free(struct text_search* search) {
+    if (search == NULL) return;
+    free(search->ids);
+    text_search_init(search);
+}
+
+// Returns true if the text in the search box or the list at the given version
+// differ from what was last searched.
+bool text_search_due(struct text_search* search, uint64_t version) {
+    if (search == NULL) return false;
+    if (strcmp(search->query, search->searched) != 0) return true;
+    return search->active && search->version != version;
+}
+
+// Start a new search for the text in the search box, in the list at the given
+// version, with no matches yet.
+void text_search_begin(struct text_search* search, uint64_t version) {
+    if (search == NULL) return;
+    strcpy(search->searched, search->query);
+    search->active = search->query[0] != '\0';
+    search->version = version;
+    search->count = 0;
+}
+
+// Add the ID of a matching record to a search.
+// Returns true on success, or false on failure.
+bool text_search_add(struct text_search* search, enterprise_id id) {
+    if (search == NULL) return false;
+    if (search->count == search->capacity) {
+        uint32_t capacity = search->capacity == 0 ? \
+        TEXT_SEARCH_FIRST_CAPACITY : search->capacity * 2;
+        enterprise_id* ids = \
+        realloc(search->ids, sizeof(enterprise_id) * capacity);
+        if (ids == NULL) return false;
+        search->ids = ids;
+        search->capacity = capacity;
+    }
+    search->ids[search->count++] = id;
+    return true;
+}
+
+// Compare two IDs for sorting.
+static int text_search_compare(const void* a, const void* b) {
+    enterprise_id id_a = *(const enterprise_id*)a;
+    enterprise_id id_b = *(const enterprise_id*)b;
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+// Put the matches of a search found through the index into list order, and
+// drop repeated matches. IDs only ever grow as records are appended, so the
+// order of IDs is the order of the list.
+void text_search_finish(struct text_search* search) {
+    if (search == NULL || search->count == 0) return;
+    qsort(search->ids, search->count, sizeof(enterprise_id), \
+    text_search_compare);
+    uint32_t kept = 1;
+    for (uint32_t match = 1; match < search->count; match++) {
+        if (search->ids[match] != search->ids[kept - 1]) {
+            search->ids[kept++] = search->ids[match];
+        }
+    }
+    search->count = kept;
+}
+
+// Returns the ID of the match at the given row of a search, or
+// ENTERPRISE_ID_NONE if there is no such match.
+enterprise_id text_search_id(struct text_search* search, uint32_t row) {
+    if (search == NULL || row >= search->count) return ENTERPRISE_ID_NONE;
+    return search->ids[row];
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "constants.h"
+
+#ifndef ENTERPRISE_IDS
+#define ENTERPRISE_IDS
+#include "enterprise_id.h"
+#endif
+
+/* How text search works.
+The customer, supplier and employee tables have a search box that lists only
+the records whose name, email, phone number or address contain the text typed
+in, ignoring case. Checking every record on every keystroke is too slow for
+large lists, so each of those lists keeps a trigram index of its text.
+
+A trigram is three bytes in a row of a field, with ASCII letters folded to
+lower case. The index maps every trigram to the handles (see record_store.c)
+of the records with a field containing it. Any record containing the searched
+text contains all of its trigrams, so only the records under the search's
+rarest trigram need to be checked against the text. Searches shorter than a
+trigram check every record instead.
+
+The index is built the first time a list is searched, and then kept up to date
+by indexing a record's text again whenever it is edited. Handles are never
+taken out of the index: edits and deletions leave stale handles behind, which
+are weeded out by checking every candidate against the text. Once stale
+handles make up over half of the index it is built again from scratch.
+
+The matches of a search are kept in a text search as IDs in list order, so
+that the table can show them like the rows of the whole list.
+
+Data structures:
+text_index_entry: The handles of the records containing one trigram.
+text_index: The trigram index of one list.
+text_search: The text being searched for in a list and its matches.
+*/
+
+#define TEXT_INDEX_MIN_CAPACITY 1024
+#define TEXT_INDEX_FIRST_HANDLES 4
+#define TEXT_INDEX_TRIGRAM_LENGTH 3
+#define TEXT_SEARCH_FIRST_CAPACITY 64
+
+// The handles of the records with a field containing a trigram. Empty slots of
+// the index have a trigram of 0, which no text contains.
+struct text_index_entry {
+    uint32_t trigram;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t* handles;
+};
+
+// Trigram index structure.
+struct text_index {
+    bool built;
+
+    // Open addressing hash table of every trigram in the index.
+    struct text_index_entry* entries;
+    uint32_t capacity;
+    uint32_t count;
+
+    // Handles in the index, and how many there were when it was built.
+    uint64_t handles;
+    uint64_t built_handles;
+};
+
+// Text search structure.
+struct text_search {
+    // The text typed into the search box, and the text last searched for.
+    char query[ENTERPRISE_STRING_LENGTH];
+    char searched[ENTERPRISE_STRING_LENGTH];
+
+    // True while the search box holds text and only matches are listed.
+    bool active;
+    // The version of the list when it was last searched.
+    uint64_t version;
+
+    // IDs of the matching records, in list order.
+    enterprise_id* ids;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+void text_index_init(struct text_index* index);
+void text_index_free(struct text_index* index);
+bool text_index_add(struct text_index* index, uint32_t handle, \
+const char* text);
+void text_index_clear(struct text_index* index);
+void text_index_finish(struct text_index* index);
+bool text_index_due(struct text_index* index);
+bool text_index_candidates(struct text_index* index, const char* query, \
+const uint32_t** candidates, uint32_t* candidate_count);
+bool text_index_contains(const char* text, const char* query);
+void text_search_init(struct text_search* search);
+void text_search_free(struct text_search* search);
+bool text_search_due(struct text_search* search, uint64_t version);
+void text_search_begin(struct text_search* search, uint64_t version);
+bool text_search_add(struct text_search* search, enterprise_id id);
+void text_search_finish(struct text_search* search);
+enterprise_id text_search_id(struct text_search* search, uint32_t row);
@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef ENTERPRISE_WORKER_POOL
+#define ENTERPRISE_WORKER_POOL
+#include "worker_pool.h"
+#endif
+
+// Returns the time in seconds since some fixed point, for timing work.
+double worker_pool_clock() {
+    struct timespec now;
+    if (timespec_get(&now, TIME_UTC) == 0) return 0.0;
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// Returns the number of processor cores that threads can run on.
+uint32_t worker_pool_cores() {
+    #if defined(ENTERPRISE_THREADS) && defined(_SC_NPROCESSORS_ONLN)
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        if (cores > WORKER_POOL_MAX_THREADS) return WORKER_POOL_MAX_THREADS;
+        if (cores > 0) return (uint32_t)cores;
+    #endif
+    return 1;
+}
+
+#if defined(ENTERPRISE_THREADS)
+
+// Run jobs as they are handed out until the pool stops.
+static void* worker_pool_thread(void* data) {
+    struct worker_pool* pool = data;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->count == 0 && pool->stopping == false) {
+            pthread_cond_wait(&pool->job_waiting, &pool->lock);
+        }
+        if (pool->count == 0) break;
+
+        struct worker_pool_job job = pool->jobs[pool->first];
+        pool->first++;
+        pool->count--;
+        pthread_mutex_unlock(&pool->lock);
+        job.function(job.data);
+        pthread_mutex_lock(&pool->lock);
+
+        if (job.finish != NULL) pool->finished[pool->finished_count++] = job;
+        if (--pool->unfinished == 0) {
+            pthread_cond_broadcast(&pool->jobs_finished);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Make room for one more waiting job.
+// Returns true on success, or false on failure.
+static bool worker_pool_reserve_job(struct worker_pool* pool) {
+    if (pool->first > 0) {
+        memmove(pool->jobs, pool->jobs + pool->first, \
+        sizeof(struct worker_pool_job) * pool->count);
+        pool->first = 0;
+    }
+    if (pool->count < pool->capacity) return true;
+    uint32_t capacity = pool->capacity == 0 \
+    ? WORKER_POOL_FIRST_CAPACITY : pool->capacity * 2;
+    struct worker_pool_job* jobs = \
+    realloc(pool->jobs, sizeof(struct worker_pool_job) * capacity);
+    if (jobs == NULL) return false;
+    pool->jobs = jobs;
+    pool->capacity = capacity;
+    return true;
+}
+
+#endif
+
+// Make room for one more job waiting for its finish function, on top of
+// every job that may already be.
+// Returns true on success, or false on failure.
+static bool worker_pool_reserve_finished(struct worker_pool* pool) {
+    uint32_t needed = pool->finished_count + pool->unfinished + 1;
+    if (needed <= pool->finished_capacity) return true;
+    uint32_t capacity = pool->finished_capacity == 0 \
+    ? WORKER_POOL_FIRST_CAPACITY : pool->finished_capacity * 2;
+    while (capacity < needed) capacity *= 2;
+    struct worker_pool_job* finished = \
+    realloc(pool->finished, sizeof(struct worker_pool_job) * capacity);
+    if (finished == NULL) return false;
+    pool->finished = finished;
+    pool->finished_capacity = capacity;
+    return true;
+}
+
+// Initialise a pool that runs jobs on up to thread_count threads.
+// Returns true on success, or false if the pool will run jobs on the thread
+// that hands them out.
+bool worker_pool_init(struct worker_pool* pool, uint32_t thread_count) {
+    if (pool == NULL) return false;
+    memset(pool, 0, sizeof(struct worker_pool));
+    #if defined(ENTERPRISE_THREADS)
+        if (thread_count > WORKER_POOL_MAX_THREADS) {
+            thread_count = WORKER_POOL_MAX_THREADS;
+        }
+        if (pthread_mutex_init(&pool->lock, NULL) != 0) return false;
+        if (pthread_cond_init(&pool->job_waiting, NULL) != 0) {
+            pthread_mutex_destroy(&pool->lock);
+            return false;
+        }
+        if (pthread_cond_init(&pool->jobs_finished, NULL) != 0) {
+            pthread_cond_destroy(&pool->job_waiting);
+            pthread_mutex_destroy(&pool->lock);
+            return false;
+        }
+        pool->synchronised = true;
+        while (pool->thread_count < thread_count && pthread_create\
+        (&pool->threads[pool->thread_count], NULL, worker_pool_thread, pool) \
+        == 0) {
+            pool->thread_count++;
+        }
+    #else
+        UNUSED(thread_count);
+    #endif
+    return pool->thread_count > 0;
+}
+
+// Hand a job to the pool, to run function on data, and then finish on data
+// when the pool is next drained, unless finish is NULL. If the pool has no
+// threads, or the job can not be queued, it runs before this returns, and if
+// its finish function can not be queued either, that runs straight after.
+void worker_pool_submit_finish(struct worker_pool* pool, \
+worker_pool_function function, worker_pool_function finish, void* data) {
+    if (pool == NULL || function == NULL) return;
+    #if defined(ENTERPRISE_THREADS)
+        if (pool->thread_count > 0) {
+            pthread_mutex_lock(&pool->lock);
+            if ((finish == NULL || worker_pool_reserve_finished(pool)) && \
+            (pool->first + pool->count < pool->capacity || \
+            worker_pool_reserve_job(pool))) {
+                struct worker_pool_job* job = \
+                &pool->jobs[pool->first + pool->count];
+                job->function = function;
+                job->finish = finish;
+                job->data = data;
+                pool->count++;
+                pool->unfinished++;
+                pthread_cond_signal(&pool->job_waiting);
+                pthread_mutex_unlock(&pool->lock);
+                return;
+            }
+            pthread_mutex_unlock(&pool->lock);
+        }
+    #endif
+    function(data);
+    if (finish == NULL) return;
+    #if defined(ENTERPRISE_THREADS)
+        if (pool->synchronised) pthread_mutex_lock(&pool->lock);
+    #endif
+    bool queued = worker_pool_reserve_finished(pool);
+    if (queued) {
+        struct worker_pool_job job = {function, finish, data};
+        pool->finished[pool->finished_count++] = job;
+    }
+    #if defined(ENTERPRISE_THREADS)
+        if (pool->synchronised) pthread_mutex_unlock(&pool->lock);
+    #endif
+    if (queued == false) finish(data);
+}
+
+// Hand a job to the pool, to run function on data. If the pool has no threads,
+// or the job can not be queued, it runs before this returns.
+void worker_pool_submit(struct worker_pool* pool, \
+worker_pool_function function, void* data) {
+    worker_pool_submit_finish(pool, function, NULL, data);
+}
+
+// Run the finish functions of the jobs that are done, in the order they were
+// done. Must be called from the thread the finish functions belong to.
+// Returns the number of finish functions run.
+uint32_t worker_pool_drain(struct worker_pool* pool) {
+    if (pool == NULL) return 0;
+    uint32_t drained = 0;
+    for (;;) {
+        struct worker_pool_job job;
+        bool found = false;
+        #if defined(ENTERPRISE_THREADS)
+            if (pool->synchronised) pthread_mutex_lock(&pool->lock);
+        #endif
+        if (pool->finished_count > 0) {
+            job = pool->finished[0];
+            pool->finished_count--;
+            memmove(pool->finished, pool->finished + 1, \
+            sizeof(struct worker_pool_job) * pool->finished_count);
+            found = true;
+        }
+        #if defined(ENTERPRISE_THREADS)
+            if (pool->synchronised) pthread_mutex_unlock(&pool->lock);
+        #endif
+        if (found == false) return drained;
+        job.finish(job.data);
+        drained++;
+    }
+}
+
+// Wait until every job handed to the pool so far has finished.
+void worker_pool_wait(struct worker_pool* pool) {
+    if (pool == NULL) return;
+    #if defined(ENTERPRISE_THREADS)
+        if (pool->thread_count == 0) return;
+        pthread_mutex_lock(&pool->lock);
+        while (pool->unfinished > 0) {
+            pthread_cond_wait(&pool->jobs_finished, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    #endif
+}
+
+// Free all resources associated with a pool, after waiting for its jobs and
+// running the finish functions still waiting to run.
+void worker_pool_free(struct worker_pool* pool) {
+    if (pool == NULL) return;
+    #if defined(ENTERPRISE_THREADS)
+        if (pool->thread_count > 0) {
+            pthread_mutex_lock(&pool->lock);
+            pool->stopping = true;
+            pthread_cond_broadcast(&pool->job_waiting);
+            pthread_mutex_unlock(&pool->lock);
+            for (uint32_t thread = 0; thread < pool->thread_count; thread++) {
+                pthread_join(pool->threads[thread], NULL);
+            }
+        }
+        if (pool->synchronised) {
+            pthread_cond_destroy(&pool->jobs_finished);
+            pthread_cond_destroy(&pool->job_waiting);
+            pthread_mutex_destroy(&pool->lock);
+            pool->synchronised = false;
+        }
+    #endif
+    worker_pool_drain(pool);
+    free(pool->jobs);
+    pool->jobs = NULL;
+    free(pool->finished);
+    pool->finished = NULL;
+    pool->finished_count = 0;
+    pool->thread_count = 0;
+}
+
+// Start noting the progress of a job of total steps, none of them done.
+void worker_pool_progress_begin\
+(struct worker_pool_progress* progress, uint64_t total) {
+    if (progress == NULL) return;
+    #if defined(__GNUC__)
+        __atomic_store_n(&progress->done, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&progress->total, total, __ATOMIC_RELAXED);
+    #else
+        progress->done = 0;
+        progress->total = total;
+    #endif
+}
+
+// Note that a job has done count more steps.
+void worker_pool_progress_add\
+(struct worker_pool_progress* progress, uint64_t count) {
+    if (progress == NULL) return;
+    #if defined(__GNUC__)
+        __atomic_fetch_add(&progress->done, count, __ATOMIC_RELAXED);
+    #else
+        progress->done += count;
+    #endif
+}
+
+// Returns how much of a job is done, from 0 to 1.
+double worker_pool_progress_fraction(struct worker_pool_progress* progress) {
+    if (progress == NULL) return 0.0;
+    #if defined(__GNUC__)
+        uint64_t done = __atomic_load_n(&progress->done, __ATOMIC_RELAXED);
+        uint64_t total = __atomic_load_n(&progress->total, __ATOMIC_RELAXED);
+    #else
+        uint64_t done = progress->done;
+        uint64_t total = progress->total;
+    #endif
+    if (total == 0) return 0.0;
+    return done >= total ? 1.0 : (double)done / (double)total;
+}
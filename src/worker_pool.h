@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "constants.h"
+
+// Threads are used wherever POSIX threads are available. Elsewhere, such as in
+// the browser build, or when built with ENTERPRISE_NO_THREADS defined, jobs
+// run one after another on the thread that hands them out.
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__) && \
+!defined(ENTERPRISE_NO_THREADS)
+    #define ENTERPRISE_THREADS
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+/* How worker pools work.
+Some work splits into jobs that touch nothing in common, such as loading each
+list of a snapshot. A worker pool runs such jobs at the same time on a few
+threads, so they take as long as the slowest job instead of all of them. Other
+work, such as saving a large enterprise, takes long enough that the program
+runs it on a worker thread so that frames keep being drawn in the meantime.
+
+Jobs are handed to the pool with worker_pool_submit and queued until a thread
+is free to run them, in the order they were handed out. worker_pool_wait
+returns once every job handed out so far has finished, and everything the jobs
+wrote can be read from then on.
+
+A job must only change data that no other job, and not the thread that
+handed it out, uses until the pool has been waited on. Jobs can not be
+cancelled, so a job that fails records it in its own data.
+
+A job can be given a finish function as well, which runs on the thread that
+drains the pool with worker_pool_drain once the job is done, rather than on the
+worker. The program drains its pool once a frame, so a finish function can
+safely touch whatever only the program's thread uses, such as the menus.
+
+While a job runs, it can note how far it has got in a worker_pool_progress,
+which any other thread can read at the same time, for example to draw a
+progress bar.
+
+Without threads, or if the pool could not start any, jobs run straight away
+on the thread that hands them out, so callers need no second code path.
+
+Data structures:
+worker_pool_job: A function to run, the data to run it on and what to do once
+it is done.
+worker_pool_progress: How far a job has got.
+worker_pool: The threads, the jobs waiting for them and the jobs done.
+*/
+
+#define WORKER_POOL_MAX_THREADS 64
+#define WORKER_POOL_FIRST_CAPACITY 16
+
+// A job run by a worker pool.
+typedef void (*worker_pool_function)(void* data);
+
+// A function to run, the data to run it on, and a function to run on the same
+// data once it is done, or NULL.
+struct worker_pool_job {
+    worker_pool_function function;
+    worker_pool_function finish;
+    void* data;
+};
+
+// How far a job has got, as done out of total steps.
+struct worker_pool_progress {
+    uint64_t done;
+    uint64_t total;
+};
+
+// Worker pool structure.
+struct worker_pool {
+    // Jobs waiting to run, from first to count.
+    struct worker_pool_job* jobs;
+    uint32_t first;
+    uint32_t count;
+    uint32_t capacity;
+
+    // Jobs that are done and waiting for their finish functions to run. There
+    // is always room for every job handed out with a finish function.
+    struct worker_pool_job* finished;
+    uint32_t finished_count;
+    uint32_t finished_capacity;
+
+    // Jobs handed out that have not finished yet.
+    uint32_t unfinished;
+    uint32_t thread_count;
+    bool stopping;
+
+    #if defined(ENTERPRISE_THREADS)
+        // Set once the lock and conditions below are initialised.
+        bool synchronised;
+        pthread_t threads[WORKER_POOL_MAX_THREADS];
+        pthread_mutex_t lock;
+        pthread_cond_t job_waiting;
+        pthread_cond_t jobs_finished;
+    #endif
+};
+
+double worker_pool_clock();
+uint32_t worker_pool_cores();
+bool worker_pool_init(struct worker_pool* pool, uint32_t thread_count);
+void worker_pool_submit_finish(struct worker_pool* pool, \
+worker_pool_function function, worker_pool_function finish, void* data);
+void worker_pool_submit(struct worker_pool* pool, \
+worker_pool_function function, void* data);
+uint32_t worker_pool_drain(struct worker_pool* pool);
+void worker_pool_wait(struct worker_pool* pool);
+void worker_pool_free(struct worker_pool* pool);
+void worker_pool_progress_begin\
+(struct worker_pool_progress* progress, uint64_t total);
+void worker_pool_progress_add\
+(struct worker_pool_progress* progress, uint64_t count);
+double worker_pool_progress_fraction(struct worker_pool_progress* progress);